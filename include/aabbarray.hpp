@@ -0,0 +1,80 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Axis aligned bounding boxes of a list of objects, packed as separate
+ * arrays of min x, min y, max x and max y. Used to test one box against many
+ * others at once with SSE or AVX.
+ *
+ * @details Overlap gives the same result as sf::FloatRect::intersects(...):
+ * boxes that only touch do not overlap, and boxes with zero width or height
+ * never overlap anything.
+ */
+class AabbArray
+{
+public:
+    /**
+     * @brief Create an empty array.
+     */
+    AabbArray();
+
+    /**
+     * @brief Set the number of boxes. New boxes are empty.
+     *
+     * @param count number of boxes.
+     */
+    void resize(std::size_t count);
+
+    /**
+     * @brief Set a box. Boxes with negative width or height are flipped, like
+     * sf::FloatRect::intersects(...) does.
+     *
+     * @param index index of box, less than get_size().
+     * @param bounds new bounds of the box.
+     */
+    void set(std::size_t index, const sf::FloatRect &bounds);
+
+    /**
+     * @brief Get number of boxes.
+     */
+    std::size_t get_size() const;
+
+    /**
+     * @brief Check if two boxes overlap.
+     */
+    bool overlaps(std::size_t first, std::size_t second) const;
+
+    /**
+     * @brief Find all boxes in [begin, end) that overlap box index, using the
+     * widest SIMD kernel available. Indices are added in increasing order.
+     *
+     * @param index index of box to test.
+     * @param begin first box to test against.
+     * @param end one past the last box to test against.
+     * @param found[out] indices of overlapping boxes are added to this.
+     */
+    void find_overlaps(std::size_t index, std::size_t begin, std::size_t end,
+                       std::vector<std::size_t> &found) const;
+
+    /**
+     * @brief Same as find_overlaps(...), but tests one box at a time. Used for
+     * the boxes left over by the SIMD kernels and to compare against them.
+     */
+    void find_overlaps_scalar(std::size_t index, std::size_t begin, std::size_t end,
+                              std::vector<std::size_t> &found) const;
+
+    /**
+     * @brief Get name of the kernel used by find_overlaps(...), "avx", "sse2"
+     * or "scalar".
+     */
+    static const char *get_kernel_name();
+
+private:
+    std::vector<float> m_min_x;
+    std::vector<float> m_min_y;
+    std::vector<float> m_max_x;
+    std::vector<float> m_max_y;
+};
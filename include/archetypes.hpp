@@ -0,0 +1,148 @@
+#pragma once
+
+#include "entityworld.hpp"
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Forward declaration
+class GameObject;
+struct EnemyMinionData;
+
+/**
+ * @brief Multipliers applied on top of an archetype at one difficulty.
+ */
+struct DifficultyModifier
+{
+    float health;
+    float speed;
+};
+
+/**
+ * @brief Description of one kind of simple enemy. Values are multipliers on
+ * the base values of EnemyMinionData, so all kinds scale with the
+ * configuration.
+ */
+struct EnemyArchetype
+{
+    std::string name;
+    std::string texture;
+    float health;
+    float speed;
+    float attack_cooldown;
+    float projectile_prob;
+    float powerup_prob;
+    AttackPattern pattern;
+    sf::Vector2f direction;
+    // Turn around at the sides of the window.
+    bool bounce;
+    // Modifiers of difficulty 1, 2 and 3.
+    std::array<DifficultyModifier, 3> difficulties;
+
+    /**
+     * @brief Construct an archetype with all multipliers 1, flying straight
+     * down and shooting down.
+     */
+    EnemyArchetype();
+
+    /**
+     * @brief Set value of in struct based on given key and value. If key is not
+     * recognized, false is returned. If key is recognized but value is invalid,
+     * exception is thrown.
+     *
+     * @param key key to set value for.
+     * @param value value to set.
+     */
+    bool set_value(const std::string &key, const std::string &value);
+};
+
+/**
+ * @brief Table of the simple enemies, see EnemyArchetype. Spawning an enemy is
+ * a lookup in the table followed by adding an entity to an EntityWorld.
+ *
+ * @details Tables are loaded from a file in the same format as the game
+ * configuration. ARCHETYPE starts a new archetype, the following keys belong
+ * to it:
+ *          // This is a comment
+ *          ARCHETYPE=tank;
+ *          TEXTURE=assets/images/enemy/Tank.png;
+ *          HEALTH=5.0;
+ *          HEALTH_1=1.5;
+ *
+ * Keys are:
+ *      ARCHETYPE (string), TEXTURE (string), HEALTH (float), SPEED (float),
+ *      ATTACK_COOLDOWN (float), PROJECTILE_PROB (float), POWERUP_PROB (float),
+ *      PATTERN (NONE, DOWN, CROSS or TURN), DIRECTION_X (float),
+ *      DIRECTION_Y (float), BOUNCE (0 or 1), HEALTH_1, HEALTH_2, HEALTH_3,
+ *      SPEED_1, SPEED_2, SPEED_3 (float)
+ *
+ * @note Invalid values and keys outside of an archetype throw
+ * std::logic_error. Unknown keys are ignored.
+ */
+class ArchetypeTable
+{
+public:
+    /**
+     * @brief Create an empty table.
+     */
+    ArchetypeTable();
+
+    /**
+     * @brief Get the built in table: minion, mover, tank and multishot.
+     */
+    static ArchetypeTable defaults();
+
+    /**
+     * @brief Load a table from file. Throws std::logic_error if the file
+     * cannot be opened.
+     *
+     * @param path path to archetype file.
+     */
+    static ArchetypeTable from_file(const std::string &path);
+
+    /**
+     * @brief Add an archetype. Replaces any archetype with the same name.
+     *
+     * @return std::size_t id of the archetype.
+     */
+    std::size_t add(const EnemyArchetype &archetype);
+
+    /**
+     * @brief Get id of an archetype. Throws std::logic_error if there is no
+     * archetype with the name.
+     */
+    std::size_t find(const std::string &name) const;
+
+    /**
+     * @brief Get an archetype.
+     *
+     * @param id id returned by add(...) or find(...).
+     */
+    const EnemyArchetype &get(std::size_t id) const;
+
+    /**
+     * @brief Get number of archetypes.
+     */
+    std::size_t get_size() const;
+
+    /**
+     * @brief Add an enemy to a world.
+     *
+     * @param world world to add the enemy to.
+     * @param data base values of all simple enemies.
+     * @param id id of the archetype.
+     * @param x position.
+     * @param y position.
+     * @param difficulty 1, 2 or 3, clamped to that range.
+     * @return GameObject* object of the enemy, see EntityObject. Owned by the
+     * caller.
+     */
+    GameObject *create(EntityWorld &world, const EnemyMinionData &data, std::size_t id,
+                       float x, float y, int difficulty) const;
+
+private:
+    std::vector<EnemyArchetype> m_archetypes;
+};
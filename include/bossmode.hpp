@@ -14,15 +14,18 @@ public:
     BossMode(const BossMode &) = delete;
     BossMode &operator=(const BossMode &) = delete;
 
-    void render(sf::RenderWindow &window) const override;
+    void render(RenderSnapshot &snapshot) const override;
     void update(Context &context) override;
     void handle(const sf::Event &event, Context &context) override;
     void init(const GameConfiguration &gc) override;
+    unsigned int get_level() const override;
 
 private:
-    GameObject* m_boss;
+    // Stale once the boss is deleted, see GameMode::get_object(...).
+    ObjectHandle m_boss;
     bool m_to_normal;
-    sf::Time m_to_normal_time;
+    // Goes back to the normal mode a grace period after the boss is beaten.
+    Timer m_to_normal_timer;
     float m_time; 
 
     GameMode *m_previous_state;
@@ -36,10 +39,15 @@ private:
     unsigned m_boss_level; 
     unsigned m_player_level; 
 
-    void render_texts(sf::RenderWindow &window) const;
+    void render_texts(RenderSnapshot &snapshot) const;
     void init_texts();
-    void update_texts();
+    void update_texts(const HudData &hud, FrameArena &arena) override;
 
+    /**
+     * @brief Go back to the normal mode after the grace period, once the boss
+     * is defeated.
+     */
+    void start_to_normal_timer();
     void to_normal(Context &context);
     void to_end(Context &context);
 };
\ No newline at end of file
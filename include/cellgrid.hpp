@@ -0,0 +1,111 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Axis aligned box of an item of a CellGrid. A box with min_x above
+ * max_x is empty and is left out of the grid.
+ */
+struct CellBox
+{
+    float min_x;
+    float min_y;
+    float max_x;
+    float max_y;
+
+    /**
+     * @brief Get a box that is left out of the grid.
+     */
+    static CellBox empty();
+};
+
+/**
+ * @brief Uniform grid of the indices of boxes, shared by SpatialGrid and
+ * ProjectileSystem. Only knows the boxes, what they stand for is up to the
+ * owner.
+ *
+ * @details Every box is stored in all cells it touches. The cells are filled
+ * by a counting sort: count the boxes of every cell, turn the counts into
+ * start indices and fill. The memory is kept between builds.
+ */
+class CellGrid
+{
+public:
+    /**
+     * @brief Indices of the boxes in one cell.
+     */
+    struct Cell
+    {
+        const std::size_t *first;
+        const std::size_t *last;
+
+        const std::size_t *begin() const;
+        const std::size_t *end() const;
+    };
+
+    /**
+     * @brief Create an empty grid.
+     *
+     * @param cell_size width and height of the cells.
+     * @param max_cells cells are made larger if the boxes are spread over
+     * more than this many cells in any direction.
+     */
+    CellGrid(float cell_size, float max_cells);
+
+    /**
+     * @brief Replace the contents of the grid. Box i is stored as index i.
+     *
+     * @param boxes boxes to add, empty boxes are left out.
+     */
+    void build(const std::vector<CellBox> &boxes);
+
+    /**
+     * @brief Remove all boxes.
+     */
+    void clear();
+
+    /**
+     * @brief Get the column or row of a coordinate, may be outside the grid.
+     */
+    int get_column(float x) const;
+    int get_row(float y) const;
+
+    /**
+     * @brief Get number of columns or rows, 0 if the grid is empty.
+     */
+    int get_columns() const;
+    int get_rows() const;
+
+    float get_cell_size() const;
+
+    /**
+     * @brief Get the top left corner of the grid.
+     */
+    const sf::Vector2f &get_origin() const;
+
+    /**
+     * @brief Get the boxes of a cell inside the grid.
+     */
+    Cell get_cell(int column, int row) const;
+
+    /**
+     * @brief Check if a cell is the first cell both a box and a query starting
+     * at first_column and first_row cover. Queries over several cells report
+     * a box only there, so every box is reported once.
+     */
+    bool is_first_cell(const CellBox &box, int column, int row, int first_column, int first_row) const;
+
+private:
+    float m_default_cell_size;
+    float m_max_cells;
+    float m_cell_size;
+    sf::Vector2f m_origin;
+    int m_columns;
+    int m_rows;
+    // Boxes of cell i are m_cell_boxes[m_cell_start[i]] until
+    // m_cell_boxes[m_cell_start[i + 1]].
+    std::vector<std::size_t> m_cell_start;
+    std::vector<std::size_t> m_cell_boxes;
+};
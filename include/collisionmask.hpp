@@ -0,0 +1,67 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Opaque pixels of an image, packed as one bit per pixel into rows of
+ * 64-bit words. Used for pixel accurate collision.
+ *
+ * @details Bit k of word w in a row is pixel 64 * w + k. Pixels outside the
+ * image are transparent.
+ */
+class CollisionMask
+{
+public:
+    /**
+     * @brief Create an empty mask.
+     */
+    CollisionMask();
+
+    /**
+     * @brief Create a mask of the pixels with at least the given alpha.
+     *
+     * @param image image to create mask from.
+     * @param alpha_threshold lowest alpha of an opaque pixel.
+     */
+    explicit CollisionMask(const sf::Image &image, sf::Uint8 alpha_threshold = 128);
+
+    /**
+     * @brief Get width in pixels.
+     */
+    unsigned get_width() const;
+
+    /**
+     * @brief Get height in pixels.
+     */
+    unsigned get_height() const;
+
+    /**
+     * @brief Check if a pixel is opaque. Returns false outside the mask.
+     */
+    bool get(int x, int y) const;
+
+    /**
+     * @brief Get the 64 pixels of row y starting at column x, bit k being
+     * pixel x + k. x does not have to be a multiple of 64.
+     */
+    std::uint64_t get_row_bits(int x, int y) const;
+
+    /**
+     * @brief Get number of opaque pixels.
+     */
+    std::size_t get_count() const;
+
+private:
+    unsigned m_width;
+    unsigned m_height;
+    std::size_t m_row_words;
+    std::vector<std::uint64_t> m_bits;
+
+    /**
+     * @brief Get a word of a row, 0 outside the mask.
+     */
+    std::uint64_t get_word(long word, int y) const;
+};
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Forward declaration
+class GameObject;
+
+/**
+ * @brief Change in contact between two objects since the last frame.
+ */
+struct ContactEvent
+{
+    enum class Type
+    {
+        Enter,
+        Stay,
+        Exit
+    };
+
+    Type type;
+    GameObject *first;
+    GameObject *second;
+};
+
+/**
+ * @brief Remembers which pairs of objects touched last frame, so that contacts
+ * can be reported as enter, stay and exit events instead of being found anew
+ * every frame.
+ *
+ * @details Events are in a fixed order: enter and stay events in the order the
+ * pairs are given, followed by exit events in the order the contacts were given
+ * in the previous update.
+ */
+class ContactCache
+{
+public:
+    /**
+     * @brief Create an empty cache.
+     */
+    ContactCache();
+
+    /**
+     * @brief Replace the contacts with the pairs touching this frame.
+     *
+     * @param pairs pairs touching this frame, each pair at most once.
+     * @param events[out] events are added to this.
+     */
+    void update(const std::vector<std::pair<GameObject *, GameObject *>> &pairs,
+                std::vector<ContactEvent> &events);
+
+    /**
+     * @brief Remove all contacts with objects that are marked as removed. Call
+     * before the objects are deleted.
+     *
+     * @param events[out] an exit event is added for every removed contact.
+     */
+    void remove_removed_objects(std::vector<ContactEvent> &events);
+
+    /**
+     * @brief Remove all contacts with an object without any events. Call before
+     * deleting an object that is not marked as removed.
+     *
+     * @param object object to forget.
+     */
+    void forget(const GameObject *object);
+
+    /**
+     * @brief Check if two objects are in contact, in any order.
+     */
+    bool has_contact(const GameObject *first, const GameObject *second) const;
+
+    /**
+     * @brief Get number of contacts.
+     */
+    std::size_t get_contact_count() const;
+
+    /**
+     * @brief Remove all contacts without any events.
+     */
+    void clear();
+
+private:
+    typedef std::pair<const GameObject *, const GameObject *> Key;
+
+    struct KeyHash
+    {
+        std::size_t operator()(const Key &key) const;
+    };
+
+    // Frame the contact was last seen in.
+    std::unordered_map<Key, std::size_t, KeyHash> m_frames;
+    // Contacts in the order of the last update.
+    std::vector<std::pair<GameObject *, GameObject *>> m_contacts;
+    std::vector<std::pair<GameObject *, GameObject *>> m_next_contacts;
+    std::size_t m_frame;
+
+    /**
+     * @brief Get key of a pair, the same for both orders.
+     */
+    static Key make_key(const GameObject *first, const GameObject *second);
+};
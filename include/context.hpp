@@ -3,18 +3,60 @@
 #include <SFML/Graphics.hpp>
 #include <vector>
 
+#include "eventbus.hpp"
+#include "framearena.hpp"
+#include "projectilesystem.hpp"
+
 // Forward declaration
 class GameObject;
 class GameState;
-class Player;
+class SpatialGrid;
+class ThreadPool;
+struct RayHit;
+enum class CollisionLayer : unsigned;
 typedef std::vector<GameObject *> ObjectVector;
 
+/**
+ * @brief Damage done to everything whose bounds are in a ring around a point,
+ * see Context::spawn_area_effect(...).
+ */
+struct AreaEffect
+{
+    sf::Vector2f center;
+    // Objects this close or closer are not hit.
+    float inner_radius;
+    float outer_radius;
+    // Same as the arguments of BasicProjectile.
+    bool friendly;
+    int damage;
+};
+
+/**
+ * @brief Objects, projectiles, area effects and events spawned by one thread,
+ * see Context::set_thread_spawn_buffer(...).
+ */
+struct SpawnBuffer
+{
+    std::vector<GameObject *> objects;
+    std::vector<ProjectileSpawn> projectiles;
+    std::vector<AreaEffect> area_effects;
+    EventBus events;
+
+    /**
+     * @brief Construct an empty spawn buffer.
+     */
+    SpawnBuffer();
+};
+
 /**
  * @brief Contains all data needed by GameStates and GameObjects. Will be
  * used to pass data throughout the program.
  *
  * @attention objects passed into Context must live as long or longer than the
  * created context object. Otherwise you can get access to deallocated memory.
+ *
+ * @details A context is kept from one frame to the next, see end_frame(), so
+ * its queues keep their memory.
  */
 class Context
 {
@@ -45,6 +87,13 @@ public:
      */
     void set_delta(const sf::Time &delta);
 
+    /**
+     * @brief Get ready for the next frame: the next state, the spatial grid
+     * and the event bus are reset and the frame arena is emptied. The spawn
+     * queues must already be empty.
+     */
+    void end_frame();
+
     /**
      * @brief Set next game state. If next state is already set, it will not
      * be set.
@@ -59,16 +108,118 @@ public:
      * @brief Add GameObjects to the spawn queue. Takes ownership of the spawned
      * GameObject.
      *
+     * @details If the calling thread has a spawn buffer set, see
+     * set_thread_spawn_buffer(...), the object is added to that buffer instead.
+     *
      * @param game_object GameObject to be spawned.
      */
     void spawn_object(GameObject *object);
 
     /**
-     * @brief Set the current player.
+     * @brief Add a projectile to the spawn queue. Takes the same arguments as
+     * the constructor of BasicProjectile. The projectile is added to the
+     * projectile system of the game mode, see ProjectileSystem.
+     *
+     * @details If the calling thread has a spawn buffer set, see
+     * set_thread_spawn_buffer(...), the projectile is added to that buffer
+     * instead.
+     */
+    void spawn_projectile(float x, float y, float angle, float v, bool friendly, int damage = 1);
+
+    /**
+     * @brief Add an area effect to the queue. The game mode applies it once,
+     * after all objects are updated: ships in the ring are hit as if by a
+     * BasicProjectile, and projectiles of the other side in the ring are
+     * killed.
+     *
+     * @details If the calling thread has a spawn buffer set, see
+     * set_thread_spawn_buffer(...), the effect is added to that buffer
+     * instead.
+     */
+    void spawn_area_effect(const AreaEffect &effect);
+
+    /**
+     * @brief Publish a gameplay event to the event bus, see EventBus. The
+     * event is dropped if no bus is set.
+     *
+     * @details If the calling thread has a spawn buffer set, see
+     * set_thread_spawn_buffer(...), the event is added to that buffer instead.
+     */
+    template <typename T>
+    void publish(const T &event);
+
+    /**
+     * @brief Redirect spawn_object(...), spawn_projectile(...),
+     * spawn_area_effect(...) and publish(...) calls made by
+     * the calling thread into the given buffer. Used when objects are updated
+     * in parallel, so spawns can be merged back in a deterministic order. Pass
+     * nullptr to reset.
+     *
+     * @param buffer buffer owned by the caller, or nullptr.
+     */
+    static void set_thread_spawn_buffer(SpawnBuffer *buffer);
+
+    /**
+     * @brief Spawn and publish everything in a buffer, in the order it was
+     * added, as if the calls had been made on the calling thread. Empties the
+     * buffer, keeping its memory.
+     *
+     * @param buffer buffer filled by a thread, see set_thread_spawn_buffer(...).
+     */
+    void merge_spawn_buffer(SpawnBuffer &buffer);
+
+    /**
+     * @brief Set the thread pool used for parallel work. May be nullptr, in
+     * which case all work is done on the calling thread.
+     *
+     * @param pool thread pool, must outlive the context.
+     */
+    void set_thread_pool(ThreadPool *pool);
+
+    /**
+     * @brief Set the grid used by the spatial queries, see find_nearest(...).
+     * May be nullptr, in which case the queries find nothing.
+     *
+     * @param grid grid of the current objects, must outlive its use.
+     */
+    void set_spatial_grid(const SpatialGrid *grid);
+
+    /**
+     * @brief Set the bus that publish(...) adds events to. May be nullptr, in
+     * which case events are dropped.
+     *
+     * @param bus event bus, must outlive its use.
+     */
+    void set_event_bus(EventBus *bus);
+
+    /**
+     * @brief Find the object closest to a point in the given layers, see
+     * SpatialGrid::find_nearest(...). Objects are seen as they were at the end
+     * of the last frame.
+     *
+     * @return closest object, or nullptr if there is none.
+     */
+    const GameObject *find_nearest(const sf::Vector2f &point, CollisionLayer layers,
+                                   float max_distance = 1e9f) const;
+
+    /**
+     * @brief Find all objects in the given layers within a radius of a point,
+     * see SpatialGrid::find_in_radius(...).
+     *
+     * @param found[out] found objects are added to this.
+     */
+    void find_in_radius(const sf::Vector2f &point, float radius, CollisionLayer layers,
+                        std::vector<const GameObject *> &found) const;
+
+    /**
+     * @brief Find the first object in the given layers hit by a ray, see
+     * SpatialGrid::raycast(...).
      *
-     * @param player current player.
+     * @param hit[out] the first hit, if any.
+     * @return true if an object was hit.
      */
-    void set_player(const Player *player);
+    bool raycast(const sf::Vector2f &origin, const sf::Vector2f &direction, float max_distance,
+                 CollisionLayer layers, RayHit &hit) const;
 
     /**
      * @brief Get delta-time between current and last frame.
@@ -91,11 +242,29 @@ public:
      * @details The objects are given away to prevent multiple pointers to
      * the same object accidentally. Which can lead to undefined behaviour.
      *
-     * @param objects[out] the vector with new objects will be moved into this
-     * parameter.
+     * @param objects[out] the vector with new objects will be swapped with
+     * this parameter, which should be empty. Its memory is used for the next
+     * objects.
      */
     void get_new_objects(std::vector<GameObject *> &objects);
 
+    /**
+     * @brief Get all new projectiles that should be spawned. The queue is
+     * emptied.
+     *
+     * @param projectiles[out] the new projectiles will be moved into this
+     * parameter.
+     */
+    void get_new_projectiles(std::vector<ProjectileSpawn> &projectiles);
+
+    /**
+     * @brief Get all area effects that should be applied. The queue is
+     * emptied.
+     *
+     * @param effects[out] the new effects will be moved into this parameter.
+     */
+    void get_new_area_effects(std::vector<AreaEffect> &effects);
+
     /**
      * @brief Get the window size as sf::Vector2u.
      *
@@ -111,12 +280,20 @@ public:
     const sf::RenderWindow &get_window() const;
 
     /**
-     * @brief Get read only reference to current player. Will throw exception
-     * if player is not set.
+     * @brief Get the thread pool. Nullptr if no pool is set.
      *
-     * @return const Player* current player.
+     * @return ThreadPool* thread pool.
      */
-    const Player *get_player() const;
+    ThreadPool *get_thread_pool() const;
+
+    /**
+     * @brief Get the arena for memory needed until the end of the frame, see
+     * FrameArena. Only for the game state, e.g. its HUD task, not for objects
+     * updated in parallel.
+     *
+     * @return FrameArena& arena, emptied by end_frame().
+     */
+    FrameArena &get_frame_arena();
 
     /**
      * @brief Exit the game.
@@ -134,8 +311,27 @@ private:
     sf::Time m_delta;
     GameState *m_next_state;
     std::vector<GameObject *> m_new_objects;
+    std::vector<ProjectileSpawn> m_new_projectiles;
+    std::vector<AreaEffect> m_new_area_effects;
     const sf::RenderWindow &m_window;
     bool m_quit;
-    const Player *m_player;
+    ThreadPool *m_thread_pool;
+    const SpatialGrid *m_spatial_grid;
+    EventBus *m_event_bus;
+    FrameArena m_frame_arena;
     /* Should contain everything that objects and states need*/
-};
\ No newline at end of file
+
+    /**
+     * @brief Get the bus publish(...) adds events to: the bus of the spawn
+     * buffer of the calling thread if set, otherwise m_event_bus.
+     */
+    EventBus *get_event_bus() const;
+};
+
+template <typename T>
+void Context::publish(const T &event)
+{
+    EventBus *bus{get_event_bus()};
+    if (bus != nullptr)
+        bus->publish(event);
+}
\ No newline at end of file
@@ -0,0 +1,170 @@
+#pragma once
+
+#include "timerwheel.hpp"
+
+#include <SFML/System.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Forward declaration
+class Context;
+
+/**
+ * @brief What a timed effect modifies.
+ */
+enum class EffectType : std::uint8_t
+{
+    // Multiplies the cooldown between shots.
+    FireRate,
+    // Multiplies the movement speed.
+    Speed,
+    // Fire three shots in a fan.
+    Spread,
+    // Fire two shots side by side.
+    DoubleShot,
+    // Each stack absorbs one hit.
+    Shield
+};
+
+/**
+ * @brief One active effect type of an EffectStack, as shown in the HUD.
+ */
+struct EffectStatus
+{
+    EffectType type;
+    unsigned int stacks;
+    // Seconds until the last stack runs out.
+    float remaining;
+};
+
+/**
+ * @brief Time limited modifiers of a ship, e.g. from power-ups.
+ *
+ * @details Every add(...) is one stack with its own duration. Stacks of a type
+ * are combined by multiplying their values, see get_multiplier(...). When a type
+ * has as many stacks as allowed, adding another refreshes the stack that would
+ * run out first instead. The stack holds at most s_capacity stacks, when full
+ * the stack closest to running out is replaced.
+ *
+ * Stacks run out on a TimerWheel owned by the stack, moved by update(...), so
+ * nothing is polled and the effects follow the ship from one game mode to the
+ * next. The stacks live in a fixed array, adding and removing never allocates.
+ */
+class EffectStack
+{
+public:
+    // Stacks of all types held at once.
+    static const std::size_t s_capacity{8};
+
+    typedef std::array<EffectStatus, s_capacity> StatusArray;
+
+    EffectStack();
+
+    EffectStack(const EffectStack &) = delete;
+    EffectStack &operator=(const EffectStack &) = delete;
+
+    /**
+     * @brief Add a stack of an effect.
+     *
+     * @param type what the effect modifies.
+     * @param value multiplier of the effect, see get_multiplier(...).
+     * @param duration seconds until the stack runs out.
+     * @param max_stacks stacks of the type allowed at once, at least 1.
+     */
+    void add(EffectType type, float value, float duration, unsigned int max_stacks = 1);
+
+    /**
+     * @brief Remove all stacks of a type.
+     */
+    void remove(EffectType type);
+
+    /**
+     * @brief Remove the stack of a type that runs out first, e.g. a shield
+     * that absorbed a hit.
+     *
+     * @return true if there was a stack to remove.
+     */
+    bool consume(EffectType type);
+
+    /**
+     * @brief Remove all stacks.
+     */
+    void clear();
+
+    /**
+     * @brief Move time forward, removing the stacks that run out.
+     *
+     * @param delta time since the last update.
+     * @param context[in,out] class containing useful data.
+     */
+    void update(const sf::Time &delta, Context &context);
+
+    /**
+     * @brief Check if a type has at least one stack.
+     */
+    bool has(EffectType type) const;
+
+    /**
+     * @brief Get number of stacks of a type.
+     */
+    unsigned int get_stacks(EffectType type) const;
+
+    /**
+     * @brief Get the product of the values of all stacks of a type, 1 if there
+     * are none.
+     */
+    float get_multiplier(EffectType type) const;
+
+    /**
+     * @brief Get number of stacks of all types.
+     */
+    std::size_t get_size() const;
+
+    /**
+     * @brief Get one status per active type, ordered by the oldest stack of
+     * each type.
+     *
+     * @param status[out] filled from the start.
+     * @return std::size_t number of statuses filled in.
+     */
+    std::size_t get_status(StatusArray &status) const;
+
+    /**
+     * @brief Get the name of a type, as shown in the HUD.
+     */
+    static const char *get_name(EffectType type);
+
+private:
+    struct Stack
+    {
+        EffectType type;
+        float value;
+        // Told to the timer, which can not know its own id.
+        std::uint32_t serial;
+        TimerId expiry;
+    };
+
+    std::array<Stack, s_capacity> m_stacks;
+    std::size_t m_size;
+    std::uint32_t m_next_serial;
+    TimerWheel m_timers;
+
+    /**
+     * @brief Get index of the stack of a type, or of any type if
+     * any_type is set, that runs out first. -1 if there is none.
+     */
+    int find_first_to_expire(EffectType type, bool any_type = false) const;
+
+    /**
+     * @brief Remove the stack at an index, cancelling its timer. Keeps the
+     * order of the other stacks.
+     */
+    void erase(std::size_t index);
+
+    /**
+     * @brief Give a stack a new serial and schedule its end, cancelling the
+     * old end if any.
+     */
+    void schedule(Stack &stack, float duration);
+};
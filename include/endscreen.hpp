@@ -3,15 +3,20 @@
 #include "gamestate.hpp"
 #include "gameobject.hpp"
 
+#include <cstddef>
+#include <cstdint>
+
+class ScoreStore;
+
 class EndScreen : public Menu
 {
 public:
-    EndScreen(GameState *previous_state, Player *current_player);
+    EndScreen(GameState *previous_state, Player *current_player, unsigned int level = 0);
     virtual ~EndScreen();
     EndScreen(const EndScreen &) = delete;
     EndScreen &operator=(const EndScreen &) = delete;
 
-    void render(sf::RenderWindow &window) const override;
+    void render(RenderSnapshot &snapshot) const override;
     void update(Context &context) override;
     void handle(const sf::Event &event, Context &context) override;
     void init(const GameConfiguration &gc) override;
@@ -19,19 +24,43 @@ public:
 private:
     GameState *m_previous_state;
     Player *m_current_player;
+    unsigned int m_level;
     sf::Sprite m_scoreboard;
     
     sf::Text m_player_score_text; 
     sf::Text m_death_text; 
     sf::Text m_highscore_text;
+    sf::Text m_leaderboard_text;
     unsigned int m_current_highscore;
 
+    // Leaderboard is owned by the game configuration and shared between states.
+    const ScoreStore *m_score_store;
+    std::uint64_t m_leaderboard_version;
+    std::size_t m_score_ticket;
+    int m_leaderboard_rank;
+
     void init_texts(const GameConfiguration &gc); 
-    void render_texts(sf::RenderWindow &window) const; 
+    void render_texts(RenderSnapshot &snapshot) const; 
     void update_texts();
-    
-    void check_highscore(const GameConfiguration &gc);
-    void set_new_highscore(const GameConfiguration &gc);
+
+    /**
+     * @brief Rebuild the leaderboard text, but only if the leaderboard or the
+     * rank of this run has changed since last time. Polled every frame, never
+     * waits for the score store.
+     */
+    void update_leaderboard_text();
+
+    /**
+     * @brief Update the high score and whether this run beat it from the
+     * score store.
+     */
+    void check_highscore();
+
+    /**
+     * @brief Submit the finished run to the leaderboard. Saving is done in the
+     * background by the score store.
+     */
+    void submit_score(const GameConfiguration &gc);
     bool m_new_highscore;
 
 };
@@ -1,6 +1,8 @@
 #pragma once
 #include "ship.hpp"
+#include "timerwheel.hpp"
 #include <SFML/Graphics.hpp>
+#include <random>
 
 struct EnemyMinionData;
 struct EnemyBossData;
@@ -22,21 +24,42 @@ public:
      * @brief Update function, with common functionality for all enemies.
      *
      * @details Will do following:
-     *          1. Check if the enemy is ready to attack. If so, call attack function.
-     *          2. Check if the enemy is dead. If so, remove it from the game.
-     *          3. Move the enemy.
-     *          4. Check if the enemy is outside the screen. If so, remove it from the game.'
+     *          1. Check if the enemy is dead. If so, remove it from the game.
+     *          2. Move the enemy.
+     *          3. Check if the enemy is outside the screen. If so, remove it from the game.'
      *             Only checks the y position (outside bottom of the screen).
      *
      * @param context[in,out] class containing useful data.
      */
     void update(Context &context) override;
+
+    /**
+     * @brief Start the attack timer. Every attack cooldown, the enemy calls
+     * attack function with a chance of the projectile probability.
+     */
+    void start_timers(TimerWheel &timers) override;
     bool handle(const sf::Event &event, Context &context) override;
     sf::FloatRect bounds() const override;
+    CollisionLayer get_layer() const override;
+
+    /**
+     * @brief Take damage from the player and friendly projectiles. Called
+     * once per contact, see collision_enter(...).
+     */
     void collision(const GameObject *other) override;
 
+    /**
+     * @brief Does nothing, damage is only taken when a contact starts.
+     */
+    void collision_stay(const GameObject *other) override;
+
+    /**
+     * @brief Take damage from a friendly projectile.
+     */
+    void projectile_hit(const ProjectileHit &hit) override;
+
 protected:
-    sf::Clock clock;
+    Timer e_attack_timer;
     // Prefixed with e_ (e for enemy) to make it clearer.
     float e_powerup_prob;
     float e_attack_cooldown;
@@ -44,11 +67,26 @@ protected:
     float e_powerup_speed;
     sf::Vector2f e_move_direction;
 
-    void Randomize_powerup(Context &context, float x_pos, float y_pos) const;
+    // Every enemy has its own random generator, seeded when it is created. Gives
+    // the same result no matter in which order, or on which thread, enemies are
+    // updated.
+    std::minstd_rand e_rng;
+
+    void Randomize_powerup(Context &context, float x_pos, float y_pos);
+
+    /**
+     * @brief Get a random integer in [0, max).
+     */
+    int random_int(int max);
+
+    /**
+     * @brief Get a random float in [0, 1].
+     */
+    float random_float();
 
     /**
      * @brief Attack function for the enemy. Will be called when the enemy is ready to attack,
-     * if Enemy update function is used. Default implementation will do nothing.
+     * if Enemy start_timers function is used. Default implementation will do nothing.
      *
      * @param context[in,out] class containing useful data.
      */
@@ -6,16 +6,22 @@
 
 struct EnemyBossData;
 
-class EnemyBoss : public Enemy
+class EnemyBoss final : public Enemy
 {
 public:
     EnemyBoss(const EnemyBossData &data, float x, float y, int difficulty);
     ~EnemyBoss() = default;
     void update(Context &context) override;
 
+    /**
+     * @brief Start the attack timer. After every cooldown the boss picks one
+     * of its attacks and fires it a number of times.
+     */
+    void start_timers(TimerWheel &timers) override;
+    ObjectKind get_kind() const override;
+
 private:
     const sf::Texture &m_image;
-    bool doing_attack;
     int attack_nr{};
     int counter{};
     int boss_attack_length{};
@@ -6,25 +6,30 @@
 
 struct EnemyBossData;
 
-class EnemyBoss2 : public Enemy
+class EnemyBoss2 final : public Enemy
 {
 public:
     EnemyBoss2(const EnemyBossData &data, float x, float y, int diffuculty);
     ~EnemyBoss2() = default;
     void update(Context &context) override;
 
+    /**
+     * @brief Start the attack timers: a constant attack every attack time,
+     * and one of two random attacks every cooldown.
+     */
+    void start_timers(TimerWheel &timers) override;
+    ObjectKind get_kind() const override;
+
 private:
     const sf::Texture &m_image;
-    bool m_attack;
     float m_attack_time;
-    int m_attack_number;
     int m_number_of_items_spawned;
 
     void check_health(Context &context);
     void attack(Context &context, int attack_number);
-    void cooldown();
     void constant_attack(Context &context);
 
-    sf::Clock const_attack_clock;
-    sf::Clock m_clock;
+    Timer m_constant_attack_timer;
+    // Seconds of constant attacks so far, sways the projectiles side to side.
+    float m_constant_attack_phase;
 };
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+#include "entityworld.hpp"
+#include "gameobject.hpp"
+
+/**
+ * @brief GameObject standing in for an entity of an EntityWorld, so the
+ * entity takes part in collisions, spatial queries and removal like any other
+ * object.
+ *
+ * @details The object holds no state of its own: bounds, layer and damage go
+ * through the components of the entity, and update(...) and rendering are
+ * left to the systems of the world. Deleting the object destroys the entity.
+ */
+class EntityObject : public GameObject
+{
+public:
+    /**
+     * @brief Create an entity and its object.
+     *
+     * @param world world to add the entity to, must outlive the object.
+     * @param desc components of the entity.
+     */
+    EntityObject(EntityWorld &world, const EntityDesc &desc);
+    ~EntityObject();
+
+    EntityObject(const EntityObject &) = delete;
+    EntityObject &operator=(const EntityObject &) = delete;
+
+    /**
+     * @brief Allocate an object from the pool. Classes deriving from
+     * EntityObject are allocated as usual. The pool is shared by all threads.
+     */
+    static void *operator new(std::size_t size);
+    static void operator delete(void *memory, std::size_t size);
+
+    /**
+     * @brief Get number of objects that can be allocated from the pool
+     * without allocating more memory.
+     *
+     * @note Primary use is for testing.
+     */
+    static std::size_t get_pool_free();
+
+    /**
+     * @brief Does nothing, the entity is updated by EntityWorld::update(...).
+     */
+    void update(Context &context) override;
+
+    /**
+     * @brief Does nothing, the entity is drawn by EntityWorld::render(...).
+     */
+    void render(RenderSnapshot &snapshot) const override;
+    bool render_batched(RenderBatch &batch) const override;
+
+    /**
+     * @brief Start the weapon of the entity, see EntityWorld::start_weapon(...).
+     */
+    void start_timers(TimerWheel &timers) override;
+
+    bool handle(const sf::Event &event, Context &context) override;
+    sf::FloatRect bounds() const override;
+    bool get_collision_shape(CollisionShape &shape) const override;
+    CollisionLayer get_layer() const override;
+    ObjectKind get_kind() const override;
+
+    /**
+     * @brief Take damage from ships and projectiles of the other side. Called
+     * once per contact, see collision_enter(...).
+     */
+    void collision(const GameObject *other) override;
+
+    /**
+     * @brief Does nothing, damage is only taken when a contact starts.
+     */
+    void collision_stay(const GameObject *other) override;
+
+    /**
+     * @brief Take damage from a projectile of the other side.
+     */
+    void projectile_hit(const ProjectileHit &hit) override;
+
+    /**
+     * @brief Get the entity of the object.
+     */
+    Entity get_entity() const;
+
+    /**
+     * @brief Get current health of the entity.
+     */
+    int get_health() const;
+
+private:
+    // Objects allocated at a time when the pool is empty.
+    static const std::size_t s_pool_block_size;
+    // Free memory of the pool, every pointer fits one EntityObject.
+    static std::vector<void *> s_pool;
+    // Objects may be created and deleted on worker threads, guards s_pool.
+    static std::mutex s_pool_mutex;
+
+    EntityWorld &m_world;
+    Entity m_entity;
+};
@@ -0,0 +1,276 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "context.hpp"
+#include "handletable.hpp"
+#include "timerwheel.hpp"
+
+// Forward declaration
+class CollisionMask;
+class GameObject;
+class RenderBatch;
+
+/**
+ * @brief Id of an entity in an EntityWorld. Stays the same while the entity
+ * moves around in the component arrays, and no longer resolves once the entity
+ * is destroyed, even if its slot is reused.
+ */
+typedef Handle Entity;
+
+/**
+ * @brief Side an entity fights on.
+ */
+enum class Faction : std::uint8_t
+{
+    Neutral,
+    Player,
+    Enemy
+};
+
+/**
+ * @brief What an entity does when its weapon is ready.
+ */
+enum class AttackPattern : std::uint8_t
+{
+    None,
+    // One projectile straight down.
+    Down,
+    // Four projectiles, one in every direction.
+    Cross,
+    // No projectile, turns around horizontally.
+    Turn
+};
+
+struct Transform
+{
+    sf::Vector2f position;
+};
+
+struct Velocity
+{
+    sf::Vector2f direction;
+    float speed;
+    // Turn around at the sides of the window instead of leaving it.
+    bool bounce;
+};
+
+struct Collider
+{
+    // Bounds relative to the position.
+    sf::FloatRect local_bounds;
+    // Opaque pixels of the sprite, nullptr if the bounds are solid.
+    const CollisionMask *mask;
+};
+
+struct Health
+{
+    int current;
+    int max;
+};
+
+struct WeaponCooldown
+{
+    // Seconds between attempts to attack.
+    float cooldown;
+    // Repeating timer attacking every cooldown, 0 until the weapon is
+    // started, see EntityWorld::start_weapon(...).
+    TimerId timer;
+    // Chance to attack on every attempt.
+    float probability;
+    float projectile_speed;
+    AttackPattern pattern;
+};
+
+struct SpriteRef
+{
+    const sf::Texture *texture;
+    sf::IntRect texture_rect;
+    sf::Vector2f origin;
+    // Health bar is drawn this far below the position, or not at all if 0.
+    float health_bar_offset;
+};
+
+/**
+ * @brief What an entity leaves behind when it is destroyed.
+ */
+struct Loot
+{
+    // Chance to drop a power-up.
+    float powerup_probability;
+    float powerup_speed;
+    // Score given to the player.
+    int score;
+};
+
+/**
+ * @brief All components of a new entity, see EntityWorld::create(...).
+ */
+struct EntityDesc
+{
+    Transform transform;
+    Velocity velocity;
+    Collider collider;
+    Health health;
+    WeaponCooldown weapon;
+    SpriteRef sprite;
+    Loot loot;
+    Faction faction;
+};
+
+/**
+ * @brief Dense storage of simple entities, one array per component, and the
+ * systems that update them.
+ *
+ * @details Component i of every array belongs to the same entity, so systems
+ * walk the arrays from start to end without following pointers. Destroying an
+ * entity moves the last entity into its place. Every entity has a GameObject
+ * that represents it to the rest of the game, e.g. for collisions, see
+ * EntityObject. The world never owns those objects.
+ */
+class EntityWorld
+{
+public:
+    /**
+     * @brief Create an empty world.
+     */
+    EntityWorld();
+
+    EntityWorld(const EntityWorld &) = delete;
+    EntityWorld &operator=(const EntityWorld &) = delete;
+
+    /**
+     * @brief Add an entity.
+     *
+     * @param desc components of the entity.
+     * @param object object representing the entity, see EntityObject.
+     * @return id of the new entity.
+     */
+    Entity create(const EntityDesc &desc, GameObject *object);
+
+    /**
+     * @brief Start the weapon of an entity, so it attacks every cooldown until
+     * the entity is destroyed or removed. Weapons that are never started never
+     * attack.
+     *
+     * @param entity entity in the world.
+     * @param timers wheel firing the weapon, must outlive the entity.
+     */
+    void start_weapon(Entity entity, TimerWheel &timers);
+
+    /**
+     * @brief Remove an entity. Its id is no longer in the world, even once a
+     * later create(...) reuses its slot. Cancels the weapon of the entity.
+     *
+     * @param entity entity in the world.
+     */
+    void destroy(Entity entity);
+
+    /**
+     * @brief Check if an entity is in the world.
+     */
+    bool contains(Entity entity) const;
+
+    /**
+     * @brief Get number of entities.
+     */
+    std::size_t get_size() const;
+
+    /**
+     * @brief Get components of an entity. The reference is valid until an
+     * entity is created or destroyed.
+     *
+     * @param entity entity in the world.
+     */
+    Transform &get_transform(Entity entity);
+    const Transform &get_transform(Entity entity) const;
+    Velocity &get_velocity(Entity entity);
+    const Collider &get_collider(Entity entity) const;
+    Health &get_health(Entity entity);
+    const Health &get_health(Entity entity) const;
+    WeaponCooldown &get_weapon(Entity entity);
+    const SpriteRef &get_sprite(Entity entity) const;
+    Faction get_faction(Entity entity) const;
+
+    /**
+     * @brief Get bounds of an entity in world coordinates.
+     *
+     * @param entity entity in the world.
+     */
+    sf::FloatRect get_bounds(Entity entity) const;
+
+    /**
+     * @brief Run all systems once, in order: health and movement. Weapons are
+     * not polled, they attack when their timer fires, see start_weapon(...).
+     * Entities that die or leave the window have their object removed, see
+     * GameObject::remove(), and are skipped from then on.
+     *
+     * @details With a thread pool in the context and enough entities, the
+     * entities are split into chunks updated in parallel. Every chunk spawns
+     * and publishes into a SpawnBuffer of its own, merged in chunk order
+     * afterwards, so the result is the same as on one thread.
+     *
+     * @param context[in,out] class containing useful data. Must have a player.
+     */
+    void update(Context &context);
+
+    /**
+     * @brief Add sprites of all entities to a batch, and their health bars on
+     * layer 1.
+     *
+     * @param batch batch to add triangles to.
+     */
+    void render(RenderBatch &batch) const;
+
+private:
+    std::vector<Transform> m_transforms;
+    std::vector<Velocity> m_velocities;
+    std::vector<Collider> m_colliders;
+    std::vector<Health> m_healths;
+    std::vector<WeaponCooldown> m_weapons;
+    std::vector<SpriteRef> m_sprites;
+    std::vector<Loot> m_loot;
+    std::vector<Faction> m_factions;
+    // Every entity has its own random generator, like Enemy.
+    std::vector<std::minstd_rand> m_rngs;
+    // False once the object of the entity has been removed.
+    std::vector<std::uint8_t> m_alive;
+    std::vector<GameObject *> m_objects;
+    // Id of the entity at every index.
+    std::vector<Entity> m_entities;
+
+    // Index of every id in the component arrays.
+    HandleTable m_indices;
+    // Wheel of the started weapons, nullptr until one is started.
+    TimerWheel *m_timers;
+    // One spawn buffer per chunk, kept between frames to reuse their memory.
+    std::vector<SpawnBuffer> m_spawn_buffers;
+
+    /**
+     * @brief Attack with an entity, called by the timer of its weapon.
+     */
+    void attack(Entity entity, Context &context);
+
+    /**
+     * @brief Remove entities in [begin, end) without health and give the
+     * player their loot.
+     */
+    void update_health(Context &context, std::size_t begin, std::size_t end);
+
+    /**
+     * @brief Move the entities in [begin, end) and remove the ones below the
+     * window.
+     */
+    void update_movement(Context &context, std::size_t begin, std::size_t end);
+
+    /**
+     * @brief Remove the object of the entity at an index.
+     */
+    void kill(std::size_t index);
+
+    std::size_t get_index(Entity entity) const;
+};
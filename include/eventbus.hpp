@@ -0,0 +1,303 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <tuple>
+#include <vector>
+
+// Forward declaration
+enum class PowerUpType : std::uint8_t;
+
+/**
+ * @brief An enemy was destroyed by the player.
+ */
+struct EnemyKilled
+{
+    sf::Vector2f position;
+    int score;
+
+    EnemyKilled();
+    EnemyKilled(const sf::Vector2f &position, int score);
+};
+
+/**
+ * @brief A boss was destroyed by the player.
+ */
+struct BossDefeated
+{
+    sf::Vector2f position;
+    int score;
+
+    BossDefeated();
+    BossDefeated(const sf::Vector2f &position, int score);
+};
+
+/**
+ * @brief The player lost health outside of a collision, e.g. to an enemy that
+ * got past it.
+ */
+struct PlayerHit
+{
+    int damage;
+
+    PlayerHit();
+    PlayerHit(int damage);
+};
+
+/**
+ * @brief The player picked up a power-up.
+ */
+struct PowerupCollected
+{
+    PowerUpType type;
+    sf::Vector2f position;
+
+    PowerupCollected();
+    PowerupCollected(PowerUpType type, const sf::Vector2f &position);
+};
+
+/**
+ * @brief The game mode went up a level.
+ */
+struct LevelUp
+{
+    unsigned int level;
+
+    LevelUp();
+    LevelUp(unsigned int level);
+};
+
+/**
+ * @brief First in, first out ring of events. Memory is only allocated when the
+ * ring is full, so once it has grown to the busiest frame pushing is free.
+ */
+template <typename T>
+class EventQueue
+{
+public:
+    /**
+     * @brief Create an empty queue.
+     *
+     * @param capacity events that fit before the queue grows, rounded up to a
+     * power of two.
+     */
+    EventQueue(std::size_t capacity = 64);
+
+    /**
+     * @brief Add an event to the back of the queue.
+     */
+    void push(const T &event);
+
+    /**
+     * @brief Remove the event at the front of the queue. The queue must not be
+     * empty.
+     *
+     * @return T the removed event.
+     */
+    T pop();
+
+    /**
+     * @brief Get the i:th event from the front of the queue.
+     */
+    const T &operator[](std::size_t i) const;
+
+    /**
+     * @brief Remove all events, keeping the memory.
+     */
+    void clear();
+
+    std::size_t get_size() const;
+    std::size_t get_capacity() const;
+    bool is_empty() const;
+
+private:
+    std::vector<T> m_events;
+    std::size_t m_head;
+    std::size_t m_size;
+
+    /**
+     * @brief Double the capacity, moving the events to the start of the ring.
+     */
+    void grow();
+};
+
+/**
+ * @brief Typed queues of gameplay events, drained by subscribers once per
+ * frame after the simulation step.
+ *
+ * @details Objects publish events while they are updated, through
+ * Context::publish(...), instead of reaching into the player or the game mode.
+ * Events of one type are delivered in the order they were published. Types are
+ * delivered one after the other in a fixed order: PlayerHit, EnemyKilled,
+ * BossDefeated, PowerupCollected and LevelUp. Events published by a
+ * subscriber are delivered by the same dispatch().
+ *
+ * Subscribers are added once, when the owner is set up. Publishing and
+ * dispatching do not allocate unless a queue outgrows its busiest frame so far.
+ *
+ * @attention not thread safe. Threads updating objects in parallel publish into
+ * a bus of their own, see SpawnBuffer, which is appended to the main bus in a
+ * deterministic order.
+ */
+class EventBus
+{
+public:
+    EventBus();
+
+    EventBus(const EventBus &) = delete;
+    EventBus &operator=(const EventBus &) = delete;
+    EventBus(EventBus &&) = default;
+    EventBus &operator=(EventBus &&) = default;
+
+    /**
+     * @brief Queue an event until the next dispatch().
+     */
+    template <typename T>
+    void publish(const T &event);
+
+    /**
+     * @brief Add a subscriber, called once for every dispatched event of type
+     * T. Subscribers of a type are called in the order they were added.
+     */
+    template <typename T>
+    void subscribe(const std::function<void(const T &)> &subscriber);
+
+    /**
+     * @brief Get the queued events of type T.
+     */
+    template <typename T>
+    const EventQueue<T> &get_events() const;
+
+    /**
+     * @brief Move all queued events of another bus to the back of the queues of
+     * this bus. The subscribers of the other bus are not called.
+     */
+    void append(EventBus &other);
+
+    /**
+     * @brief Deliver all queued events to the subscribers, emptying the queues.
+     */
+    void dispatch();
+
+    /**
+     * @brief Drop all queued events.
+     */
+    void clear();
+
+    /**
+     * @brief Get number of queued events of all types.
+     */
+    std::size_t get_size() const;
+
+private:
+    template <typename T>
+    struct Channel
+    {
+        Channel() : events{}, subscribers{} {}
+
+        EventQueue<T> events;
+        std::vector<std::function<void(const T &)>> subscribers;
+    };
+
+    // In the order the types are dispatched.
+    std::tuple<Channel<PlayerHit>, Channel<EnemyKilled>, Channel<BossDefeated>,
+               Channel<PowerupCollected>, Channel<LevelUp>>
+        m_channels;
+};
+
+/*================================EventQueue==================================*/
+
+template <typename T>
+EventQueue<T>::EventQueue(std::size_t capacity)
+    : m_events{},
+      m_head{0},
+      m_size{0}
+{
+    std::size_t size{1};
+    while (size < capacity)
+        size *= 2;
+    m_events.resize(size);
+}
+
+template <typename T>
+void EventQueue<T>::push(const T &event)
+{
+    if (m_size == m_events.size())
+        grow();
+    m_events[(m_head + m_size) & (m_events.size() - 1)] = event;
+    m_size++;
+}
+
+template <typename T>
+T EventQueue<T>::pop()
+{
+    T event{m_events[m_head]};
+    m_head = (m_head + 1) & (m_events.size() - 1);
+    m_size--;
+    return event;
+}
+
+template <typename T>
+const T &EventQueue<T>::operator[](std::size_t i) const
+{
+    return m_events[(m_head + i) & (m_events.size() - 1)];
+}
+
+template <typename T>
+void EventQueue<T>::clear()
+{
+    m_head = 0;
+    m_size = 0;
+}
+
+template <typename T>
+std::size_t EventQueue<T>::get_size() const
+{
+    return m_size;
+}
+
+template <typename T>
+std::size_t EventQueue<T>::get_capacity() const
+{
+    return m_events.size();
+}
+
+template <typename T>
+bool EventQueue<T>::is_empty() const
+{
+    return m_size == 0;
+}
+
+template <typename T>
+void EventQueue<T>::grow()
+{
+    std::vector<T> events(m_events.size() * 2);
+    for (std::size_t i{0}; i < m_size; i++)
+    {
+        events[i] = (*this)[i];
+    }
+    m_events.swap(events);
+    m_head = 0;
+}
+
+/*=================================EventBus===================================*/
+
+template <typename T>
+void EventBus::publish(const T &event)
+{
+    std::get<Channel<T>>(m_channels).events.push(event);
+}
+
+template <typename T>
+void EventBus::subscribe(const std::function<void(const T &)> &subscriber)
+{
+    std::get<Channel<T>>(m_channels).subscribers.push_back(subscriber);
+}
+
+template <typename T>
+const EventQueue<T> &EventBus::get_events() const
+{
+    return std::get<Channel<T>>(m_channels).events;
+}
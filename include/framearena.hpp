@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Linear allocator for memory that only lives until the end of a frame,
+ * e.g. scratch vectors and strings built during an update.
+ *
+ * @details Allocating bumps an offset into a block, freeing does nothing. All
+ * memory is given back at once by reset(...). When a frame needs more than the
+ * block holds another block is added, and the next reset(...) replaces the
+ * blocks with one block big enough for all of them. After a few frames every
+ * frame fits in one block and nothing is allocated from the heap.
+ *
+ * Not thread safe, a frame arena must only be used by one thread at a time.
+ */
+class FrameArena
+{
+public:
+    // Size of the first block.
+    static const std::size_t s_default_block_size;
+
+    /**
+     * @param block_size size in bytes of the first block, allocated on first
+     * use.
+     */
+    explicit FrameArena(std::size_t block_size = s_default_block_size);
+
+    FrameArena(const FrameArena &) = delete;
+    FrameArena &operator=(const FrameArena &) = delete;
+
+    /**
+     * @brief Allocate memory that stays valid until the next reset(...).
+     *
+     * @param size size in bytes.
+     * @param alignment power of two, at most alignof(std::max_align_t).
+     * @return void* the memory, never nullptr.
+     */
+    void *allocate(std::size_t size, std::size_t alignment);
+
+    /**
+     * @brief Give back all memory. Everything allocated since the last reset
+     * becomes invalid.
+     */
+    void reset();
+
+    /**
+     * @brief Get number of bytes allocated since the last reset.
+     */
+    std::size_t get_used() const;
+
+    /**
+     * @brief Get number of bytes in all blocks.
+     */
+    std::size_t get_capacity() const;
+
+    /**
+     * @brief Get number of blocks, 1 once the frames fit in one block.
+     */
+    std::size_t get_block_count() const;
+
+private:
+    struct Block
+    {
+        std::unique_ptr<unsigned char[]> data;
+        std::size_t size;
+    };
+
+    std::vector<Block> m_blocks;
+    // Block allocated from, and offset of its first free byte.
+    std::size_t m_block;
+    std::size_t m_offset;
+    std::size_t m_used;
+    std::size_t m_block_size;
+
+    /**
+     * @brief Add a block of at least the given size and allocate from it.
+     */
+    void add_block(std::size_t size);
+};
+
+/**
+ * @brief Standard allocator giving out the memory of a FrameArena, so standard
+ * containers can live in it. deallocate(...) does nothing, a container that
+ * grows leaves its old memory in the arena until the arena is reset.
+ */
+template <typename T>
+class ArenaAllocator
+{
+public:
+    typedef T value_type;
+
+    ArenaAllocator(FrameArena &arena) noexcept
+        : m_arena{&arena}
+    {
+    }
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other) noexcept
+        : m_arena{other.get_arena()}
+    {
+    }
+
+    T *allocate(std::size_t count)
+    {
+        return static_cast<T *>(m_arena->allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *, std::size_t) noexcept
+    {
+    }
+
+    FrameArena *get_arena() const noexcept
+    {
+        return m_arena;
+    }
+
+private:
+    FrameArena *m_arena;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T> &lhs, const ArenaAllocator<U> &rhs) noexcept
+{
+    return lhs.get_arena() == rhs.get_arena();
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T> &lhs, const ArenaAllocator<U> &rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+/**
+ * @brief Vector in a FrameArena, e.g. FrameVector<int> v{arena};
+ */
+template <typename T>
+using FrameVector = std::vector<T, ArenaAllocator<T>>;
+
+/**
+ * @brief String in a FrameArena, e.g. FrameString s{arena};
+ */
+typedef std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>> FrameString;
+
+/**
+ * @brief Append printf style formatted text to a string. Unlike a
+ * std::stringstream, nothing is allocated outside the arena of the string.
+ *
+ * @param string[in,out] string appended to.
+ * @param format format as for std::printf(...).
+ */
+void append_format(FrameString &string, const char *format, ...);
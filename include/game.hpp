@@ -4,6 +4,9 @@
 #include <string>
 
 #include "gamestate.hpp"
+#include "renderthread.hpp"
+#include "scorestore.hpp"
+#include "threadpool.hpp"
 
 /**
  * @brief Class responsible for the games main-loop and creating a window.
@@ -58,6 +61,10 @@ public:
     /**
      * @brief Start the games main loop. Will throw an exception if no GameState
      * is set.
+     *
+     * @details Events and simulation run on the calling thread. Every frame the
+     * current state is rendered into a snapshot, which is drawn by the render
+     * thread.
      */
     void run();
 
@@ -72,7 +79,12 @@ public:
 private:
     sf::RenderWindow m_window;
     GameState *m_current_state;
+    // Leaderboard of all states, lent to m_configuration.
+    ScoreStore m_score_store;
     GameConfiguration m_configuration;
+    ThreadPool m_thread_pool;
+    sf::View m_view;
+    RenderThread m_render_thread;
 
     /**
      * @brief Handle global game events. Called once for every polled event.
@@ -88,6 +100,11 @@ private:
      */
     void handle_context(Context &context);
 
+    /**
+     * @brief Stop the render thread and close the window.
+     */
+    void close_window();
+
     /**
      * @brief Switch the current state to the given state.
      *
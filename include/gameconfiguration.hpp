@@ -3,6 +3,8 @@
 #include <SFML/Graphics.hpp>
 #include <string>
 
+class ScoreStore;
+
 // TODO: Add more configuration options.
 
 struct EnemyMinionData
@@ -89,6 +91,13 @@ struct NormalModeData
     float spawn_time_multiplier;
     float spawn_time_min;
     unsigned int spawn_seed;
+    // Archetype table of the simple enemies, built in table if empty.
+    std::string archetype_file;
+    // Spawn table of the simple enemies, built in table if empty.
+    std::string spawn_file;
+    // Compiled wave timeline, see WaveTimeline. Random spawns if empty, and
+    // after the last wave.
+    std::string wave_file;
 
     EnemyMinionData minion_data;
     PlayerData player_data;
@@ -147,6 +156,7 @@ struct GameData
     unsigned int fps;
     float music_volume;
     float effects_volume;
+    unsigned int worker_threads;
 
     /**
      * @brief Construct a new Game Data object with default values.
@@ -182,7 +192,8 @@ struct GameData
  *      TITLE (string), WINDOW_WIDTH (int), WINDOW_HEIGHT (uint), FPS (uint),
  *      START_LEVEL (uint), LEVEL_INCREASE_TIME (float), BOSS_SPAWN_TIME (float),
  *      BASE_SPAWN_TIME (float), SPAWN_TIME_MULTIPLIER (float),
- *      SPAWN_TIME_MIN (float), SPAWN_SEED (uint), PLAYER_HEALTH (int),
+ *      SPAWN_TIME_MIN (float), SPAWN_SEED (uint), ARCHETYPE_FILE (string),
+ *      SPAWN_FILE (string), WAVE_FILE (string), PLAYER_HEALTH (int),
  *      PLAYER_SPEED (float), PLAYER_PROJECTILE_SPEED (float),
  *      PLAYER_ATTACK_COOLDOWN (float), BASE_HEALTH (int), BASE_SPEED (float),
  *      BASE_ATTACK_COOLDOWN (float), BASE_PROJECTILE_SPEED (float),
@@ -190,7 +201,7 @@ struct GameData
  *      BOSS_POS_X (float), BOSS_POS_Y (float), BOSS_BASE_HEALTH (int),
  *      BOSS_BASE_ATTACK_COOLDOWN (float), BOSS_BASE_PROJECTILE_SPEED (float),
  *      BOSS_BASE_ATTACK_TIME (float), BOSS_BASE_ATTACK_LENGTH (int),
- *      MUSIC_VOLUME (float), EFFECTS_VOLUME (float)
+ *      MUSIC_VOLUME (float), EFFECTS_VOLUME (float), WORKER_THREADS (uint)
  *
  * @note If types of values are invalid, a std::logic_error is thrown. Keys are case
  * sensitive and unkown keys are ignored. If a key is missing, a default value
@@ -199,7 +210,9 @@ struct GameData
 class GameConfiguration
 {
 public:
-    ~GameConfiguration();
+    // Copies share the leaderboard, see set_score_store(...).
+    GameConfiguration(const GameConfiguration &) = default;
+    GameConfiguration &operator=(const GameConfiguration &) = default;
 
     /**
      * @brief Get underlying GameData struct.
@@ -240,17 +253,27 @@ public:
     void update_window_size(const sf::Vector2u &window_size);
 
     /**
-     * @brief Get current high score.
+     * @brief Get current high score, 0 if there is no leaderboard.
      */
     unsigned int get_high_score() const;
 
     /**
-     * @brief Set the new high score. If the new score is lower than the old one,
-     * nothing happens.
+     * @brief Get the leaderboard, owned by the Game. Loading a configuration
+     * never touches the score files, see set_score_store(...).
+     *
+     * @return ScoreStore* the leaderboard, nullptr if none is set, e.g. in
+     * tools and tests.
+     */
+    ScoreStore *get_score_store() const;
+
+    /**
+     * @brief Set the leaderboard. Copies of the configuration made after this
+     * share it.
      *
-     * @param score new high score.
+     * @param score_store leaderboard, must outlive the configuration and its
+     * copies.
      */
-    void update_high_score(unsigned int score) const;
+    void set_score_store(ScoreStore *score_store);
 
     /**
      * @brief Load GameConfig from file.
@@ -272,7 +295,8 @@ private:
     GameData m_g_data;
     NormalModeData m_nm_data;
     BossModeData m_bm_data;
-    mutable unsigned int m_high_score;
+    // Not owned, nullptr if no leaderboard is set.
+    ScoreStore *m_score_store;
 
     /**
      * @brief Check if the read config key is valid. If valid, set the value in
@@ -298,19 +322,6 @@ private:
      */
     static void write_default_config();
 
-    /**
-     * @brief Get the current high score from the high score file (high_score.txt).
-     * If the file does not exist, a default value of 0 is returned.
-     */
-    static unsigned int load_high_score();
-
-    /**
-     * @brief Write the current high score to the high score file (high_score.txt).
-     *
-     * @param score score to write.
-     */
-    static void write_high_score(unsigned int score);
-
     /**
      * @brief Construct a new Game Configuration object based on the given data.
      *
@@ -319,6 +330,5 @@ private:
     GameConfiguration(
         const GameData &g_data,
         const NormalModeData &nm_data,
-        const BossModeData &bm_data,
-        unsigned int high_score);
+        const BossModeData &bm_data);
 };
\ No newline at end of file
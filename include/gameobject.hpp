@@ -1,8 +1,75 @@
 #pragma once
 
 #include <SFML/Graphics.hpp>
+#include <vector>
 
 #include "context.hpp"
+#include "narrowphase.hpp"
+#include "rendersnapshot.hpp"
+
+// Forward declaration
+class RenderBatch;
+class TimerWheel;
+
+/**
+ * @brief Collision layers of objects, used as bit flags to filter spatial
+ * queries. Combine layers with operator|.
+ */
+enum class CollisionLayer : unsigned
+{
+    None = 0,
+    Player = 1 << 0,
+    Enemy = 1 << 1,
+    PowerUp = 1 << 2,
+    Projectile = 1 << 3,
+    All = ~0u
+};
+
+/**
+ * @brief Kinds of objects a GameMode keeps in a container of their own, so
+ * they are updated and drawn in a loop over one final class instead of one
+ * virtual call each. Objects of all other classes are Other.
+ */
+enum class ObjectKind
+{
+    Other,
+    Entity,
+    Player,
+    EnemyBoss,
+    EnemyBoss2,
+    PowerUp,
+    Shockwave
+};
+
+/**
+ * @brief Combine two sets of layers.
+ */
+CollisionLayer operator|(CollisionLayer first, CollisionLayer second);
+
+/**
+ * @brief Check if two sets of layers have any layer in common.
+ */
+bool has_layer(CollisionLayer layers, CollisionLayer layer);
+
+/**
+ * @brief A hit by a projectile that is not a GameObject, e.g. one of a
+ * ProjectileSystem. Passed instead of a temporary Projectile object.
+ */
+struct ProjectileHit
+{
+    // Position of the projectile when it hit.
+    sf::Vector2f position;
+    int damage;
+    // Fired by the player if true.
+    bool friendly;
+
+    /**
+     * @brief Construct a hostile hit at (0, 0) without damage.
+     */
+    ProjectileHit();
+
+    ProjectileHit(const sf::Vector2f &position, int damage, bool friendly);
+};
 
 /**
  * @brief Pure virtual class defining public API of a GameObject.
@@ -16,9 +83,19 @@ public:
     /**
      * @brief Render the GameObject. Will be called once every frame.
      *
-     * @param window window to draw on.
+     * @param snapshot snapshot to draw into.
      */
-    virtual void render(sf::RenderWindow &window) const = 0;
+    virtual void render(RenderSnapshot &snapshot) const = 0;
+
+    /**
+     * @brief Add the GameObject's triangles to a batch instead of rendering it
+     * with render(...). May be called from any thread. Returns false by
+     * default, meaning render(...) is used instead.
+     *
+     * @param batch batch to add triangles to.
+     * @return true if the object was added to the batch.
+     */
+    virtual bool render_batched(RenderBatch &batch) const;
 
     /**
      * @brief Update the GameObject. Will be called once every frame.
@@ -27,6 +104,16 @@ public:
      */
     virtual void update(Context &context) = 0;
 
+    /**
+     * @brief Schedule the timers of the GameObject, e.g. cooldowns and
+     * lifetimes, see Timer. Called by the game mode when the object is
+     * spawned, so the callbacks fire on the game mode's time. Does nothing by
+     * default.
+     *
+     * @param timers timers of the game mode, outlive the object.
+     */
+    virtual void start_timers(TimerWheel &timers);
+
     /**
      * @brief Let the GameObject handle a given event. Not guaranteed to be called
      * for every event.
@@ -46,6 +133,56 @@ public:
      */
     virtual sf::FloatRect bounds() const  = 0;
 
+    /**
+     * @brief Get the bounds saved by the last refresh_bounds() call. Cheaper
+     * than bounds(), used for collision detection.
+     *
+     * @return const sf::FloatRect& cached hit box.
+     */
+    const sf::FloatRect &get_cached_bounds() const;
+
+    /**
+     * @brief Save bounds() as the cached bounds, if they may have changed.
+     * Called by GameMode once per frame after all objects are updated.
+     *
+     * @details Bounds are recomputed if mark_bounds_dirty() has been called,
+     * or if the transform returned by get_transform() has moved, rotated, or
+     * changed scale or origin. Objects without a transform are recomputed
+     * every call. Objects with sub-colliders get the bounds of all
+     * sub-colliders instead of bounds().
+     *
+     * @return true if the bounds were recomputed.
+     */
+    bool refresh_bounds();
+
+    /**
+     * @brief Get the sub-colliders in world coordinates, as transformed by the
+     * last refresh_bounds() call. Empty if the object has none.
+     */
+    const std::vector<CollisionShape> &get_sub_colliders() const;
+
+    /**
+     * @brief Get the exact shape of the object, tested by the Narrowphase
+     * after the cached bounds overlap. May be called from any thread. Returns
+     * false by default, meaning the cached bounds are exact.
+     *
+     * @param shape[out] shape of the object.
+     * @return true if shape was set.
+     */
+    virtual bool get_collision_shape(CollisionShape &shape) const;
+
+    /**
+     * @brief Get the collision layer of the object. CollisionLayer::None by
+     * default, meaning the object is not found by spatial queries.
+     */
+    virtual CollisionLayer get_layer() const;
+
+    /**
+     * @brief Get the kind of the object, read once when it is spawned.
+     * ObjectKind::Other by default.
+     */
+    virtual ObjectKind get_kind() const;
+
     /**
      * @brief Will be called once for every collision.
      *
@@ -53,6 +190,38 @@ public:
      */
     virtual void collision(const GameObject *other) = 0;
 
+    /**
+     * @brief Will be called the first frame the objects touch. Calls
+     * collision(...) by default.
+     *
+     * @param other object that was collided with.
+     */
+    virtual void collision_enter(const GameObject *other);
+
+    /**
+     * @brief Will be called every following frame the objects still touch.
+     * Calls collision(...) by default.
+     *
+     * @param other object that was collided with.
+     */
+    virtual void collision_stay(const GameObject *other);
+
+    /**
+     * @brief Will be called once when the objects no longer touch, or when one
+     * of them is removed. Does nothing by default.
+     *
+     * @param other object that was collided with.
+     */
+    virtual void collision_exit(const GameObject *other);
+
+    /**
+     * @brief Will be called once for every hit by a projectile that is not a
+     * GameObject, see ProjectileSystem::collide(...). Does nothing by default.
+     *
+     * @param hit values of the projectile.
+     */
+    virtual void projectile_hit(const ProjectileHit &hit);
+
     /**
      * @brief Check collision between self and other. Uses the bounds method
      * to get hit box (sf::FloatRect).
@@ -78,4 +247,44 @@ public:
 
 protected:
     bool m_removed;
+
+    /**
+     * @brief Make the next refresh_bounds() call recompute the bounds. Use if
+     * the bounds change without the transform changing, e.g. a new texture.
+     */
+    void mark_bounds_dirty();
+
+    /**
+     * @brief Use a few boxes instead of one as the shape of the object, e.g.
+     * the hull of a large sprite. The boxes are in the local coordinates of
+     * get_transform() and are ignored without a transform.
+     *
+     * @param colliders boxes in local coordinates.
+     */
+    void set_sub_colliders(const std::vector<sf::FloatRect> &colliders);
+
+    /**
+     * @brief Get the transform that decides the bounds, used to check if the
+     * cached bounds are still valid. Returns nullptr by default, meaning the
+     * bounds are recomputed every frame.
+     */
+    virtual const sf::Transformable *get_transform() const;
+
+private:
+    /**
+     * @brief Transform values the cached bounds were computed with.
+     */
+    struct TransformKey
+    {
+        sf::Vector2f position;
+        sf::Vector2f scale;
+        sf::Vector2f origin;
+        float rotation;
+    };
+
+    sf::FloatRect m_cached_bounds;
+    TransformKey m_cached_transform;
+    bool m_bounds_dirty;
+    std::vector<sf::FloatRect> m_local_colliders;
+    std::vector<CollisionShape> m_sub_colliders;
 };
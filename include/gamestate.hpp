@@ -2,10 +2,25 @@
 
 #include <SFML/Graphics.hpp>
 
+#include "aabbarray.hpp"
+#include "contactcache.hpp"
 #include "context.hpp"
+#include "effectstack.hpp"
+#include "entityworld.hpp"
+#include "framearena.hpp"
 #include "gameconfiguration.hpp"
+#include "handletable.hpp"
+#include "projectilesystem.hpp"
+#include "renderbatch.hpp"
+#include "spatialgrid.hpp"
+#include "taskgraph.hpp"
+#include "timerwheel.hpp"
 #include "ui.hpp"
 
+#include <cstddef>
+#include <utility>
+#include <vector>
+
 /**
  * @brief A pure virtual class used to define the public API of a GameState.
  */
@@ -17,9 +32,9 @@ public:
     /**
      * @brief Render the state. Will be called once every frame.
      *
-     * @param window window to draw on.
+     * @param snapshot snapshot to draw into.
      */
-    virtual void render(sf::RenderWindow &window) const = 0;
+    virtual void render(RenderSnapshot &snapshot) const = 0;
 
     /**
      * @brief Update the state. Will be called once every frame.
@@ -49,7 +64,26 @@ public:
 /*=================================GameMode===================================*/
 
 // Forward declaration
+class EnemyBoss;
+class EnemyBoss2;
 class Player;
+class PowerUp;
+class Shockwave;
+class ThreadPool;
+
+/**
+ * @brief Player values shown in the HUD. Read before a frame is updated, so the
+ * HUD can be formatted while the objects are updated.
+ */
+struct HudData
+{
+    bool has_player;
+    int score;
+    int health;
+    // Active effects of the player, see EffectStack::get_status(...).
+    EffectStack::StatusArray effects;
+    std::size_t effect_count;
+};
 
 /**
  * @brief A pure virtual class, that extend GameSate, defining a GameMode.
@@ -93,26 +127,54 @@ public:
     GameMode &operator=(const GameMode &) = delete;
 
     /**
-     * @brief Will draw background (if set) and call render on all currently 
-     * spawned objects.
+     * @brief Will draw background (if set) and all currently spawned objects.
+     *
+     * @details Objects are added to render batches in parallel chunks, see
+     * GameObject::render_batched(...). The batches are stitched into one vertex
+     * array per layer and texture. Objects that cannot be batched are rendered
+     * with render(...) in their place in the object order, between the
+     * batches of the objects before and after them. All projectiles are drawn
+     * last. Build time is recorded in the Profiler as "render.build".
      * 
-     * @param window window to draw on.
+     * @param snapshot snapshot to draw into.
      */
-    virtual void render(sf::RenderWindow &window) const override;
+    virtual void render(RenderSnapshot &snapshot) const override;
 
     /**
      * @brief Will update all currently spawned objects.
      *
      * @details
-     * Will do following (in order):
-     *      1. update context.
+     * First the timers are moved forward by the frame's delta, firing the
+     * callbacks of all timers that are due, see TimerWheel.
+     *
+     * The frame is run as a task graph on the context's thread pool:
+     *      entities.update     run the systems of the entity world, see
+     *                          EntityWorld::update(...).
+     *      update              call update on all objects that are not
+     *                          entities, depends on entities.update.
+     *      collision.bounds    refresh and pack the cached bounds of all
+     *                          objects, depends on update.
+     *      collision.find.N    find colliding objects, depends on
+     *                          collision.bounds. Split into chunks that run in
+     *                          parallel.
+     *      collision.resolve   send contact events for objects that collide,
+     *                          in the same order as a serial check. Depends on
+     *                          all collision.find tasks.
+     *      projectiles.update  move all projectiles, no dependencies.
+     *      projectiles.collide collide projectiles with objects. Depends on
+     *                          collision.resolve and projectiles.update.
+     *      hud                 update_texts(...), no dependencies.
+     *      music               update music, no dependencies.
+     * The graph is kept between frames and only rebuilt when the number of
+     * collision.find chunks changes.
+     *
+     * After the graph is done:
+     *      1. apply area effects and dispatch the events published during the
+     *         frame, see get_events().
      *      2. check if player is removed (dead), if so end game.
-     *      3. call update on all objects.
-     *      4. check for collision between object and call collision on objects
-     *         that collide.
-     *      5. delete all objects that are marked as removed.
-     *      6. spawned all new objects contained in context.
-     *      7. update music.
+     *      3. delete all objects that are marked as removed, and all dead
+     *         projectiles.
+     *      4. spawned all new objects and projectiles contained in context.
      *
      * @param context[in,out] class containing useful data.
      */
@@ -145,37 +207,139 @@ public:
      */
     virtual void pause();
 
+    /**
+     * @brief Get the current difficulty level. Used when the run is saved to the
+     * leaderboard.
+     *
+     * @return unsigned int current level, 0 if the game mode has no levels.
+     */
+    virtual unsigned int get_level() const;
+
+    /**
+     * @brief Get a spawned object by handle, in O(1).
+     *
+     * @param handle handle returned by spawn_object(...).
+     * @return GameObject* the object, nullptr if it has been deleted or
+     * removed from this game mode.
+     */
+    GameObject *get_object(ObjectHandle handle) const;
+
 protected:
     sf::Clock m_clock;
     sf::Time m_pause_time;
     bool m_paused;
 
     /**
-     * @brief Call update on all objects in m_objects.
+     * @brief Call update on all objects, one loop per kind, see ObjectKind. If
+     * the context has a thread pool and there are at least 256 objects in
+     * m_active_objects, those are split into chunks that are updated in
+     * parallel. The game modes never have that many, since enemies are
+     * entities and not active objects.
+     *
+     * @details Objects spawned during a parallel update are collected per chunk
+     * and handed to the context in chunk order, giving the same spawn order as a
+     * serial update. Health lost by the player is applied once all objects are
+     * updated.
      * 
      * @param context[in,out] class containing useful data
      */
     void update_objects(Context &context);
 
     /**
-     * @brief Check for collision between objects in m_objects. If collision is
-     * detected call collision on both objects.
+     * @brief Refresh the cached bounds of all objects and pack them into
+     * m_bounds, once per frame. Split into parallel chunks if pool is set and
+     * there are enough objects. The number of objects that had to recompute
+     * their bounds is counted in the Profiler as "bounds.recomputed".
+     *
+     * @param pool thread pool, may be nullptr.
      */
-    void collision_check();
+    void refresh_bounds(ThreadPool *pool);
 
     /**
-     * @brief Delete all objects in m_objects that are marked as removed.
+     * @brief Find colliding objects in one chunk of m_objects. The pairs are
+     * saved until resolve_collisions() is called. Chunks may be searched in
+     * parallel.
+     *
+     * @details Chunks are ranges of rows in the triangle of all object pairs,
+     * sized so that every chunk checks about the same number of pairs. Each
+     * row is tested with the SIMD kernel of AabbArray against the bounds
+     * packed by refresh_bounds(...).
+     *
+     * @param chunk index of chunk to search.
+     * @param chunk_count total number of chunks.
+     */
+    void find_collisions(std::size_t chunk, std::size_t chunk_count);
+
+    /**
+     * @brief Update the contact cache with the pairs found by
+     * find_collisions(...) and send the contact events to both objects of
+     * each pair: collision_enter(...) for new contacts, collision_stay(...)
+     * for lasting contacts and collision_exit(...) for ended contacts.
+     *
+     * @details Enter and stay events come in the same order as a serial check,
+     * followed by exit events. Enter and stay events are not sent if one of
+     * the objects has already been removed.
+     */
+    void resolve_collisions();
+
+    /**
+     * @brief Update the HUD. Runs at the same time as the objects are updated,
+     * so it must not touch objects or the player. Does nothing by default.
+     *
+     * @param hud player values from the start of the frame.
+     * @param arena frame arena of the context, for building the strings.
+     */
+    virtual void update_texts(const HudData &hud, FrameArena &arena);
+
+    /**
+     * @brief Set the string of a text, unless the text already shows it.
+     * The string is built in m_text_buffer and copied into the memory the text
+     * already has, so it only allocates when the string is longer than any
+     * before.
+     *
+     * @return true if the string was set, e.g. so the text can be centered.
+     */
+    bool set_text(sf::Text &text, const FrameString &string);
+
+    /**
+     * @brief Apply the area effects spawned this frame, see
+     * Context::spawn_area_effect(...). Ships are found through the spatial
+     * grid, rebuilt from the bounds of this frame first, so they are hit where
+     * they are now. Counted in the Profiler as "area_effects".
+     *
+     * @param context[in,out] class containing useful data
+     */
+    void apply_area_effects(Context &context);
+
+    /**
+     * @brief Delete all objects in m_objects that are marked as removed. Their
+     * contacts are ended with collision_exit(...) first.
      */
     void delete_removed_objects();
 
     /**
-     * @brief Spawn all new objects contained in context. Will add new objects
-     * to m_objects.
+     * @brief Spawn all new objects and projectiles contained in context. Will
+     * add new objects to m_objects and new projectiles to m_projectiles.
      * 
      * @param context[in,out] class containing useful data
      */
     void spawn_new_objects(Context &context);
 
+    /**
+     * @brief Add an object to m_objects, and to the container of its kind,
+     * see ObjectKind. Entities go in no other container.
+     *
+     * @return ObjectHandle handle of the object.
+     */
+    ObjectHandle add_object(GameObject *object);
+
+    /**
+     * @brief Remove the object at an index of m_objects, moving the last object
+     * into its place. The object is not deleted and its handle becomes
+     * invalid.
+     */
+    void erase_object(std::size_t index);
+
     /**
      * @brief Set the player. Will delete old player if present. Player will be
      * added to vector of spawned objects.
@@ -203,8 +367,9 @@ protected:
      * if object is nullptr.
      *
      * @param object object to be spawned.
+     * @return ObjectHandle handle of the object, see get_object(...).
      */
-    void spawn_object(GameObject *object);
+    ObjectHandle spawn_object(GameObject *object);
 
     /**
      * @brief Set a background to the game mode. Background will be scaled to fit
@@ -215,7 +380,7 @@ protected:
     void set_background(const std::string &path, const sf::Vector2u &window_size);
 
     /**
-     * @brief Clear all currently spawned objects.
+     * @brief Clear all currently spawned objects and projectiles.
      *
      * @param delete_player if true, player will also be deleted.
      */
@@ -285,6 +450,41 @@ protected:
      */
     const std::vector<GameObject *> &get_objects() const;
 
+    /**
+     * @brief Get the currently spawned projectiles.
+     *
+     * @note Primary use is for testing.
+     *
+     * @return const ProjectileSystem& currently spawned projectiles.
+     */
+    const ProjectileSystem &get_projectiles() const;
+
+    /**
+     * @brief Get the world of the simple enemies, see Archetypes. Their
+     * objects are in m_objects like all other objects, and are spawned with
+     * spawn_object(...).
+     *
+     * @return EntityWorld& world updated by this game mode.
+     */
+    EntityWorld &get_entities();
+
+    /**
+     * @brief Get the timers of this game mode. They move forward at the start
+     * of every update, so they stand still while the game mode is paused.
+     *
+     * @return TimerWheel& timers of this game mode.
+     */
+    TimerWheel &get_timers();
+
+    /**
+     * @brief Get the gameplay events of this game mode. They are dispatched
+     * once per update, after the objects are updated and have collided. The
+     * game mode itself subscribes to keep the score and health of the player.
+     *
+     * @return EventBus& events of this game mode.
+     */
+    EventBus &get_events();
+
     /**
      * @brief Get the music. Music will be deleted when GameMode goes out of
      * scope.
@@ -306,8 +506,84 @@ private:
         FadeOut
     };
 
+    /**
+     * @brief Vertex array of the render list, one per segment, layer and
+     * texture, see build_render_list(...).
+     */
+    struct RenderTarget
+    {
+        std::size_t segment;
+        unsigned int layer;
+        const sf::Texture *texture;
+        std::size_t vertex_count;
+    };
+
     std::vector<GameObject *> m_objects;
-    Player *m_player;
+    // Objects of m_objects by kind, in the order they were spawned. Every
+    // kind is updated and drawn in a loop over its final class instead of one
+    // virtual call per object. Objects of entities are in none of them, the
+    // systems of m_entities run them in bulk.
+    std::vector<Player *> m_players;
+    std::vector<EnemyBoss *> m_bosses;
+    std::vector<EnemyBoss2 *> m_bosses2;
+    std::vector<PowerUp *> m_powerups;
+    std::vector<Shockwave *> m_shockwaves;
+    // Objects of ObjectKind::Other, updated through their virtual update.
+    std::vector<GameObject *> m_active_objects;
+    // Handle of every object of m_objects, at the same index.
+    std::vector<ObjectHandle> m_object_handles;
+    // Positions in m_objects of the handles.
+    HandleTable m_handles;
+    ObjectHandle m_player;
+    ProjectileSystem m_projectiles;
+    // Destroyed after the destructor has deleted the objects of its entities.
+    EntityWorld m_entities;
+    // Timers of the objects and the derived game mode, moved by update only.
+    TimerWheel m_timers;
+    // Events published during an update, dispatched at the end of it.
+    EventBus m_events;
+
+    // One spawn buffer per chunk, kept between frames to reuse their memory.
+    std::vector<SpawnBuffer> m_spawn_buffers;
+
+    // Pool from the last update, used to build the render list.
+    ThreadPool *m_thread_pool;
+    // One render batch per chunk, kept between frames to reuse their memory.
+    mutable std::vector<RenderBatch> m_render_batches;
+    // Scratch space of build_render_list(...), kept between frames for the
+    // same reason: the targets, the order they are drawn in and their batch
+    // in the snapshot.
+    mutable std::vector<RenderTarget> m_render_targets;
+    mutable std::vector<std::size_t> m_render_order;
+    mutable std::vector<std::size_t> m_snapshot_batches;
+
+    // Per frame work, only rebuilt when the number of chunks changes.
+    TaskGraph m_frame_graph;
+    std::size_t m_frame_chunk_count;
+    // Read by the tasks of m_frame_graph, only set during update.
+    Context *m_frame_context;
+    HudData m_hud;
+    // Strings of set_text(...) are built here, so its memory is reused.
+    sf::String m_text_buffer;
+    // Bounds of m_objects, packed at the start of the collision check.
+    AabbArray m_bounds;
+    // Colliding pairs found in every chunk, as indices into m_objects.
+    std::vector<std::vector<std::pair<std::size_t, std::size_t>>> m_collision_pairs;
+    // Scratch space for the overlaps of one row, per chunk.
+    std::vector<std::vector<std::size_t>> m_collision_rows;
+    // Contacts between objects, kept between frames.
+    ContactCache m_contacts;
+    std::vector<std::pair<GameObject *, GameObject *>> m_contact_pairs;
+    std::vector<ContactEvent> m_contact_events;
+    // Cached bounds of m_objects at the end of the last frame, used by the
+    // spatial queries of Context. Rebuilt mid-frame by apply_area_effects(...).
+    SpatialGrid m_spatial_grid;
+    // Scratch space for apply_area_effects(...).
+    std::vector<AreaEffect> m_area_effects;
+    std::vector<const GameObject *> m_area_hits;
+    // Scratch space for spawn_new_objects(...).
+    std::vector<GameObject *> m_new_objects;
+    std::vector<ProjectileSpawn> m_new_projectiles;
 
     sf::Sprite m_background;
     sf::Music m_music;
@@ -323,6 +599,43 @@ private:
      * do something if music is currently fading.
      */
     void update_music();
+
+    /**
+     * @brief Rebuild m_frame_graph for a number of collision.find chunks, see
+     * update(...).
+     */
+    void build_frame_graph(std::size_t chunk_count);
+
+    /**
+     * @brief Send the events in m_contact_events to the objects. Power-ups
+     * picked up by the player are published as PowerupCollected.
+     */
+    void dispatch_contact_events();
+
+    /**
+     * @brief Publish PowerupCollected if the objects are the player and a
+     * power-up.
+     */
+    void publish_pickup(const GameObject *player, const GameObject *powerup);
+
+    /**
+     * @brief Batch all objects in parallel and stitch the batches into the
+     * snapshot.
+     *
+     * @param snapshot snapshot to draw into.
+     */
+    void build_render_list(RenderSnapshot &snapshot) const;
+
+    /**
+     * @brief Call function(chunk_index, begin, end) for every chunk of
+     * m_active_objects, on the pool if there are enough objects.
+     *
+     * @param chunk_size number of objects per chunk.
+     * @param function must fit in a std::function without allocating when
+     * the pool is used, i.e. capture at most two pointers or references.
+     */
+    template <typename Function>
+    void for_each_chunk(std::size_t chunk_size, const Function &function) const;
 };
 
 /*====================================MENU====================================*/
@@ -351,9 +664,9 @@ public:
      * Buttons will be rendered on top of sprites, meaning sprites are rendered
      * first.
      *
-     * @param window window to draw on.
+     * @param snapshot snapshot to draw into.
      */
-    virtual void render(sf::RenderWindow &window) const override;
+    virtual void render(RenderSnapshot &snapshot) const override;
 
     /**
      * @brief Update the Menu. Will call update on all added buttons.
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Reference to an element of a dense array, see HandleTable. Stays
+ * valid while the element moves around in the array, and becomes invalid when
+ * the element is removed, even if its slot is reused.
+ */
+struct Handle
+{
+    std::uint32_t index;
+    // 0 is never a valid generation, so a value initialized handle is null.
+    std::uint32_t generation;
+
+    /**
+     * @brief Check if the handle was never set.
+     */
+    bool is_null() const;
+
+    bool operator==(const Handle &other) const;
+    bool operator!=(const Handle &other) const;
+};
+
+/**
+ * @brief Handle of a GameObject of a GameMode, see GameMode::get_object(...).
+ */
+typedef Handle ObjectHandle;
+
+/**
+ * @brief Maps handles to the positions of elements in a dense array, e.g. the
+ * objects of a game mode or the components of an entity world.
+ *
+ * @details Each handle points to a slot holding the position of its element
+ * and a generation. Removing an element bumps the generation of its slot, so
+ * old handles to the slot no longer match and lookups of them fail. Slots are
+ * reused, a table never holds more slots than the most elements it has held at
+ * once.
+ *
+ * The owner of the array calls move(...) whenever an element changes position,
+ * e.g. when the last element is swapped into a hole.
+ */
+class HandleTable
+{
+public:
+    // Position of an element whose handle is not valid.
+    static const std::size_t s_no_index;
+
+    HandleTable();
+
+    /**
+     * @brief Create a handle for an element.
+     *
+     * @param index position of the element.
+     * @return Handle new handle of the element.
+     */
+    Handle insert(std::size_t index);
+
+    /**
+     * @brief Invalidate a handle.
+     *
+     * @return true if the handle was valid.
+     */
+    bool erase(Handle handle);
+
+    /**
+     * @brief Update the position of the element of a valid handle.
+     */
+    void move(Handle handle, std::size_t index);
+
+    /**
+     * @brief Get the position of an element in O(1).
+     *
+     * @return std::size_t position of the element, s_no_index if the handle
+     * is not valid.
+     */
+    std::size_t get_index(Handle handle) const;
+
+    /**
+     * @brief Check if a handle is valid.
+     */
+    bool contains(Handle handle) const;
+
+    /**
+     * @brief Get number of valid handles.
+     */
+    std::size_t get_size() const;
+
+    /**
+     * @brief Invalidate all handles. Slots are kept, so old handles stay
+     * invalid.
+     */
+    void clear();
+
+private:
+    struct Slot
+    {
+        // Position of the element, or next free slot if free.
+        std::size_t index;
+        std::uint32_t generation;
+        bool used;
+    };
+
+    std::vector<Slot> m_slots;
+    std::size_t m_free;
+    std::size_t m_size;
+
+    /**
+     * @brief Get the slot of a valid handle, nullptr if the handle is not
+     * valid.
+     */
+    const Slot *find(Handle handle) const;
+};
@@ -13,9 +13,9 @@ public:
      * @brief Render the menu. Will be called once every frame. Also calls
      * Menu render function.
      *
-     * @param window window to draw on.
+     * @param snapshot snapshot to draw into.
      */
-    void render(sf::RenderWindow &window) const override;
+    void render(RenderSnapshot &snapshot) const override;
 
     /**
      * @brief Update the menu. Will be called once every frame. Also calls Menu
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+// Forward declaration
+class CollisionMask;
+class GameObject;
+
+/**
+ * @brief Exact shape of an object: a rectangle in local coordinates, placed in
+ * the world by a transform, optionally with a mask of its opaque pixels.
+ */
+struct CollisionShape
+{
+    // Local to world coordinates.
+    sf::Transform transform;
+    // Rectangle in local coordinates, e.g. the local bounds of a sprite.
+    sf::FloatRect rect;
+    // Opaque pixels, nullptr if the whole rectangle is solid.
+    const CollisionMask *mask;
+    // Pixel of the mask at local coordinate (0, 0), e.g. the texture rect.
+    sf::Vector2i mask_offset;
+
+    /**
+     * @brief Construct an empty shape, without a mask.
+     */
+    CollisionShape();
+
+    CollisionShape(const sf::Transform &transform, const sf::FloatRect &rect,
+                   const CollisionMask *mask, const sf::Vector2i &mask_offset);
+};
+
+/**
+ * @brief Exact collision tests, run after the bounding boxes of two objects
+ * are known to overlap.
+ *
+ * @details Shapes are first tested as oriented boxes with the separating axis
+ * test. If any of them has a mask, the pixels are then tested one row at a
+ * time in the local space of a masked shape, 64 pixels per AND. Shapes that
+ * are only moved relative to each other, or that have no mask, are tested
+ * without looking at single pixels.
+ */
+class Narrowphase
+{
+public:
+    /**
+     * @brief Check if the shapes of two objects overlap. Objects with
+     * sub-colliders overlap if any of them does, objects with neither
+     * sub-colliders nor a collision shape use their cached bounds.
+     */
+    static bool overlaps(const GameObject &first, const GameObject &second);
+
+    /**
+     * @brief Check if the shape of an object overlaps a shape, same as
+     * overlaps(const GameObject &, const GameObject &).
+     */
+    static bool overlaps(const GameObject &object, const CollisionShape &shape);
+
+    /**
+     * @brief Check if two shapes overlap. Shapes that only touch do not
+     * overlap, like sf::FloatRect::intersects(...).
+     */
+    static bool overlaps(const CollisionShape &first, const CollisionShape &second);
+
+    /**
+     * @brief Check if two shapes overlap as oriented boxes, ignoring masks.
+     */
+    static bool boxes_overlap(const CollisionShape &first, const CollisionShape &second);
+
+    /**
+     * @brief Create a solid shape covering an axis aligned box.
+     *
+     * @param bounds box in world coordinates.
+     */
+    static CollisionShape make_box(const sf::FloatRect &bounds);
+
+    /**
+     * @brief Get the transform of a transformable, same as getTransform() but
+     * without updating its cache, so it may be called from several threads.
+     */
+    static sf::Transform get_transform(const sf::Transformable &transformable);
+};
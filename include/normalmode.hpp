@@ -2,6 +2,13 @@
 
 #include "gamestate.hpp"
 #include "gameobject.hpp"
+#include "archetypes.hpp"
+#include "spawntable.hpp"
+#include "wavetimeline.hpp"
+
+#include <memory>
+#include <random>
+#include <vector>
 
 class NormalMode : public GameMode
 {
@@ -13,9 +20,9 @@ public:
      * @brief Render the state. Will be called once every frame. Also calls
      * GameMode render function.
      *
-     * @param window window to draw on.
+     * @param snapshot snapshot to draw into.
      */
-    void render(sf::RenderWindow &window) const override;
+    void render(RenderSnapshot &snapshot) const override;
 
     /**
      * @brief Update the state. Will be called once every frame. Also calls GameMode
@@ -46,12 +53,41 @@ public:
      */
     void init(const GameConfiguration &gc) override;
 
+    /**
+     * @brief Get the current level rating.
+     */
+    unsigned int get_level() const override;
+
+protected:
+    /**
+     * @brief Create a simple enemy, used for random spawns and waves. Creates an
+     * entity in get_entities(), from the archetype table of the configuration.
+     *
+     * @param archetype id of the archetype in get_archetypes().
+     * @param position position of the enemy.
+     * @param difficulty difficulty of the enemy, 1 to 3.
+     * @return GameObject* enemy pointer.
+     */
+    virtual GameObject *create_enemy(std::size_t archetype, const sf::Vector2f &position, int difficulty);
+
+    /**
+     * @brief Get the archetypes of the simple enemies.
+     */
+    const ArchetypeTable &get_archetypes() const;
+
+    /**
+     * @brief Get the base values all archetypes are scaled from.
+     */
+    const EnemyMinionData &get_minion_data() const;
+
 private:
     // Spawn related data.
     float m_spawn_time, m_spawn_time_multiplier, m_spawn_time_min;
     float m_boss_spawn_time, m_current_boss_time;
-    sf::Time m_prev_spawn_time;
-    sf::Time m_prev_boss_spawn_time;
+    Timer m_spawn_timer;
+    Timer m_boss_timer;
+    // Fades out the music before the boss comes.
+    Timer m_boss_warning_timer;
     unsigned int m_boss_counter;
 
     unsigned int m_spawn_zone;
@@ -61,7 +97,7 @@ private:
     // Difficulty related data.
     unsigned int m_level_rating;
     float m_level_inc_rate, m_current_level_time;
-    sf::Time m_level_time;
+    Timer m_level_timer;
     sf::Sound m_level_up_sound;
 
     // UI related data.
@@ -75,33 +111,90 @@ private:
     FloatRectangleBar m_boss_countdown_bar;
 
     EnemyMinionData m_minion_data;
+    ArchetypeTable m_archetypes;
+    SpawnTable m_spawn_table;
+    // Picks the enemies from m_spawn_table.
+    std::mt19937 m_spawn_rng;
+
+    // Scripted waves, enemies are spawned at random if there are none or
+    // once all of them have been spawned.
+    std::unique_ptr<WaveCursor> m_waves;
+    // Archetype ids of the names used by m_waves.
+    std::vector<std::size_t> m_wave_archetypes;
+    // Time of the timers when the timeline started.
+    float m_wave_start;
 
     /**
      * @brief Render all texts.
      *
-     * @param window window to draw to.
+     * @param snapshot snapshot to draw into.
      */
-    void render_texts(sf::RenderWindow &window) const;
+    void render_texts(RenderSnapshot &snapshot) const;
 
     /**
      * @brief Render all bars.
      *
-     * @param window window to draw to.
+     * @param snapshot snapshot to draw into.
      */
-    void render_bars(sf::RenderWindow &window) const;
+    void render_bars(RenderSnapshot &snapshot) const;
 
     /**
-     * @brief Update all texts.
+     * @brief Update all texts. Runs at the same time as the objects are updated.
+     *
+     * @param hud player values from the start of the frame.
      */
-    void update_texts();
+    void update_texts(const HudData &hud, FrameArena &arena) override;
 
     /**
-     * @brief Handle time related events.
+     * @brief Update the bars from the timers and spawn the waves that are due.
+     * Spawns, level ups and the boss are fired by the timers, see
+     * start_timers().
      *
      * @param context[in,out] class containing useful data.
      */
     void handle_time(Context &context);
 
+    /**
+     * @brief Spawn all events of m_waves that are due. Goes to the boss at a
+     * boss event, the events after it are handled when the boss is beaten.
+     * After the last event m_waves is reset and the spawn and boss timers are
+     * started, see start_spawn_timers().
+     *
+     * @param context[in,out] class containing useful data.
+     */
+    void handle_waves(Context &context);
+
+    /**
+     * @brief Start the spawn, level and boss timers. Without scripted waves
+     * enemies are spawned every m_spawn_time and the boss comes every
+     * m_boss_spawn_time.
+     */
+    void start_timers();
+
+    /**
+     * @brief Start spawning random enemies every m_spawn_time and the boss
+     * timer. Used without scripted waves and after the last wave.
+     */
+    void start_spawn_timers();
+
+    /**
+     * @brief Start the boss timer and the warning before it.
+     */
+    void start_boss_timer();
+
+    /**
+     * @brief Spawn a random enemy and start the spawn timer again.
+     *
+     * @param context[in,out] class containing useful data.
+     */
+    void spawn_enemy(Context &context);
+
+    /**
+     * @brief Go up one level, spawning faster, publish LevelUp and start the
+     * level timer again.
+     */
+    void level_up();
+
     /**
      * @brief Initialize all texts.
      *
@@ -136,9 +229,9 @@ private:
      * @details The position of the enemy will be random, but will be based on the
      * current spawn zone.
      *
-     * Enemy spawned will be based on the current level. The higher the level, the
-     * more difficult the enemies will be. Difficulty will increase up to a
-     * certain point.
+     * Enemy spawned will be picked from the band of m_spawn_table that covers
+     * the current level. The higher the level, the more difficult the enemies
+     * will be. Difficulty will increase up to the last band.
      *
      * @return GameObject* enemy pointer.
      */
@@ -153,46 +246,6 @@ private:
      */
     sf::Vector2f get_enemy_position(const sf::Vector2u &window_size);
 
-    /**
-     * @brief Get the random enemy. Used in get_enemy function.
-     *
-     * @param pos enemy position.
-     * @return GameObject* enemy pointer.
-     */
-    GameObject *get_enemy_first(const sf::Vector2f &pos) const;
-
-    /**
-     * @brief Get the random enemy.Used in get_enemy function.
-     *
-     * @param pos enemy position.
-     * @return GameObject* enemy pointer.
-     */
-    GameObject *get_enemy_second(const sf::Vector2f &pos) const;
-
-    /**
-     * @brief Get the random enemy. Used in get_enemy function.
-     *
-     * @param pos enemy position.
-     * @return GameObject* enemy pointer.
-     */
-    GameObject *get_enemy_third(const sf::Vector2f &pos) const;
-
-    /**
-     * @brief Get the random enemy. Used in get_enemy function.
-     *
-     * @param pos enemy position.
-     * @return GameObject* enemy pointer.
-     */
-    GameObject *get_enemy_fourth(const sf::Vector2f &pos) const;
-
-    /**
-     * @brief Get the random enemy. Used in get_enemy function.
-     *
-     * @param pos enemy position.
-     * @return GameObject* enemy pointer.
-     */
-    GameObject *get_enemy_default(const sf::Vector2f &pos) const;
-
     /**
      * @brief Go to boss state. Context needed to set next state.
      *
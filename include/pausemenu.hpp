@@ -14,9 +14,9 @@ public:
      * @brief Render PauseMenu. Will be called once every frame. Also calls Menu
      * render function. Will render the previous state if it exists.
      * 
-     * @param window window to draw on.
+     * @param snapshot snapshot to draw into.
      */
-    virtual void render(sf::RenderWindow &window) const override;
+    virtual void render(RenderSnapshot &snapshot) const override;
 
     /**
      * @brief Update PauseMenu. Will be called once every frame. Also calls Menu
@@ -1,12 +1,13 @@
 #pragma once
 
+#include "effectstack.hpp"
+#include "eventbus.hpp"
 #include "ship.hpp"
 #include <SFML/Graphics.hpp>
-#include <string>
 
 struct PlayerData;
 
-class Player : public Ship
+class Player final : public Ship
 {
 public:
     Player(const PlayerData &data, float x, float y);
@@ -14,28 +15,75 @@ public:
     void update(Context &context) override;
     bool handle(const sf::Event &event, Context &context) override;
     sf::FloatRect bounds() const override;
+    CollisionLayer get_layer() const override;
+    ObjectKind get_kind() const override;
+
+    /**
+     * @brief Take damage from enemies and enemy projectiles. Called once per
+     * contact, see collision_enter(...).
+     */
     void collision(const GameObject *other) override;
-    void kills(int score, bool boss) const;
+
+    /**
+     * @brief Keep the player from moving into a boss while they touch.
+     */
+    void collision_stay(const GameObject *other) override;
+
+    /**
+     * @brief Take damage from an enemy projectile.
+     */
+    void projectile_hit(const ProjectileHit &hit) override;
+
+    /**
+     * @brief Add the score of a destroyed enemy or boss. Called by the game
+     * mode for EnemyKilled and BossDefeated events.
+     */
+    void kills(int score, bool boss);
     int get_score() const;
     int get_kills() const;
     int get_boss_kills() const;
-    void lose_health(int health = 1) const;
+
+    /**
+     * @brief Lose health and remove the player if it died. Called by the game
+     * mode for PlayerHit events.
+     */
+    void lose_health(int health = 1);
+
+    /**
+     * @brief Apply the effect of a picked up power-up. Called by the game mode
+     * for PowerupCollected events. Timed effects are added to the effect stack,
+     * see get_effects().
+     */
+    void collect(PowerUpType type);
+
+    /**
+     * @brief Get the active timed effects, e.g. for the HUD.
+     */
+    const EffectStack &get_effects() const;
 
 private:
     const sf::Texture &m_image;
     sf::Clock m_shoot_clock;
-    sf::Clock m_powerup_clock;
-    mutable int m_score;
-    mutable int m_kills;
-    mutable int m_boss_kills;
+    EffectStack m_effects;
+    int m_score;
+    int m_kills;
+    int m_boss_kills;
     float m_shoot_speed;
     float m_min_shoot_speed;
     float m_max_speed;
-    std::string m_shot_type;
     float m_angle;
-    mutable int m_health_lost;
     sf::Vector2f m_old_pos; // Store the old position of the player every frame
 
     bool out_of_bounds(float width, float height) const;
     void attack(Context &context);
+
+    /**
+     * @brief Lose health to a hit, unless a shield absorbs it.
+     */
+    void take_hit(int damage);
+
+    /**
+     * @brief Get movement speed with the speed effects applied.
+     */
+    float get_speed() const;
 };
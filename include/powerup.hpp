@@ -4,7 +4,23 @@
 #include <SFML/Graphics.hpp>
 #include  "context.hpp"
 #include "resourcemanager.hpp"
-
+#include "timerwheel.hpp"
+#include <cstdint>
+#include <random>
+
+/**
+ * @brief Types of power-ups, in the order of PowerUp::create(...).
+ */
+enum class PowerUpType : std::uint8_t
+{
+    Repair,
+    Speed,
+    Buckshot,
+    Doubleshoot,
+    Boost,
+    Score,
+    Nuke
+};
 
 //Class definition of PowerUp as an inheritance class with basic funktionality
 //as moving, collision and so on.
@@ -12,24 +28,75 @@
 class PowerUp: public GameObject
 {
 public:
-    PowerUp(float x, float y, float v);
+    PowerUp(PowerUpType type, float x, float y, float v);
     ~PowerUp() =default;
-    void render(sf::RenderWindow &window) const;
-    void update(Context &context);
+    void render(RenderSnapshot &snapshot) const;
+    bool render_batched(RenderBatch &batch) const override final;
+
+    /**
+     * @brief Fall down the screen. A Nuke the player has touched fires a
+     * Shockwave and is removed. Final, so the game mode updates all power-ups
+     * in one loop without a virtual call.
+     */
+    void update(Context &context) override final;
+
+    /**
+     * @brief Remove the power-up once it has been on screen for 10 seconds.
+     */
+    void start_timers(TimerWheel &timers) override;
     bool handle(const sf::Event &event, Context &context);
     sf::FloatRect bounds() const;
-    virtual void collision(const GameObject *other);
+    CollisionLayer get_layer() const override;
+    ObjectKind get_kind() const override final;
+
+    /**
+     * @brief Remove the power-up when it touches the player. A Nuke instead
+     * goes off on its next update(...).
+     */
+    void collision(const GameObject *other) override final;
+
+    /**
+     * @brief Create a random power-up, all types equally likely.
+     *
+     * @param rng random generator to draw from.
+     * @param x, y position of the power-up.
+     * @param v falling speed of the power-up.
+     */
+    static PowerUp *create_random(std::minstd_rand &rng, float x, float y, float v);
+
+    /**
+     * @brief Create a power-up of a type. Types are, in order: Repair, Speed,
+     * Buckshot, Doubleshoot, Boost, Add_score and Nuke. Types above Nuke
+     * create a Nuke.
+     *
+     * @param type index of the type.
+     * @param x, y position of the power-up.
+     * @param v falling speed of the power-up.
+     */
+    static PowerUp *create(unsigned int type, float x, float y, float v);
+
+    /**
+     * @brief Get the type of the power-up, published in PowerupCollected when
+     * the player picks it up.
+     */
+    PowerUpType get_type() const;
+
     bool activate_nuke;
     sf::Sprite m_sprite;
 private:
+    PowerUpType m_type;
     float powerup_speed;
     sf::Vector2f m_direction;
-    sf::Clock PowerUp_clock;
+    Timer m_lifetime;
+
+protected:
+    const sf::Transformable *get_transform() const override;
 };
 
 
 //Class definition of all powerups with individual textures. Funktionality is 
-//in the player file exept for the class "Nuke".
+//in the player file, see Player::collect(...), exept for the class "Nuke",
+//see PowerUp::update(...).
 
 class Repair: public PowerUp
 {
@@ -89,8 +156,6 @@ class Nuke: public PowerUp
 {
 public:
     Nuke(float x, float y, float v);
-    void update(Context &context) override;
-    void collision(const GameObject *other);
 private:
     const sf::Texture &m_image;
 };
\ No newline at end of file
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <SFML/System.hpp>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+
+/**
+ * @brief Timing data for one named piece of work.
+ */
+struct ProfileEntry
+{
+    sf::Time last;
+    sf::Time max;
+    sf::Time total;
+    std::size_t samples;
+
+    /**
+     * @brief Construct a new Profile Entry with all values set to zero.
+     */
+    ProfileEntry();
+
+    /**
+     * @brief Get the average time of all samples.
+     */
+    sf::Time get_average() const;
+};
+
+/**
+ * @brief Values of one named counter, one sample per frame.
+ */
+struct CounterEntry
+{
+    std::size_t last;
+    std::size_t max;
+    std::size_t total;
+    std::size_t samples;
+
+    /**
+     * @brief Construct a new Counter Entry with all values set to zero.
+     */
+    CounterEntry();
+
+    /**
+     * @brief Get the average value of all samples.
+     */
+    double get_average() const;
+};
+
+/**
+ * @brief Collects timings of named work, e.g. the tasks of a frame, and named
+ * counters, e.g. work done per frame. Can be used from any thread.
+ */
+class Profiler
+{
+public:
+    /**
+     * @brief Add a timing sample. Only allocates the first time a name is
+     * used.
+     *
+     * @param name name of the measured work.
+     * @param time time the work took.
+     */
+    static void record(const char *name, const sf::Time &time);
+
+    /**
+     * @brief Add a counter sample. Only allocates the first time a name is
+     * used.
+     *
+     * @param name name of the counter.
+     * @param value value this frame.
+     */
+    static void count(const char *name, std::size_t value);
+
+    /**
+     * @brief Get a copy of all entries, sorted by name.
+     */
+    static std::map<std::string, ProfileEntry> get_entries();
+
+    /**
+     * @brief Get a copy of the entry with the given name. The entry is empty if
+     * nothing has been recorded with that name.
+     */
+    static ProfileEntry get_entry(const std::string &name);
+
+    /**
+     * @brief Get a copy of all counters, sorted by name.
+     */
+    static std::map<std::string, CounterEntry> get_counters();
+
+    /**
+     * @brief Get a copy of the counter with the given name. The counter is
+     * empty if nothing has been counted with that name.
+     */
+    static CounterEntry get_counter(const std::string &name);
+
+    /**
+     * @brief Remove all entries and counters.
+     */
+    static void reset();
+
+private:
+    static std::mutex Mutex;
+    // Looked up by const char *, see std::less<void>.
+    static std::map<std::string, ProfileEntry, std::less<>> Entries;
+    static std::map<std::string, CounterEntry, std::less<>> Counters;
+};
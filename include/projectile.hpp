@@ -26,14 +26,20 @@ class Projectile : public GameObject
 public:
     Projectile(float x, float y, float angle ,float v, bool friendly, int damage = 1);
     ~Projectile() = default;
-    void render(sf::RenderWindow &window) const override;
+    void render(RenderSnapshot &snapshot) const override;
+    bool render_batched(RenderBatch &batch) const override;
     void update(Context &context) override;
     bool handle(const sf::Event &event, Context &context) override;
     sf::FloatRect bounds() const override;
+    CollisionLayer get_layer() const override;
     bool is_friendly() const;
     int get_damage() const;
+    // Values passed to GameObject::projectile_hit(...) when this hits an object.
+    ProjectileHit get_hit() const;
 
 protected:
+    const sf::Transformable *get_transform() const override;
+
     sf::CircleShape m_circle;
     sf::Vector2f m_direction;
     float m_speed;
@@ -0,0 +1,247 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "cellgrid.hpp"
+
+// Forward declaration
+class GameObject;
+class RenderSnapshot;
+
+/**
+ * @brief Request to spawn a projectile. Same arguments as the constructor of
+ * Projectile, see projectile.hpp.
+ */
+struct ProjectileSpawn
+{
+    float x;
+    float y;
+    float angle;
+    float v;
+    bool friendly;
+    int damage;
+};
+
+/**
+ * @brief All projectiles of a game mode, stored as parallel arrays instead of
+ * one GameObject per projectile.
+ *
+ * @details Projectiles fly in straight lines at constant speed, so instead of
+ * being moved every frame they store where and when they were spawned, and
+ * their position is computed from the time of the system when needed. The
+ * time a projectile leaves the window is computed once and kept in a queue,
+ * so update(...) only touches projectiles that expire. All projectiles are
+ * drawn as a single vertex batch. Collisions with ships behave as if the
+ * projectile was a BasicProjectile, see collide(...), but no Projectile object
+ * is created for a hit.
+ *
+ * Collision is continuous: the path from the previous to the current position
+ * is tested, so fast projectiles can not pass through thin targets between
+ * two frames.
+ */
+class ProjectileSystem
+{
+public:
+    /**
+     * @brief Create an empty projectile system.
+     */
+    ProjectileSystem();
+
+    /**
+     * @brief Add a projectile. It is moved from the next update(...).
+     *
+     * @param projectile projectile to add.
+     */
+    void spawn(const ProjectileSpawn &projectile);
+
+    /**
+     * @brief Advance the time of all projectiles and kill the ones that have
+     * left the window for good. Projectiles spawned outside the window that
+     * fly into it live until they leave it again. Projectiles leaving the
+     * window can still hit something on their way out in the following
+     * collide(...) call. Expired projectiles are counted in the Profiler as
+     * "projectiles.expired".
+     *
+     * @param delta time since last frame in seconds.
+     * @param window_size size of the window.
+     */
+    void update(float delta, const sf::Vector2u &window_size);
+
+    /**
+     * @brief Collide all projectiles with the objects, using their cached
+     * bounds. For every overlapping pair object->projectile_hit(...) is called
+     * with the projectile's values. The projectile is killed where a
+     * BasicProjectile would remove itself, i.e. a friendly projectile hitting
+     * an enemy or an enemy projectile hitting the player.
+     *
+     * @details A projectile overlaps an object if its bounds overlap the
+     * object's collision shape at the current position, see Narrowphase, or
+     * the object's bounds anywhere on the segment from the previous position.
+     * The segments are sorted into a grid first, so every object is only
+     * tested against the projectiles in the cells its bounds cover. Hits are
+     * counted in the Profiler as "projectiles.hits", hits only found on the
+     * segment also as "projectiles.swept_hits", and the projectiles tested as
+     * "projectiles.candidates".
+     *
+     * @note Dead projectiles and removed objects do not collide, so a
+     * projectile can only hit one object.
+     *
+     * @param objects objects to collide with.
+     */
+    void collide(const std::vector<GameObject *> &objects);
+
+    /**
+     * @brief Kill all projectiles of one side whose centre is further than
+     * inner_radius and at most outer_radius from a point.
+     *
+     * @param center centre of the ring.
+     * @param inner_radius projectiles this close or closer are kept.
+     * @param outer_radius projectiles further away are kept.
+     * @param friendly kill projectiles fired by the player if true, otherwise
+     * the ones fired by enemies.
+     * @return number of projectiles killed.
+     */
+    std::size_t kill_in_ring(const sf::Vector2f &center, float inner_radius, float outer_radius,
+                             bool friendly);
+
+    /**
+     * @brief Delete all dead projectiles. Keeps the order of the others.
+     */
+    void remove_dead();
+
+    /**
+     * @brief Remove all projectiles.
+     */
+    void clear();
+
+    /**
+     * @brief Draw all projectiles as one batch of quads.
+     *
+     * @param snapshot snapshot to draw into.
+     */
+    void render(RenderSnapshot &snapshot) const;
+
+    /**
+     * @brief Get number of projectiles, including dead ones not yet removed.
+     */
+    std::size_t get_count() const;
+
+    /**
+     * @brief Get position of a projectile.
+     *
+     * @param index index of projectile, less than get_count().
+     */
+    sf::Vector2f get_position(std::size_t index) const;
+
+    /**
+     * @brief Check if a projectile was fired by the player.
+     *
+     * @param index index of projectile, less than get_count().
+     */
+    bool is_friendly(std::size_t index) const;
+
+    /**
+     * @brief Get damage done by a projectile.
+     *
+     * @param index index of projectile, less than get_count().
+     */
+    int get_damage(std::size_t index) const;
+
+    /**
+     * @brief Check if a projectile is alive, i.e. not out of bounds or hit.
+     * Dead projectiles are removed by remove_dead().
+     *
+     * @param index index of projectile, less than get_count().
+     */
+    bool is_alive(std::size_t index) const;
+
+private:
+    /**
+     * @brief State of a projectile, stored as a byte.
+     */
+    enum State : std::uint8_t
+    {
+        Dead,
+        Alive,
+        // Out of bounds, dies after collide(...).
+        Leaving
+    };
+
+    /**
+     * @brief Time a projectile leaves the window, ordered by time.
+     */
+    struct Expiry
+    {
+        float time;
+        std::size_t serial;
+
+        bool operator>(const Expiry &other) const
+        {
+            return time > other.time;
+        }
+    };
+
+    // Position at m_spawn_time and velocity, the position at time t is
+    // origin + velocity * (t - spawn_time).
+    std::vector<float> m_origin_x;
+    std::vector<float> m_origin_y;
+    std::vector<float> m_vx;
+    std::vector<float> m_vy;
+    std::vector<float> m_spawn_time;
+    std::vector<int> m_damage;
+    std::vector<std::uint8_t> m_friendly;
+    std::vector<std::uint8_t> m_state;
+    // Increasing number given at spawn, finds a projectile after
+    // remove_dead() has moved it.
+    std::vector<std::size_t> m_serial;
+
+    float m_time;
+    // Time before the last update(...).
+    float m_previous_time;
+    std::size_t m_next_serial;
+    // First serial without an entry in m_expiry_queue.
+    std::size_t m_scheduled_serial;
+    // Window size the expiry times were computed for.
+    sf::Vector2u m_window_size;
+    // Min-heap of the times projectiles leave the window. Entries of dead
+    // projectiles are skipped when they come up.
+    std::vector<Expiry> m_expiry_queue;
+
+    // Grid of the paths built by collide(...), kept to reuse the memory.
+    // Path i is the box around projectile i since the last update(...), empty
+    // if the projectile is dead.
+    std::vector<CellBox> m_paths;
+    CellGrid m_grid;
+    // Projectiles near the object being collided.
+    std::vector<std::size_t> m_candidates;
+
+    /**
+     * @brief Add the expiry times of projectiles first and later to the queue.
+     */
+    void schedule(std::size_t first);
+
+    /**
+     * @brief Move the time back to 0, keeping all positions the same.
+     */
+    void rebase_time();
+
+    /**
+     * @brief Sort the paths of all projectiles that are not dead into the grid.
+     */
+    void build_grid();
+
+    /**
+     * @brief Set m_candidates to the projectiles in the grid cells a box
+     * covers, in increasing order.
+     */
+    void find_candidates(float left, float top, float right, float bottom);
+
+    /**
+     * @brief Get index of the projectile with a serial, or of the first one
+     * after it if it has been removed.
+     */
+    std::size_t find_index(std::size_t serial) const;
+};
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <vector>
+
+// Forward declaration
+class GameObject;
+
+/**
+ * @brief Collects triangles for a slice of game objects, grouped by layer and
+ * texture. Batches from several threads are later stitched into one vertex
+ * array per layer and texture, so every group is drawn with a single call.
+ *
+ * @details Groups are kept in the order they are first used. Layer decides
+ * draw order between groups: every group on layer 0 is drawn before any group
+ * on layer 1, e.g. sprites before health bars.
+ *
+ * Objects that cannot be batched keep their place in the draw order. Every
+ * such object starts a new segment: groups of earlier segments, on all
+ * layers, are drawn before the object and groups of later segments after it.
+ */
+class RenderBatch
+{
+public:
+    /**
+     * @brief Triangles sharing one layer and texture.
+     */
+    struct Group
+    {
+        // Number of unbatched objects added before the group.
+        std::size_t segment;
+        unsigned int layer;
+        const sf::Texture *texture;
+        std::vector<sf::Vertex> vertices;
+
+        // Where the vertices are copied when batches are stitched.
+        std::size_t target_batch;
+        std::size_t target_offset;
+    };
+
+    /**
+     * @brief Create an empty batch.
+     */
+    RenderBatch();
+
+    /**
+     * @brief Remove all vertices and objects. Keeps allocated memory.
+     */
+    void clear();
+
+    /**
+     * @brief Add a textured quad for the sprite.
+     */
+    void add_sprite(const sf::Sprite &sprite, unsigned int layer = 0);
+
+    /**
+     * @brief Add fill and outline of the rectangle.
+     */
+    void add_rectangle(const sf::RectangleShape &rectangle, unsigned int layer = 0);
+
+    /**
+     * @brief Add fill of the circle. Outlines are not batched.
+     */
+    void add_circle(const sf::CircleShape &circle, unsigned int layer = 0);
+
+    /**
+     * @brief Add a flat coloured ring, e.g. an expanding shockwave.
+     *
+     * @param center centre of the ring.
+     * @param inner_radius radius of the hole, may be 0 for a disc.
+     * @param outer_radius outer radius.
+     * @param color colour of the ring.
+     * @param point_count number of segments around the ring.
+     */
+    void add_ring(const sf::Vector2f &center, float inner_radius, float outer_radius,
+                  const sf::Color &color, std::size_t point_count = 64, unsigned int layer = 0);
+
+    /**
+     * @brief Add an object that could not be batched. It is rendered on its own
+     * after the groups added before it, see Group::segment.
+     */
+    void add_unbatched(const GameObject *object);
+
+    /**
+     * @brief Get number of groups in use.
+     */
+    std::size_t get_group_count() const;
+
+    /**
+     * @brief Get a group. Groups are numbered in the order they were first used.
+     *
+     * @param index index of group, less than get_group_count().
+     */
+    Group &get_group(std::size_t index);
+    const Group &get_group(std::size_t index) const;
+
+    /**
+     * @brief Get objects that could not be batched, in the order they were added.
+     */
+    const std::vector<const GameObject *> &get_unbatched() const;
+
+private:
+    std::vector<Group> m_groups;
+    // Number of groups in use. Groups after this keep their memory for reuse.
+    std::size_t m_group_count;
+    std::vector<const GameObject *> m_unbatched;
+    // Group used last, objects often share texture with the previous object.
+    std::size_t m_last_group;
+    // First group of the current segment, earlier groups are not reused.
+    std::size_t m_segment_begin;
+
+    /**
+     * @brief Get vertex vector of group with layer and texture in the current
+     * segment, add it if needed.
+     */
+    std::vector<sf::Vertex> &get_vertices(unsigned int layer, const sf::Texture *texture);
+
+    /**
+     * @brief Add two triangles for the quad a, b, c, d (in order around the quad).
+     */
+    static void add_quad(
+        std::vector<sf::Vertex> &vertices,
+        const sf::Vertex &a, const sf::Vertex &b, const sf::Vertex &c, const sf::Vertex &d);
+};
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <variant>
+#include <vector>
+
+/**
+ * @brief Everything needed to draw one frame. States and objects draw copies of
+ * their sprites, shapes and texts into the snapshot, which can then be drawn
+ * to a window on another thread while the next frame is simulated.
+ *
+ * @note Textures and fonts are not copied. They must outlive the snapshot,
+ * which holds for everything loaded through ResourceManager. Texts are drawn
+ * with the render thread's copy of their font, see
+ * ResourceManager::get_render_font(...), so building their glyphs never
+ * touches a font used by the simulation.
+ */
+class RenderSnapshot
+{
+public:
+    /**
+     * @brief Create an empty snapshot.
+     */
+    RenderSnapshot();
+
+    /**
+     * @brief Remove everything drawn and start a new frame. Keeps allocated
+     * memory.
+     *
+     * @param size size of the window the frame is for.
+     * @param view view used when drawing the frame.
+     */
+    void reset(const sf::Vector2u &size, const sf::View &view);
+
+    /**
+     * @brief Add a copy of a drawable to the snapshot. Drawables are drawn in
+     * the order they are added.
+     */
+    void draw(const sf::Sprite &sprite);
+
+    /**
+     * @brief Add a copy of a text to the snapshot. Texts are copied into slots
+     * kept between frames, the n:th text of a frame into the n:th slot. Only
+     * the string and style that differ from the slot are assigned, so drawing
+     * the same texts every frame does not allocate. Texts without a font draw
+     * nothing and are left out.
+     */
+    void draw(const sf::Text &text);
+    void draw(const sf::RectangleShape &rectangle);
+    void draw(const sf::CircleShape &circle);
+
+    /**
+     * @brief Add a batch of triangles sharing one texture, drawn with a single
+     * call. The batch is drawn at this point in the draw order. Fill the
+     * vertices with get_batch_vertices(...).
+     *
+     * @param texture texture of the triangles, nullptr for none.
+     * @param vertex_count number of vertices, three per triangle.
+     * @return std::size_t index of the batch.
+     */
+    std::size_t add_batch(const sf::Texture *texture, std::size_t vertex_count);
+
+    /**
+     * @brief Get the vertices of a batch. Different ranges of the same batch
+     * may be filled from different threads.
+     *
+     * @param index index of batch returned by add_batch(...).
+     * @return sf::Vertex* first vertex of batch.
+     */
+    sf::Vertex *get_batch_vertices(std::size_t index);
+
+    /**
+     * @brief Get number of batches in the snapshot.
+     */
+    std::size_t get_batch_count() const;
+
+    /**
+     * @brief Get number of vertices in a batch.
+     *
+     * @param index index of batch returned by add_batch(...).
+     */
+    std::size_t get_batch_size(std::size_t index) const;
+
+    /**
+     * @brief Get size of the window the frame is for.
+     */
+    sf::Vector2u get_size() const;
+
+    /**
+     * @brief Get number of drawables in the snapshot.
+     */
+    std::size_t get_draw_count() const;
+
+    /**
+     * @brief Draw the snapshot to target, using the view of the snapshot.
+     *
+     * @param target target to draw on.
+     */
+    void render(sf::RenderTarget &target) const;
+
+private:
+    struct Batch
+    {
+        const sf::Texture *texture;
+        std::vector<sf::Vertex> vertices;
+    };
+
+    // Refers to a batch in m_batches.
+    struct BatchDraw
+    {
+        std::size_t index;
+    };
+
+    // Refers to a text in m_texts.
+    struct TextDraw
+    {
+        std::size_t index;
+    };
+
+    typedef std::variant<sf::Sprite, TextDraw, sf::RectangleShape, sf::CircleShape, BatchDraw> Drawable;
+
+    std::vector<Drawable> m_drawables;
+    // Batches are kept between frames to reuse their memory.
+    std::vector<Batch> m_batches;
+    std::size_t m_batch_count;
+    // Texts are kept between frames, so a text that did not change is not
+    // copied again.
+    std::vector<sf::Text> m_texts;
+    std::size_t m_text_count;
+    sf::Vector2u m_size;
+    sf::View m_view;
+};
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+
+#include "rendersnapshot.hpp"
+
+/**
+ * @brief Draws render snapshots to a window on its own thread, so a slow
+ * display() never holds up event handling and simulation.
+ *
+ * @details Snapshots are triple buffered. The simulation fills the back buffer
+ * and submits it, which swaps it with the ready buffer. The render thread swaps
+ * the ready buffer with the buffer it draws from. Neither side ever waits for
+ * the other, and a submitted frame that is replaced before it is drawn is
+ * skipped.
+ *
+ * @note The window is created on, and must handle events on, the main thread.
+ * The render thread only activates it for drawing.
+ */
+class RenderThread
+{
+public:
+    /**
+     * @brief Create a render thread for the given window. Drawing does not
+     * start until start() is called.
+     *
+     * @param window window to draw on, must outlive the render thread.
+     */
+    explicit RenderThread(sf::RenderWindow &window);
+
+    /**
+     * @brief Stop the render thread.
+     */
+    ~RenderThread();
+
+    RenderThread(const RenderThread &) = delete;
+    RenderThread &operator=(const RenderThread &) = delete;
+
+    /**
+     * @brief Get the snapshot to fill with the next frame. Only valid until
+     * submit() is called.
+     *
+     * @return RenderSnapshot& back buffer.
+     */
+    RenderSnapshot &get_back_buffer();
+
+    /**
+     * @brief Hand the back buffer over to the render thread.
+     */
+    void submit();
+
+    /**
+     * @brief Deactivate the window on the calling thread and start drawing
+     * on the render thread. Does nothing if already started.
+     */
+    void start();
+
+    /**
+     * @brief Stop and join the render thread, then activate the window on the
+     * calling thread again. Must be called before the window is closed. Does
+     * nothing if not started.
+     */
+    void stop();
+
+private:
+    sf::RenderWindow &m_window;
+    RenderSnapshot m_snapshots[3];
+
+    std::mutex m_mutex;
+    std::condition_variable m_submitted;
+    // Indices into m_snapshots. m_back is only used by the simulation and
+    // m_front only by the render thread. m_ready is guarded by m_mutex.
+    std::size_t m_back;
+    std::size_t m_ready;
+    std::size_t m_front;
+    bool m_has_ready;
+    bool m_stop;
+
+    std::thread m_thread;
+
+    /**
+     * @brief Render thread main loop.
+     */
+    void run();
+};
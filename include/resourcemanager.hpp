@@ -2,8 +2,11 @@
 
 #include <SFML/Graphics.hpp>
 #include <SFML/Audio.hpp>
+#include <mutex>
 #include <string>
 
+#include "collisionmask.hpp"
+
 class ResourceManager // Texture, font, sound
 {
 public:
@@ -15,9 +18,31 @@ public:
     static sf::SoundBuffer &load_sound_buffer(std::string const &path);
     static sf::Font &load_font(std::string const &path);
 
+    /**
+     * @brief Get the copy of a font used by the render thread, see
+     * RenderSnapshot. Drawing or measuring a text adds glyphs to its font, so
+     * the render thread and the simulation each have their own copy, loaded
+     * separately from the same file. Returns the font itself if it was not
+     * loaded by load_font(...).
+     */
+    static const sf::Font &get_render_font(const sf::Font &font);
+
+    /**
+     * @brief Get the collision mask of a texture, built when the texture was
+     * loaded. Returns nullptr if the texture was not loaded by load_texture(...).
+     */
+    static const CollisionMask *get_mask(const sf::Texture &texture);
+
 private:
     static std::map<std::string, sf::Texture> Textures;
     static std::map<std::string, sf::Font> Fonts;
+    // Render thread copy of every font of Fonts, by address.
+    static std::map<const sf::Font *, sf::Font> Render_fonts;
     static std::map<std::string, sf::SoundBuffer> Sound_buffers;
     static std::map<std::string, sf::Sound> Sounds;
+    // Textures are never removed, so their addresses are stable keys.
+    static std::map<const sf::Texture *, CollisionMask> Masks;
+
+    // Objects may be created on worker threads, guards the maps above.
+    static std::recursive_mutex Mutex;
 };
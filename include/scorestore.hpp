@@ -0,0 +1,185 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief One row in the leaderboard.
+ */
+struct ScoreEntry
+{
+    std::uint32_t score;
+    std::uint32_t kills;
+    std::uint32_t boss_kills;
+    std::uint32_t level;
+    std::uint32_t seed;
+    std::int64_t timestamp;
+
+    /**
+     * @brief Construct a new Score Entry with all values set to zero.
+     */
+    ScoreEntry();
+};
+
+/**
+ * @brief Persistent top-N leaderboard. All file IO is done by a background
+ * writer thread. Only flush() waits for it.
+ *
+ * @details The leaderboard is kept in memory and written to a compact binary
+ * file whenever it changes. Writes go to a temporary file which is synced to
+ * disk and then renamed over the old one. On POSIX the directory is synced
+ * after the rename, on Windows the rename is written through. A crash at any
+ * point leaves either the previous or the new leaderboard.
+ * If the binary file does not exist, the old high_score.txt file is imported
+ * instead.
+ *
+ * File format (little endian):
+ *          "SILB"      magic, 4 bytes.
+ *          version     uint16.
+ *          count       uint16.
+ *          entries     count * (5 * uint32 + int64).
+ *          checksum    uint32, FNV-1a of the entry bytes.
+ *
+ * @note Only one ScoreStore should exist per file. The Game owns the
+ * instance and lends it to its configuration.
+ */
+class ScoreStore
+{
+public:
+    /**
+     * @brief Create a store and start loading the given file in the background.
+     *
+     * @param path path to leaderboard file.
+     * @param capacity number of entries kept in the leaderboard.
+     * @param legacy_path path to the old plain text high score file, imported
+     * if there is no leaderboard file.
+     */
+    ScoreStore(const std::string &path = "high_score.dat", std::size_t capacity = 10,
+               const std::string &legacy_path = "high_score.txt");
+
+    /**
+     * @brief Write pending changes and stop the writer thread.
+     */
+    ~ScoreStore();
+
+    ScoreStore(const ScoreStore &) = delete;
+    ScoreStore &operator=(const ScoreStore &) = delete;
+
+    /**
+     * @brief Rank returned by get_rank(...) until the writer thread has
+     * inserted the entry.
+     */
+    static const int s_pending_rank{-2};
+
+    /**
+     * @brief Submit a finished run. Never waits, the writer thread inserts the
+     * entry once the file is loaded, so the rank is against the whole
+     * leaderboard. The leaderboard is only written to disk if the entry made it
+     * onto the leaderboard.
+     *
+     * @param entry entry to submit.
+     * @return std::size_t ticket to pass to get_rank(...).
+     */
+    std::size_t submit(const ScoreEntry &entry);
+
+    /**
+     * @brief Get the rank of a submitted entry.
+     *
+     * @param ticket ticket returned by submit(...).
+     * @return int 0-based rank of the entry, -1 if it did not make the
+     * leaderboard and s_pending_rank if it has not been inserted yet.
+     */
+    int get_rank(std::size_t ticket) const;
+
+    /**
+     * @brief Get the best score on the leaderboard, 0 if it is empty.
+     */
+    unsigned int get_high_score() const;
+
+    /**
+     * @brief Get a copy of the leaderboard, sorted with the best entry first.
+     *
+     * @return std::vector<ScoreEntry> current leaderboard.
+     */
+    std::vector<ScoreEntry> get_leaderboard() const;
+
+    /**
+     * @brief Get a number that changes every time the leaderboard changes. Can be
+     * used to avoid copying the leaderboard when nothing has changed.
+     */
+    std::uint64_t get_version() const;
+
+    /**
+     * @brief Check if the leaderboard file has been loaded.
+     */
+    bool is_loaded() const;
+
+    /**
+     * @brief Block until the file is loaded, all submitted entries are ranked
+     * and all changes are written to disk.
+     */
+    void flush();
+
+private:
+    const std::string m_path;
+    const std::size_t m_capacity;
+    const std::string m_legacy_path;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_changed;
+    std::condition_variable m_written;
+
+    std::vector<ScoreEntry> m_entries;
+    // Submitted entries with their tickets, inserted by the writer thread.
+    std::vector<std::pair<std::size_t, ScoreEntry>> m_pending;
+    // Rank of every ticket, s_pending_rank until it is inserted.
+    std::vector<int> m_ranks;
+    std::uint64_t m_version;
+    std::uint64_t m_written_version;
+    bool m_loaded;
+    bool m_stop;
+
+    std::thread m_writer;
+
+    /**
+     * @brief Writer thread main function. Loads the file, then inserts
+     * submitted entries and writes the leaderboard every time m_version changes.
+     */
+    void run();
+
+    /**
+     * @brief Insert all of m_pending and record their ranks. m_mutex must be
+     * held and the file loaded.
+     */
+    void insert_pending();
+
+    /**
+     * @brief Insert entry into m_entries, keeping it sorted and at most
+     * m_capacity long. m_mutex must be held.
+     *
+     * @return int 0-based rank of the entry, -1 if it was not inserted.
+     */
+    int insert(const ScoreEntry &entry);
+
+    /**
+     * @brief Read a leaderboard file. Returns false if the file does not exist
+     * or is corrupt.
+     */
+    static bool read_file(const std::string &path, std::vector<ScoreEntry> &entries);
+
+    /**
+     * @brief Write a leaderboard to a temporary file and rename it over path.
+     * Returns once the file and the rename are synced to disk.
+     */
+    static bool write_file(const std::string &path, const std::vector<ScoreEntry> &entries);
+
+    /**
+     * @brief Read the old plain text high score file (high_score.txt).
+     */
+    static bool read_legacy_file(const std::string &path, ScoreEntry &entry);
+};
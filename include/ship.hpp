@@ -4,15 +4,22 @@
 #include <SFML/Graphics.hpp>
 #include "ui.hpp"
 
+// Forward declaration
+class CollisionMask;
+
 class Ship : public GameObject
 {
 public:
     Ship(int health, float speed, float projectile_speed);
     virtual ~Ship() = default;
-    void render(sf::RenderWindow &window) const override;
+    Ship(const Ship &) = delete;
+    Ship &operator=(const Ship &) = delete;
+    void render(RenderSnapshot &snapshot) const override;
+    bool render_batched(RenderBatch &batch) const override;
     void update(Context &context) override = 0;
     bool handle(const sf::Event &event, Context &context) override = 0;
     sf::FloatRect bounds() const override = 0;
+    bool get_collision_shape(CollisionShape &shape) const override;
     void collision(const GameObject *other) override = 0;
     int get_health() const;
     int get_max_health() const;
@@ -29,6 +36,16 @@ protected:
     sf::Vector2f s_health_bar_offset;
     IntRectangleBar s_health_bar;
     bool s_health_bar_visible;
+    // Opaque pixels of the sprite's texture, nullptr if unknown.
+    const CollisionMask *s_mask;
+
+    /**
+     * @brief Set the texture of the sprite and use its collision mask, see
+     * ResourceManager::get_mask(...).
+     *
+     * @param texture texture loaded with ResourceManager::load_texture(...).
+     */
+    void set_texture(const sf::Texture &texture);
 
     /**
      * @brief Toggle the visibility of the health bar. If its visible, it needs
@@ -46,4 +63,9 @@ protected:
      * @param context[in, out] class containing useful data.
      */
     void update_health_bar();
+
+    /**
+     * @brief Bounds follow the sprite.
+     */
+    const sf::Transformable *get_transform() const override;
 };
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include "context.hpp"
+#include "gameobject.hpp"
+
+/**
+ * @brief Ring that expands from a point until it has left the window, fired
+ * by the Nuke power-up.
+ *
+ * @details Every frame the ring moves outwards and spawns an AreaEffect for
+ * the band it passed, see Context::spawn_area_effect(...). Every ship is
+ * therefore hit once, when the front of the ring reaches its bounds, and
+ * projectiles of the other side in the band are destroyed. The shockwave has
+ * no collision layer and no size, so it never takes part in collisions
+ * itself.
+ */
+class Shockwave final : public GameObject
+{
+public:
+    /**
+     * @brief Create a shockwave.
+     *
+     * @param x, y centre of the ring.
+     * @param friendly true if fired by the player, then it hits enemies.
+     * @param damage damage done to every ship hit.
+     */
+    Shockwave(float x, float y, bool friendly, int damage);
+    ~Shockwave() = default;
+    void render(RenderSnapshot &snapshot) const override;
+    bool render_batched(RenderBatch &batch) const override;
+    void update(Context &context) override;
+    bool handle(const sf::Event &event, Context &context) override;
+    sf::FloatRect bounds() const override;
+    ObjectKind get_kind() const override;
+    void collision(const GameObject *other) override;
+
+    /**
+     * @brief Get distance from the centre to the front of the ring.
+     */
+    float get_radius() const;
+
+private:
+    sf::Vector2f m_center;
+    float m_radius;
+    bool m_friendly;
+    int m_damage;
+
+    /**
+     * @brief Get the inner radius of the drawn ring.
+     */
+    float get_inner_radius() const;
+};
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <vector>
+
+#include "cellgrid.hpp"
+#include "gameobject.hpp"
+
+/**
+ * @brief Result of SpatialGrid::raycast(...).
+ */
+struct RayHit
+{
+    const GameObject *object;
+    // Distance along the ray to the first point inside the object.
+    float distance;
+    sf::Vector2f point;
+};
+
+/**
+ * @brief Uniform grid of the cached bounds of objects, used to answer spatial
+ * queries without looking at every object.
+ *
+ * @details Every object is stored in all cells its bounds touch. Queries only
+ * look at the cells they cover, so they cost about as much as the number of
+ * objects near the query, not the number of objects in total. The grid is a
+ * snapshot: objects that move, spawn or are deleted are not seen until the
+ * next build(...). Queries are const and may run on several threads at once.
+ */
+class SpatialGrid
+{
+public:
+    /**
+     * @brief Create an empty grid.
+     *
+     * @param cell_size width and height of the cells.
+     */
+    explicit SpatialGrid(float cell_size = 128.f);
+
+    /**
+     * @brief Replace the contents of the grid with objects, using their cached
+     * bounds and layers. Objects without size, without a layer, or marked as
+     * removed are left out.
+     *
+     * @param objects objects to add, must outlive the next build(...).
+     */
+    void build(const std::vector<GameObject *> &objects);
+
+    /**
+     * @brief Remove all objects.
+     */
+    void clear();
+
+    /**
+     * @brief Get number of objects in the grid.
+     */
+    std::size_t get_size() const;
+
+    /**
+     * @brief Find the object closest to a point, measured to the edge of its
+     * bounds. Objects containing the point are at distance 0.
+     *
+     * @param point point to search from.
+     * @param layers layers to search.
+     * @param max_distance objects further away are not found.
+     * @return closest object, or nullptr if there is none.
+     */
+    const GameObject *find_nearest(const sf::Vector2f &point, CollisionLayer layers,
+                                   float max_distance = 1e9f) const;
+
+    /**
+     * @brief Find all objects whose bounds are within a distance of a point.
+     * Every object is found once, in no particular order.
+     *
+     * @param point centre of the circle.
+     * @param radius radius of the circle.
+     * @param layers layers to search.
+     * @param found[out] found objects are added to this.
+     */
+    void find_in_radius(const sf::Vector2f &point, float radius, CollisionLayer layers,
+                        std::vector<const GameObject *> &found) const;
+
+    /**
+     * @brief Find all objects whose bounds are further than inner_radius and
+     * at most outer_radius from a point, e.g. the objects passed by an
+     * expanding ring. Same as find_in_radius(...) otherwise.
+     *
+     * @param point centre of the ring.
+     * @param inner_radius objects this close or closer are not found.
+     * @param outer_radius objects further away are not found.
+     * @param layers layers to search.
+     * @param found[out] found objects are added to this.
+     */
+    void find_in_ring(const sf::Vector2f &point, float inner_radius, float outer_radius,
+                      CollisionLayer layers, std::vector<const GameObject *> &found) const;
+
+    /**
+     * @brief Find the first object hit by a ray. A ray starting inside an
+     * object hits it at distance 0.
+     *
+     * @param origin start of the ray.
+     * @param direction direction of the ray, does not have to be normalized.
+     * @param max_distance length of the ray.
+     * @param layers layers to search.
+     * @param hit[out] the first hit, if any.
+     * @return true if an object was hit.
+     */
+    bool raycast(const sf::Vector2f &origin, const sf::Vector2f &direction, float max_distance,
+                 CollisionLayer layers, RayHit &hit) const;
+
+private:
+    struct Entry
+    {
+        const GameObject *object;
+        CollisionLayer layer;
+    };
+
+    // Entry i has bounds m_boxes[i] and is stored as i in m_grid.
+    std::vector<Entry> m_entries;
+    std::vector<CellBox> m_boxes;
+    CellGrid m_grid;
+
+    /**
+     * @brief Squared distance from a point to a box.
+     */
+    static float get_distance2(const CellBox &box, const sf::Vector2f &point);
+};
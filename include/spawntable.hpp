@@ -0,0 +1,185 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Forward declaration
+class ArchetypeTable;
+
+/**
+ * @brief Weighted random choice in constant time, with Vose's alias method.
+ *
+ * @details Every outcome gets a column of equal width. A column holds its own
+ * outcome up to a threshold and the rest is filled by one other outcome, its
+ * alias. Sampling picks a column and compares with the threshold, both from
+ * one 32 bit random number.
+ */
+class AliasTable
+{
+public:
+    /**
+     * @brief Create an empty table.
+     */
+    AliasTable();
+
+    /**
+     * @brief Create a table. Throws std::logic_error if there are no weights,
+     * a weight is negative or all weights are 0.
+     *
+     * @param weights weight of every outcome, need not sum to 1.
+     */
+    AliasTable(const std::vector<double> &weights);
+
+    /**
+     * @brief Pick an outcome.
+     *
+     * @param random uniformly distributed 32 bit random number.
+     * @return std::size_t index of the weight picked.
+     */
+    std::size_t sample(std::uint32_t random) const;
+
+    /**
+     * @brief Get the chance of an outcome, as given by the columns.
+     *
+     * @param outcome index of a weight.
+     */
+    double get_probability(std::size_t outcome) const;
+
+    /**
+     * @brief Get number of outcomes.
+     */
+    std::size_t get_size() const;
+
+private:
+    // Chance to keep the outcome of a column, scaled to [0, 2^32].
+    std::vector<std::uint64_t> m_thresholds;
+    std::vector<std::size_t> m_aliases;
+};
+
+/**
+ * @brief One enemy that may be spawned.
+ */
+struct SpawnEntry
+{
+    std::string archetype;
+    int difficulty;
+    double weight;
+};
+
+/**
+ * @brief Enemies spawned from a level until the level of the next band.
+ */
+struct SpawnBand
+{
+    unsigned int level;
+    std::vector<SpawnEntry> entries;
+};
+
+/**
+ * @brief Enemy picked by SpawnTable::sample(...).
+ */
+struct SpawnChoice
+{
+    // Id in the ArchetypeTable the spawn table was compiled with.
+    std::size_t archetype;
+    int difficulty;
+};
+
+/**
+ * @brief Chances of the simple enemies to be spawned at every level, see
+ * SpawnBand. Compiled into one AliasTable per band, so picking an enemy costs
+ * one random number.
+ *
+ * @details Tables are loaded from a file in the same format as the game
+ * configuration. LEVEL starts a new band, the following spawns belong to it:
+ *          // This is a comment
+ *          LEVEL=3;
+ *          SPAWN=minion,1,27;
+ *          SPAWN=mover,1,4;
+ *
+ * Keys are:
+ *      LEVEL (uint), SPAWN (archetype name, difficulty int, weight float)
+ *
+ * Bands must be in increasing order of level. The first band is used for all
+ * levels below its level.
+ *
+ * @note Invalid values throw std::logic_error. Unknown keys are ignored.
+ */
+class SpawnTable
+{
+public:
+    /**
+     * @brief Create an empty table.
+     */
+    SpawnTable();
+
+    /**
+     * @brief Get the built in table, new enemies every third level up to level
+     * 12. Uses the archetypes of ArchetypeTable::defaults().
+     */
+    static SpawnTable defaults();
+
+    /**
+     * @brief Load a table from file. Throws std::logic_error if the file
+     * cannot be opened.
+     *
+     * @param path path to spawn file.
+     */
+    static SpawnTable from_file(const std::string &path);
+
+    /**
+     * @brief Add a band after all other bands. Throws std::logic_error if its
+     * level is not above the level of the last band.
+     */
+    void add_band(const SpawnBand &band);
+
+    /**
+     * @brief Look up the archetypes and build the alias tables. Must be called
+     * before sample(...). Throws std::logic_error if an archetype is missing,
+     * or a band has no spawns or no weight.
+     *
+     * @param archetypes table to look up archetypes in.
+     */
+    void compile(const ArchetypeTable &archetypes);
+
+    /**
+     * @brief Pick an enemy to spawn.
+     *
+     * @param level current level.
+     * @param random uniformly distributed 32 bit random number.
+     */
+    const SpawnChoice &sample(unsigned int level, std::uint32_t random) const;
+
+    /**
+     * @brief Get index of the band used at a level.
+     */
+    std::size_t find_band(unsigned int level) const;
+
+    /**
+     * @brief Get number of bands.
+     */
+    std::size_t get_band_count() const;
+
+    /**
+     * @brief Get a band.
+     *
+     * @param band index of the band.
+     */
+    const SpawnBand &get_band(std::size_t band) const;
+
+    /**
+     * @brief Get chance of a spawn in a band, as sampled after compile(...).
+     *
+     * @param band index of the band.
+     * @param entry index of the spawn in the band.
+     */
+    double get_probability(std::size_t band, std::size_t entry) const;
+
+private:
+    std::vector<SpawnBand> m_bands;
+    // Compiled bands, same order as m_bands.
+    std::vector<AliasTable> m_aliases;
+    std::vector<std::vector<SpawnChoice>> m_choices;
+};
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <SFML/System.hpp>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Forward declaration
+class ThreadPool;
+class TaskCounter;
+
+/**
+ * @brief A set of named tasks with explicit dependencies, run once per frame.
+ * Tasks without a dependency between them may run at the same time.
+ *
+ * @details A task can only depend on tasks added before it, meaning the graph
+ * can never contain a cycle and the order tasks are added in is always a
+ * valid order to run them in. The time every task takes is recorded in the
+ * Profiler under the task name.
+ */
+class TaskGraph
+{
+public:
+    typedef std::size_t TaskId;
+
+    /**
+     * @brief Create an empty graph.
+     */
+    TaskGraph();
+
+    TaskGraph(const TaskGraph &) = delete;
+    TaskGraph &operator=(const TaskGraph &) = delete;
+
+    /**
+     * @brief Add a task to the graph. Throws exception if a dependency is not
+     * a task in the graph.
+     *
+     * @param name name used when the task is profiled.
+     * @param function work to be done.
+     * @param dependencies tasks that must be done before this task starts.
+     * @return TaskId id of the new task.
+     */
+    TaskId add_task(
+        const std::string &name,
+        const std::function<void()> &function,
+        const std::vector<TaskId> &dependencies = {});
+
+    /**
+     * @brief Run all tasks and wait until they are done. If a task throws, tasks
+     * depending on it are skipped, all other tasks still run and the first
+     * exception is rethrown.
+     *
+     * @param pool thread pool to run on. If nullptr, all tasks are run on the
+     * calling thread in the order they were added.
+     */
+    void run(ThreadPool *pool);
+
+    /**
+     * @brief Remove all tasks.
+     */
+    void clear();
+
+    /**
+     * @brief Get number of tasks in the graph.
+     */
+    std::size_t get_task_count() const;
+
+    /**
+     * @brief Get the time the task took the last time the graph was run.
+     *
+     * @param id id of task.
+     */
+    sf::Time get_task_time(TaskId id) const;
+
+private:
+    struct Task
+    {
+        std::string name;
+        std::function<void()> function;
+        std::vector<TaskId> dependents;
+        unsigned int dependency_count;
+        sf::Time time;
+    };
+
+    std::vector<Task> m_tasks;
+    // Dependencies left before each task can start, only used while running.
+    // When run serially, 1 if the task is skipped.
+    std::unique_ptr<std::atomic<unsigned int>[]> m_remaining;
+    std::size_t m_remaining_size;
+    // Pool and counter of a parallel run, only set while running. Tasks on
+    // the pool only carry their id, see run_task(...).
+    ThreadPool *m_pool;
+    TaskCounter *m_counter;
+
+    /**
+     * @brief Run all tasks on the calling thread in the order they were added.
+     */
+    void run_serial();
+
+    /**
+     * @brief Mark the dependents of a task as skipped in a serial run. Skipped
+     * tasks skip their own dependents in turn, since they come later.
+     */
+    void skip_dependents(TaskId id);
+
+    /**
+     * @brief Submit a task to m_pool. When it is done, dependents that have no
+     * dependencies left are submitted.
+     */
+    void submit(TaskId id);
+
+    /**
+     * @brief Run a task submitted to the pool, see submit(...).
+     *
+     * @param graph the graph the task belongs to.
+     * @param id id of the task.
+     */
+    static void run_task(void *graph, std::size_t id);
+
+    /**
+     * @brief Run a task and record its time.
+     */
+    void execute(TaskId id);
+};
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Keeps track of unfinished tasks submitted to a ThreadPool. Wait for
+ * the tasks with ThreadPool::wait(...).
+ */
+class TaskCounter
+{
+public:
+    TaskCounter();
+
+    TaskCounter(const TaskCounter &) = delete;
+    TaskCounter &operator=(const TaskCounter &) = delete;
+
+    /**
+     * @brief Check if all tasks counted by this counter are done.
+     */
+    bool is_done() const;
+
+private:
+    friend class ThreadPool;
+
+    std::atomic<std::size_t> m_pending;
+    // First exception thrown by a counted task, guarded by the pool mutex.
+    std::exception_ptr m_error;
+};
+
+/**
+ * @brief Persistent pool of worker threads used to split per-frame work over
+ * all cores. Threads are created once and sleep while there is no work.
+ *
+ * @details Every thread has its own task queue. Tasks submitted from inside a
+ * task go to the queue of the running thread, which takes tasks from the back
+ * of its own queue. A thread with an empty queue steals from the front of the
+ * other queues. Threads waiting for tasks to finish run other tasks meanwhile,
+ * so waiting inside a task is allowed and a pool with zero workers runs
+ * everything on the waiting thread. A task is a function pointer with a data
+ * pointer and an index, and the queues are rings that keep their memory, so
+ * queueing a task does not allocate once the rings are large enough.
+ */
+class ThreadPool
+{
+public:
+    /**
+     * @brief Function run by a task, called as function(data, index).
+     */
+    typedef void (*TaskFunction)(void *data, std::size_t index);
+
+    /**
+     * @brief Start the worker threads.
+     *
+     * @param workers number of worker threads. 0 means one less than the number
+     * of hardware threads, since the calling thread also does work.
+     */
+    explicit ThreadPool(unsigned int workers = 0);
+
+    /**
+     * @brief Stop and join all worker threads. Tasks still queued are dropped.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /**
+     * @brief Get number of threads doing work, including the calling thread.
+     */
+    unsigned int get_thread_count() const;
+
+    /**
+     * @brief Queue a task. The counter is increased now and decreased when the
+     * task is done.
+     *
+     * @param function function to run.
+     * @param data passed to function, must outlive the task.
+     * @param index passed to function.
+     * @param counter counter to wait on, must outlive the task.
+     */
+    void submit(TaskFunction function, void *data, std::size_t index, TaskCounter &counter);
+
+    /**
+     * @brief Run queued tasks until all tasks counted by counter are done. If
+     * one of them threw, the first exception is rethrown.
+     *
+     * @param counter counter to wait on.
+     */
+    void wait(TaskCounter &counter);
+
+    /**
+     * @brief Split [0, count) into chunks of chunk_size and call function once
+     * for every chunk. Returns when all chunks are done. If a chunk throws, the
+     * first exception is rethrown on the calling thread.
+     *
+     * @note Chunks run in any order and on any thread.
+     *
+     * @param count number of items.
+     * @param chunk_size number of items per chunk, the last chunk may be smaller.
+     * @param function called as function(chunk_index, begin, end).
+     */
+    void parallel_for(
+        std::size_t count,
+        std::size_t chunk_size,
+        const std::function<void(std::size_t, std::size_t, std::size_t)> &function);
+
+private:
+    struct Task
+    {
+        TaskFunction function;
+        void *data;
+        std::size_t index;
+        TaskCounter *counter;
+    };
+
+    /**
+     * @brief Task queue of one thread, a ring buffer that only grows when it
+     * is full.
+     */
+    struct Queue
+    {
+        Queue();
+
+        bool empty() const;
+        void push_back(const Task &task);
+        Task pop_back();
+        Task pop_front();
+
+        std::mutex mutex;
+        // Task i of the queue is tasks[(first + i) % tasks.size()].
+        std::vector<Task> tasks;
+        std::size_t first;
+        std::size_t count;
+    };
+
+    std::vector<std::thread> m_workers;
+    // Queue 0 is shared by threads outside the pool, worker i uses queue i + 1.
+    std::vector<std::unique_ptr<Queue>> m_queues;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::atomic<std::size_t> m_queued;
+    bool m_stop;
+
+    /**
+     * @brief Worker thread main loop.
+     *
+     * @param index index of the worker's own queue.
+     */
+    void run(std::size_t index);
+
+    /**
+     * @brief Get index of the calling thread's queue.
+     */
+    std::size_t get_queue_index() const;
+
+    /**
+     * @brief Take a task from queue index, or steal one from another queue.
+     *
+     * @return true if a task was found.
+     */
+    bool take_task(std::size_t index, Task &task);
+
+    /**
+     * @brief Run a task and update its counter.
+     */
+    void execute(Task &task);
+};
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <SFML/System.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Forward declaration
+class Context;
+
+/**
+ * @brief Id of a timer scheduled on a TimerWheel. Ids are never reused, 0 is
+ * never a valid id.
+ */
+typedef std::uint64_t TimerId;
+
+/**
+ * @brief Deadlines of a game mode, fired in the order they are due.
+ *
+ * @details Time is split into ticks. Timers due within 64 ticks are kept in
+ * 64 slots, one per tick; timers further away are kept in coarser levels of
+ * 64 slots each and are moved down a level when their slot comes up. Moving
+ * the wheel one tick only looks at the timers that fire, plus a slot of the
+ * next level every 64 ticks, so the cost of a frame does not depend on the
+ * number of timers.
+ *
+ * The wheel only moves when advance(...) is called, so timers of a paused
+ * game mode are paused too.
+ *
+ * Timers may be scheduled and cancelled from inside a callback, including the
+ * timer that is firing.
+ */
+class TimerWheel
+{
+public:
+    typedef std::function<void(Context &)> Callback;
+
+    /**
+     * @brief Create a wheel.
+     *
+     * @param resolution length of a tick. Timers fire at the first tick at or
+     * after their deadline.
+     */
+    TimerWheel(const sf::Time &resolution = sf::milliseconds(10));
+
+    TimerWheel(const TimerWheel &) = delete;
+    TimerWheel &operator=(const TimerWheel &) = delete;
+
+    /**
+     * @brief Schedule a timer.
+     *
+     * @param delay seconds from now, at least one tick.
+     * @param callback called on the thread calling advance(...).
+     * @param period if above 0, the timer fires again every period seconds
+     * until it is cancelled.
+     * @return TimerId id of the timer.
+     */
+    TimerId schedule(float delay, const Callback &callback, float period = 0.f);
+
+    /**
+     * @brief Cancel a timer.
+     *
+     * @return true if the timer was pending.
+     */
+    bool cancel(TimerId id);
+
+    /**
+     * @brief Check if a timer is pending, i.e. has not fired or is repeating.
+     */
+    bool is_pending(TimerId id) const;
+
+    /**
+     * @brief Get seconds until a timer fires, 0 if it is not pending.
+     */
+    float get_remaining(TimerId id) const;
+
+    /**
+     * @brief Move the wheel forward and fire all timers that are due.
+     *
+     * @param delta time to move forward, carried over to the next call if
+     * less than a tick.
+     * @param context[in,out] passed to the callbacks.
+     */
+    void advance(const sf::Time &delta, Context &context);
+
+    /**
+     * @brief Get seconds the wheel has moved forward, in whole ticks.
+     */
+    float get_time() const;
+
+    /**
+     * @brief Get number of pending timers.
+     */
+    std::size_t get_pending_count() const;
+
+private:
+    struct Node
+    {
+        Callback callback;
+        std::uint64_t expiry;
+        // Ticks between firings of a repeating timer, 0 if not repeating.
+        std::uint64_t period;
+        std::uint32_t generation;
+        // Neighbours in the slot, or in the free list.
+        std::int32_t prev, next;
+        // Slot the node is linked into, -1 if it is not.
+        std::int32_t slot;
+    };
+
+    sf::Time m_resolution;
+    sf::Time m_carry;
+    std::uint64_t m_now;
+    std::vector<Node> m_nodes;
+    std::int32_t m_free;
+    // First and last node of every slot, level by level.
+    std::vector<std::int32_t> m_heads;
+    std::vector<std::int32_t> m_tails;
+    std::size_t m_pending;
+
+    /**
+     * @brief Move the wheel one tick and fire the timers of the tick.
+     */
+    void tick(Context &context);
+
+    /**
+     * @brief Move all timers of a slot to the slots they belong in now.
+     */
+    void cascade(std::size_t slot);
+
+    /**
+     * @brief Get a node for a new timer.
+     */
+    std::int32_t allocate();
+
+    /**
+     * @brief Add a node to the end of the slot its expiry belongs in.
+     */
+    void link(std::int32_t index);
+
+    /**
+     * @brief Remove a node from its slot.
+     */
+    void unlink(std::int32_t index);
+
+    /**
+     * @brief Give a node back, invalidating its id.
+     */
+    void release(std::int32_t index);
+
+    /**
+     * @brief Get node of an id, -1 if the id is not pending.
+     */
+    std::int32_t find(TimerId id) const;
+
+    /**
+     * @brief Convert seconds to ticks, at least one.
+     */
+    std::uint64_t to_ticks(float seconds) const;
+};
+
+/**
+ * @brief Timer owned by an object, cancelled when the object is destroyed.
+ * Only one timer is pending at a time, starting it again replaces it.
+ *
+ * @attention the wheel must outlive the timer.
+ */
+class Timer
+{
+public:
+    Timer();
+    ~Timer();
+
+    Timer(const Timer &) = delete;
+    Timer &operator=(const Timer &) = delete;
+
+    /**
+     * @brief Schedule the timer, see TimerWheel::schedule(...). Replaces the
+     * pending timer, if any.
+     */
+    void start(TimerWheel &wheel, float delay, const TimerWheel::Callback &callback, float period = 0.f);
+
+    /**
+     * @brief Cancel the timer, if it is pending.
+     */
+    void stop();
+
+    /**
+     * @brief Check if the timer is pending.
+     */
+    bool is_running() const;
+
+    /**
+     * @brief Get seconds until the timer fires, 0 if it is not pending.
+     */
+    float get_remaining() const;
+
+private:
+    TimerWheel *m_wheel;
+    TimerId m_id;
+};
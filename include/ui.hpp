@@ -5,6 +5,8 @@
 #include <string>
 
 #include "context.hpp"
+#include "rendersnapshot.hpp"
+#include "renderbatch.hpp"
 
 /**
  * @brief Pure virtual class defining public API for a static UI element;
@@ -17,9 +19,9 @@ public:
     /**
      * @brief Render UI element. Will be called once every frame;
      *
-     * @param window window to draw on.
+     * @param snapshot snapshot to draw into.
      */
-    virtual void render(sf::RenderWindow &window) const = 0;
+    virtual void render(RenderSnapshot &snapshot) const = 0;
 };
 
 /**
@@ -32,9 +34,9 @@ public:
     /**
      * @brief Render UI element. Will be called once every frame.
      *
-     * @param window window to draw on.
+     * @param snapshot snapshot to draw into.
      */
-    virtual void render(sf::RenderWindow &window) const = 0;
+    virtual void render(RenderSnapshot &snapshot) const = 0;
 
     /**
      * @brief Update UI element. Will be called once every frame.
@@ -158,9 +160,9 @@ public:
     /**
      * @brief Render button. Will be called once every frame.
      * 
-     * @param window window to draw on.
+     * @param snapshot snapshot to draw into.
      */
-    void render(sf::RenderWindow &window) const override;
+    void render(RenderSnapshot &snapshot) const override;
 
     /**
      * @brief Update button. Will be called once every frame.
@@ -304,9 +306,17 @@ public:
     /**
      * @brief Render bar based on current- and max value.
      * 
-     * @param window window to draw on.
+     * @param snapshot snapshot to draw into.
      */
-    void render(sf::RenderWindow &window) const override;
+    void render(RenderSnapshot &snapshot) const override;
+
+    /**
+     * @brief Add bar to a batch instead of rendering it.
+     *
+     * @param batch batch to add bar to.
+     * @param layer layer of the bar in the batch.
+     */
+    void render_batched(RenderBatch &batch, unsigned int layer) const;
 
     /**
      * @brief Update bar. Will update bar size based on current- and max value.
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief What happens at a mark of a wave timeline.
+ */
+enum class WaveEventType : std::uint8_t
+{
+    // A row of enemies of one archetype.
+    Formation,
+    // One power-up, see PowerUp::create(...).
+    PowerUp,
+    // Switch to the boss.
+    Boss
+};
+
+/**
+ * @brief One event of a compiled wave timeline. Positions are in pixels
+ * along y and in fractions of the window width along x, so the same timeline
+ * fits every window.
+ */
+struct WaveEvent
+{
+    // Seconds since the timeline started.
+    float time;
+    WaveEventType type;
+    int difficulty;
+    // Enemies in the formation.
+    unsigned int count;
+    // Index into WaveCursor::get_names() of a formation, power-up type of a
+    // power-up.
+    std::uint32_t index;
+    // First enemy or power-up.
+    sf::Vector2f position;
+    // Offset from one enemy of a formation to the next.
+    sf::Vector2f step;
+};
+
+/**
+ * @brief Compiler of authored wave timelines into a binary stream of events,
+ * sorted by time and read back by WaveCursor.
+ *
+ * @details Timelines are written in the same format as the game configuration,
+ * one event per line:
+ *          // This is a comment
+ *          FORMATION=2.0,minion,1,5,0.1,-20,0.2,0;
+ *          POWERUP=10.0,repair,0.5,-20;
+ *          BOSS=45.0;
+ *
+ * Keys are:
+ *      FORMATION (time, archetype, difficulty, count, x, y, step x, step y),
+ *      POWERUP (time, type, x, y), BOSS (time)
+ *
+ * Power-up types are repair, speed, buckshot, doubleshoot, boost, score and
+ * nuke. Events may be written in any order.
+ *
+ * The binary stream starts with "WAVE", a version and the names of all
+ * archetypes, followed by the number of events and the events. All numbers
+ * are stored little endian.
+ *
+ * @note Invalid values throw std::logic_error. Unknown keys are ignored.
+ */
+class WaveTimeline
+{
+public:
+    /**
+     * @brief Compile a timeline.
+     *
+     * @param text authored timeline.
+     * @param binary stream to write the compiled timeline to.
+     * @return std::size_t number of events.
+     */
+    static std::size_t compile(std::istream &text, std::ostream &binary);
+
+    /**
+     * @brief Compile a timeline file. Throws std::logic_error if a file
+     * cannot be opened.
+     *
+     * @param text_path path to authored timeline.
+     * @param binary_path path to write the compiled timeline to.
+     * @return std::size_t number of events.
+     */
+    static std::size_t compile(const std::string &text_path, const std::string &binary_path);
+
+    /**
+     * @brief Get index of a power-up type by name. Throws std::logic_error if
+     * there is no such type.
+     */
+    static std::uint32_t find_powerup(const std::string &name);
+};
+
+/**
+ * @brief Reader of a compiled wave timeline. Events are read from the stream
+ * a chunk at a time, so only one chunk of a long timeline is in memory.
+ *
+ * @details Every tick, poll(...) is called until it returns false. Each call
+ * only looks at the next event, so a tick costs the number of events due.
+ */
+class WaveCursor
+{
+public:
+    /**
+     * @brief Open a compiled timeline file. Throws std::logic_error if the
+     * file cannot be opened or is not a compiled timeline.
+     *
+     * @param path path to compiled timeline.
+     */
+    WaveCursor(const std::string &path);
+
+    /**
+     * @brief Read a compiled timeline from a stream. Throws std::logic_error
+     * if the stream is not a compiled timeline.
+     *
+     * @param stream stream positioned at the start of the timeline.
+     */
+    WaveCursor(std::unique_ptr<std::istream> stream);
+
+    /**
+     * @brief Get the next event if it is due.
+     *
+     * @param time seconds since the timeline started.
+     * @param event[out] next event, set if true is returned.
+     * @return true if an event was due, and the cursor moved past it.
+     */
+    bool poll(float time, WaveEvent &event);
+
+    /**
+     * @brief Check if all events have been polled.
+     */
+    bool is_done() const;
+
+    /**
+     * @brief Get the archetype names used by the formations.
+     */
+    const std::vector<std::string> &get_names() const;
+
+    /**
+     * @brief Get the total number of events.
+     */
+    std::size_t get_event_count() const;
+
+private:
+    // Events read from the stream at a time.
+    static const std::size_t s_chunk_size;
+
+    std::unique_ptr<std::istream> m_stream;
+    std::vector<std::string> m_names;
+    std::size_t m_event_count;
+    // Events read so far.
+    std::size_t m_events_read;
+    std::vector<WaveEvent> m_chunk;
+    std::size_t m_next;
+
+    /**
+     * @brief Read the header of the timeline.
+     */
+    void read_header();
+
+    /**
+     * @brief Replace the chunk with the next events of the stream.
+     */
+    void read_chunk();
+};
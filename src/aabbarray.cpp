@@ -0,0 +1,144 @@
+#include "aabbarray.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    // Stored for empty boxes, fails every comparison in the overlap test.
+    const float s_empty_min{std::numeric_limits<float>::infinity()};
+    const float s_empty_max{-std::numeric_limits<float>::infinity()};
+
+    /**
+     * @brief Add begin + k for every bit k set in mask.
+     */
+    void add_mask(int mask, std::size_t begin, std::vector<std::size_t> &found)
+    {
+        for (std::size_t k{0}; mask != 0; k++, mask >>= 1)
+        {
+            if (mask & 1)
+                found.push_back(begin + k);
+        }
+    }
+}
+
+AabbArray::AabbArray()
+    : m_min_x{},
+      m_min_y{},
+      m_max_x{},
+      m_max_y{}
+{
+}
+
+void AabbArray::resize(std::size_t count)
+{
+    m_min_x.resize(count, s_empty_min);
+    m_min_y.resize(count, s_empty_min);
+    m_max_x.resize(count, s_empty_max);
+    m_max_y.resize(count, s_empty_max);
+}
+
+void AabbArray::set(std::size_t index, const sf::FloatRect &bounds)
+{
+    float right{bounds.left + bounds.width};
+    float bottom{bounds.top + bounds.height};
+    float min_x{std::min(bounds.left, right)};
+    float max_x{std::max(bounds.left, right)};
+    float min_y{std::min(bounds.top, bottom)};
+    float max_y{std::max(bounds.top, bottom)};
+    if (!(min_x < max_x) || !(min_y < max_y))
+    {
+        min_x = min_y = s_empty_min;
+        max_x = max_y = s_empty_max;
+    }
+    m_min_x[index] = min_x;
+    m_min_y[index] = min_y;
+    m_max_x[index] = max_x;
+    m_max_y[index] = max_y;
+}
+
+std::size_t AabbArray::get_size() const
+{
+    return m_min_x.size();
+}
+
+bool AabbArray::overlaps(std::size_t first, std::size_t second) const
+{
+    return m_min_x[first] < m_max_x[second] && m_min_x[second] < m_max_x[first] &&
+           m_min_y[first] < m_max_y[second] && m_min_y[second] < m_max_y[first];
+}
+
+void AabbArray::find_overlaps(std::size_t index, std::size_t begin, std::size_t end,
+                              std::vector<std::size_t> &found) const
+{
+    const float *min_x{m_min_x.data()};
+    const float *min_y{m_min_y.data()};
+    const float *max_x{m_max_x.data()};
+    const float *max_y{m_max_y.data()};
+    std::size_t i{begin};
+
+#if defined(__AVX__)
+    const __m256 box_min_x{_mm256_set1_ps(min_x[index])};
+    const __m256 box_min_y{_mm256_set1_ps(min_y[index])};
+    const __m256 box_max_x{_mm256_set1_ps(max_x[index])};
+    const __m256 box_max_y{_mm256_set1_ps(max_y[index])};
+    for (; i + 8 <= end; i += 8)
+    {
+        __m256 x{_mm256_and_ps(
+            _mm256_cmp_ps(box_min_x, _mm256_loadu_ps(max_x + i), _CMP_LT_OQ),
+            _mm256_cmp_ps(_mm256_loadu_ps(min_x + i), box_max_x, _CMP_LT_OQ))};
+        __m256 y{_mm256_and_ps(
+            _mm256_cmp_ps(box_min_y, _mm256_loadu_ps(max_y + i), _CMP_LT_OQ),
+            _mm256_cmp_ps(_mm256_loadu_ps(min_y + i), box_max_y, _CMP_LT_OQ))};
+        int mask{_mm256_movemask_ps(_mm256_and_ps(x, y))};
+        if (mask != 0)
+            add_mask(mask, i, found);
+    }
+#elif defined(__SSE2__)
+    const __m128 box_min_x{_mm_set1_ps(min_x[index])};
+    const __m128 box_min_y{_mm_set1_ps(min_y[index])};
+    const __m128 box_max_x{_mm_set1_ps(max_x[index])};
+    const __m128 box_max_y{_mm_set1_ps(max_y[index])};
+    for (; i + 4 <= end; i += 4)
+    {
+        __m128 x{_mm_and_ps(_mm_cmplt_ps(box_min_x, _mm_loadu_ps(max_x + i)),
+                            _mm_cmplt_ps(_mm_loadu_ps(min_x + i), box_max_x))};
+        __m128 y{_mm_and_ps(_mm_cmplt_ps(box_min_y, _mm_loadu_ps(max_y + i)),
+                            _mm_cmplt_ps(_mm_loadu_ps(min_y + i), box_max_y))};
+        int mask{_mm_movemask_ps(_mm_and_ps(x, y))};
+        if (mask != 0)
+            add_mask(mask, i, found);
+    }
+#endif
+
+    // Remaining boxes, or all of them without SIMD.
+    if (i < end)
+        find_overlaps_scalar(index, i, end, found);
+}
+
+void AabbArray::find_overlaps_scalar(std::size_t index, std::size_t begin, std::size_t end,
+                                     std::vector<std::size_t> &found) const
+{
+    for (std::size_t i{begin}; i < end; i++)
+    {
+        if (overlaps(index, i))
+            found.push_back(i);
+    }
+}
+
+const char *AabbArray::get_kernel_name()
+{
+#if defined(__AVX__)
+    return "avx";
+#elif defined(__SSE2__)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,272 @@
+#include "archetypes.hpp"
+#include "entityobject.hpp"
+#include "gameconfiguration.hpp"
+#include "resourcemanager.hpp"
+
+#define _USE_MATH_DEFINES
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+/*==============================EnemyArchetype================================*/
+
+EnemyArchetype::EnemyArchetype()
+    : name{},
+      texture{"assets/images/enemy/enemy.png"},
+      health{1.f},
+      speed{1.f},
+      attack_cooldown{1.f},
+      projectile_prob{1.f},
+      powerup_prob{1.f},
+      pattern{AttackPattern::Down},
+      direction{0.f, 1.f},
+      bounce{false},
+      difficulties{DifficultyModifier{1.f, 1.f}, DifficultyModifier{1.f, 1.f}, DifficultyModifier{1.f, 1.f}}
+{
+}
+
+bool EnemyArchetype::set_value(const std::string &key, const std::string &value)
+{
+    std::stringstream ss{value};
+    if (key == "TEXTURE")
+    {
+        texture = value;
+        return true;
+    }
+    else if (key == "HEALTH")
+    {
+        if (!(ss >> health))
+            throw std::logic_error("HEALTH value is not a valid float.");
+        return true;
+    }
+    else if (key == "SPEED")
+    {
+        if (!(ss >> speed))
+            throw std::logic_error("SPEED value is not a valid float.");
+        return true;
+    }
+    else if (key == "ATTACK_COOLDOWN")
+    {
+        if (!(ss >> attack_cooldown))
+            throw std::logic_error("ATTACK_COOLDOWN value is not a valid float.");
+        return true;
+    }
+    else if (key == "PROJECTILE_PROB")
+    {
+        if (!(ss >> projectile_prob))
+            throw std::logic_error("PROJECTILE_PROB value is not a valid float.");
+        return true;
+    }
+    else if (key == "POWERUP_PROB")
+    {
+        if (!(ss >> powerup_prob))
+            throw std::logic_error("POWERUP_PROB value is not a valid float.");
+        return true;
+    }
+    else if (key == "PATTERN")
+    {
+        if (value == "NONE")
+            pattern = AttackPattern::None;
+        else if (value == "DOWN")
+            pattern = AttackPattern::Down;
+        else if (value == "CROSS")
+            pattern = AttackPattern::Cross;
+        else if (value == "TURN")
+            pattern = AttackPattern::Turn;
+        else
+            throw std::logic_error("PATTERN value is not NONE, DOWN, CROSS or TURN.");
+        return true;
+    }
+    else if (key == "DIRECTION_X")
+    {
+        if (!(ss >> direction.x))
+            throw std::logic_error("DIRECTION_X value is not a valid float.");
+        return true;
+    }
+    else if (key == "DIRECTION_Y")
+    {
+        if (!(ss >> direction.y))
+            throw std::logic_error("DIRECTION_Y value is not a valid float.");
+        return true;
+    }
+    else if (key == "BOUNCE")
+    {
+        if (!(ss >> bounce))
+            throw std::logic_error("BOUNCE value is not 0 or 1.");
+        return true;
+    }
+    for (std::size_t i{0}; i < difficulties.size(); i++)
+    {
+        std::string suffix{"_" + std::to_string(i + 1)};
+        if (key == "HEALTH" + suffix)
+        {
+            if (!(ss >> difficulties[i].health))
+                throw std::logic_error(key + " value is not a valid float.");
+            return true;
+        }
+        else if (key == "SPEED" + suffix)
+        {
+            if (!(ss >> difficulties[i].speed))
+                throw std::logic_error(key + " value is not a valid float.");
+            return true;
+        }
+    }
+    return false;
+}
+
+/*==============================ArchetypeTable================================*/
+
+ArchetypeTable::ArchetypeTable()
+    : m_archetypes{}
+{
+}
+
+ArchetypeTable ArchetypeTable::defaults()
+{
+    ArchetypeTable table{};
+
+    // Flies straight down and shoots down.
+    EnemyArchetype minion{};
+    minion.name = "minion";
+    minion.difficulties[1].health = 2.f;
+    minion.difficulties[2] = DifficultyModifier{3.f, 1.5f};
+    table.add(minion);
+
+    // Flies diagonally and turns around instead of shooting.
+    EnemyArchetype mover{};
+    mover.name = "mover";
+    mover.texture = "assets/images/enemy/enemy_mover.png";
+    mover.attack_cooldown = 0.5f;
+    mover.powerup_prob = 2.f;
+    mover.pattern = AttackPattern::Turn;
+    mover.direction = sf::Vector2f{static_cast<float>(1 / M_SQRT1_2), static_cast<float>(1 / M_SQRT2)};
+    mover.bounce = true;
+    mover.difficulties[1].speed = 2.f;
+    mover.difficulties[2] = DifficultyModifier{2.f, 3.f};
+    table.add(mover);
+
+    // Slow with a lot of health.
+    EnemyArchetype tank{};
+    tank.name = "tank";
+    tank.texture = "assets/images/enemy/Tank.png";
+    tank.health = 5.f;
+    tank.speed = 0.4f;
+    tank.attack_cooldown = 2.f;
+    tank.projectile_prob = 0.5f;
+    tank.powerup_prob = 3.f;
+    tank.difficulties[0].health = 1.5f;
+    tank.difficulties[1].health = 2.f;
+    tank.difficulties[2].speed = 1.5f;
+    table.add(tank);
+
+    // Shoots in all four directions at once.
+    EnemyArchetype multishot{};
+    multishot.name = "multishot";
+    multishot.attack_cooldown = 2.f;
+    multishot.powerup_prob = 2.f;
+    multishot.pattern = AttackPattern::Cross;
+    table.add(multishot);
+
+    return table;
+}
+
+ArchetypeTable ArchetypeTable::from_file(const std::string &path)
+{
+    std::ifstream file{path};
+    if (!file.is_open())
+        throw std::logic_error("ArchetypeTableERROR: could not open " + path + ".");
+
+    ArchetypeTable table{};
+    EnemyArchetype archetype{};
+    std::string line{}, key{}, value{};
+    while (std::getline(file, line))
+    {
+        if (line.rfind("//", 0) == 0 || line.empty())
+            continue;
+        std::stringstream ss{line};
+        std::getline(ss, key, '=');
+        std::getline(ss, value, ';');
+        if (key == "ARCHETYPE")
+        {
+            if (!archetype.name.empty())
+                table.add(archetype);
+            archetype = EnemyArchetype{};
+            archetype.name = value;
+        }
+        else if (archetype.name.empty())
+        {
+            throw std::logic_error("ArchetypeTableERROR: " + key + " is not part of an archetype.");
+        }
+        else
+        {
+            archetype.set_value(key, value);
+        }
+    }
+    if (!archetype.name.empty())
+        table.add(archetype);
+    return table;
+}
+
+std::size_t ArchetypeTable::add(const EnemyArchetype &archetype)
+{
+    for (std::size_t id{0}; id < m_archetypes.size(); id++)
+    {
+        if (m_archetypes[id].name == archetype.name)
+        {
+            m_archetypes[id] = archetype;
+            return id;
+        }
+    }
+    m_archetypes.push_back(archetype);
+    return m_archetypes.size() - 1;
+}
+
+std::size_t ArchetypeTable::find(const std::string &name) const
+{
+    for (std::size_t id{0}; id < m_archetypes.size(); id++)
+    {
+        if (m_archetypes[id].name == name)
+            return id;
+    }
+    throw std::logic_error("ArchetypeTableERROR: no archetype named " + name + ".");
+}
+
+const EnemyArchetype &ArchetypeTable::get(std::size_t id) const
+{
+    return m_archetypes.at(id);
+}
+
+std::size_t ArchetypeTable::get_size() const
+{
+    return m_archetypes.size();
+}
+
+GameObject *ArchetypeTable::create(EntityWorld &world, const EnemyMinionData &data, std::size_t id,
+                                   float x, float y, int difficulty) const
+{
+    const EnemyArchetype &archetype{get(id)};
+    const DifficultyModifier &modifier{archetype.difficulties[std::clamp(difficulty, 1, 3) - 1]};
+    const sf::Texture &image{ResourceManager::load_texture(archetype.texture)};
+    sf::Vector2u texture_size{image.getSize()};
+    sf::Vector2f origin{texture_size.x / 2.f, texture_size.y / 2.f};
+    int health{static_cast<int>(data.base_health * archetype.health * modifier.health)};
+
+    EntityDesc desc{Transform{sf::Vector2f{x, y}},
+                    Velocity{archetype.direction, data.base_speed * archetype.speed * modifier.speed,
+                             archetype.bounce},
+                    Collider{sf::FloatRect{-origin.x, -origin.y, static_cast<float>(texture_size.x),
+                                           static_cast<float>(texture_size.y)},
+                             ResourceManager::get_mask(image)},
+                    Health{health, health},
+                    WeaponCooldown{data.base_attack_cooldown * archetype.attack_cooldown, 0,
+                                   data.base_projectile_prob * archetype.projectile_prob,
+                                   data.base_projectile_speed, archetype.pattern},
+                    SpriteRef{&image,
+                              sf::IntRect{0, 0, static_cast<int>(texture_size.x), static_cast<int>(texture_size.y)},
+                              origin, texture_size.y / 2.f + 10.f},
+                    Loot{data.base_powerup_prob * archetype.powerup_prob, data.base_speed * 0.5f, 100},
+                    Faction::Enemy};
+    return new EntityObject{world, desc};
+}
@@ -9,15 +9,15 @@
 #include "bossmode.hpp"
 #include "endscreen.hpp"
 
-#include <sstream>
 #include <random>
+#include <cmath>
 
 BossMode::BossMode(GameMode *previous_state, Player *current_player,
                    unsigned int boss_level, unsigned int player_level)
     : GameMode{{current_player}, current_player},
-      m_boss{nullptr},
+      m_boss{},
       m_to_normal{false},
-      m_to_normal_time{},
+      m_to_normal_timer{},
       m_time{5.f},
       m_previous_state{previous_state},
       m_scoreboard{},
@@ -29,6 +29,9 @@ BossMode::BossMode(GameMode *previous_state, Player *current_player,
       m_boss_level{boss_level},
       m_player_level{player_level}
 {
+    // Published once the boss is dead, before it is deleted.
+    GameMode::get_events().subscribe<BossDefeated>([this](const BossDefeated &)
+                                                   { start_to_normal_timer(); });
 }
 
 BossMode::~BossMode()
@@ -37,69 +40,67 @@ BossMode::~BossMode()
     delete m_previous_state;
 }
 
-void BossMode::render(sf::RenderWindow &window) const
+void BossMode::render(RenderSnapshot &snapshot) const
 {
-    GameMode::render(window);
-    window.draw(m_scoreboard);
-    render_texts(window);
+    GameMode::render(snapshot);
+    snapshot.draw(m_scoreboard);
+    render_texts(snapshot);
 }
-void BossMode::render_texts(sf::RenderWindow &window) const
+void BossMode::render_texts(RenderSnapshot &snapshot) const
 {
-    window.draw(m_level_number_text);
-    window.draw(m_player_score_text);
-    window.draw(m_player_health_text);
+    snapshot.draw(m_level_number_text);
+    snapshot.draw(m_player_score_text);
+    snapshot.draw(m_player_health_text);
 }
 
 void BossMode::update(Context &context)
 {
-    update_texts();
     GameMode::update(context);
-
-    Player *player = GameMode::get_player();
-    if (player == nullptr)
-    {
-        return;
-    }
-
-    if (m_boss->is_removed() && !m_to_normal)
-    {
-        m_to_normal = true;
-        m_to_normal_time = m_clock.getElapsedTime();
-    }
-    else if (m_to_normal)
-    {
-        to_normal(context);
-    }
+    // A boss removed without being defeated still ends the fight.
+    if (!m_boss.is_null() && GameMode::get_object(m_boss) == nullptr)
+        start_to_normal_timer();
 }
 
-void BossMode::update_texts()
+void BossMode::update_texts(const HudData &hud, FrameArena &arena)
 {
+    // Strings are built in the frame arena, and texts are only set when they
+    // change.
     {
-        std::stringstream ss{};
-        ss << m_player_level;
-        m_level_number_text.setString(ss.str());
-
-        float text_width{m_level_number_text.getLocalBounds().width};
-        float text_height{m_level_number_text.getLocalBounds().height};
-        m_level_number_text.setOrigin({text_width / 2.f, text_height});
+        FrameString string{arena};
+        append_format(string, "%u", m_player_level);
+        if (GameMode::set_text(m_level_number_text, string))
+        {
+            float text_width{m_level_number_text.getLocalBounds().width};
+            float text_height{m_level_number_text.getLocalBounds().height};
+            m_level_number_text.setOrigin({text_width / 2.f, text_height});
+        }
     }
 
     // Player related information.
-    Player *player = GameMode::get_player();
-    if (player == nullptr)
+    if (!hud.has_player)
         return;
     {
-        std::stringstream ss{};
-        ss << player->get_score();
-        m_player_score_text.setString(ss.str());
-        float text_width{m_player_score_text.getLocalBounds().width};
-        float text_height{m_player_score_text.getLocalBounds().height};
-        m_player_score_text.setOrigin({text_width / 2.f, text_height});
+        FrameString string{arena};
+        append_format(string, "%d", hud.score);
+        if (GameMode::set_text(m_player_score_text, string))
+        {
+            float text_width{m_player_score_text.getLocalBounds().width};
+            float text_height{m_player_score_text.getLocalBounds().height};
+            m_player_score_text.setOrigin({text_width / 2.f, text_height});
+        }
     }
     {
-        std::stringstream ss{};
-        ss << "Health - " << player->get_health();
-        m_player_health_text.setString(ss.str());
+        FrameString string{arena};
+        append_format(string, "Health - %d", hud.health);
+        for (std::size_t i{0}; i < hud.effect_count; i++)
+        {
+            const EffectStatus &effect{hud.effects[i]};
+            append_format(string, "\n%s", EffectStack::get_name(effect.type));
+            if (effect.stacks > 1)
+                append_format(string, " x%u", effect.stacks);
+            append_format(string, " - %ds", static_cast<int>(std::ceil(effect.remaining)));
+        }
+        GameMode::set_text(m_player_health_text, string);
     }
 }
 
@@ -112,9 +113,7 @@ void BossMode::init(const GameConfiguration &gc)
 {
     if (m_paused)
     {
-        // Adjust the time to normal to account for the time paused.
-        sf::Time time_paused = m_clock.getElapsedTime() - m_pause_time;
-        m_to_normal_time += time_paused;
+        // The timers stand still while paused, only the music is resumed.
         GameMode::play_music();
         return;
     }
@@ -135,21 +134,27 @@ void BossMode::init(const GameConfiguration &gc)
     }
 
 
+    GameObject *boss{nullptr};
     if (m_boss_level == 1)
     {
-        m_boss = new EnemyBoss{data.boss_data, pos.x, pos.y, 1};
+        boss = new EnemyBoss{data.boss_data, pos.x, pos.y, 1};
     }
     else if (m_boss_level == 2)
     {
-        m_boss = new EnemyBoss2{data.boss_data, pos.x, pos.y + 70, 1};
+        boss = new EnemyBoss2{data.boss_data, pos.x, pos.y + 70, 1};
     }
 
-    GameMode::spawn_object(m_boss);
+    m_boss = GameMode::spawn_object(boss);
     GameMode::set_background("assets/images/background.png", gc.get_window_size());
     GameMode::set_music("assets/sounds/boss_music.ogg", gc.get_data().music_volume);
     GameMode::play_music();
 }
 
+unsigned int BossMode::get_level() const
+{
+    return m_player_level;
+}
+
 void BossMode::init_texts()
 {
     m_level_number_text.setPosition(26.f, 39.f);
@@ -162,11 +167,17 @@ void BossMode::init_texts()
     m_player_health_text.setFillColor(sf::Color::White);
 }
 
+void BossMode::start_to_normal_timer()
+{
+    if (m_to_normal)
+        return;
+    m_to_normal = true;
+    m_to_normal_timer.start(GameMode::get_timers(), m_time, [this](Context &context)
+                            { to_normal(context); });
+}
+
 void BossMode::to_normal(Context &context)
 {
-    if ((m_clock.getElapsedTime() - m_to_normal_time).asSeconds() > m_time)
-    {
-        context.set_next_state(m_previous_state);
-        m_previous_state = nullptr;
-    }
+    context.set_next_state(m_previous_state);
+    m_previous_state = nullptr;
 }
\ No newline at end of file
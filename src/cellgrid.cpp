@@ -0,0 +1,168 @@
+#include "cellgrid.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+/*==================================CellBox===================================*/
+
+CellBox CellBox::empty()
+{
+    float infinity{std::numeric_limits<float>::infinity()};
+    return CellBox{infinity, infinity, -infinity, -infinity};
+}
+
+/*==================================CellGrid==================================*/
+
+const std::size_t *CellGrid::Cell::begin() const
+{
+    return first;
+}
+
+const std::size_t *CellGrid::Cell::end() const
+{
+    return last;
+}
+
+CellGrid::CellGrid(float cell_size, float max_cells)
+    : m_default_cell_size{cell_size},
+      m_max_cells{max_cells},
+      m_cell_size{cell_size},
+      m_origin{},
+      m_columns{0},
+      m_rows{0},
+      m_cell_start(1, 0),
+      m_cell_boxes{}
+{
+    if (!(cell_size > 0.f))
+        throw std::logic_error("CellGridERROR: cell size must be positive.");
+}
+
+void CellGrid::build(const std::vector<CellBox> &boxes)
+{
+    float infinity{std::numeric_limits<float>::infinity()};
+    float min_x{infinity}, min_y{infinity};
+    float max_x{-infinity}, max_y{-infinity};
+    for (const CellBox &box : boxes)
+    {
+        if (box.min_x > box.max_x)
+            continue;
+        min_x = std::min(min_x, box.min_x);
+        min_y = std::min(min_y, box.min_y);
+        max_x = std::max(max_x, box.max_x);
+        max_y = std::max(max_y, box.max_y);
+    }
+
+    m_cell_boxes.clear();
+    if (min_x > max_x)
+    {
+        m_columns = 0;
+        m_rows = 0;
+        m_cell_start.assign(1, 0);
+        return;
+    }
+
+    m_cell_size = m_default_cell_size;
+    while ((max_x - min_x) / m_cell_size > m_max_cells || (max_y - min_y) / m_cell_size > m_max_cells)
+    {
+        m_cell_size *= 2.f;
+    }
+    m_origin = sf::Vector2f{min_x, min_y};
+    m_columns = get_column(max_x) + 1;
+    m_rows = get_row(max_y) + 1;
+
+    // Counting sort of the boxes into the cells they cover. First count every
+    // cell, then turn the counts into start indices and fill.
+    std::size_t cell_count{static_cast<std::size_t>(m_columns) * m_rows};
+    m_cell_start.assign(cell_count + 1, 0);
+    for (const CellBox &box : boxes)
+    {
+        if (box.min_x > box.max_x)
+            continue;
+        for (int row{get_row(box.min_y)}; row <= get_row(box.max_y); row++)
+        {
+            for (int column{get_column(box.min_x)}; column <= get_column(box.max_x); column++)
+            {
+                m_cell_start[row * m_columns + column]++;
+            }
+        }
+    }
+    std::size_t total{0};
+    for (std::size_t &start : m_cell_start)
+    {
+        std::size_t count{start};
+        start = total;
+        total += count;
+    }
+    m_cell_boxes.resize(total);
+    for (std::size_t i{0}; i < boxes.size(); i++)
+    {
+        const CellBox &box{boxes[i]};
+        if (box.min_x > box.max_x)
+            continue;
+        for (int row{get_row(box.min_y)}; row <= get_row(box.max_y); row++)
+        {
+            for (int column{get_column(box.min_x)}; column <= get_column(box.max_x); column++)
+            {
+                m_cell_boxes[m_cell_start[row * m_columns + column]++] = i;
+            }
+        }
+    }
+    // Filling moved every start to the start of the next cell.
+    for (std::size_t cell{cell_count}; cell > 0; cell--)
+    {
+        m_cell_start[cell] = m_cell_start[cell - 1];
+    }
+    m_cell_start[0] = 0;
+}
+
+void CellGrid::clear()
+{
+    m_cell_boxes.clear();
+    m_cell_start.assign(1, 0);
+    m_columns = 0;
+    m_rows = 0;
+}
+
+int CellGrid::get_column(float x) const
+{
+    return static_cast<int>(std::floor((x - m_origin.x) / m_cell_size));
+}
+
+int CellGrid::get_row(float y) const
+{
+    return static_cast<int>(std::floor((y - m_origin.y) / m_cell_size));
+}
+
+int CellGrid::get_columns() const
+{
+    return m_columns;
+}
+
+int CellGrid::get_rows() const
+{
+    return m_rows;
+}
+
+float CellGrid::get_cell_size() const
+{
+    return m_cell_size;
+}
+
+const sf::Vector2f &CellGrid::get_origin() const
+{
+    return m_origin;
+}
+
+CellGrid::Cell CellGrid::get_cell(int column, int row) const
+{
+    std::size_t cell{static_cast<std::size_t>(row) * m_columns + column};
+    return Cell{m_cell_boxes.data() + m_cell_start[cell], m_cell_boxes.data() + m_cell_start[cell + 1]};
+}
+
+bool CellGrid::is_first_cell(const CellBox &box, int column, int row, int first_column, int first_row) const
+{
+    return column == std::max(get_column(box.min_x), first_column) &&
+           row == std::max(get_row(box.min_y), first_row);
+}
@@ -0,0 +1,85 @@
+#include "collisionmask.hpp"
+
+#include <bitset>
+
+namespace
+{
+    const std::size_t s_word_bits{64};
+}
+
+CollisionMask::CollisionMask()
+    : m_width{0},
+      m_height{0},
+      m_row_words{0},
+      m_bits{}
+{
+}
+
+CollisionMask::CollisionMask(const sf::Image &image, sf::Uint8 alpha_threshold)
+    : m_width{image.getSize().x},
+      m_height{image.getSize().y},
+      m_row_words{(image.getSize().x + s_word_bits - 1) / s_word_bits},
+      m_bits(m_row_words * m_height, 0)
+{
+    const sf::Uint8 *pixels{image.getPixelsPtr()};
+    if (pixels == nullptr)
+        return;
+    for (unsigned y{0}; y < m_height; y++)
+    {
+        std::uint64_t *row{m_bits.data() + y * m_row_words};
+        for (unsigned x{0}; x < m_width; x++)
+        {
+            // RGBA, alpha is the fourth byte.
+            if (pixels[(static_cast<std::size_t>(y) * m_width + x) * 4 + 3] >= alpha_threshold)
+                row[x / s_word_bits] |= std::uint64_t{1} << (x % s_word_bits);
+        }
+    }
+}
+
+unsigned CollisionMask::get_width() const
+{
+    return m_width;
+}
+
+unsigned CollisionMask::get_height() const
+{
+    return m_height;
+}
+
+bool CollisionMask::get(int x, int y) const
+{
+    if (x < 0 || y < 0 || x >= static_cast<int>(m_width) || y >= static_cast<int>(m_height))
+        return false;
+    return (m_bits[y * m_row_words + x / s_word_bits] >> (x % s_word_bits)) & 1;
+}
+
+std::uint64_t CollisionMask::get_row_bits(int x, int y) const
+{
+    // Floor division, x may be negative.
+    long word{x >= 0 ? x / 64L : -((63L - x) / 64L)};
+    unsigned shift{static_cast<unsigned>(x - word * 64L)};
+    std::uint64_t bits{get_word(word, y) >> shift};
+    if (shift != 0)
+        bits |= get_word(word + 1, y) << (s_word_bits - shift);
+    return bits;
+}
+
+std::size_t CollisionMask::get_count() const
+{
+    std::size_t count{0};
+    for (std::uint64_t word : m_bits)
+    {
+        count += std::bitset<64>{word}.count();
+    }
+    return count;
+}
+
+std::uint64_t CollisionMask::get_word(long word, int y) const
+{
+    if (word < 0 || y < 0 || word >= static_cast<long>(m_row_words) ||
+        y >= static_cast<int>(m_height))
+    {
+        return 0;
+    }
+    return m_bits[y * m_row_words + word];
+}
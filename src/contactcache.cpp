@@ -0,0 +1,108 @@
+#include "contactcache.hpp"
+#include "gameobject.hpp"
+
+#include <functional>
+
+ContactCache::ContactCache()
+    : m_frames{},
+      m_contacts{},
+      m_next_contacts{},
+      m_frame{0}
+{
+}
+
+void ContactCache::update(const std::vector<std::pair<GameObject *, GameObject *>> &pairs,
+                          std::vector<ContactEvent> &events)
+{
+    m_frame++;
+    m_next_contacts.clear();
+    for (const std::pair<GameObject *, GameObject *> &pair : pairs)
+    {
+        auto result = m_frames.try_emplace(make_key(pair.first, pair.second), m_frame);
+        if (result.second)
+        {
+            events.push_back(ContactEvent{ContactEvent::Type::Enter, pair.first, pair.second});
+        }
+        else
+        {
+            result.first->second = m_frame;
+            events.push_back(ContactEvent{ContactEvent::Type::Stay, pair.first, pair.second});
+        }
+        m_next_contacts.push_back(pair);
+    }
+
+    // Contacts not seen this frame have ended.
+    for (const std::pair<GameObject *, GameObject *> &contact : m_contacts)
+    {
+        auto it = m_frames.find(make_key(contact.first, contact.second));
+        if (it->second != m_frame)
+        {
+            events.push_back(ContactEvent{ContactEvent::Type::Exit, contact.first, contact.second});
+            m_frames.erase(it);
+        }
+    }
+    std::swap(m_contacts, m_next_contacts);
+}
+
+void ContactCache::remove_removed_objects(std::vector<ContactEvent> &events)
+{
+    std::size_t kept{0};
+    for (std::size_t i{0}; i < m_contacts.size(); i++)
+    {
+        std::pair<GameObject *, GameObject *> contact{m_contacts[i]};
+        if (contact.first->is_removed() || contact.second->is_removed())
+        {
+            events.push_back(ContactEvent{ContactEvent::Type::Exit, contact.first, contact.second});
+            m_frames.erase(make_key(contact.first, contact.second));
+        }
+        else
+        {
+            m_contacts[kept++] = contact;
+        }
+    }
+    m_contacts.resize(kept);
+}
+
+void ContactCache::forget(const GameObject *object)
+{
+    std::size_t kept{0};
+    for (std::size_t i{0}; i < m_contacts.size(); i++)
+    {
+        std::pair<GameObject *, GameObject *> contact{m_contacts[i]};
+        if (contact.first == object || contact.second == object)
+            m_frames.erase(make_key(contact.first, contact.second));
+        else
+            m_contacts[kept++] = contact;
+    }
+    m_contacts.resize(kept);
+}
+
+bool ContactCache::has_contact(const GameObject *first, const GameObject *second) const
+{
+    return m_frames.count(make_key(first, second)) != 0;
+}
+
+std::size_t ContactCache::get_contact_count() const
+{
+    return m_contacts.size();
+}
+
+void ContactCache::clear()
+{
+    m_frames.clear();
+    m_contacts.clear();
+}
+
+std::size_t ContactCache::KeyHash::operator()(const Key &key) const
+{
+    std::size_t first{std::hash<const GameObject *>{}(key.first)};
+    std::size_t second{std::hash<const GameObject *>{}(key.second)};
+    return first ^ (second + 0x9e3779b9 + (first << 6) + (first >> 2));
+}
+
+ContactCache::Key ContactCache::make_key(const GameObject *first, const GameObject *second)
+{
+    if (std::less<const GameObject *>{}(second, first))
+        return Key{second, first};
+    return Key{first, second};
+}
@@ -1,14 +1,38 @@
 #include "context.hpp"
+#include "spatialgrid.hpp"
 #include <utility>
 #include <sstream>
 
+namespace
+{
+    // Set while a thread updates its share of objects in parallel.
+    thread_local SpawnBuffer *t_spawn_buffer{nullptr};
+}
+
+/*================================SpawnBuffer=================================*/
+
+SpawnBuffer::SpawnBuffer()
+    : objects{},
+      projectiles{},
+      area_effects{},
+      events{}
+{
+}
+
+/*==================================Context===================================*/
+
 Context::Context(const sf::Time &delta, const sf::RenderWindow &window)
     : m_delta{delta},
       m_next_state{nullptr}, 
       m_new_objects{},
+      m_new_projectiles{},
+      m_new_area_effects{},
       m_window{window}, 
       m_quit{false}, 
-      m_player{nullptr}
+      m_thread_pool{nullptr},
+      m_spatial_grid{nullptr},
+      m_event_bus{nullptr},
+      m_frame_arena{}
 {
     m_new_objects.reserve(100);
 }
@@ -25,6 +49,16 @@ Context::~Context() noexcept(false)
     }
 }
 
+void Context::end_frame()
+{
+    m_next_state = nullptr;
+    // Both belong to the state that was updated, which is deleted before the
+    // next frame if the state changes.
+    m_spatial_grid = nullptr;
+    m_event_bus = nullptr;
+    m_frame_arena.reset();
+}
+
 void Context::set_delta(const sf::Time &delta)
 {
     m_delta = delta;
@@ -42,12 +76,62 @@ bool Context::set_next_state(GameState *next_state)
 
 void Context::spawn_object(GameObject *object)
 {
-    m_new_objects.push_back(object);
+    if (t_spawn_buffer != nullptr)
+        t_spawn_buffer->objects.push_back(object);
+    else
+        m_new_objects.push_back(object);
+}
+
+void Context::spawn_projectile(float x, float y, float angle, float v, bool friendly, int damage)
+{
+    ProjectileSpawn projectile{x, y, angle, v, friendly, damage};
+    if (t_spawn_buffer != nullptr)
+        t_spawn_buffer->projectiles.push_back(projectile);
+    else
+        m_new_projectiles.push_back(projectile);
+}
+
+void Context::spawn_area_effect(const AreaEffect &effect)
+{
+    if (t_spawn_buffer != nullptr)
+        t_spawn_buffer->area_effects.push_back(effect);
+    else
+        m_new_area_effects.push_back(effect);
+}
+
+void Context::set_thread_spawn_buffer(SpawnBuffer *buffer)
+{
+    t_spawn_buffer = buffer;
+}
+
+void Context::merge_spawn_buffer(SpawnBuffer &buffer)
+{
+    for (GameObject *object : buffer.objects)
+    {
+        spawn_object(object);
+    }
+    for (const ProjectileSpawn &projectile : buffer.projectiles)
+    {
+        spawn_projectile(projectile.x, projectile.y, projectile.angle,
+                         projectile.v, projectile.friendly, projectile.damage);
+    }
+    for (const AreaEffect &effect : buffer.area_effects)
+    {
+        spawn_area_effect(effect);
+    }
+    EventBus *bus{get_event_bus()};
+    if (bus != nullptr)
+        bus->append(buffer.events);
+    else
+        buffer.events.clear();
+    buffer.objects.clear();
+    buffer.projectiles.clear();
+    buffer.area_effects.clear();
 }
 
-void Context::set_player(const Player *player)
+void Context::set_thread_pool(ThreadPool *pool)
 {
-    m_player = player;
+    m_thread_pool = pool;
 }
 
 const sf::Time &Context::get_delta() const
@@ -62,9 +146,20 @@ GameState *Context::get_next_state() const
 
 void Context::get_new_objects(std::vector<GameObject *> &objects)
 {
-    // Move objects into objects parameter & reset m_new_objects.
-    objects = std::move(m_new_objects);
-    m_new_objects = std::vector<GameObject *>{};
+    objects.swap(m_new_objects);
+    m_new_objects.clear();
+}
+
+void Context::get_new_projectiles(std::vector<ProjectileSpawn> &projectiles)
+{
+    projectiles.swap(m_new_projectiles);
+    m_new_projectiles.clear();
+}
+
+void Context::get_new_area_effects(std::vector<AreaEffect> &effects)
+{
+    effects.swap(m_new_area_effects);
+    m_new_area_effects.clear();
 }
 
 sf::Vector2u Context::get_window_size() const
@@ -77,9 +172,47 @@ const sf::RenderWindow &Context::get_window() const
     return m_window;
 }
 
-const Player *Context::get_player() const
+ThreadPool *Context::get_thread_pool() const
+{
+    return m_thread_pool;
+}
+
+FrameArena &Context::get_frame_arena()
+{
+    return m_frame_arena;
+}
+
+void Context::set_spatial_grid(const SpatialGrid *grid)
+{
+    m_spatial_grid = grid;
+}
+
+void Context::set_event_bus(EventBus *bus)
+{
+    m_event_bus = bus;
+}
+
+const GameObject *Context::find_nearest(const sf::Vector2f &point, CollisionLayer layers,
+                                        float max_distance) const
+{
+    if (m_spatial_grid == nullptr)
+        return nullptr;
+    return m_spatial_grid->find_nearest(point, layers, max_distance);
+}
+
+void Context::find_in_radius(const sf::Vector2f &point, float radius, CollisionLayer layers,
+                             std::vector<const GameObject *> &found) const
 {
-    return m_player;
+    if (m_spatial_grid != nullptr)
+        m_spatial_grid->find_in_radius(point, radius, layers, found);
+}
+
+bool Context::raycast(const sf::Vector2f &origin, const sf::Vector2f &direction, float max_distance,
+                      CollisionLayer layers, RayHit &hit) const
+{
+    if (m_spatial_grid == nullptr)
+        return false;
+    return m_spatial_grid->raycast(origin, direction, max_distance, layers, hit);
 }
 
 void Context::exit()
@@ -90,4 +223,11 @@ void Context::exit()
 bool Context::has_exited() const
 {
     return m_quit;
-}
\ No newline at end of file
+}
+
+EventBus *Context::get_event_bus() const
+{
+    if (t_spawn_buffer != nullptr)
+        return &t_spawn_buffer->events;
+    return m_event_bus;
+}
@@ -0,0 +1,170 @@
+#include "effectstack.hpp"
+
+#include <algorithm>
+
+const std::size_t EffectStack::s_capacity;
+
+EffectStack::EffectStack()
+    : m_stacks{},
+      m_size{0},
+      m_next_serial{0},
+      m_timers{}
+{
+}
+
+void EffectStack::add(EffectType type, float value, float duration, unsigned int max_stacks)
+{
+    int index{-1};
+    if (get_stacks(type) >= std::max(max_stacks, 1u))
+        index = find_first_to_expire(type);
+    else if (m_size == s_capacity)
+        erase(static_cast<std::size_t>(find_first_to_expire(type, true)));
+
+    if (index < 0)
+    {
+        index = static_cast<int>(m_size++);
+        m_stacks[index] = Stack{type, value, 0, 0};
+    }
+    m_stacks[index].value = value;
+    schedule(m_stacks[index], duration);
+}
+
+void EffectStack::remove(EffectType type)
+{
+    for (std::size_t i{m_size}; i > 0; i--)
+    {
+        if (m_stacks[i - 1].type == type)
+            erase(i - 1);
+    }
+}
+
+bool EffectStack::consume(EffectType type)
+{
+    int index{find_first_to_expire(type)};
+    if (index < 0)
+        return false;
+    erase(static_cast<std::size_t>(index));
+    return true;
+}
+
+void EffectStack::clear()
+{
+    while (m_size > 0)
+        erase(m_size - 1);
+}
+
+void EffectStack::update(const sf::Time &delta, Context &context)
+{
+    m_timers.advance(delta, context);
+}
+
+bool EffectStack::has(EffectType type) const
+{
+    return get_stacks(type) > 0;
+}
+
+unsigned int EffectStack::get_stacks(EffectType type) const
+{
+    return static_cast<unsigned int>(std::count_if(m_stacks.begin(), m_stacks.begin() + m_size,
+                                                   [type](const Stack &stack)
+                                                   { return stack.type == type; }));
+}
+
+float EffectStack::get_multiplier(EffectType type) const
+{
+    float multiplier{1.f};
+    for (std::size_t i{0}; i < m_size; i++)
+    {
+        if (m_stacks[i].type == type)
+            multiplier *= m_stacks[i].value;
+    }
+    return multiplier;
+}
+
+std::size_t EffectStack::get_size() const
+{
+    return m_size;
+}
+
+std::size_t EffectStack::get_status(StatusArray &status) const
+{
+    std::size_t count{0};
+    for (std::size_t i{0}; i < m_size; i++)
+    {
+        const Stack &stack{m_stacks[i]};
+        float remaining{m_timers.get_remaining(stack.expiry)};
+        auto it = std::find_if(status.begin(), status.begin() + count, [&stack](const EffectStatus &s)
+                               { return s.type == stack.type; });
+        if (it == status.begin() + count)
+        {
+            status[count++] = EffectStatus{stack.type, 1, remaining};
+        }
+        else
+        {
+            it->stacks++;
+            it->remaining = std::max(it->remaining, remaining);
+        }
+    }
+    return count;
+}
+
+const char *EffectStack::get_name(EffectType type)
+{
+    switch (type)
+    {
+    case EffectType::FireRate:
+        return "Fire rate";
+    case EffectType::Speed:
+        return "Speed";
+    case EffectType::Spread:
+        return "Buckshot";
+    case EffectType::DoubleShot:
+        return "Doubleshoot";
+    case EffectType::Shield:
+        return "Shield";
+    }
+    return "";
+}
+
+int EffectStack::find_first_to_expire(EffectType type, bool any_type) const
+{
+    int found{-1};
+    float first{0.f};
+    for (std::size_t i{0}; i < m_size; i++)
+    {
+        if (!any_type && m_stacks[i].type != type)
+            continue;
+        float remaining{m_timers.get_remaining(m_stacks[i].expiry)};
+        if (found < 0 || remaining < first)
+        {
+            found = static_cast<int>(i);
+            first = remaining;
+        }
+    }
+    return found;
+}
+
+void EffectStack::erase(std::size_t index)
+{
+    m_timers.cancel(m_stacks[index].expiry);
+    std::move(m_stacks.begin() + index + 1, m_stacks.begin() + m_size, m_stacks.begin() + index);
+    m_size--;
+}
+
+void EffectStack::schedule(Stack &stack, float duration)
+{
+    m_timers.cancel(stack.expiry);
+    stack.serial = m_next_serial++;
+    std::uint32_t serial{stack.serial};
+    stack.expiry = m_timers.schedule(duration, [this, serial](Context &)
+                                     {
+                                         for (std::size_t i{0}; i < m_size; i++)
+                                         {
+                                             if (m_stacks[i].serial == serial)
+                                             {
+                                                 erase(i);
+                                                 return;
+                                             }
+                                         }
+                                     });
+}
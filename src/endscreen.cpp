@@ -5,19 +5,28 @@
 #include "enemyboss.hpp"
 #include "player.hpp"
 #include "endscreen.hpp"
+#include "scorestore.hpp"
 
 #include <sstream>
 #include <iomanip>
+#include <ctime>
+#include <algorithm>
 
-EndScreen::EndScreen(GameState *previous_state, Player *current_player)
+EndScreen::EndScreen(GameState *previous_state, Player *current_player, unsigned int level)
     : Menu(),
       m_previous_state{previous_state},
       m_current_player{current_player},
+      m_level{level},
       m_scoreboard{},
       m_player_score_text{"", ResourceManager::load_font("assets/font/Aquire.otf")},
       m_death_text{"", ResourceManager::load_font("assets/font/Aquire.otf")},
       m_highscore_text{"", ResourceManager::load_font("assets/font/Aquire.otf")},
+      m_leaderboard_text{"", ResourceManager::load_font("assets/font/Aquire.otf"), 18},
       m_current_highscore{},
+      m_score_store{nullptr},
+      m_leaderboard_version{0},
+      m_score_ticket{0},
+      m_leaderboard_rank{ScoreStore::s_pending_rank},
       m_new_highscore{}
 {
 }
@@ -27,22 +36,22 @@ EndScreen::~EndScreen()
     delete m_previous_state;
 }
 
-void EndScreen::render(sf::RenderWindow &window) const
+void EndScreen::render(RenderSnapshot &snapshot) const
 {
     if (m_previous_state != nullptr)
     {
-        m_previous_state->render(window);
+        m_previous_state->render(snapshot);
     }
 
-    sf::RectangleShape rect{{static_cast<float>(window.getSize().x),
-                             static_cast<float>(window.getSize().y)}};
+    sf::RectangleShape rect{{static_cast<float>(snapshot.get_size().x),
+                             static_cast<float>(snapshot.get_size().y)}};
     rect.setFillColor({40, 0, 0, 180});
     rect.setPosition(0, 0);
 
-    window.draw(rect);
+    snapshot.draw(rect);
 
-    render_texts(window);
-    Menu::render(window);
+    render_texts(snapshot);
+    Menu::render(snapshot);
 }
 
 void EndScreen::update(Context &context)
@@ -63,8 +72,6 @@ void EndScreen::init(const GameConfiguration &gc)
 
     std::string path{"assets/images/menu/"};
 
-    check_highscore(gc);
-
     init_texts(gc);
 
     float volume{gc.get_data().effects_volume};
@@ -84,16 +91,7 @@ void EndScreen::init(const GameConfiguration &gc)
         m_scoreboard.setTexture(ResourceManager::load_texture(base_path + "scoreboard.png"));
         m_scoreboard.setPosition(width / 2, height / 2 + 300);
     }
-    {
-        if (m_new_highscore)
-        {
-            set_new_highscore(gc);
-        }
-        else
-        {
-            m_current_highscore = gc.get_high_score();
-        }
-    }
+    submit_score(gc);
 }
 
 void EndScreen::init_texts(const GameConfiguration &gc)
@@ -112,10 +110,16 @@ void EndScreen::init_texts(const GameConfiguration &gc)
     // Highscore text
     m_highscore_text.setPosition(width / 2, height / 2 - 250);
     m_highscore_text.setFillColor(sf::Color::White);
+
+    // Leaderboard text, below the buttons.
+    m_leaderboard_text.setPosition(width / 2, height / 2 + 230);
+    m_leaderboard_text.setFillColor(sf::Color::White);
 }
 
 void EndScreen::update_texts()
 {
+    // First, the high score texts below depend on the rank of this run.
+    update_leaderboard_text();
     {
         std::stringstream ss{};
         ss << "Score " << m_current_player->get_score() << "    minion kills " << m_current_player->get_kills()
@@ -154,26 +158,66 @@ void EndScreen::update_texts()
     }
 }
 
-void EndScreen::render_texts(sf::RenderWindow &window) const
+void EndScreen::update_leaderboard_text()
 {
-    window.draw(m_player_score_text);
-    window.draw(m_death_text);
-    window.draw(m_highscore_text);
-}
+    if (m_score_store == nullptr)
+        return;
 
-void EndScreen::check_highscore(const GameConfiguration &gc)
-{
-    unsigned int current_highscore{gc.get_high_score()};
+    int rank{m_score_store->get_rank(m_score_ticket)};
+    std::uint64_t version{m_score_store->get_version()};
+    if (rank == m_leaderboard_rank && version == m_leaderboard_version)
+        return;
+
+    m_leaderboard_rank = rank;
+    m_leaderboard_version = version;
+    check_highscore();
 
-    if (m_current_player->get_score() > (int)current_highscore)
+    std::vector<ScoreEntry> entries{m_score_store->get_leaderboard()};
+
+    std::stringstream ss{};
+    // Only the top five fit on the screen.
+    for (std::size_t i{0}; i < entries.size() && i < 5; i++)
     {
-        m_new_highscore = true;
-        return;
+        ss << (static_cast<int>(i) == m_leaderboard_rank ? "> " : "")
+           << i + 1 << ".  " << entries[i].score
+           << "    level " << entries[i].level
+           << "    kills " << entries[i].kills << "\n";
     }
-    m_new_highscore = false;
+    m_leaderboard_text.setString(ss.str());
+    float text_width{m_leaderboard_text.getLocalBounds().width};
+    m_leaderboard_text.setOrigin({text_width / 2.f, 0.f});
+}
+
+void EndScreen::render_texts(RenderSnapshot &snapshot) const
+{
+    snapshot.draw(m_player_score_text);
+    snapshot.draw(m_death_text);
+    snapshot.draw(m_highscore_text);
+    snapshot.draw(m_leaderboard_text);
 }
 
-void EndScreen::set_new_highscore(const GameConfiguration &gc)
+void EndScreen::check_highscore()
 {
-    gc.update_high_score(m_current_player->get_score());
+    // Until the run is ranked the high score is the best loaded so far. Equal
+    // scores keep the older run first, so rank 0 means the old one was beaten.
+    m_current_highscore = m_score_store->get_high_score();
+    m_new_highscore = m_leaderboard_rank == 0 && m_current_player->get_score() > 0;
+}
+
+void EndScreen::submit_score(const GameConfiguration &gc)
+{
+    ScoreEntry entry{};
+    entry.score = static_cast<std::uint32_t>(std::max(m_current_player->get_score(), 0));
+    entry.kills = static_cast<std::uint32_t>(m_current_player->get_kills());
+    entry.boss_kills = static_cast<std::uint32_t>(m_current_player->get_boss_kills());
+    entry.level = m_level;
+    entry.seed = gc.get_normal_mode_data().spawn_seed;
+    entry.timestamp = static_cast<std::int64_t>(std::time(nullptr));
+
+    // Without a leaderboard there is nothing to rank the run against.
+    ScoreStore *store{gc.get_score_store()};
+    if (store == nullptr)
+        return;
+    m_score_ticket = store->submit(entry);
+    m_score_store = store;
 }
\ No newline at end of file
@@ -2,13 +2,20 @@
 #include "projectile.hpp"
 #include "resourcemanager.hpp"
 #include "gameconfiguration.hpp"
-#include "player.hpp"
 #include "powerup.hpp"
 #define _USE_MATH_DEFINES
 #include <math.h>
 #include <cmath>
 
-
+namespace
+{
+    // Hull of boss.png in texture pixels, the dome without the transparent
+    // corners.
+    const std::vector<sf::FloatRect> s_hull{
+        {10.f, 110.f, 880.f, 80.f},
+        {100.f, 48.f, 700.f, 62.f},
+        {260.f, 8.f, 380.f, 40.f}};
+}
 
 EnemyBoss::EnemyBoss(const EnemyBossData &data, float x, float y, int)
     : Enemy{data.base_health,
@@ -19,14 +26,13 @@ EnemyBoss::EnemyBoss(const EnemyBossData &data, float x, float y, int)
 	    0.f,
 	    0.f},
       m_image{ResourceManager::load_texture("assets/images/enemy/boss.png")},
-      doing_attack{false},
       attack_nr{0},
       counter{0},
       boss_attack_length{data.base_attack_length},
       attack_time{data.base_attack_time}
 {
-    clock.restart();
-    s_sprite.setTexture(m_image);
+    set_texture(m_image);
+    set_sub_colliders(s_hull);
     sf::Vector2u texture_size{m_image.getSize()};
     s_sprite.setOrigin(texture_size.x / 2, texture_size.y / 2);
     s_sprite.setPosition(x, y);
@@ -43,23 +49,32 @@ void EnemyBoss::update(Context &context)
     if (s_health <= 0)
     {
 	spawn_powerups(context);
-	context.get_player()->kills(2500, true);
+	context.publish(BossDefeated{s_sprite.getPosition(), 2500});
 	remove();
     }
-    if (doing_attack)
-    {
-	attack(context);
-    }
-    else
-    {
-	if (clock.getElapsedTime().asSeconds() >= e_attack_cooldown)
-	{
-	    doing_attack = true;
-	    attack_nr = rand() % 3;
-	    counter = 0;
-	    clock.restart();
-	}
-    }
+}
+
+void EnemyBoss::start_timers(TimerWheel &timers)
+{
+    // Wait for the cooldown, then fire boss_attack_length shots of a random
+    // attack, attack_time apart, and start over.
+    e_attack_timer.start(timers, e_attack_cooldown, [this, &timers](Context &)
+			 {
+			     attack_nr = random_int(3);
+			     counter = 0;
+			     e_attack_timer.start(timers, attack_time, [this, &timers](Context &context)
+						  {
+						      attack(context);
+						      if (counter == boss_attack_length)
+							  start_timers(timers);
+						  },
+						  attack_time);
+			 });
+}
+
+ObjectKind EnemyBoss::get_kind() const
+{
+    return ObjectKind::EnemyBoss;
 }
 
 void EnemyBoss::attack(Context &context)
@@ -82,58 +97,29 @@ void EnemyBoss::attack0(Context &context)
 {
     int width = static_cast<int>(context.get_window_size().x);
     sf::Vector2f cur_pos = s_sprite.getPosition();
-    if (clock.getElapsedTime().asSeconds() >= attack_time)
-    {
-	float random_x{};
-	random_x = static_cast<float>(rand()) / RAND_MAX * width;
-	context.spawn_object(
-	    new BasicProjectile{random_x, cur_pos.y, M_PI_2, s_projectile_speed, false});
-	counter++;
-	if (counter == boss_attack_length)
-	{
-	    doing_attack = false;
-	}
-	clock.restart();
-    }
+    float random_x{};
+    random_x = random_float() * width;
+    context.spawn_projectile(random_x, cur_pos.y, M_PI_2, s_projectile_speed, false);
+    counter++;
 }
 
 void EnemyBoss::attack1(Context &context)
 {
     sf::Vector2f cur_pos = s_sprite.getPosition();
-    if (clock.getElapsedTime().asSeconds() >= attack_time)
-    {
-	float random_dir{};
-	random_dir = static_cast<float>(rand()) / RAND_MAX;
-	context.spawn_object(
-	    new BasicProjectile{cur_pos.x, cur_pos.y, static_cast<float>(M_PI) * random_dir, s_projectile_speed, false});
-	counter++;
-	if (counter == boss_attack_length)
-	{
-	    doing_attack = false;
-	}
-	clock.restart();
-    }
+    float random_dir{};
+    random_dir = random_float();
+    context.spawn_projectile(cur_pos.x, cur_pos.y, static_cast<float>(M_PI) * random_dir, s_projectile_speed, false);
+    counter++;
 }
 
 void EnemyBoss::attack2(Context &context)
 {
     int width = static_cast<int>(context.get_window_size().x);
     sf::Vector2f cur_pos = s_sprite.getPosition();
-    if (clock.getElapsedTime().asSeconds() >= attack_time)
-    {
-	int x_offset{counter * width / 10};
-	context.spawn_object(
-	    new BasicProjectile{cur_pos.x + x_offset, cur_pos.y, M_PI_2, s_projectile_speed, false});
-	context.spawn_object(
-	    new BasicProjectile{cur_pos.x - x_offset, cur_pos.y, M_PI_2, s_projectile_speed, false});
-	counter++;
-	if (counter == boss_attack_length)
-	{
-	    doing_attack = false;
-	}
-	clock.restart();
-    }
-    
+    int x_offset{counter * width / 10};
+    context.spawn_projectile(cur_pos.x + x_offset, cur_pos.y, M_PI_2, s_projectile_speed, false);
+    context.spawn_projectile(cur_pos.x - x_offset, cur_pos.y, M_PI_2, s_projectile_speed, false);
+    counter++;
 }
 
 void EnemyBoss::spawn_powerups(Context &context)
@@ -142,10 +128,10 @@ void EnemyBoss::spawn_powerups(Context &context)
     sf::Vector2f cur_pos = s_sprite.getPosition();
     float random_x{};
     float rand_val{};
-    random_x = static_cast<float>(rand()) / RAND_MAX * width / 2 + width / 4;
+    random_x = random_float() * width / 2 + width / 4;
     context.spawn_object(new Repair{random_x, cur_pos.y, e_powerup_speed});
-    random_x = static_cast<float>(rand()) / RAND_MAX * width / 2 + width / 4;
-    rand_val = static_cast<float>(rand()) / RAND_MAX;
+    random_x = random_float() * width / 2 + width / 4;
+    rand_val = random_float();
     if (rand_val < 0.5)
     {
 	context.spawn_object(new Speed{random_x, cur_pos.y, e_powerup_speed});
@@ -154,12 +140,12 @@ void EnemyBoss::spawn_powerups(Context &context)
     {
 	context.spawn_object(new Boost{random_x, cur_pos.y, e_powerup_speed});
     }
-    random_x = static_cast<float>(rand()) / RAND_MAX * width / 2 + width / 4;
+    random_x = random_float() * width / 2 + width / 4;
     Randomize_powerup(context, random_x, cur_pos.y);
-    rand_val = static_cast<float>(rand()) / RAND_MAX;
+    rand_val = random_float();
     if (rand_val < 0.5)
     {
-	random_x = static_cast<float>(rand()) / RAND_MAX * width / 2 + width / 4;
+	random_x = random_float() * width / 2 + width / 4;
 	Randomize_powerup(context, random_x, cur_pos.y);
     }
 }
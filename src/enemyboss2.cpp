@@ -1,14 +1,25 @@
 #include "enemyboss2.hpp"
 #include "projectile.hpp"
-#include "player.hpp"
 #include "powerup.hpp"
 
 #define _USE_MATH_DEFINES
 #include <math.h>
+#include <algorithm>
 #include <cmath>
 #include "resourcemanager.hpp"
 #include "gameconfiguration.hpp"
 
+namespace
+{
+    // Hull of shrek1.png in texture pixels: head, body, legs and feet. The
+    // ears are left out.
+    const std::vector<sf::FloatRect> s_hull{
+        {66.f, 52.f, 58.f, 50.f},
+        {12.f, 117.f, 172.f, 135.f},
+        {60.f, 250.f, 72.f, 35.f},
+        {10.f, 285.f, 180.f, 85.f}};
+}
+
 EnemyBoss2::EnemyBoss2(const EnemyBossData &data, float x, float y, int)
     : Enemy{data.base_health,
             0.f,
@@ -18,14 +29,13 @@ EnemyBoss2::EnemyBoss2(const EnemyBossData &data, float x, float y, int)
             0.f,
             0.f},
       m_image{ResourceManager::load_texture("assets/images/enemy/shrek1.png")},
-      m_attack{false},
       m_attack_time{data.base_attack_time},
-      m_attack_number{0},
       m_number_of_items_spawned{6},
-      const_attack_clock{},
-      m_clock{}
+      m_constant_attack_timer{},
+      m_constant_attack_phase{0.f}
 {
-    Ship::s_sprite.setTexture(m_image);
+    Ship::set_texture(m_image);
+    set_sub_colliders(s_hull);
     sf::Vector2u texture_size{m_image.getSize()};
     Ship::s_sprite.setOrigin(texture_size.x / 2, texture_size.y / 2);
     Ship::s_sprite.setPosition(x, y);
@@ -40,41 +50,44 @@ void EnemyBoss2::update(Context &context)
 {
     Ship::update_health_bar();
     check_health(context);
-    constant_attack(context);
-    attack(context, m_attack_number);
-    cooldown();
+}
+
+void EnemyBoss2::start_timers(TimerWheel &timers)
+{
+    m_constant_attack_timer.start(timers, m_attack_time, [this](Context &context)
+                                  { constant_attack(context); },
+                                  m_attack_time);
+    // One random attack every cooldown, but not faster than the attack time.
+    float attack_period{std::max(e_attack_cooldown, m_attack_time)};
+    e_attack_timer.start(timers, attack_period, [this](Context &context)
+                         { attack(context, random_int(2)); },
+                         attack_period);
+}
+
+ObjectKind EnemyBoss2::get_kind() const
+{
+    return ObjectKind::EnemyBoss2;
 }
 
 void EnemyBoss2::attack(Context &context, int attack_number)
 {
     // boss information
     sf::Vector2f current_position = s_sprite.getPosition();
-    if (m_attack)
+    if (attack_number == 0)
     {
-        if (attack_number == 0)
-        {
-            if (clock.getElapsedTime().asSeconds() >= m_attack_time)
-            {
-                int offset_x = rand() % 3 * 100;
-                context.spawn_object(new BasicProjectile{current_position.x + offset_x,
-                                                         current_position.y, M_PI_4, 3 * s_projectile_speed, false});
-                context.spawn_object(new BasicProjectile{current_position.x - offset_x,
-                                                         current_position.y, M_PI_4 + M_PI_2, 3 * s_projectile_speed, false});
-                clock.restart();
-            }
-        }
-        if (attack_number == 1)
-        {
-            if (clock.getElapsedTime().asSeconds() >= m_attack_time)
-            {
-                int offset_x = (rand() % 2 + 3) * 100;
-                context.spawn_object(new BasicProjectile{current_position.x + offset_x,
-                                                         0, M_PI_2, 5 * s_projectile_speed, false});
-                context.spawn_object(new BasicProjectile{current_position.x - offset_x,
-                                                         0, M_PI_2, 5 * s_projectile_speed, false});
-                clock.restart();
-            }
-        }
+        int offset_x = random_int(3) * 100;
+        context.spawn_projectile(current_position.x + offset_x,
+                                 current_position.y, M_PI_4, 3 * s_projectile_speed, false);
+        context.spawn_projectile(current_position.x - offset_x,
+                                 current_position.y, M_PI_4 + M_PI_2, 3 * s_projectile_speed, false);
+    }
+    if (attack_number == 1)
+    {
+        int offset_x = (random_int(2) + 3) * 100;
+        context.spawn_projectile(current_position.x + offset_x,
+                                 0, M_PI_2, 5 * s_projectile_speed, false);
+        context.spawn_projectile(current_position.x - offset_x,
+                                 0, M_PI_2, 5 * s_projectile_speed, false);
     }
 }
 
@@ -82,18 +95,16 @@ void EnemyBoss2::constant_attack(Context &context)
 {
     sf::Vector2f current_position = s_sprite.getPosition();
 
-    float offset_x1 = sin(m_clock.getElapsedTime().asSeconds());
-    float offset_x2 = sin(m_clock.getElapsedTime().asSeconds() + M_PI);
+    // The strands sway with the time the boss has been attacking.
+    m_constant_attack_phase += m_attack_time;
+    float offset_x1 = sin(m_constant_attack_phase);
+    float offset_x2 = sin(m_constant_attack_phase + M_PI);
 
     // Constant DNA attack
-    if (const_attack_clock.getElapsedTime().asSeconds() >= m_attack_time)
-    {
-        context.spawn_object(new BasicProjectile{current_position.x + offset_x2 * 200,
-                                                 0, M_PI_2, 3 * s_projectile_speed, false});
-        context.spawn_object(new BasicProjectile{current_position.x + offset_x1 * 200,
-                                                 0, M_PI_2, 3 * s_projectile_speed, false});
-        const_attack_clock.restart();
-    }
+    context.spawn_projectile(current_position.x + offset_x2 * 200,
+                             0, M_PI_2, 3 * s_projectile_speed, false);
+    context.spawn_projectile(current_position.x + offset_x1 * 200,
+                             0, M_PI_2, 3 * s_projectile_speed, false);
 }
 
 void EnemyBoss2::check_health(Context &context)
@@ -103,7 +114,7 @@ void EnemyBoss2::check_health(Context &context)
     if (s_health <= 0)
     {
         GameObject::remove();
-        context.get_player()->kills(1000, true);
+        context.publish(BossDefeated{current_position, 1000});
         // spawn powerups
         for (int i = 0; i < m_number_of_items_spawned; i++)
         {
@@ -113,14 +124,3 @@ void EnemyBoss2::check_health(Context &context)
         }
     }
 }
-
-void EnemyBoss2::cooldown()
-{
-    if (clock.getElapsedTime().asSeconds() >= e_attack_cooldown)
-    {
-        m_attack = true;
-        return;
-    }
-    m_attack = false;
-    m_attack_number = rand() % 2;
-}
@@ -0,0 +1,159 @@
+#include "entityobject.hpp"
+#include "narrowphase.hpp"
+#include "projectile.hpp"
+
+#include <new>
+
+const std::size_t EntityObject::s_pool_block_size{64};
+std::vector<void *> EntityObject::s_pool{};
+std::mutex EntityObject::s_pool_mutex{};
+
+EntityObject::EntityObject(EntityWorld &world, const EntityDesc &desc)
+    : GameObject{},
+      m_world{world},
+      m_entity{world.create(desc, this)}
+{
+}
+
+EntityObject::~EntityObject()
+{
+    m_world.destroy(m_entity);
+}
+
+void *EntityObject::operator new(std::size_t size)
+{
+    if (size != sizeof(EntityObject))
+        return ::operator new(size);
+    std::lock_guard<std::mutex> lock{s_pool_mutex};
+    if (s_pool.empty())
+    {
+        // One allocation for a whole block, handed out one object at a time.
+        char *block{static_cast<char *>(::operator new(sizeof(EntityObject) * s_pool_block_size))};
+        for (std::size_t i{s_pool_block_size}; i > 0; i--)
+        {
+            s_pool.push_back(block + (i - 1) * sizeof(EntityObject));
+        }
+    }
+    void *memory{s_pool.back()};
+    s_pool.pop_back();
+    return memory;
+}
+
+void EntityObject::operator delete(void *memory, std::size_t size)
+{
+    if (memory == nullptr)
+        return;
+    if (size != sizeof(EntityObject))
+    {
+        ::operator delete(memory);
+        return;
+    }
+    std::lock_guard<std::mutex> lock{s_pool_mutex};
+    s_pool.push_back(memory);
+}
+
+std::size_t EntityObject::get_pool_free()
+{
+    std::lock_guard<std::mutex> lock{s_pool_mutex};
+    return s_pool.size();
+}
+
+void EntityObject::update(Context &)
+{
+}
+
+void EntityObject::render(RenderSnapshot &) const
+{
+}
+
+bool EntityObject::render_batched(RenderBatch &) const
+{
+    return true;
+}
+
+void EntityObject::start_timers(TimerWheel &timers)
+{
+    m_world.start_weapon(m_entity, timers);
+}
+
+bool EntityObject::handle(const sf::Event &, Context &)
+{
+    return false;
+}
+
+sf::FloatRect EntityObject::bounds() const
+{
+    return m_world.get_bounds(m_entity);
+}
+
+bool EntityObject::get_collision_shape(CollisionShape &shape) const
+{
+    const Collider &collider{m_world.get_collider(m_entity)};
+    if (collider.mask == nullptr)
+        return false;
+    const sf::FloatRect &local_bounds{collider.local_bounds};
+    const sf::IntRect &texture_rect{m_world.get_sprite(m_entity).texture_rect};
+    sf::Transform transform{};
+    transform.translate(m_world.get_transform(m_entity).position +
+                        sf::Vector2f{local_bounds.left, local_bounds.top});
+    shape = CollisionShape{transform, sf::FloatRect{0.f, 0.f, local_bounds.width, local_bounds.height},
+                           collider.mask, sf::Vector2i{texture_rect.left, texture_rect.top}};
+    return true;
+}
+
+CollisionLayer EntityObject::get_layer() const
+{
+    switch (m_world.get_faction(m_entity))
+    {
+    case Faction::Player:
+        return CollisionLayer::Player;
+    case Faction::Enemy:
+        return CollisionLayer::Enemy;
+    default:
+        return CollisionLayer::None;
+    }
+}
+
+ObjectKind EntityObject::get_kind() const
+{
+    return ObjectKind::Entity;
+}
+
+void EntityObject::collision(const GameObject *other)
+{
+    Health &health{m_world.get_health(m_entity)};
+    Faction faction{m_world.get_faction(m_entity)};
+    // Ships lose one health when they crash into a ship of the other side.
+    if ((faction == Faction::Enemy && other->get_layer() == CollisionLayer::Player) ||
+        (faction == Faction::Player && other->get_layer() == CollisionLayer::Enemy))
+    {
+        health.current -= 1;
+    }
+    const Projectile *projectile{dynamic_cast<const Projectile *>(other)};
+    if (projectile != nullptr)
+    {
+        projectile_hit(projectile->get_hit());
+    }
+}
+
+void EntityObject::collision_stay(const GameObject *)
+{
+}
+
+void EntityObject::projectile_hit(const ProjectileHit &hit)
+{
+    if (hit.friendly == (m_world.get_faction(m_entity) == Faction::Enemy))
+    {
+        m_world.get_health(m_entity).current -= hit.damage;
+    }
+}
+
+Entity EntityObject::get_entity() const
+{
+    return m_entity;
+}
+
+int EntityObject::get_health() const
+{
+    return m_world.get_health(m_entity).current;
+}
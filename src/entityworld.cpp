@@ -0,0 +1,360 @@
+#include "entityworld.hpp"
+#include "context.hpp"
+#include "gameobject.hpp"
+#include "powerup.hpp"
+#include "renderbatch.hpp"
+#include "threadpool.hpp"
+
+#define _USE_MATH_DEFINES
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace
+{
+    // Same look as the health bar of Ship.
+    const sf::Vector2f s_health_bar_size{70.f, 6.f};
+    const sf::Color s_health_bar_color{sf::Color::Cyan};
+    const sf::Color s_health_bar_background{0x4b4b4bff};
+    // Below this many entities the systems run on the calling thread, which
+    // is cheaper than waking up the workers. Same as GameMode.
+    const std::size_t s_parallel_threshold{256};
+    const std::size_t s_min_chunk_size{64};
+
+    /**
+     * @brief Get a random integer in [0, max), same as Enemy::random_int(...).
+     */
+    int random_int(std::minstd_rand &rng, int max)
+    {
+        return static_cast<int>(rng() % static_cast<unsigned int>(max));
+    }
+}
+
+
+EntityWorld::EntityWorld()
+    : m_transforms{},
+      m_velocities{},
+      m_colliders{},
+      m_healths{},
+      m_weapons{},
+      m_sprites{},
+      m_loot{},
+      m_factions{},
+      m_rngs{},
+      m_alive{},
+      m_objects{},
+      m_entities{},
+      m_indices{},
+      m_timers{nullptr},
+      m_spawn_buffers{}
+{
+}
+
+Entity EntityWorld::create(const EntityDesc &desc, GameObject *object)
+{
+    if (object == nullptr)
+        throw std::logic_error("EntityWorldERROR: entity must have an object.");
+
+    Entity entity{m_indices.insert(m_entities.size())};
+
+    m_transforms.push_back(desc.transform);
+    m_velocities.push_back(desc.velocity);
+    m_colliders.push_back(desc.collider);
+    m_healths.push_back(desc.health);
+    m_weapons.push_back(desc.weapon);
+    m_weapons.back().timer = 0;
+    m_sprites.push_back(desc.sprite);
+    m_loot.push_back(desc.loot);
+    m_factions.push_back(desc.faction);
+    m_rngs.emplace_back(static_cast<std::minstd_rand::result_type>(rand()));
+    m_alive.push_back(true);
+    m_objects.push_back(object);
+    m_entities.push_back(entity);
+    return entity;
+}
+
+void EntityWorld::start_weapon(Entity entity, TimerWheel &timers)
+{
+    WeaponCooldown &weapon{m_weapons[get_index(entity)]};
+    if (m_timers != nullptr && m_timers != &timers)
+        throw std::logic_error("EntityWorldERROR: weapons must be started on one wheel.");
+    m_timers = &timers;
+    if (weapon.timer != 0)
+        timers.cancel(weapon.timer);
+    weapon.timer = timers.schedule(weapon.cooldown, [this, entity](Context &context)
+                                   { attack(entity, context); },
+                                   weapon.cooldown);
+}
+
+void EntityWorld::destroy(Entity entity)
+{
+    std::size_t index{get_index(entity)};
+    if (m_weapons[index].timer != 0)
+        m_timers->cancel(m_weapons[index].timer);
+    std::size_t last{m_entities.size() - 1};
+    if (index != last)
+    {
+        m_transforms[index] = m_transforms[last];
+        m_velocities[index] = m_velocities[last];
+        m_colliders[index] = m_colliders[last];
+        m_healths[index] = m_healths[last];
+        m_weapons[index] = m_weapons[last];
+        m_sprites[index] = m_sprites[last];
+        m_loot[index] = m_loot[last];
+        m_factions[index] = m_factions[last];
+        m_rngs[index] = m_rngs[last];
+        m_alive[index] = m_alive[last];
+        m_objects[index] = m_objects[last];
+        m_entities[index] = m_entities[last];
+        m_indices.move(m_entities[index], index);
+    }
+    m_transforms.pop_back();
+    m_velocities.pop_back();
+    m_colliders.pop_back();
+    m_healths.pop_back();
+    m_weapons.pop_back();
+    m_sprites.pop_back();
+    m_loot.pop_back();
+    m_factions.pop_back();
+    m_rngs.pop_back();
+    m_alive.pop_back();
+    m_objects.pop_back();
+    m_entities.pop_back();
+
+    m_indices.erase(entity);
+}
+
+bool EntityWorld::contains(Entity entity) const
+{
+    return m_indices.contains(entity);
+}
+
+std::size_t EntityWorld::get_size() const
+{
+    return m_entities.size();
+}
+
+Transform &EntityWorld::get_transform(Entity entity)
+{
+    return m_transforms[get_index(entity)];
+}
+
+const Transform &EntityWorld::get_transform(Entity entity) const
+{
+    return m_transforms[get_index(entity)];
+}
+
+Velocity &EntityWorld::get_velocity(Entity entity)
+{
+    return m_velocities[get_index(entity)];
+}
+
+const Collider &EntityWorld::get_collider(Entity entity) const
+{
+    return m_colliders[get_index(entity)];
+}
+
+Health &EntityWorld::get_health(Entity entity)
+{
+    return m_healths[get_index(entity)];
+}
+
+const Health &EntityWorld::get_health(Entity entity) const
+{
+    return m_healths[get_index(entity)];
+}
+
+WeaponCooldown &EntityWorld::get_weapon(Entity entity)
+{
+    return m_weapons[get_index(entity)];
+}
+
+const SpriteRef &EntityWorld::get_sprite(Entity entity) const
+{
+    return m_sprites[get_index(entity)];
+}
+
+Faction EntityWorld::get_faction(Entity entity) const
+{
+    return m_factions[get_index(entity)];
+}
+
+sf::FloatRect EntityWorld::get_bounds(Entity entity) const
+{
+    std::size_t index{get_index(entity)};
+    sf::FloatRect bounds{m_colliders[index].local_bounds};
+    bounds.left += m_transforms[index].position.x;
+    bounds.top += m_transforms[index].position.y;
+    return bounds;
+}
+
+void EntityWorld::update(Context &context)
+{
+    if (m_entities.empty())
+        return;
+    ThreadPool *pool{context.get_thread_pool()};
+    if (pool == nullptr || pool->get_thread_count() == 1 || m_entities.size() < s_parallel_threshold)
+    {
+        update_health(context, 0, m_entities.size());
+        update_movement(context, 0, m_entities.size());
+        return;
+    }
+
+    // Every entity only touches its own components, so chunks run both
+    // systems one after the other, as in GameMode::update_objects(...).
+    std::size_t chunk_size{std::max(s_min_chunk_size, m_entities.size() / (pool->get_thread_count() * 4))};
+    std::size_t chunk_count{(m_entities.size() + chunk_size - 1) / chunk_size};
+    if (m_spawn_buffers.size() < chunk_count)
+        m_spawn_buffers.resize(chunk_count);
+    pool->parallel_for(m_entities.size(), chunk_size,
+                       [this, &context](std::size_t chunk, std::size_t begin, std::size_t end)
+                       {
+                           Context::set_thread_spawn_buffer(&m_spawn_buffers[chunk]);
+                           try
+                           {
+                               update_health(context, begin, end);
+                               update_movement(context, begin, end);
+                           }
+                           catch (...)
+                           {
+                               Context::set_thread_spawn_buffer(nullptr);
+                               throw;
+                           }
+                           Context::set_thread_spawn_buffer(nullptr);
+                       });
+    for (std::size_t chunk{0}; chunk < chunk_count; chunk++)
+    {
+        context.merge_spawn_buffer(m_spawn_buffers[chunk]);
+    }
+}
+
+void EntityWorld::render(RenderBatch &batch) const
+{
+    sf::Sprite sprite{};
+    for (std::size_t i{0}; i < m_entities.size(); i++)
+    {
+        const SpriteRef &ref{m_sprites[i]};
+        sprite.setTexture(*ref.texture);
+        sprite.setTextureRect(ref.texture_rect);
+        sprite.setOrigin(ref.origin);
+        sprite.setPosition(m_transforms[i].position);
+        batch.add_sprite(sprite);
+    }
+
+    // Health bars on top of all ships.
+    sf::RectangleShape background{s_health_bar_size};
+    background.setOrigin(s_health_bar_size / 2.f);
+    background.setFillColor(s_health_bar_background);
+    sf::RectangleShape bar{background};
+    bar.setFillColor(s_health_bar_color);
+    for (std::size_t i{0}; i < m_entities.size(); i++)
+    {
+        if (m_sprites[i].health_bar_offset == 0.f)
+            continue;
+        const Health &health{m_healths[i]};
+        sf::Vector2f position{m_transforms[i].position + sf::Vector2f{0.f, m_sprites[i].health_bar_offset}};
+        float fraction{std::max(0.f, health.current / static_cast<float>(health.max))};
+        background.setPosition(position);
+        bar.setPosition(position);
+        bar.setSize(sf::Vector2f{s_health_bar_size.x * fraction, s_health_bar_size.y});
+        batch.add_rectangle(background, 1);
+        batch.add_rectangle(bar, 1);
+    }
+}
+
+void EntityWorld::attack(Entity entity, Context &context)
+{
+    std::size_t i{get_index(entity)};
+    WeaponCooldown &weapon{m_weapons[i]};
+    if (!m_alive[i])
+    {
+        // Removed entities never attack again, so the wheel can forget them.
+        m_timers->cancel(weapon.timer);
+        weapon.timer = 0;
+        return;
+    }
+
+    // At this time only probabilities with 2 decimal places are supported.
+    if (random_int(m_rngs[i], 100) < (1.f - weapon.probability) * 100.f)
+        return;
+    const sf::Vector2f &position{m_transforms[i].position};
+    bool friendly{m_factions[i] == Faction::Player};
+    switch (weapon.pattern)
+    {
+    case AttackPattern::Down:
+        context.spawn_projectile(position.x, position.y, M_PI_2, weapon.projectile_speed, friendly);
+        break;
+    case AttackPattern::Cross:
+        for (int direction{0}; direction < 4; direction++)
+        {
+            context.spawn_projectile(position.x, position.y, direction * M_PI_2,
+                                     weapon.projectile_speed, friendly);
+        }
+        break;
+    case AttackPattern::Turn:
+        m_velocities[i].direction.x *= -1;
+        break;
+    case AttackPattern::None:
+        break;
+    }
+}
+
+void EntityWorld::update_health(Context &context, std::size_t begin, std::size_t end)
+{
+    for (std::size_t i{begin}; i < end; i++)
+    {
+        if (!m_alive[i] || m_healths[i].current > 0)
+            continue;
+        const Loot &loot{m_loot[i]};
+        // At this time only probabilities with 2 decimal places are supported.
+        if (random_int(m_rngs[i], 100) >= (1.f - loot.powerup_probability) * 100.f)
+        {
+            const sf::Vector2f &position{m_transforms[i].position};
+            context.spawn_object(PowerUp::create_random(m_rngs[i], position.x, position.y, loot.powerup_speed));
+        }
+        context.publish(EnemyKilled{m_transforms[i].position, loot.score});
+        kill(i);
+    }
+}
+
+void EntityWorld::update_movement(Context &context, std::size_t begin, std::size_t end)
+{
+    float delta{context.get_delta().asSeconds()};
+    sf::Vector2u window_size{context.get_window_size()};
+    for (std::size_t i{begin}; i < end; i++)
+    {
+        if (!m_alive[i])
+            continue;
+        Velocity &velocity{m_velocities[i]};
+        sf::Vector2f &position{m_transforms[i].position};
+        sf::Vector2f old_position{position};
+        position += velocity.direction * velocity.speed * delta;
+
+        // Entities below the window got past the player.
+        if (position.y > window_size.y)
+        {
+            context.publish(PlayerHit{1});
+            kill(i);
+        }
+        else if (velocity.bounce && (position.x < 0 || position.x > window_size.x))
+        {
+            velocity.direction.x *= -1;
+            position = old_position;
+        }
+    }
+}
+
+void EntityWorld::kill(std::size_t index)
+{
+    m_alive[index] = false;
+    m_objects[index]->remove();
+}
+
+std::size_t EntityWorld::get_index(Entity entity) const
+{
+    std::size_t index{m_indices.get_index(entity)};
+    if (index == HandleTable::s_no_index)
+        throw std::logic_error("EntityWorldERROR: entity is not in the world.");
+    return index;
+}
@@ -0,0 +1,137 @@
+#include "eventbus.hpp"
+#include "powerup.hpp"
+
+#include <tuple>
+#include <utility>
+
+namespace
+{
+    /**
+     * @brief Call a function with every channel of a bus, in dispatch order.
+     */
+    template <typename Channels, typename Function>
+    void for_each_channel(Channels &channels, Function function)
+    {
+        std::apply([&function](auto &...channel)
+                   { (function(channel), ...); },
+                   channels);
+    }
+
+    /**
+     * @brief Call a function with every pair of channels of the same type.
+     */
+    template <typename Channels, typename Function, std::size_t... I>
+    void for_each_channel_pair(Channels &a, Channels &b, Function function, std::index_sequence<I...>)
+    {
+        (function(std::get<I>(a), std::get<I>(b)), ...);
+    }
+}
+
+/*==================================Events====================================*/
+
+EnemyKilled::EnemyKilled()
+    : position{},
+      score{0}
+{
+}
+
+EnemyKilled::EnemyKilled(const sf::Vector2f &position, int score)
+    : position{position},
+      score{score}
+{
+}
+
+BossDefeated::BossDefeated()
+    : position{},
+      score{0}
+{
+}
+
+BossDefeated::BossDefeated(const sf::Vector2f &position, int score)
+    : position{position},
+      score{score}
+{
+}
+
+PlayerHit::PlayerHit()
+    : damage{0}
+{
+}
+
+PlayerHit::PlayerHit(int damage)
+    : damage{damage}
+{
+}
+
+PowerupCollected::PowerupCollected()
+    : type{PowerUpType::Repair},
+      position{}
+{
+}
+
+PowerupCollected::PowerupCollected(PowerUpType type, const sf::Vector2f &position)
+    : type{type},
+      position{position}
+{
+}
+
+LevelUp::LevelUp()
+    : level{0}
+{
+}
+
+LevelUp::LevelUp(unsigned int level)
+    : level{level}
+{
+}
+
+/*==================================EventBus==================================*/
+
+EventBus::EventBus()
+    : m_channels{}
+{
+}
+
+void EventBus::append(EventBus &other)
+{
+    for_each_channel_pair(m_channels, other.m_channels, [](auto &to, auto &from)
+                          {
+                              while (!from.events.is_empty())
+                                  to.events.push(from.events.pop());
+                          },
+                          std::make_index_sequence<std::tuple_size<decltype(m_channels)>::value>{});
+}
+
+void EventBus::dispatch()
+{
+    // Subscribers may publish, so go again until every queue stays empty.
+    while (get_size() > 0)
+    {
+        for_each_channel(m_channels, [](auto &channel)
+                         {
+                             while (!channel.events.is_empty())
+                             {
+                                 // Popped first, publishing may grow the queue.
+                                 auto event{channel.events.pop()};
+                                 for (const auto &subscriber : channel.subscribers)
+                                 {
+                                     subscriber(event);
+                                 }
+                             }
+                         });
+    }
+}
+
+void EventBus::clear()
+{
+    for_each_channel(m_channels, [](auto &channel)
+                     { channel.events.clear(); });
+}
+
+std::size_t EventBus::get_size() const
+{
+    std::size_t size{0};
+    for_each_channel(m_channels, [&size](const auto &channel)
+                     { size += channel.events.get_size(); });
+    return size;
+}
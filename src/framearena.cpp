@@ -0,0 +1,96 @@
+#include "framearena.hpp"
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+
+const std::size_t FrameArena::s_default_block_size{64 * 1024};
+
+FrameArena::FrameArena(std::size_t block_size)
+    : m_blocks{},
+      m_block{0},
+      m_offset{0},
+      m_used{0},
+      m_block_size{std::max<std::size_t>(block_size, 1)}
+{
+}
+
+void *FrameArena::allocate(std::size_t size, std::size_t alignment)
+{
+    if (m_blocks.empty())
+        add_block(std::max(m_block_size, size));
+
+    Block &block{m_blocks[m_block]};
+    std::uintptr_t begin{reinterpret_cast<std::uintptr_t>(block.data.get())};
+    std::size_t offset{((begin + m_offset + alignment - 1) & ~(alignment - 1)) - begin};
+    if (offset + size > block.size)
+    {
+        // Blocks are only added, never reused, until the next reset.
+        add_block(std::max(m_block_size, size));
+        offset = 0;
+    }
+
+    m_offset = offset + size;
+    m_used += size;
+    return m_blocks[m_block].data.get() + offset;
+}
+
+void FrameArena::reset()
+{
+    if (m_blocks.size() > 1)
+    {
+        // The frame did not fit, next time it does.
+        std::size_t capacity{get_capacity()};
+        m_blocks.clear();
+        m_blocks.push_back(Block{std::make_unique<unsigned char[]>(capacity), capacity});
+    }
+    m_block = 0;
+    m_offset = 0;
+    m_used = 0;
+}
+
+std::size_t FrameArena::get_used() const
+{
+    return m_used;
+}
+
+std::size_t FrameArena::get_capacity() const
+{
+    std::size_t capacity{0};
+    for (const Block &block : m_blocks)
+        capacity += block.size;
+    return capacity;
+}
+
+std::size_t FrameArena::get_block_count() const
+{
+    return m_blocks.size();
+}
+
+void FrameArena::add_block(std::size_t size)
+{
+    // new[] memory is aligned for every fundamental type.
+    m_blocks.push_back(Block{std::make_unique<unsigned char[]>(size), size});
+    m_block = m_blocks.size() - 1;
+    m_offset = 0;
+}
+
+void append_format(FrameString &string, const char *format, ...)
+{
+    std::va_list args;
+    va_start(args, format);
+    std::va_list size_args;
+    va_copy(size_args, args);
+    int size{std::vsnprintf(nullptr, 0, format, size_args)};
+    va_end(size_args);
+    if (size > 0)
+    {
+        std::size_t old_size{string.size()};
+        // vsnprintf writes a terminating null, which the resized string has
+        // room for past its end.
+        string.resize(old_size + static_cast<std::size_t>(size));
+        std::vsnprintf(&string[old_size], static_cast<std::size_t>(size) + 1, format, args);
+    }
+    va_end(args);
+}
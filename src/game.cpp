@@ -8,7 +8,12 @@
 Game::Game(const GameConfiguration& gc, GameState* start)
     : m_window{sf::VideoMode{gc.get_window_size().x, gc.get_window_size().y}, gc.get_data().title}, 
     m_current_state{start}, 
-    m_configuration{gc}
+    m_score_store{},
+    m_configuration{gc},
+    m_thread_pool{gc.get_data().worker_threads},
+    m_view{sf::FloatRect{0.f, 0.f, static_cast<float>(gc.get_window_size().x),
+                         static_cast<float>(gc.get_window_size().y)}},
+    m_render_thread{m_window}
 {
     sf::Image icon{};
      if (!icon.loadFromFile("assets/images/icon.png"))
@@ -16,13 +21,14 @@ Game::Game(const GameConfiguration& gc, GameState* start)
 
     m_window.setIcon(28, 28, icon.getPixelsPtr());
     m_window.setFramerateLimit(gc.get_data().fps);
+    m_configuration.set_score_store(&m_score_store);
     m_current_state->init(m_configuration);
 }
 
 Game::~Game()
 {
+    close_window();
     delete m_current_state;
-    m_window.close();
 }
 
 void Game::run()
@@ -33,10 +39,17 @@ void Game::run()
     }
 
     sf::Clock clock{};
+    sf::Clock frame_clock{};
+    unsigned int fps{m_configuration.get_data().fps};
+    sf::Time frame_time{fps > 0 ? sf::seconds(1.f / fps) : sf::Time::Zero};
 
+    // One context for all frames, so its memory is reused.
+    Context context{sf::Time::Zero, m_window};
+    context.set_thread_pool(&m_thread_pool);
+    m_render_thread.start();
     while (m_window.isOpen())
     {
-        Context context{clock.restart(), m_window};
+        context.set_delta(clock.restart());
         sf::Event event;
         while (m_window.pollEvent(event))
         {
@@ -46,11 +59,18 @@ void Game::run()
 
         m_current_state->update(context);
 
-        m_window.clear();
-        m_current_state->render(m_window);
-        m_window.display();
+        RenderSnapshot &snapshot{m_render_thread.get_back_buffer()};
+        snapshot.reset(m_window.getSize(), m_view);
+        m_current_state->render(snapshot);
+        m_render_thread.submit();
 
         handle_context(context);
+        context.end_frame();
+
+        // The window limits the frame rate on the render thread, the
+        // simulation is limited here instead.
+        sf::sleep(frame_time - frame_clock.getElapsedTime());
+        frame_clock.restart();
     }
 }
 
@@ -67,12 +87,12 @@ void Game::handle(const sf::Event &event)
 {
     if (event.type == sf::Event::Closed)
     {
-        m_window.close();
+        close_window();
     }
     else if (event.type == sf::Event::Resized)
     {
         sf::FloatRect visible_area(0, 0, event.size.width, event.size.height);
-        m_window.setView(sf::View(visible_area));
+        m_view = sf::View(visible_area);
         m_configuration.update_window_size({event.size.width, event.size.height});
     }
     else if (event.type == sf::Event::LostFocus)
@@ -93,7 +113,13 @@ void Game::handle_context(Context &context)
         switch_state(state);
 
     if (context.has_exited())
-        m_window.close();
+        close_window();
+}
+
+void Game::close_window()
+{
+    m_render_thread.stop();
+    m_window.close();
 }
 
 void Game::switch_state(GameState *state)
@@ -1,4 +1,5 @@
 #include "gameconfiguration.hpp"
+#include "scorestore.hpp"
 
 #include <fstream>
 #include <sstream>
@@ -156,6 +157,9 @@ NormalModeData::NormalModeData()
       spawn_time_multiplier{0.0f},
       spawn_time_min{0.0f},
       spawn_seed{0},
+      archetype_file{},
+      spawn_file{},
+      wave_file{},
       minion_data{},
       player_data{}
 {
@@ -206,6 +210,21 @@ bool NormalModeData::set_value(const std::string &key, const std::string &value)
             throw std::logic_error("SPAWN_SEED value is not a valid uint.");
         return true;
     }
+    else if (key == "ARCHETYPE_FILE")
+    {
+        archetype_file = value;
+        return true;
+    }
+    else if (key == "SPAWN_FILE")
+    {
+        spawn_file = value;
+        return true;
+    }
+    else if (key == "WAVE_FILE")
+    {
+        wave_file = value;
+        return true;
+    }
     else
     {
         if (minion_data.set_value(key, value))
@@ -263,7 +282,8 @@ GameData::GameData()
       window_height{750},
       fps{0},
       music_volume{0.0f},
-      effects_volume{0.0f}
+      effects_volume{0.0f},
+      worker_threads{0}
 {
 }
 
@@ -305,16 +325,17 @@ bool GameData::set_value(const std::string &key, const std::string &value)
             throw std::logic_error("EFFECTS_VOLUME value is not a valid float.");
         return true;
     }
+    else if (key == "WORKER_THREADS")
+    {
+        if (!(ss >> worker_threads))
+            throw std::logic_error("WORKER_THREADS value is not a valid uint.");
+        return true;
+    }
     return false;
 }
 
 /*==============================GameConfiguration=============================*/
 
-GameConfiguration::~GameConfiguration()
-{
-    write_high_score(m_high_score);
-}
-
 const GameData &GameConfiguration::get_data() const
 {
     return m_g_data;
@@ -337,12 +358,17 @@ sf::Vector2u GameConfiguration::get_window_size() const
 
 unsigned int GameConfiguration::get_high_score() const
 {
-    return m_high_score;
+    return m_score_store == nullptr ? 0 : m_score_store->get_high_score();
 }
 
-void GameConfiguration::update_high_score(unsigned int score) const
+ScoreStore *GameConfiguration::get_score_store() const
 {
-    score > m_high_score ? m_high_score = score : m_high_score = m_high_score;
+    return m_score_store;
+}
+
+void GameConfiguration::set_score_store(ScoreStore *score_store)
+{
+    m_score_store = score_store;
 }
 
 void GameConfiguration::update_window_size(const sf::Vector2u &window_size)
@@ -372,7 +398,7 @@ GameConfiguration GameConfiguration::from_file(const std::string &path)
         std::getline(ss, value, ';');
         check_key(key, value, g_data, nm_data, bm_data);
     }
-    return GameConfiguration{g_data, nm_data, bm_data, load_high_score()};
+    return GameConfiguration{g_data, nm_data, bm_data};
 }
 
 GameConfiguration GameConfiguration::default_config()
@@ -411,6 +437,8 @@ void GameConfiguration::write_default_config()
          << "WINDOW_WIDTH=900;\n"
          << "WINDOW_HEIGHT=900;\n"
          << "FPS=60;\n"
+         << "// Number of extra threads used to update objects, 0 to pick based on the CPU\n"
+         << "WORKER_THREADS=0;\n"
          << "// NormalMode related configuration\n"
          << "START_LEVEL=1;\n"
          << "LEVEL_INCREASE_TIME=10.0;\n"
@@ -419,6 +447,12 @@ void GameConfiguration::write_default_config()
          << "SPAWN_TIME_MULTIPLIER=0.98;\n"
          << "SPAWN_TIME_MIN=0.3;\n"
          << "SPAWN_SEED=0;\n"
+         << "// Stats of the enemy types, see assets/archetypes.txt\n"
+         << "ARCHETYPE_FILE=assets/archetypes.txt;\n"
+         << "// Chances of the enemy types per level, see assets/spawns.txt\n"
+         << "SPAWN_FILE=assets/spawns.txt;\n"
+         << "// Scripted waves, random spawns after the last one. Compile assets/waves.txt with wavec\n"
+         << "// WAVE_FILE=assets/waves.wave;\n"
          << "// Player data\n"
          << "PLAYER_HEALTH=5;\n"
          << "PLAYER_SPEED=100.0;\n"
@@ -446,37 +480,13 @@ void GameConfiguration::write_default_config()
          << "EFFECTS_VOLUME=100.0;\n";
 }
 
-unsigned int GameConfiguration::load_high_score()
-{
-    std::ifstream fs{"high_score.txt"};
-    if (!fs.is_open())
-    {
-        return 0;
-    }
-    else
-    {
-        unsigned int high_score{};
-        fs >> high_score;
-        fs.close();
-        return high_score;
-    }
-}
-
-void GameConfiguration::write_high_score(unsigned int score)
-{
-    std::ofstream fs{"high_score.txt"};
-    fs << score;
-    fs.close();
-}
-
 GameConfiguration::GameConfiguration(
     const GameData &g_data,
     const NormalModeData &nm_data,
-    const BossModeData &bm_data,
-    unsigned int high_score)
+    const BossModeData &bm_data)
     : m_g_data{g_data},
       m_nm_data{nm_data},
       m_bm_data{bm_data},
-      m_high_score{high_score}
+      m_score_store{nullptr}
 {
 }
\ No newline at end of file
@@ -1,9 +1,75 @@
 #include "gameobject.hpp"
+#include <algorithm>
 #include <cmath>
 
+CollisionLayer operator|(CollisionLayer first, CollisionLayer second)
+{
+    return static_cast<CollisionLayer>(static_cast<unsigned>(first) | static_cast<unsigned>(second));
+}
+
+bool has_layer(CollisionLayer layers, CollisionLayer layer)
+{
+    return (static_cast<unsigned>(layers) & static_cast<unsigned>(layer)) != 0;
+}
+
+ProjectileHit::ProjectileHit()
+    : position{},
+      damage{0},
+      friendly{false}
+{
+}
+
+ProjectileHit::ProjectileHit(const sf::Vector2f &position, int damage, bool friendly)
+    : position{position},
+      damage{damage},
+      friendly{friendly}
+{
+}
 
 GameObject::GameObject()
-    : m_removed{false}
+    : m_removed{false},
+      m_cached_bounds{},
+      m_cached_transform{},
+      m_bounds_dirty{true},
+      m_local_colliders{},
+      m_sub_colliders{}
+{
+}
+
+bool GameObject::render_batched(RenderBatch &) const
+{
+    return false;
+}
+
+void GameObject::start_timers(TimerWheel &)
+{
+}
+
+CollisionLayer GameObject::get_layer() const
+{
+    return CollisionLayer::None;
+}
+
+ObjectKind GameObject::get_kind() const
+{
+    return ObjectKind::Other;
+}
+
+void GameObject::collision_enter(const GameObject *other)
+{
+    collision(other);
+}
+
+void GameObject::collision_stay(const GameObject *other)
+{
+    collision(other);
+}
+
+void GameObject::collision_exit(const GameObject *)
+{
+}
+
+void GameObject::projectile_hit(const ProjectileHit &)
 {
 }
 
@@ -12,6 +78,86 @@ bool GameObject::collides(const GameObject *other) const
     return bounds().intersects(other->bounds());
 }
 
+bool GameObject::get_collision_shape(CollisionShape &) const
+{
+    return false;
+}
+
+const sf::FloatRect &GameObject::get_cached_bounds() const
+{
+    return m_cached_bounds;
+}
+
+bool GameObject::refresh_bounds()
+{
+    const sf::Transformable *transform{get_transform()};
+    TransformKey key{};
+    if (transform != nullptr)
+    {
+        key = TransformKey{transform->getPosition(), transform->getScale(),
+                           transform->getOrigin(), transform->getRotation()};
+        if (!m_bounds_dirty &&
+            key.position == m_cached_transform.position &&
+            key.scale == m_cached_transform.scale &&
+            key.origin == m_cached_transform.origin &&
+            key.rotation == m_cached_transform.rotation)
+        {
+            return false;
+        }
+    }
+
+    if (transform != nullptr && !m_local_colliders.empty())
+    {
+        // Transform the sub-colliders once, the narrowphase tests them.
+        sf::Transform matrix{Narrowphase::get_transform(*transform)};
+        sf::FloatRect first{matrix.transformRect(m_local_colliders.front())};
+        float left{first.left};
+        float top{first.top};
+        float right{first.left + first.width};
+        float bottom{first.top + first.height};
+        m_sub_colliders.resize(m_local_colliders.size());
+        for (std::size_t i{0}; i < m_local_colliders.size(); i++)
+        {
+            m_sub_colliders[i] = CollisionShape{matrix, m_local_colliders[i], nullptr, sf::Vector2i{}};
+            sf::FloatRect box{matrix.transformRect(m_local_colliders[i])};
+            left = std::min(left, box.left);
+            top = std::min(top, box.top);
+            right = std::max(right, box.left + box.width);
+            bottom = std::max(bottom, box.top + box.height);
+        }
+        m_cached_bounds = sf::FloatRect{left, top, right - left, bottom - top};
+    }
+    else
+    {
+        m_cached_bounds = bounds();
+    }
+    m_cached_transform = key;
+    m_bounds_dirty = false;
+    return true;
+}
+
+const std::vector<CollisionShape> &GameObject::get_sub_colliders() const
+{
+    return m_sub_colliders;
+}
+
+void GameObject::mark_bounds_dirty()
+{
+    m_bounds_dirty = true;
+}
+
+void GameObject::set_sub_colliders(const std::vector<sf::FloatRect> &colliders)
+{
+    m_local_colliders = colliders;
+    m_sub_colliders.clear();
+    mark_bounds_dirty();
+}
+
+const sf::Transformable *GameObject::get_transform() const
+{
+    return nullptr;
+}
+
 void GameObject::remove()
 {
     m_removed = true;
@@ -1,15 +1,70 @@
 #include "gamestate.hpp"
 #include "gameobject.hpp"
+#include "narrowphase.hpp"
 #include "player.hpp"
 #include "resourcemanager.hpp"
 #include "endscreen.hpp"
+#include "enemyboss.hpp"
+#include "enemyboss2.hpp"
 #include "pausemenu.hpp"
+#include "powerup.hpp"
+#include "profiler.hpp"
+#include "shockwave.hpp"
+#include "threadpool.hpp"
 
 #include <SFML/Graphics.hpp>
+#include <atomic>
 #include <cmath>
 #include <algorithm>
 #include <sstream>
 
+namespace
+{
+    // Below this many objects refreshing the bounds is cheaper than waking up
+    // the workers. m_objects also holds the objects of entities, so big waves
+    // reach it.
+    const std::size_t s_parallel_threshold{256};
+    // Same for the update and the render list, which only walk
+    // m_active_objects. With enemies in m_entities, NormalMode and BossMode
+    // have a few dozen active objects at most and stay serial, which is
+    // cheaper at that size. The enemies themselves are updated in parallel by
+    // EntityWorld::update(...).
+    const std::size_t s_parallel_update_threshold{256};
+    const std::size_t s_min_chunk_size{64};
+    // Below this many objects collision is checked in a single chunk.
+    const std::size_t s_parallel_collision_threshold{128};
+
+    // Loops over the objects of one kind. The update and render functions of
+    // every kind are final, so the calls are not virtual.
+    template <typename Kind>
+    void update_kind(const std::vector<Kind *> &objects, Context &context)
+    {
+        for (Kind *object : objects)
+        {
+            object->update(context);
+        }
+    }
+
+    template <typename Kind>
+    void batch_kind(const std::vector<Kind *> &objects, RenderBatch &batch)
+    {
+        for (const Kind *object : objects)
+        {
+            if (!object->render_batched(batch))
+                batch.add_unbatched(object);
+        }
+    }
+
+    template <typename Kind>
+    void erase_removed(std::vector<Kind *> &objects)
+    {
+        objects.erase(std::remove_if(objects.begin(), objects.end(),
+                                     [](const Kind *object)
+                                     { return object->is_removed(); }),
+                      objects.end());
+    }
+}
+
 /*===================================GameMode=================================*/
 
 GameMode::GameMode()
@@ -26,8 +81,42 @@ GameMode::GameMode(const std::vector<GameObject *> &objects, Player *player)
     : m_clock{},
       m_pause_time{},
       m_paused{false},
-      m_objects{objects},
-      m_player{player},
+      m_objects{},
+      m_players{},
+      m_bosses{},
+      m_bosses2{},
+      m_powerups{},
+      m_shockwaves{},
+      m_active_objects{},
+      m_object_handles{},
+      m_handles{},
+      m_player{},
+      m_projectiles{},
+      m_entities{},
+      m_timers{},
+      m_events{},
+      m_spawn_buffers{},
+      m_thread_pool{nullptr},
+      m_render_batches{},
+      m_render_targets{},
+      m_render_order{},
+      m_snapshot_batches{},
+      m_frame_graph{},
+      m_frame_chunk_count{0},
+      m_frame_context{nullptr},
+      m_hud{},
+      m_text_buffer{},
+      m_bounds{},
+      m_collision_pairs{},
+      m_collision_rows{},
+      m_contacts{},
+      m_contact_pairs{},
+      m_contact_events{},
+      m_spatial_grid{},
+      m_area_effects{},
+      m_area_hits{},
+      m_new_objects{},
+      m_new_projectiles{},
       m_background{},
       m_music{},
       m_music_volume{0.f},
@@ -35,6 +124,35 @@ GameMode::GameMode(const std::vector<GameObject *> &objects, Player *player)
       m_music_fade_duration{0.f},
       m_music_fade_type{FadeType::None}
 {
+    for (GameObject *object : objects)
+    {
+        ObjectHandle handle{add_object(object)};
+        if (object == player)
+            m_player = handle;
+    }
+
+    // The score and health of the player only change here, on the thread
+    // dispatching the events, so they need no locking.
+    m_events.subscribe<PlayerHit>([this](const PlayerHit &event)
+                                  {
+                                      if (Player *player{get_player()})
+                                          player->lose_health(event.damage);
+                                  });
+    m_events.subscribe<EnemyKilled>([this](const EnemyKilled &event)
+                                    {
+                                        if (Player *player{get_player()})
+                                            player->kills(event.score, false);
+                                    });
+    m_events.subscribe<BossDefeated>([this](const BossDefeated &event)
+                                     {
+                                         if (Player *player{get_player()})
+                                             player->kills(event.score, true);
+                                     });
+    m_events.subscribe<PowerupCollected>([this](const PowerupCollected &event)
+                                         {
+                                             if (Player *player{get_player()})
+                                                 player->collect(event.type);
+                                         });
 }
 
 GameMode::~GameMode()
@@ -45,36 +163,117 @@ GameMode::~GameMode()
     }
 }
 
-void GameMode::render(sf::RenderWindow &window) const
+void GameMode::render(RenderSnapshot &snapshot) const
 {
-    window.draw(m_background);
-    for (const GameObject *object : m_objects)
-    {
-        object->render(window);
-    }
+    sf::Clock clock{};
+    snapshot.draw(m_background);
+    build_render_list(snapshot);
+    m_projectiles.render(snapshot);
+    Profiler::record("render.build", clock.getElapsedTime());
 }
 
 void GameMode::update(Context &context)
 {
-    // Update context with all currently spawned objects & set player.
-    context.set_player(m_player);
+    ThreadPool *pool{context.get_thread_pool()};
+    m_thread_pool = pool;
+    m_frame_context = &context;
+    context.set_spatial_grid(&m_spatial_grid);
+    context.set_event_bus(&m_events);
+    // Timers only fire when they are due, the rest are not looked at.
+    m_timers.advance(context.get_delta(), context);
+    Player *player{get_player()};
+    m_hud = HudData{player != nullptr, 0, 0, {}, 0};
+    if (player != nullptr)
+    {
+        m_hud.score = player->get_score();
+        m_hud.health = player->get_health();
+        m_hud.effect_count = player->get_effects().get_status(m_hud.effects);
+    }
+
+    std::size_t chunk_count{1};
+    if (pool != nullptr && m_objects.size() >= s_parallel_collision_threshold)
+        chunk_count = pool->get_thread_count() * 2;
+    if (m_collision_pairs.size() < chunk_count)
+    {
+        m_collision_pairs.resize(chunk_count);
+        m_collision_rows.resize(chunk_count);
+    }
+    if (m_frame_graph.get_task_count() == 0 || chunk_count != m_frame_chunk_count)
+        build_frame_graph(chunk_count);
+    m_frame_graph.run(pool);
+    m_frame_context = nullptr;
+    context.set_spatial_grid(nullptr);
+    apply_area_effects(context);
 
-    update_objects(context);
-    collision_check();
+    // The simulation step is done, let the subscribers react to it.
+    sf::Clock events_clock{};
+    Profiler::count("events", m_events.get_size());
+    m_events.dispatch();
+    Profiler::record("events.dispatch", events_clock.getElapsedTime());
 
     // If player is removed (dead), end game & skip deletion of objects. Otherwise,
     // the player will be deleted and the game will crash in next state.
-    if (m_player != nullptr && m_player->is_removed())
+    player = get_player();
+    if (player != nullptr && player->is_removed())
     {
-        context.set_next_state(new EndScreen{this, m_player});
+        context.set_next_state(new EndScreen{this, player, get_level()});
         // Objects need to be spawned, because context throws an exception if
         // there objects remaining when it is destroyed.
         spawn_new_objects(context);
         return;
     }
     delete_removed_objects();
+    m_projectiles.remove_dead();
     spawn_new_objects(context);
-    update_music();
+
+    // Rebuilt after deleting, so the grid never points to deleted objects.
+    sf::Clock clock{};
+    m_spatial_grid.build(m_objects);
+    Profiler::record("spatial.build", clock.getElapsedTime());
+}
+
+void GameMode::build_frame_graph(std::size_t chunk_count)
+{
+    m_frame_graph.clear();
+    m_frame_chunk_count = chunk_count;
+    TaskGraph::TaskId entities_task{m_frame_graph.add_task(
+        "entities.update", [this]
+        { m_entities.update(*m_frame_context); })};
+    TaskGraph::TaskId update_task{m_frame_graph.add_task(
+        "update", [this]
+        { update_objects(*m_frame_context); },
+        {entities_task})};
+    TaskGraph::TaskId bounds_task{m_frame_graph.add_task(
+        "collision.bounds", [this]
+        { refresh_bounds(m_thread_pool); },
+        {update_task})};
+    std::vector<TaskGraph::TaskId> find_tasks{};
+    for (std::size_t chunk{0}; chunk < chunk_count; chunk++)
+    {
+        find_tasks.push_back(m_frame_graph.add_task(
+            "collision.find." + std::to_string(chunk), [this, chunk, chunk_count]
+            { find_collisions(chunk, chunk_count); },
+            {bounds_task}));
+    }
+    TaskGraph::TaskId resolve_task{m_frame_graph.add_task(
+        "collision.resolve", [this]
+        { resolve_collisions(); },
+        find_tasks)};
+    TaskGraph::TaskId projectile_task{m_frame_graph.add_task(
+        "projectiles.update", [this]
+        { m_projectiles.update(m_frame_context->get_delta().asSeconds(),
+                               m_frame_context->get_window_size()); })};
+    m_frame_graph.add_task(
+        "projectiles.collide", [this]
+        { m_projectiles.collide(m_objects); },
+        {resolve_task, projectile_task});
+    // Nothing else uses the frame arena while the graph runs.
+    m_frame_graph.add_task(
+        "hud", [this]
+        { update_texts(m_hud, m_frame_context->get_frame_arena()); });
+    m_frame_graph.add_task(
+        "music", [this]
+        { update_music(); });
 }
 
 void GameMode::handle(const sf::Event &event, Context &context)
@@ -89,8 +288,13 @@ void GameMode::handle(const sf::Event &event, Context &context)
             return;
         }
     }
-    // Handle all objects.
-    for (GameObject *object : m_objects)
+    // Handle all objects. Of the kinds only the player takes input.
+    for (Player *player : m_players)
+    {
+        if (player->handle(event, context))
+            return;
+    }
+    for (GameObject *object : m_active_objects)
     {
         if (object->handle(event, context))
             break;
@@ -104,40 +308,260 @@ void GameMode::pause()
     m_paused = true;
 }
 
+unsigned int GameMode::get_level() const
+{
+    return 0;
+}
+
 void GameMode::update_objects(Context &context)
 {
-    for (GameObject *object : m_objects)
+    update_kind(m_players, context);
+    update_kind(m_bosses, context);
+    update_kind(m_bosses2, context);
+    update_kind(m_powerups, context);
+    update_kind(m_shockwaves, context);
+
+    ThreadPool *pool{context.get_thread_pool()};
+    if (pool == nullptr || pool->get_thread_count() == 1 ||
+        m_active_objects.size() < s_parallel_update_threshold)
+    {
+        for (GameObject *object : m_active_objects)
+        {
+            object->update(context);
+        }
+    }
+    else
     {
-        object->update(context);
+        // A few chunks per thread so uneven chunks even out.
+        std::size_t chunk_size{std::max(s_min_chunk_size,
+                                        m_active_objects.size() / (pool->get_thread_count() * 4))};
+        std::size_t chunk_count{(m_active_objects.size() + chunk_size - 1) / chunk_size};
+        if (m_spawn_buffers.size() < chunk_count)
+            m_spawn_buffers.resize(chunk_count);
+
+        pool->parallel_for(m_active_objects.size(), chunk_size,
+                           [this, &context](std::size_t chunk, std::size_t begin, std::size_t end)
+                           {
+                               Context::set_thread_spawn_buffer(&m_spawn_buffers[chunk]);
+                               try
+                               {
+                                   for (std::size_t i{begin}; i < end; i++)
+                                   {
+                                       m_active_objects[i]->update(context);
+                                   }
+                               }
+                               catch (...)
+                               {
+                                   Context::set_thread_spawn_buffer(nullptr);
+                                   throw;
+                               }
+                               Context::set_thread_spawn_buffer(nullptr);
+                           });
+
+        for (std::size_t chunk{0}; chunk < chunk_count; chunk++)
+        {
+            context.merge_spawn_buffer(m_spawn_buffers[chunk]);
+        }
     }
 }
 
-void GameMode::collision_check()
+void GameMode::refresh_bounds(ThreadPool *pool)
+{
+    m_bounds.resize(m_objects.size());
+    std::atomic<std::size_t> recomputed{0};
+    auto refresh = [this, &recomputed](std::size_t, std::size_t begin, std::size_t end)
+    {
+        std::size_t count{0};
+        for (std::size_t i{begin}; i < end; i++)
+        {
+            if (m_objects[i]->refresh_bounds())
+                count++;
+            m_bounds.set(i, m_objects[i]->get_cached_bounds());
+        }
+        recomputed += count;
+    };
+
+    if (pool == nullptr || pool->get_thread_count() == 1 ||
+        m_objects.size() < s_parallel_threshold)
+    {
+        refresh(0, 0, m_objects.size());
+    }
+    else
+    {
+        pool->parallel_for(m_objects.size(),
+                           std::max(s_min_chunk_size, m_objects.size() / pool->get_thread_count()),
+                           refresh);
+    }
+    Profiler::count("bounds.recomputed", recomputed);
+}
+
+void GameMode::find_collisions(std::size_t chunk, std::size_t chunk_count)
 {
     // Inspired by lecture by Christoffer Holm. (https://www.ida.liu.se/~TDDC76/current/fo/index.sv.shtml)
-    for (unsigned int i{0}; i < m_objects.size(); i++)
+    // Row i checks n - 1 - i pairs. Pick the rows so that every chunk gets an
+    // equal share of the triangle.
+    double n{static_cast<double>(m_objects.size())};
+    auto first_row = [n, chunk_count](std::size_t k)
+    {
+        double share{static_cast<double>(k) / chunk_count};
+        return static_cast<std::size_t>(n - n * std::sqrt(1.0 - share));
+    };
+    std::size_t begin{first_row(chunk)};
+    std::size_t end{chunk + 1 == chunk_count ? m_objects.size() : first_row(chunk + 1)};
+
+    std::vector<std::pair<std::size_t, std::size_t>> &pairs{m_collision_pairs[chunk]};
+    std::vector<std::size_t> &row{m_collision_rows[chunk]};
+    pairs.clear();
+    for (std::size_t i{begin}; i < end; i++)
     {
-        for (unsigned int j{i + 1}; j < m_objects.size(); j++)
+        row.clear();
+        m_bounds.find_overlaps(i, i + 1, m_objects.size(), row);
+        for (std::size_t j : row)
         {
-            if (m_objects.at(i)->collides(m_objects.at(j)))
+            if (Narrowphase::overlaps(*m_objects[i], *m_objects[j]))
+                pairs.emplace_back(i, j);
+        }
+    }
+}
+
+void GameMode::resolve_collisions()
+{
+    // Chunks cover increasing rows, so this is the order of a serial check.
+    m_contact_pairs.clear();
+    for (std::vector<std::pair<std::size_t, std::size_t>> &pairs : m_collision_pairs)
+    {
+        for (const std::pair<std::size_t, std::size_t> &pair : pairs)
+        {
+            m_contact_pairs.emplace_back(m_objects[pair.first], m_objects[pair.second]);
+        }
+        pairs.clear();
+    }
+
+    m_contact_events.clear();
+    m_contacts.update(m_contact_pairs, m_contact_events);
+    dispatch_contact_events();
+}
+
+void GameMode::dispatch_contact_events()
+{
+    for (const ContactEvent &event : m_contact_events)
+    {
+        // An object removed earlier in the frame, e.g. a power-up that was
+        // picked up, can not be hit again.
+        bool removed{event.first->is_removed() || event.second->is_removed()};
+        switch (event.type)
+        {
+        case ContactEvent::Type::Enter:
+            if (!removed)
             {
-                m_objects.at(i)->collision(m_objects.at(j));
-                m_objects.at(j)->collision(m_objects.at(i));
+                publish_pickup(event.first, event.second);
+                publish_pickup(event.second, event.first);
+                event.first->collision_enter(event.second);
+                event.second->collision_enter(event.first);
             }
+            break;
+        case ContactEvent::Type::Stay:
+            if (!removed)
+            {
+                event.first->collision_stay(event.second);
+                event.second->collision_stay(event.first);
+            }
+            break;
+        case ContactEvent::Type::Exit:
+            event.first->collision_exit(event.second);
+            event.second->collision_exit(event.first);
+            break;
         }
     }
+    m_contact_events.clear();
+}
+
+void GameMode::publish_pickup(const GameObject *player, const GameObject *powerup)
+{
+    if (player->get_layer() != CollisionLayer::Player || powerup->get_layer() != CollisionLayer::PowerUp)
+        return;
+    sf::FloatRect bounds{powerup->bounds()};
+    m_events.publish(PowerupCollected{static_cast<const PowerUp *>(powerup)->get_type(),
+                                      sf::Vector2f{bounds.left + bounds.width / 2.f,
+                                                   bounds.top + bounds.height / 2.f}});
+}
+
+void GameMode::update_texts(const HudData &, FrameArena &)
+{
+}
+
+bool GameMode::set_text(sf::Text &text, const FrameString &string)
+{
+    const sf::String &shown{text.getString()};
+    if (shown.getSize() == string.size() && std::equal(string.begin(), string.end(), shown.begin()))
+        return false;
+    // One character at a time, a single character fits in the string without
+    // allocating. setString(...) then copies into the text's own memory.
+    m_text_buffer.clear();
+    for (char character : string)
+    {
+        m_text_buffer += sf::String{static_cast<sf::Uint32>(static_cast<unsigned char>(character))};
+    }
+    text.setString(m_text_buffer);
+    return true;
+}
+
+void GameMode::apply_area_effects(Context &context)
+{
+    context.get_new_area_effects(m_area_effects);
+    if (m_area_effects.empty())
+        return;
+
+    sf::Clock clock{};
+    // The grid is from the end of the last frame. Objects have moved since,
+    // and objects spawned then had no bounds yet, so it is rebuilt from the
+    // bounds refreshed this frame.
+    m_spatial_grid.build(m_objects);
+    std::size_t hits{0};
+    for (const AreaEffect &effect : m_area_effects)
+    {
+        // Friendly effects hit enemies, the others hit the player.
+        CollisionLayer layer{effect.friendly ? CollisionLayer::Enemy : CollisionLayer::Player};
+        m_area_hits.clear();
+        m_spatial_grid.find_in_ring(effect.center, effect.inner_radius, effect.outer_radius,
+                                    layer, m_area_hits);
+        for (const GameObject *found : m_area_hits)
+        {
+            // The grid only gives read access, but the objects are owned here.
+            GameObject *object{const_cast<GameObject *>(found)};
+            if (object->is_removed())
+                continue;
+            object->projectile_hit(ProjectileHit{effect.center, effect.damage, effect.friendly});
+            hits++;
+        }
+        m_projectiles.kill_in_ring(effect.center, effect.inner_radius, effect.outer_radius,
+                                   !effect.friendly);
+    }
+    m_area_effects.clear();
+    Profiler::count("area_effects.hits", hits);
+    Profiler::record("area_effects", clock.getElapsedTime());
 }
 
 void GameMode::delete_removed_objects()
 {
+    m_contact_events.clear();
+    m_contacts.remove_removed_objects(m_contact_events);
+    dispatch_contact_events();
+
+    erase_removed(m_players);
+    erase_removed(m_bosses);
+    erase_removed(m_bosses2);
+    erase_removed(m_powerups);
+    erase_removed(m_shockwaves);
+    erase_removed(m_active_objects);
     // Inspired by lecture by Christoffer Holm. (https://www.ida.liu.se/~TDDC76/current/fo/index.sv.shtml)
     for (unsigned int i{0}; i < m_objects.size();)
     {
         if (m_objects.at(i)->is_removed())
         {
-            std::swap(m_objects.at(i), m_objects.back());
-            delete m_objects.back();
-            m_objects.pop_back();
+            GameObject *object{m_objects.at(i)};
+            erase_object(i);
+            delete object;
         }
         else
         {
@@ -148,50 +572,107 @@ void GameMode::delete_removed_objects()
 
 void GameMode::spawn_new_objects(Context &context)
 {
-    std::vector<GameObject *> new_objects{};
-    context.get_new_objects(new_objects);
+    context.get_new_objects(m_new_objects);
 
     // Spawn new objects.
-    for (GameObject *object : new_objects)
+    for (GameObject *object : m_new_objects)
+    {
+        add_object(object);
+    }
+    m_new_objects.clear();
+
+    context.get_new_projectiles(m_new_projectiles);
+    for (const ProjectileSpawn &projectile : m_new_projectiles)
     {
-        m_objects.push_back(object);
+        m_projectiles.spawn(projectile);
     }
+    m_new_projectiles.clear();
 }
 
 void GameMode::set_player(Player *player)
 {
     remove_player();
-    spawn_object(player);
-    m_player = player;
+    m_player = spawn_object(player);
 }
 
 void GameMode::remove_player(bool delete_player)
 {
-    if (m_player != nullptr)
+    std::size_t index{m_handles.get_index(m_player)};
+    if (index != HandleTable::s_no_index)
     {
-        auto it = std::find(m_objects.begin(), m_objects.end(), m_player);
-        if (it != m_objects.end())
-        {
-            // Remove old player from objects vector.
-            std::swap(*it, m_objects.back());
-            m_objects.pop_back();
-            if (delete_player)
-                delete m_player;
-            m_player = nullptr;
-        }
+        // Remove old player from objects vector.
+        Player *player{static_cast<Player *>(m_objects[index])};
+        m_contacts.forget(player);
+        m_spatial_grid.clear();
+        erase_object(index);
+        m_players.erase(std::find(m_players.begin(), m_players.end(), player));
+        if (delete_player)
+            delete player;
     }
+    m_player = ObjectHandle{};
 }
 
 Player *GameMode::get_player() const
 {
-    return m_player;
+    return static_cast<Player *>(get_object(m_player));
 }
 
-void GameMode::spawn_object(GameObject *object)
+GameObject *GameMode::get_object(ObjectHandle handle) const
+{
+    std::size_t index{m_handles.get_index(handle)};
+    return index == HandleTable::s_no_index ? nullptr : m_objects[index];
+}
+
+ObjectHandle GameMode::spawn_object(GameObject *object)
 {
     if (object == nullptr)
         throw std::logic_error("SpawnERROR: tried to spawn nullptr.");
+    return add_object(object);
+}
+
+ObjectHandle GameMode::add_object(GameObject *object)
+{
+    ObjectHandle handle{m_handles.insert(m_objects.size())};
     m_objects.push_back(object);
+    m_object_handles.push_back(handle);
+    object->start_timers(m_timers);
+    switch (object->get_kind())
+    {
+    case ObjectKind::Entity:
+        break;
+    case ObjectKind::Player:
+        m_players.push_back(static_cast<Player *>(object));
+        break;
+    case ObjectKind::EnemyBoss:
+        m_bosses.push_back(static_cast<EnemyBoss *>(object));
+        break;
+    case ObjectKind::EnemyBoss2:
+        m_bosses2.push_back(static_cast<EnemyBoss2 *>(object));
+        break;
+    case ObjectKind::PowerUp:
+        m_powerups.push_back(static_cast<PowerUp *>(object));
+        break;
+    case ObjectKind::Shockwave:
+        m_shockwaves.push_back(static_cast<Shockwave *>(object));
+        break;
+    case ObjectKind::Other:
+        m_active_objects.push_back(object);
+        break;
+    }
+    return handle;
+}
+
+void GameMode::erase_object(std::size_t index)
+{
+    m_handles.erase(m_object_handles[index]);
+    if (index + 1 != m_objects.size())
+    {
+        m_objects[index] = m_objects.back();
+        m_object_handles[index] = m_object_handles.back();
+        m_handles.move(m_object_handles[index], index);
+    }
+    m_objects.pop_back();
+    m_object_handles.pop_back();
 }
 
 void GameMode::set_background(const std::string &path, const sf::Vector2u &window_size)
@@ -209,20 +690,28 @@ void GameMode::set_background(const std::string &path, const sf::Vector2u &windo
 
 void GameMode::clear_objects(bool delete_player)
 {
+    Player *player{get_player()};
     for (GameObject *object : m_objects)
     {
-        if (object != m_player || delete_player)
+        if (object != player || delete_player)
             delete object;
     }
     m_objects.clear();
-    if (!delete_player)
-    {
-        m_objects.push_back(m_player);
-    }
-    else
-    {
-        m_player = nullptr;
-    }
+    m_object_handles.clear();
+    m_handles.clear();
+    m_players.clear();
+    m_bosses.clear();
+    m_bosses2.clear();
+    m_powerups.clear();
+    m_shockwaves.clear();
+    m_active_objects.clear();
+    m_projectiles.clear();
+    m_contacts.clear();
+    m_spatial_grid.clear();
+    // The player keeps playing under a new handle.
+    m_player = ObjectHandle{};
+    if (!delete_player && player != nullptr)
+        m_player = add_object(player);
 }
 
 void GameMode::set_music(const std::string &path, float volume, bool loop)
@@ -291,11 +780,159 @@ const std::vector<GameObject *> &GameMode::get_objects() const
     return m_objects;
 }
 
+const ProjectileSystem &GameMode::get_projectiles() const
+{
+    return m_projectiles;
+}
+
+EntityWorld &GameMode::get_entities()
+{
+    return m_entities;
+}
+
+TimerWheel &GameMode::get_timers()
+{
+    return m_timers;
+}
+
+EventBus &GameMode::get_events()
+{
+    return m_events;
+}
+
 sf::Music &GameMode::get_music()
 {
     return m_music;
 }
 
+template <typename Function>
+void GameMode::for_each_chunk(std::size_t chunk_size, const Function &function) const
+{
+    if (m_thread_pool != nullptr && m_active_objects.size() >= s_parallel_update_threshold)
+        m_thread_pool->parallel_for(m_active_objects.size(), chunk_size, function);
+    else
+        function(0, 0, m_active_objects.size());
+}
+
+void GameMode::build_render_list(RenderSnapshot &snapshot) const
+{
+    ThreadPool *pool{m_thread_pool};
+    std::size_t chunk_size{std::max<std::size_t>(m_active_objects.size(), 1)};
+    if (pool != nullptr && pool->get_thread_count() > 1 &&
+        m_active_objects.size() >= s_parallel_update_threshold)
+    {
+        chunk_size = std::max(s_min_chunk_size,
+                              m_active_objects.size() / (pool->get_thread_count() * 4));
+    }
+    // Always one chunk, the first chunk also batches the entities and the
+    // objects of every kind.
+    std::size_t chunk_count{std::max<std::size_t>((m_active_objects.size() + chunk_size - 1) / chunk_size, 1)};
+    if (m_render_batches.size() < chunk_count)
+        m_render_batches.resize(chunk_count);
+
+    // 1. Every chunk batches its slice of objects.
+    for_each_chunk(chunk_size, [this](std::size_t chunk, std::size_t begin, std::size_t end)
+                   {
+                       RenderBatch &batch{m_render_batches[chunk]};
+                       batch.clear();
+                       if (chunk == 0)
+                       {
+                           m_entities.render(batch);
+                           batch_kind(m_powerups, batch);
+                           batch_kind(m_bosses, batch);
+                           batch_kind(m_bosses2, batch);
+                           batch_kind(m_players, batch);
+                           batch_kind(m_shockwaves, batch);
+                       }
+                       for (std::size_t i{begin}; i < end; i++)
+                       {
+                           if (!m_active_objects[i]->render_batched(batch))
+                               batch.add_unbatched(m_active_objects[i]);
+                       }
+                   });
+
+    // 2. Size one vertex array per segment, layer and texture, in order of
+    // segment, layer and then first use. Every group gets its own range in the
+    // array. Segments are numbered across chunks, so the unbatched objects of
+    // all chunks are drawn in object order between them.
+    std::vector<RenderTarget> &targets{m_render_targets};
+    targets.clear();
+    std::size_t segment_offset{0};
+    for (std::size_t chunk{0}; chunk < chunk_count; chunk++)
+    {
+        RenderBatch &batch{m_render_batches[chunk]};
+        for (std::size_t g{0}; g < batch.get_group_count(); g++)
+        {
+            RenderBatch::Group &group{batch.get_group(g)};
+            std::size_t segment{segment_offset + group.segment};
+            // Targets are added in order of segment, only the last ones can match.
+            std::size_t target{targets.size()};
+            for (std::size_t t{targets.size()}; t > 0 && targets[t - 1].segment == segment; t--)
+            {
+                if (targets[t - 1].layer == group.layer && targets[t - 1].texture == group.texture)
+                {
+                    target = t - 1;
+                    break;
+                }
+            }
+            if (target == targets.size())
+                targets.push_back(RenderTarget{segment, group.layer, group.texture, 0});
+            group.target_batch = target;
+            group.target_offset = targets[target].vertex_count;
+            targets[target].vertex_count += group.vertices.size();
+        }
+        segment_offset += batch.get_unbatched().size();
+    }
+    std::vector<std::size_t> &order{m_render_order};
+    order.resize(targets.size());
+    for (std::size_t i{0}; i < order.size(); i++)
+        order[i] = i;
+    // Ties are broken by first use, std::stable_sort would allocate a buffer.
+    std::sort(order.begin(), order.end(), [&targets](std::size_t lhs, std::size_t rhs)
+              { return targets[lhs].segment < targets[rhs].segment ||
+                       (targets[lhs].segment == targets[rhs].segment &&
+                        (targets[lhs].layer < targets[rhs].layer ||
+                         (targets[lhs].layer == targets[rhs].layer && lhs < rhs))); });
+
+    // Unbatched object number i is drawn before the batches of segment i + 1.
+    std::size_t unbatched_chunk{0};
+    std::size_t unbatched{0};
+    std::size_t drawn{0};
+    auto draw_unbatched = [this, &snapshot, &unbatched_chunk, &unbatched, &drawn](std::size_t segment)
+    {
+        for (; drawn < segment; drawn++, unbatched++)
+        {
+            while (unbatched == m_render_batches[unbatched_chunk].get_unbatched().size())
+            {
+                unbatched_chunk++;
+                unbatched = 0;
+            }
+            m_render_batches[unbatched_chunk].get_unbatched()[unbatched]->render(snapshot);
+        }
+    };
+    std::vector<std::size_t> &snapshot_batch{m_snapshot_batches};
+    snapshot_batch.resize(targets.size());
+    for (std::size_t i : order)
+    {
+        draw_unbatched(targets[i].segment);
+        snapshot_batch[i] = snapshot.add_batch(targets[i].texture, targets[i].vertex_count);
+    }
+    draw_unbatched(segment_offset);
+
+    // 3. Every chunk copies its vertices into its own ranges.
+    for_each_chunk(chunk_size, [this, &snapshot](std::size_t chunk, std::size_t, std::size_t)
+                   {
+                       const RenderBatch &batch{m_render_batches[chunk]};
+                       for (std::size_t g{0}; g < batch.get_group_count(); g++)
+                       {
+                           const RenderBatch::Group &group{batch.get_group(g)};
+                           sf::Vertex *vertices{snapshot.get_batch_vertices(m_snapshot_batches[group.target_batch])};
+                           std::copy(group.vertices.begin(), group.vertices.end(),
+                                     vertices + group.target_offset);
+                       }
+                   });
+}
+
 void GameMode::update_music()
 {
     if (m_music_fade_type == FadeType::None)
@@ -354,16 +991,16 @@ Menu::~Menu()
     }
 }
 
-void Menu::render(sf::RenderWindow &window) const
+void Menu::render(RenderSnapshot &snapshot) const
 {
     for (const sf::Sprite *sprite : m_sprites)
     {
-        window.draw(*sprite);
+        snapshot.draw(*sprite);
     }
 
     for (const Button *button : m_buttons)
     {
-        button->render(window);
+        button->render(snapshot);
     }
 }
 
@@ -0,0 +1,106 @@
+#include "handletable.hpp"
+
+#include <limits>
+#include <stdexcept>
+
+/*==================================Handle====================================*/
+
+bool Handle::is_null() const
+{
+    return generation == 0;
+}
+
+bool Handle::operator==(const Handle &other) const
+{
+    return index == other.index && generation == other.generation;
+}
+
+bool Handle::operator!=(const Handle &other) const
+{
+    return !(*this == other);
+}
+
+/*===============================HandleTable==================================*/
+
+const std::size_t HandleTable::s_no_index{std::numeric_limits<std::size_t>::max()};
+
+HandleTable::HandleTable()
+    : m_slots{},
+      m_free{s_no_index},
+      m_size{0}
+{
+}
+
+Handle HandleTable::insert(std::size_t index)
+{
+    std::size_t slot{m_free};
+    if (slot == s_no_index)
+    {
+        slot = m_slots.size();
+        m_slots.push_back(Slot{0, 1, false});
+    }
+    else
+    {
+        m_free = m_slots[slot].index;
+    }
+    m_slots[slot].index = index;
+    m_slots[slot].used = true;
+    m_size++;
+    return Handle{static_cast<std::uint32_t>(slot), m_slots[slot].generation};
+}
+
+bool HandleTable::erase(Handle handle)
+{
+    if (find(handle) == nullptr)
+        return false;
+    Slot &slot{m_slots[handle.index]};
+    slot.used = false;
+    // Skip 0 when wrapping around, it marks null handles.
+    slot.generation = slot.generation == std::numeric_limits<std::uint32_t>::max() ? 1 : slot.generation + 1;
+    slot.index = m_free;
+    m_free = handle.index;
+    m_size--;
+    return true;
+}
+
+void HandleTable::move(Handle handle, std::size_t index)
+{
+    if (find(handle) == nullptr)
+        throw std::logic_error("HandleTableERROR: tried to move an invalid handle.");
+    m_slots[handle.index].index = index;
+}
+
+std::size_t HandleTable::get_index(Handle handle) const
+{
+    const Slot *slot{find(handle)};
+    return slot == nullptr ? s_no_index : slot->index;
+}
+
+bool HandleTable::contains(Handle handle) const
+{
+    return find(handle) != nullptr;
+}
+
+std::size_t HandleTable::get_size() const
+{
+    return m_size;
+}
+
+void HandleTable::clear()
+{
+    for (std::size_t i{0}; i < m_slots.size(); i++)
+    {
+        if (m_slots[i].used)
+            erase(Handle{static_cast<std::uint32_t>(i), m_slots[i].generation});
+    }
+}
+
+const HandleTable::Slot *HandleTable::find(Handle handle) const
+{
+    if (handle.index >= m_slots.size())
+        return nullptr;
+    const Slot &slot{m_slots[handle.index]};
+    if (!slot.used || slot.generation != handle.generation)
+        return nullptr;
+    return &slot;
+}
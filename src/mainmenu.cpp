@@ -2,7 +2,6 @@
 #include "normalmode.hpp"
 #include "resourcemanager.hpp"
 #include "enemy.hpp"
-#include "enemyminion.hpp"
 
 MainMenu::MainMenu()
     : Menu(), m_show_help(false), m_help_sprite{}
@@ -13,12 +12,12 @@ MainMenu::~MainMenu()
 {
 }
 
-void MainMenu::render(sf::RenderWindow &window) const
+void MainMenu::render(RenderSnapshot &snapshot) const
 {
-    Menu::render(window);
+    Menu::render(snapshot);
     if (m_show_help)
     {
-        window.draw(m_help_sprite);
+        snapshot.draw(m_help_sprite);
     }
 }
 
@@ -0,0 +1,297 @@
+#include "narrowphase.hpp"
+#include "collisionmask.hpp"
+#include "gameobject.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace
+{
+    // Largest difference from the identity for a transform to count as a
+    // translation.
+    const float s_epsilon{1e-4f};
+
+    /**
+     * @brief Get the corners of a rectangle after a transform, in order.
+     */
+    void get_corners(const sf::FloatRect &rect, const sf::Transform &transform,
+                     sf::Vector2f corners[4])
+    {
+        corners[0] = transform.transformPoint(rect.left, rect.top);
+        corners[1] = transform.transformPoint(rect.left + rect.width, rect.top);
+        corners[2] = transform.transformPoint(rect.left + rect.width, rect.top + rect.height);
+        corners[3] = transform.transformPoint(rect.left, rect.top + rect.height);
+    }
+
+    /**
+     * @brief Check if two quads are separated along an axis. Quads that only
+     * touch are separated.
+     */
+    bool separated(const sf::Vector2f first[4], const sf::Vector2f second[4],
+                   const sf::Vector2f &axis)
+    {
+        float first_min{std::numeric_limits<float>::infinity()};
+        float first_max{-std::numeric_limits<float>::infinity()};
+        float second_min{first_min};
+        float second_max{first_max};
+        for (int i{0}; i < 4; i++)
+        {
+            float a{first[i].x * axis.x + first[i].y * axis.y};
+            float b{second[i].x * axis.x + second[i].y * axis.y};
+            first_min = std::min(first_min, a);
+            first_max = std::max(first_max, a);
+            second_min = std::min(second_min, b);
+            second_max = std::max(second_max, b);
+        }
+        return first_max <= second_min || second_max <= first_min;
+    }
+
+    /**
+     * @brief Find the pixels of a row whose centres are inside a convex quad.
+     *
+     * @param corners corners of the quad, in order.
+     * @param y y coordinate of the centres of the row.
+     * @param first[out] first pixel inside.
+     * @param last[out] last pixel inside.
+     * @return false if no pixel is inside.
+     */
+    bool get_span(const sf::Vector2f corners[4], float y, int &first, int &last)
+    {
+        float left{std::numeric_limits<float>::infinity()};
+        float right{-std::numeric_limits<float>::infinity()};
+        for (int i{0}; i < 4; i++)
+        {
+            const sf::Vector2f &a{corners[i]};
+            const sf::Vector2f &b{corners[(i + 1) % 4]};
+            if ((a.y <= y) != (b.y <= y))
+            {
+                float x{a.x + (y - a.y) * (b.x - a.x) / (b.y - a.y)};
+                left = std::min(left, x);
+                right = std::max(right, x);
+            }
+        }
+        if (!(left < right))
+            return false;
+        first = static_cast<int>(std::floor(left - 0.5f)) + 1;
+        last = static_cast<int>(std::ceil(right - 0.5f)) - 1;
+        return first <= last;
+    }
+
+    /**
+     * @brief Get the bits of pixels [first, last] in the 64 pixels starting at x.
+     */
+    std::uint64_t get_span_bits(int first, int last, int x)
+    {
+        int low{std::max(first - x, 0)};
+        int high{std::min(last - x, 63)};
+        if (low > high)
+            return 0;
+        return (~std::uint64_t{0} >> (63 - high)) & (~std::uint64_t{0} << low);
+    }
+
+    /**
+     * @brief Pixel test between a shape with a mask and any other shape, in the
+     * local space of the masked shape.
+     */
+    bool masks_overlap(const CollisionShape &masked, const CollisionShape &other)
+    {
+        sf::Transform to_other{other.transform.getInverse()};
+        to_other.combine(masked.transform);
+        sf::Transform from_other{masked.transform.getInverse()};
+        from_other.combine(other.transform);
+
+        sf::Vector2f corners[4];
+        get_corners(other.rect, from_other, corners);
+        float min_x{corners[0].x}, max_x{corners[0].x};
+        float min_y{corners[0].y}, max_y{corners[0].y};
+        for (int i{1}; i < 4; i++)
+        {
+            min_x = std::min(min_x, corners[i].x);
+            max_x = std::max(max_x, corners[i].x);
+            min_y = std::min(min_y, corners[i].y);
+            max_y = std::max(max_y, corners[i].y);
+        }
+        const sf::FloatRect &rect{masked.rect};
+        int x_begin{static_cast<int>(std::floor(std::max(rect.left, min_x)))};
+        int x_end{static_cast<int>(std::ceil(std::min(rect.left + rect.width, max_x)))};
+        int y_begin{static_cast<int>(std::floor(std::max(rect.top, min_y)))};
+        int y_end{static_cast<int>(std::ceil(std::min(rect.top + rect.height, max_y)))};
+
+        // Pixel x of masked is pixel x + dx of other if the shapes are only
+        // moved relative to each other.
+        const float *matrix{to_other.getMatrix()};
+        bool translated{std::fabs(matrix[0] - 1.f) < s_epsilon && std::fabs(matrix[5] - 1.f) < s_epsilon &&
+                        std::fabs(matrix[1]) < s_epsilon && std::fabs(matrix[4]) < s_epsilon};
+        int dx{static_cast<int>(std::floor(matrix[12] + 0.5f))};
+        int dy{static_cast<int>(std::floor(matrix[13] + 0.5f))};
+        if (translated && other.mask != nullptr)
+        {
+            const sf::FloatRect &other_rect{other.rect};
+            x_begin = std::max(x_begin, static_cast<int>(std::ceil(other_rect.left)) - dx);
+            x_end = std::min(x_end, static_cast<int>(std::ceil(other_rect.left + other_rect.width)) - dx);
+            y_begin = std::max(y_begin, static_cast<int>(std::ceil(other_rect.top)) - dy);
+            y_end = std::min(y_end, static_cast<int>(std::ceil(other_rect.top + other_rect.height)) - dy);
+        }
+
+        for (int y{y_begin}; y < y_end; y++)
+        {
+            int first{0};
+            int last{-1};
+            if (other.mask == nullptr && !get_span(corners, y + 0.5f, first, last))
+                continue;
+
+            for (int x{x_begin}; x < x_end; x += 64)
+            {
+                std::uint64_t bits{masked.mask->get_row_bits(x + masked.mask_offset.x,
+                                                              y + masked.mask_offset.y)};
+                if (x_end - x < 64)
+                    bits &= (std::uint64_t{1} << (x_end - x)) - 1;
+                if (bits == 0)
+                    continue;
+
+                if (other.mask == nullptr)
+                {
+                    if (bits & get_span_bits(first, last, x))
+                        return true;
+                }
+                else if (translated)
+                {
+                    if (bits & other.mask->get_row_bits(x + dx + other.mask_offset.x,
+                                                        y + dy + other.mask_offset.y))
+                        return true;
+                }
+                else
+                {
+                    // Rotated or scaled, sample the other mask at the centre of
+                    // every opaque pixel.
+                    for (int k{0}; k < 64; k++)
+                    {
+                        if (!((bits >> k) & 1))
+                            continue;
+                        sf::Vector2f point{to_other.transformPoint(x + k + 0.5f, y + 0.5f)};
+                        if (other.rect.contains(point) &&
+                            other.mask->get(static_cast<int>(std::floor(point.x)) + other.mask_offset.x,
+                                            static_cast<int>(std::floor(point.y)) + other.mask_offset.y))
+                        {
+                            return true;
+                        }
+                    }
+                }
+            }
+        }
+        return false;
+    }
+}
+
+/*===============================CollisionShape===============================*/
+
+CollisionShape::CollisionShape()
+    : transform{},
+      rect{},
+      mask{nullptr},
+      mask_offset{}
+{
+}
+
+CollisionShape::CollisionShape(const sf::Transform &transform, const sf::FloatRect &rect,
+                               const CollisionMask *mask, const sf::Vector2i &mask_offset)
+    : transform{transform},
+      rect{rect},
+      mask{mask},
+      mask_offset{mask_offset}
+{
+}
+
+/*================================Narrowphase=================================*/
+
+bool Narrowphase::overlaps(const GameObject &first, const GameObject &second)
+{
+    for (const CollisionShape &part : first.get_sub_colliders())
+    {
+        if (overlaps(second, part))
+            return true;
+    }
+    if (!first.get_sub_colliders().empty())
+        return false;
+
+    CollisionShape shape{};
+    if (first.get_collision_shape(shape))
+        return overlaps(second, shape);
+    // The bounding boxes are known to overlap.
+    if (second.get_sub_colliders().empty() && !second.get_collision_shape(shape))
+        return true;
+    return overlaps(second, make_box(first.get_cached_bounds()));
+}
+
+bool Narrowphase::overlaps(const GameObject &object, const CollisionShape &shape)
+{
+    for (const CollisionShape &part : object.get_sub_colliders())
+    {
+        if (overlaps(part, shape))
+            return true;
+    }
+    if (!object.get_sub_colliders().empty())
+        return false;
+
+    CollisionShape object_shape{};
+    if (object.get_collision_shape(object_shape))
+        return overlaps(object_shape, shape);
+    return overlaps(make_box(object.get_cached_bounds()), shape);
+}
+
+bool Narrowphase::overlaps(const CollisionShape &first, const CollisionShape &second)
+{
+    if (!boxes_overlap(first, second))
+        return false;
+    if (first.mask == nullptr && second.mask == nullptr)
+        return true;
+    if (first.mask != nullptr)
+        return masks_overlap(first, second);
+    return masks_overlap(second, first);
+}
+
+bool Narrowphase::boxes_overlap(const CollisionShape &first, const CollisionShape &second)
+{
+    sf::Vector2f first_corners[4];
+    sf::Vector2f second_corners[4];
+    get_corners(first.rect, first.transform, first_corners);
+    get_corners(second.rect, second.transform, second_corners);
+    // Separating axis test along the edges of both boxes. Empty boxes are
+    // separated along their zero length edge.
+    return !separated(first_corners, second_corners, first_corners[1] - first_corners[0]) &&
+           !separated(first_corners, second_corners, first_corners[3] - first_corners[0]) &&
+           !separated(first_corners, second_corners, second_corners[1] - second_corners[0]) &&
+           !separated(first_corners, second_corners, second_corners[3] - second_corners[0]);
+}
+
+CollisionShape Narrowphase::make_box(const sf::FloatRect &bounds)
+{
+    float left{std::min(bounds.left, bounds.left + bounds.width)};
+    float top{std::min(bounds.top, bounds.top + bounds.height)};
+    return CollisionShape{sf::Transform{},
+                          sf::FloatRect{left, top, std::fabs(bounds.width), std::fabs(bounds.height)},
+                          nullptr,
+                          sf::Vector2i{}};
+}
+
+sf::Transform Narrowphase::get_transform(const sf::Transformable &transformable)
+{
+    // Same as sf::Transformable::getTransform().
+    float angle{-transformable.getRotation() * 3.141592654f / 180.f};
+    float cosine{std::cos(angle)};
+    float sine{std::sin(angle)};
+    const sf::Vector2f &scale{transformable.getScale()};
+    const sf::Vector2f &origin{transformable.getOrigin()};
+    const sf::Vector2f &position{transformable.getPosition()};
+    float sxc{scale.x * cosine};
+    float syc{scale.y * cosine};
+    float sxs{scale.x * sine};
+    float sys{scale.y * sine};
+    float tx{-origin.x * sxc - origin.y * sys + position.x};
+    float ty{origin.x * sxs - origin.y * syc + position.y};
+    return sf::Transform{sxc, sys, tx,
+                         -sxs, syc, ty,
+                         0.f, 0.f, 1.f};
+}
@@ -3,14 +3,9 @@
 #include "mainmenu.hpp"
 #include "resourcemanager.hpp"
 #include "player.hpp"
-#include "enemyminion.hpp"
-#include "enemymover.hpp"
-#include "enemymultishot.hpp"
-#include "enemytank.hpp"
 #include "bossmode.hpp"
+#include "powerup.hpp"
 
-#include <sstream>
-#include <iomanip>
 #include <random>
 #include <cmath>
 
@@ -21,8 +16,9 @@ NormalMode::NormalMode()
       m_spawn_time_min{0.5f},
       m_boss_spawn_time{45.f},
       m_current_boss_time{0.f},
-      m_prev_spawn_time{},
-      m_prev_boss_spawn_time{},
+      m_spawn_timer{},
+      m_boss_timer{},
+      m_boss_warning_timer{},
       m_boss_counter{1},
       m_spawn_zone{0},
       m_spawn_zones{2},
@@ -30,7 +26,7 @@ NormalMode::NormalMode()
       m_level_rating{0},
       m_level_inc_rate{10.f},
       m_current_level_time{0.f},
-      m_level_time{},
+      m_level_timer{},
       m_level_up_sound{},
       m_scoreboard{},
       m_level_number_text{"", ResourceManager::load_font("assets/font/Aquire.otf")},
@@ -40,26 +36,33 @@ NormalMode::NormalMode()
       m_boss_warning_rect{},
       m_level_bar{m_level_inc_rate, m_current_level_time},
       m_boss_countdown_bar{m_boss_spawn_time, m_current_boss_time},
-      m_minion_data{}
+      m_minion_data{},
+      m_archetypes{},
+      m_spawn_table{},
+      m_spawn_rng{},
+      m_waves{},
+      m_wave_archetypes{},
+      m_wave_start{0.f}
 {
+    GameMode::get_events().subscribe<LevelUp>([this](const LevelUp &)
+                                              { m_level_up_sound.play(); });
 }
 
 NormalMode::~NormalMode()
 {
 }
 
-void NormalMode::render(sf::RenderWindow &window) const
+void NormalMode::render(RenderSnapshot &snapshot) const
 {
-    GameMode::render(window);
-    window.draw(m_scoreboard);
-    render_bars(window);
-    render_texts(window);
+    GameMode::render(snapshot);
+    snapshot.draw(m_scoreboard);
+    render_bars(snapshot);
+    render_texts(snapshot);
 }
 
 void NormalMode::update(Context &context)
 {
     handle_time(context);
-    update_texts();
     GameMode::update(context);
 }
 
@@ -72,10 +75,7 @@ void NormalMode::init(const GameConfiguration &gc)
 {
     if (m_paused)
     {
-        // Adjust times based on pause time.
-        sf::Time time_paused = m_clock.getElapsedTime() - m_pause_time;
-        m_prev_boss_spawn_time += time_paused;
-        m_level_time += time_paused;
+        // The timers stand still while paused, only the music is resumed.
         GameMode::set_music_volume(gc.get_data().music_volume);
         GameMode::play_music();
         m_paused = false;
@@ -101,100 +101,193 @@ void NormalMode::init(const GameConfiguration &gc)
     GameMode::play_music();
 }
 
-void NormalMode::render_texts(sf::RenderWindow &window) const
+unsigned int NormalMode::get_level() const
 {
-    window.draw(m_level_number_text);
-    window.draw(m_player_score_text);
-    window.draw(m_player_health_text);
+    return m_level_rating;
 }
 
-void NormalMode::render_bars(sf::RenderWindow &window) const
+GameObject *NormalMode::create_enemy(std::size_t archetype, const sf::Vector2f &position, int difficulty)
+{
+    return m_archetypes.create(get_entities(), m_minion_data, archetype, position.x, position.y, difficulty);
+}
+
+const ArchetypeTable &NormalMode::get_archetypes() const
+{
+    return m_archetypes;
+}
+
+const EnemyMinionData &NormalMode::get_minion_data() const
+{
+    return m_minion_data;
+}
+
+void NormalMode::render_texts(RenderSnapshot &snapshot) const
+{
+    snapshot.draw(m_level_number_text);
+    snapshot.draw(m_player_score_text);
+    snapshot.draw(m_player_health_text);
+}
+
+void NormalMode::render_bars(RenderSnapshot &snapshot) const
 {
     if (m_boss_spawn_time - m_current_boss_time <= std::ceil(m_boss_spawn_time * 0.1f))
     {
-        window.draw(m_boss_warning_rect);
-        window.draw(m_boss_countdown_text);
+        snapshot.draw(m_boss_warning_rect);
+        snapshot.draw(m_boss_countdown_text);
     }
-    m_boss_countdown_bar.render(window);
-    m_level_bar.render(window);
+    m_boss_countdown_bar.render(snapshot);
+    m_level_bar.render(snapshot);
 }
 
-void NormalMode::update_texts()
+void NormalMode::update_texts(const HudData &hud, FrameArena &arena)
 {
+    // Strings are built in the frame arena, and texts are only set when they
+    // change.
     {
-        std::stringstream ss{};
-        ss << m_level_rating;
-        m_level_number_text.setString(ss.str());
-        // Make sure the text is centered.
-        float text_width{m_level_number_text.getLocalBounds().width};
-        float text_height{m_level_number_text.getLocalBounds().height};
-        m_level_number_text.setOrigin({text_width / 2.f, text_height});
+        FrameString string{arena};
+        append_format(string, "%u", m_level_rating);
+        if (GameMode::set_text(m_level_number_text, string))
+        {
+            // Make sure the text is centered.
+            float text_width{m_level_number_text.getLocalBounds().width};
+            float text_height{m_level_number_text.getLocalBounds().height};
+            m_level_number_text.setOrigin({text_width / 2.f, text_height});
+        }
     }
 
     if (m_boss_spawn_time - m_current_boss_time <= std::round(m_boss_spawn_time * 0.1f))
     {
-        std::stringstream ss{};
-        ss << "Boss incoming " << std::fixed << std::setprecision(1) << std::setw(3)
-           << m_boss_spawn_time - m_current_boss_time;
-        m_boss_countdown_text.setString(ss.str());
-        // Make sure the text is centered.
-        float text_width{m_boss_countdown_text.getLocalBounds().width};
-        float text_height{m_boss_countdown_text.getLocalBounds().height};
-        m_boss_countdown_text.setOrigin({text_width / 2.f, text_height});
+        FrameString string{arena};
+        append_format(string, "Boss incoming %3.1f", m_boss_spawn_time - m_current_boss_time);
+        if (GameMode::set_text(m_boss_countdown_text, string))
+        {
+            // Make sure the text is centered.
+            float text_width{m_boss_countdown_text.getLocalBounds().width};
+            float text_height{m_boss_countdown_text.getLocalBounds().height};
+            m_boss_countdown_text.setOrigin({text_width / 2.f, text_height});
+        }
     }
 
     // Player related information.
-    Player *player{GameMode::get_player()};
-    if (player == nullptr)
+    if (!hud.has_player)
         return;
     {
-        std::stringstream ss{};
-        ss << player->get_score();
-        m_player_score_text.setString(ss.str());
-        float text_width{m_player_score_text.getLocalBounds().width};
-        float text_height{m_player_score_text.getLocalBounds().height};
-        m_player_score_text.setOrigin({text_width / 2.f, text_height});
+        FrameString string{arena};
+        append_format(string, "%d", hud.score);
+        if (GameMode::set_text(m_player_score_text, string))
+        {
+            float text_width{m_player_score_text.getLocalBounds().width};
+            float text_height{m_player_score_text.getLocalBounds().height};
+            m_player_score_text.setOrigin({text_width / 2.f, text_height});
+        }
     }
     {
-        std::stringstream ss{};
-        ss << "Health - " << player->get_health();
-        m_player_health_text.setString(ss.str());
+        FrameString string{arena};
+        append_format(string, "Health - %d", hud.health);
+        for (std::size_t i{0}; i < hud.effect_count; i++)
+        {
+            const EffectStatus &effect{hud.effects[i]};
+            append_format(string, "\n%s", EffectStack::get_name(effect.type));
+            if (effect.stacks > 1)
+                append_format(string, " x%u", effect.stacks);
+            append_format(string, " - %ds", static_cast<int>(std::ceil(effect.remaining)));
+        }
+        GameMode::set_text(m_player_health_text, string);
     }
 }
 
 void NormalMode::handle_time(Context &context)
 {
-    m_current_boss_time = (m_clock.getElapsedTime() - m_prev_boss_spawn_time).asSeconds();
+    // With scripted waves the timeline decides when the boss comes.
+    m_current_boss_time = m_waves ? 0.f : m_boss_spawn_time - m_boss_timer.get_remaining();
     m_boss_countdown_bar.update();
 
-    m_current_level_time = (m_clock.getElapsedTime() - m_level_time).asSeconds();
+    m_current_level_time = m_level_inc_rate - m_level_timer.get_remaining();
     m_level_bar.update();
 
-    if ((m_clock.getElapsedTime() - m_prev_spawn_time).asSeconds() >= m_spawn_time)
-    {
-        GameMode::spawn_object(get_enemy(context.get_window_size()));
-        m_prev_spawn_time = m_clock.getElapsedTime();
-    }
-    if (m_current_boss_time >= m_boss_spawn_time)
-    {
-        m_prev_boss_spawn_time = m_clock.getElapsedTime();
-        to_boss(context);
-        return;
-    }
-    if (m_boss_spawn_time - m_current_boss_time <= std::ceil(m_boss_spawn_time * 0.1f))
+    if (m_waves)
+        handle_waves(context);
+}
+
+void NormalMode::handle_waves(Context &context)
+{
+    float time{GameMode::get_timers().get_time() - m_wave_start};
+    float width{static_cast<float>(context.get_window_size().x)};
+    WaveEvent event{};
+    while (m_waves->poll(time, event))
     {
-        GameMode::fade_out_music(std::ceil(m_boss_spawn_time * 0.1f));
+        switch (event.type)
+        {
+        case WaveEventType::Formation:
+            for (unsigned int i{0}; i < event.count; i++)
+            {
+                sf::Vector2f pos{event.position + static_cast<float>(i) * event.step};
+                GameMode::spawn_object(create_enemy(m_wave_archetypes[event.index],
+                                                    sf::Vector2f{pos.x * width, pos.y}, event.difficulty));
+            }
+            break;
+        case WaveEventType::PowerUp:
+            GameMode::spawn_object(PowerUp::create(event.index, event.position.x * width, event.position.y,
+                                                   m_minion_data.base_speed * 0.5f));
+            break;
+        case WaveEventType::Boss:
+            to_boss(context);
+            return;
+        }
     }
-    if (m_current_level_time >= m_level_inc_rate)
+
+    // After the last event the game goes on as without a wave file.
+    if (m_waves->is_done())
     {
-        (m_level_inc_rate < 60.f) ? m_level_inc_rate *= 1.25f : m_level_inc_rate = 60.f;
-        m_level_rating++;
-        m_spawn_time *= 0.95f;
-        m_level_time = m_clock.getElapsedTime();
-        m_level_up_sound.play();
+        m_waves.reset();
+        m_wave_archetypes.clear();
+        start_spawn_timers();
     }
 }
 
+void NormalMode::start_timers()
+{
+    TimerWheel &timers{GameMode::get_timers()};
+    m_level_timer.start(timers, m_level_inc_rate, [this](Context &)
+                        { level_up(); });
+    if (!m_waves)
+        start_spawn_timers();
+}
+
+void NormalMode::start_spawn_timers()
+{
+    m_spawn_timer.start(GameMode::get_timers(), m_spawn_time, [this](Context &context)
+                        { spawn_enemy(context); });
+    start_boss_timer();
+}
+
+void NormalMode::start_boss_timer()
+{
+    TimerWheel &timers{GameMode::get_timers()};
+    m_boss_timer.start(timers, m_boss_spawn_time, [this](Context &context)
+                       { to_boss(context); });
+    float warning{std::ceil(m_boss_spawn_time * 0.1f)};
+    m_boss_warning_timer.start(timers, m_boss_spawn_time - warning, [this, warning](Context &)
+                               { GameMode::fade_out_music(warning); });
+}
+
+void NormalMode::spawn_enemy(Context &context)
+{
+    GameMode::spawn_object(get_enemy(context.get_window_size()));
+    m_spawn_timer.start(GameMode::get_timers(), m_spawn_time, [this](Context &context)
+                        { spawn_enemy(context); });
+}
+
+void NormalMode::level_up()
+{
+    (m_level_inc_rate < 60.f) ? m_level_inc_rate *= 1.25f : m_level_inc_rate = 60.f;
+    m_level_rating++;
+    m_spawn_time *= 0.95f;
+    GameMode::get_events().publish(LevelUp{m_level_rating});
+    m_level_timer.start(GameMode::get_timers(), m_level_inc_rate, [this](Context &)
+                        { level_up(); });
+}
+
 void NormalMode::init_texts(const GameConfiguration &gc)
 {
     const BossModeData &boss_data{gc.get_boss_mode_data()};
@@ -259,34 +352,32 @@ void NormalMode::init_data(const NormalModeData &data)
 
     m_level_inc_rate = data.level_increase_time;
 
-    m_prev_boss_spawn_time = m_clock.getElapsedTime();
-    m_prev_spawn_time = m_clock.getElapsedTime();
-
     // Save the minion data for later use.
     m_minion_data = data.minion_data;
+    m_archetypes = data.archetype_file.empty() ? ArchetypeTable::defaults()
+                                               : ArchetypeTable::from_file(data.archetype_file);
+    m_spawn_table = data.spawn_file.empty() ? SpawnTable::defaults() : SpawnTable::from_file(data.spawn_file);
+    m_spawn_table.compile(m_archetypes);
+    m_spawn_rng.seed(data.spawn_seed);
+
+    m_waves.reset();
+    m_wave_archetypes.clear();
+    if (!data.wave_file.empty())
+    {
+        m_waves.reset(new WaveCursor{data.wave_file});
+        for (const std::string &name : m_waves->get_names())
+            m_wave_archetypes.push_back(m_archetypes.find(name));
+    }
+    m_wave_start = GameMode::get_timers().get_time();
+    start_timers();
 }
 
 GameObject *NormalMode::get_enemy(const sf::Vector2u &window_size)
 {
     sf::Vector2f pos{get_enemy_position(window_size)};
     // Spawn a random enemy based on the level rating.
-    switch (m_level_rating / 3)
-    {
-    case 0:
-        return get_enemy_first(pos);
-
-    case 1:
-        return get_enemy_second(pos);
-
-    case 2:
-        return get_enemy_third(pos);
-
-    case 3:
-        return get_enemy_fourth(pos);
-
-    default:
-        return get_enemy_default(pos);
-    }
+    const SpawnChoice &choice{m_spawn_table.sample(m_level_rating, m_spawn_rng())};
+    return create_enemy(choice.archetype, pos, choice.difficulty);
 }
 
 sf::Vector2f NormalMode::get_enemy_position(const sf::Vector2u &window_size)
@@ -306,90 +397,13 @@ sf::Vector2f NormalMode::get_enemy_position(const sf::Vector2u &window_size)
     return {x, y};
 }
 
-GameObject *NormalMode::get_enemy_first(const sf::Vector2f &pos) const
-{
-    return new EnemyMinion{m_minion_data, pos.x, pos.y, 1};
-}
-
-GameObject *NormalMode::get_enemy_second(const sf::Vector2f &pos) const
-{
-    int random = rand() % 10;
-    if (random >= 0 && random <= 8)
-    {
-        int difficulty = rand() % 4;
-        difficulty != 0 ? difficulty = 1 : difficulty = 2;
-        return new EnemyMinion{m_minion_data, pos.x, pos.y, difficulty};
-    }
-    else
-        return new EnemyMover{m_minion_data, pos.x, pos.y, 1};
-}
-
-GameObject *NormalMode::get_enemy_third(const sf::Vector2f &pos) const
-{
-    int random = rand() % 10;
-    if (random >= 0 && random <= 6)
-    {
-        int difficulty = rand() % 4;
-        difficulty != 0 ? difficulty = 1 : difficulty = 2;
-        return new EnemyMinion{m_minion_data, pos.x, pos.y, difficulty};
-    }
-    else if (random >= 7 && random <= 8)
-        return new EnemyMover{m_minion_data, pos.x, pos.y, 1};
-    else
-        return new EnemyTank{m_minion_data, pos.x, pos.y, 1};
-}
-
-GameObject *NormalMode::get_enemy_fourth(const sf::Vector2f &pos) const
-{
-    int random = rand() % 10;
-    int difficulty{};
-    if (random >= 0 && random <= 6)
-    {
-        difficulty = rand() % 4;
-        difficulty != 0 ? difficulty = 2 : difficulty = 3;
-        return new EnemyMinion{m_minion_data, pos.x, pos.y, difficulty};
-    }
-    else if (random >= 7 && random <= 8)
-    {
-        difficulty = rand() % 4;
-        difficulty != 0 ? difficulty = 1 : difficulty = 2;
-        return new EnemyMover{m_minion_data, pos.x, pos.y, difficulty};
-    }
-    else
-        return new EnemyTank{m_minion_data, pos.x, pos.y, 1};
-}
-
-GameObject *NormalMode::get_enemy_default(const sf::Vector2f &pos) const
-{
-    int random = rand() % 20;
-    int difficulty{};
-    if (random >= 0 && random <= 10)
-    {
-        difficulty = rand() % 4;
-        difficulty <= 2 ? difficulty = 2 : difficulty = 3;
-        return new EnemyMinion{m_minion_data, pos.x, pos.y, difficulty};
-    }
-    else if (random >= 11 && random <= 15)
-    {
-        difficulty = rand() % 6;
-        difficulty != 0 ? difficulty = 2 : difficulty = 3;
-        return new EnemyMover{m_minion_data, pos.x, pos.y, difficulty};
-    }
-    else if (random >= 16 && random <= 18)
-    {
-        difficulty = rand() % 4;
-        difficulty != 0 ? difficulty = 1 : difficulty = 2;
-        return new EnemyTank{m_minion_data, pos.x, pos.y, difficulty};
-    }
-    else
-        return new EnemyMultiShot{m_minion_data, pos.x, pos.y, 1};
-}
-
 void NormalMode::to_boss(Context &context)
 {
     GameMode::clear_objects();
     GameMode::pause();
-    m_prev_boss_spawn_time = m_clock.getElapsedTime();
+    // The next boss comes a full boss spawn time after this one is beaten.
+    if (!m_waves)
+        start_boss_timer();
     context.set_next_state(
         new BossMode{this,
                      GameMode::get_player(),
@@ -14,22 +14,22 @@ PauseMenu::~PauseMenu()
     delete m_previous_state;
 }
 
-void PauseMenu::render(sf::RenderWindow &window) const
+void PauseMenu::render(RenderSnapshot &snapshot) const
 {
     if (m_previous_state != nullptr)
     {
-        m_previous_state->render(window);
+        m_previous_state->render(snapshot);
     }
 
     sf::RectangleShape rect{
-        {static_cast<float>(window.getSize().x),
-         static_cast<float>(window.getSize().y)}};
+        {static_cast<float>(snapshot.get_size().x),
+         static_cast<float>(snapshot.get_size().y)}};
 
     rect.setFillColor({0, 0, 0, 180});
     rect.setPosition(0, 0);
 
-    window.draw(rect);
-    Menu::render(window);
+    snapshot.draw(rect);
+    Menu::render(snapshot);
 }
 
 void PauseMenu::update(Context &context)
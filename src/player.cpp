@@ -1,7 +1,6 @@
 #include "player.hpp"
-#include "projectile.hpp"
-#include "enemy.hpp"
 #include "powerup.hpp"
+#include "projectile.hpp"
 #include "resourcemanager.hpp"
 #include "gameconfiguration.hpp"
 #include "enemyboss.hpp"
@@ -9,25 +8,36 @@
 
 #define _USE_MATH_DEFINES
 #include <math.h>
+#include <algorithm>
 #include <cmath>
 
+namespace
+{
+    // Seconds the effects of the power-ups last.
+    const float s_weapon_duration{20.f};
+    const float s_boost_duration{30.f};
+    const float s_shield_duration{15.f};
+    // Stacks of an effect held at once.
+    const unsigned int s_max_fire_rate_stacks{5};
+    const unsigned int s_max_speed_stacks{3};
+    const unsigned int s_max_shield_stacks{3};
+}
+
 Player::Player(const PlayerData &data, float x, float y)
     : Ship{data.health, data.speed, data.projectile_speed},
       m_image{ResourceManager::load_texture("assets/images/rymdskepp/rymdskepp.png")},
       m_shoot_clock{},
-      m_powerup_clock{},
+      m_effects{},
       m_score{0},
       m_kills{0},
       m_boss_kills{0},
       m_shoot_speed{data.attack_cooldown},
       m_min_shoot_speed{data.attack_cooldown * 0.25f},
       m_max_speed{data.speed * 4.f},
-      m_shot_type{"nothing"},
       m_angle{-M_PI_2},
-      m_health_lost{0},
       m_old_pos{}
 {
-    s_sprite.setTexture(m_image);
+    set_texture(m_image);
     sf::Vector2u texture_size{m_image.getSize()};
     s_sprite.setOrigin(texture_size.x / 2, texture_size.y / 2);
     s_sprite.setPosition(x, y);
@@ -38,8 +48,6 @@ Player::Player(const PlayerData &data, float x, float y)
 
 void Player::update(Context &context)
 {
-    s_health -= m_health_lost;
-    m_health_lost = 0;
     update_health_bar();
 
     if (s_health <= 0)
@@ -47,6 +55,8 @@ void Player::update(Context &context)
         remove();
         return;
     }
+    // Effects that run out are removed by their timers.
+    m_effects.update(context.get_delta(), context);
 
     m_old_pos = s_sprite.getPosition();
     sf::Vector2f direction{0.f, 0.f};
@@ -74,7 +84,7 @@ void Player::update(Context &context)
     }
     if (direction != sf::Vector2f{0.f, 0.f})
     {
-        s_sprite.move(direction * s_speed * context.get_delta().asSeconds());
+        s_sprite.move(direction * get_speed() * context.get_delta().asSeconds());
         m_angle = atan2(direction.y, direction.x);
         s_sprite.setRotation(m_angle * 180.f / M_PI + 90.f);
     }
@@ -84,10 +94,6 @@ void Player::update(Context &context)
         s_sprite.setPosition(m_old_pos);
     }
 
-    if (m_powerup_clock.getElapsedTime().asSeconds() >= 20)
-    {
-        m_shot_type = "nothing";
-    }
     if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Space))
     {
         attack(context);
@@ -108,88 +114,44 @@ sf::FloatRect Player::bounds() const
     return s_sprite.getGlobalBounds();
 }
 
+CollisionLayer Player::get_layer() const
+{
+    return CollisionLayer::Player;
+}
+
+ObjectKind Player::get_kind() const
+{
+    return ObjectKind::Player;
+}
+
 void Player::collision(const GameObject *other)
 {
-    if (dynamic_cast<const Enemy *>(other))
-    {
-        if (collide_clock.getElapsedTime().asSeconds() >= 0.5)
-        {
-            s_health -= 1;
-            collide_clock.restart();
-            s_sprite.setColor(sf::Color(255, 0, 0));
-        }
-    }
-    if (dynamic_cast<const EnemyBoss2 *>(other))
-    {
-        s_sprite.setPosition(m_old_pos);
-    }
-    if (dynamic_cast<const EnemyBoss *>(other))
+    if (other->get_layer() == CollisionLayer::Enemy)
     {
-        s_sprite.setPosition(m_old_pos);
+        take_hit(1);
     }
+    collision_stay(other);
     if (dynamic_cast<const Projectile *>(other))
     {
         const Projectile *current_projectile{dynamic_cast<const Projectile *>(other)};
-        // If projectile is not friendly (belongs not to player), player will lose life.
-        if (!(current_projectile->is_friendly()))
-        {
-            s_health -= current_projectile->get_damage();
-            s_sprite.setColor(sf::Color(255, 0, 0));
-            collide_clock.restart();
-        }
-    }
-    else if (dynamic_cast<const Repair *>(other))
-    {
-        //if s_health is lower than s_max_health inc s_health else also inc s_max_health
-        s_health < s_max_health ? s_health += 1 : s_health = ++s_max_health;
-        m_score = m_score + 100;
+        projectile_hit(current_projectile->get_hit());
     }
-    if (dynamic_cast<const Speed *>(other))
-    {
-        if (m_shoot_speed > m_min_shoot_speed)
-        {
-            m_shoot_speed *= 0.85;
-        }
-        else
-        {
-            m_shoot_speed = m_min_shoot_speed;
-        }
-        m_score = m_score + 100;
-    }
-    if (dynamic_cast<const Boost *>(other))
-    {
-        if (s_speed < m_max_speed)
-        {
-            float prev_speed = s_speed;
-            s_speed *= 1.25;
-            // Increase projectile speed by the same amount as the ship's speed.
-            s_projectile_speed += (s_speed - prev_speed);
-        }
-        else
-        {
-            s_speed = m_max_speed;
-        }
-        m_score = m_score + 100;
-    }
-    if (dynamic_cast<const Add_score *>(other))
-    {
-        m_score = m_score + 2000;
-    }
-    if (dynamic_cast<const Doubleshoot *>(other))
-    {
-        m_shot_type = "Doubleshoot";
-        m_score = m_score + 100;
-        m_powerup_clock.restart();
-    }
-    if (dynamic_cast<const Nuke *>(other))
+}
+
+void Player::projectile_hit(const ProjectileHit &hit)
+{
+    // If projectile is not friendly (belongs not to player), player will lose life.
+    if (!hit.friendly)
     {
-        m_score = m_score + 200;
+        take_hit(hit.damage);
     }
-    if (dynamic_cast<const Buckshot *>(other))
+}
+
+void Player::collision_stay(const GameObject *other)
+{
+    if (dynamic_cast<const EnemyBoss2 *>(other) || dynamic_cast<const EnemyBoss *>(other))
     {
-        m_shot_type = "Buckshot";
-        m_score = m_score + 100;
-        m_powerup_clock.restart();
+        s_sprite.setPosition(m_old_pos);
     }
 }
 
@@ -208,10 +170,10 @@ int Player::get_boss_kills() const
     return m_boss_kills;
 }
 
-//funktion that is made to be called by enemies when the die to giv score
-void Player::kills(int score, bool boss) const
+//funktion that is called when enemies die to giv score
+void Player::kills(int score, bool boss)
 {
-    m_score = m_score + score;
+    m_score += score;
 
     if (boss == true)
     {
@@ -225,9 +187,64 @@ void Player::kills(int score, bool boss) const
 
 // lose_health is a funktion that is used when an enemy pass the screen 
 // the health that is send in is the remaining health of the enemy
-void Player::lose_health(int health) const
+void Player::lose_health(int health)
 {
-    m_health_lost += health;
+    s_health -= health;
+    update_health_bar();
+    if (s_health <= 0)
+    {
+        remove();
+    }
+}
+
+void Player::collect(PowerUpType type)
+{
+    switch (type)
+    {
+    case PowerUpType::Repair:
+        //if s_health is lower than s_max_health inc s_health else give a shield
+        if (s_health < s_max_health)
+        {
+            s_health += 1;
+        }
+        else
+        {
+            m_effects.add(EffectType::Shield, 1.f, s_shield_duration, s_max_shield_stacks);
+        }
+        m_score += 100;
+        break;
+    case PowerUpType::Speed:
+        m_effects.add(EffectType::FireRate, 0.85f, s_boost_duration, s_max_fire_rate_stacks);
+        m_score += 100;
+        break;
+    case PowerUpType::Boost:
+        m_effects.add(EffectType::Speed, 1.25f, s_boost_duration, s_max_speed_stacks);
+        m_score += 100;
+        break;
+    case PowerUpType::Score:
+        m_score += 2000;
+        break;
+    case PowerUpType::Doubleshoot:
+        // Only one weapon at a time, the last one picked up.
+        m_effects.remove(EffectType::Spread);
+        m_effects.add(EffectType::DoubleShot, 1.f, s_weapon_duration);
+        m_score += 100;
+        break;
+    case PowerUpType::Nuke:
+        // The shockwave is sent out by the Nuke itself.
+        m_score += 200;
+        break;
+    case PowerUpType::Buckshot:
+        m_effects.remove(EffectType::DoubleShot);
+        m_effects.add(EffectType::Spread, 1.f, s_weapon_duration);
+        m_score += 100;
+        break;
+    }
+}
+
+const EffectStack &Player::get_effects() const
+{
+    return m_effects;
 }
 
 bool Player::out_of_bounds(float width, float height) const
@@ -238,32 +255,49 @@ bool Player::out_of_bounds(float width, float height) const
 
 void Player::attack(Context &context)
 {
-    if (m_shoot_clock.getElapsedTime().asSeconds() >= m_shoot_speed)
+    float cooldown{std::max(m_shoot_speed * m_effects.get_multiplier(EffectType::FireRate), m_min_shoot_speed)};
+    if (m_shoot_clock.getElapsedTime().asSeconds() >= cooldown)
     {
         const sf::Vector2f &pos{s_sprite.getPosition()};
-        if (m_shot_type == "Buckshot") 
+        // Projectiles are sped up by the same amount as the ship.
+        float projectile_speed{s_projectile_speed + (get_speed() - s_speed)};
+        if (m_effects.has(EffectType::Spread))
         {
             //create projectile in ship dirrection and whit an angle of pi/4 the ship direction
-            context.spawn_object(new BasicProjectile(
-                pos.x, pos.y,m_angle, s_projectile_speed, true));
-            context.spawn_object(new BasicProjectile(
-                pos.x, pos.y, m_angle - 0.5 * M_PI_2, s_projectile_speed, true));
-            context.spawn_object(new BasicProjectile(
-                pos.x, pos.y, m_angle + 0.5 * M_PI_2, s_projectile_speed, true));
+            context.spawn_projectile(
+                pos.x, pos.y,m_angle, projectile_speed, true);
+            context.spawn_projectile(
+                pos.x, pos.y, m_angle - 0.5 * M_PI_2, projectile_speed, true);
+            context.spawn_projectile(
+                pos.x, pos.y, m_angle + 0.5 * M_PI_2, projectile_speed, true);
             m_shoot_clock.restart();
         }
-        else if (m_shot_type == "Doubleshoot")
+        else if (m_effects.has(EffectType::DoubleShot))
         {
-            context.spawn_object(new BasicProjectile(
-                pos.x - 5 * sin(m_angle), pos.y - 5 * cos(m_angle), m_angle, s_projectile_speed, true));
-            context.spawn_object(new BasicProjectile(
-                pos.x + 5 * sin(m_angle), pos.y + 5 * cos(m_angle), m_angle, s_projectile_speed, true));
+            context.spawn_projectile(
+                pos.x - 5 * sin(m_angle), pos.y - 5 * cos(m_angle), m_angle, projectile_speed, true);
+            context.spawn_projectile(
+                pos.x + 5 * sin(m_angle), pos.y + 5 * cos(m_angle), m_angle, projectile_speed, true);
             m_shoot_clock.restart();
         }
         else
         {
-            context.spawn_object(new BasicProjectile(pos.x, pos.y, m_angle, s_projectile_speed, true));
+            context.spawn_projectile(pos.x, pos.y, m_angle, projectile_speed, true);
             m_shoot_clock.restart();
         }
     }
 }
+
+void Player::take_hit(int damage)
+{
+    collide_clock.restart();
+    if (m_effects.consume(EffectType::Shield))
+        return;
+    s_health -= damage;
+    s_sprite.setColor(sf::Color(255, 0, 0));
+}
+
+float Player::get_speed() const
+{
+    return std::min(s_speed * m_effects.get_multiplier(EffectType::Speed), m_max_speed);
+}
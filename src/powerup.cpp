@@ -4,19 +4,30 @@
 #define _USE_MATH_DEFINES
 #include "player.hpp"
 #include "projectile.hpp"
+#include "renderbatch.hpp"
 #include "resourcemanager.hpp"
+#include "shockwave.hpp"
 #include <cmath>
 
 
+namespace
+{
+    // About as many projectiles of the old Nuke burst as hit a ship close by.
+    const int s_nuke_damage{2};
+    // Seconds before a power-up that is not picked up disappears.
+    const float s_lifetime{10.f};
+}
+
 //Class definition of PowerUp whit initial speed and position.
 
-PowerUp::PowerUp(float x, float y, float v) 
+PowerUp::PowerUp(PowerUpType type, float x, float y, float v) 
 : GameObject { },
 activate_nuke{0},
 m_sprite     { },
+m_type       {type},
 powerup_speed{v},
 m_direction  {0.0f, 0.0f},
-PowerUp_clock{ }
+m_lifetime   { }
 
 {
     int rad{9};
@@ -25,43 +36,115 @@ PowerUp_clock{ }
 }
 
 
-void PowerUp::render(sf::RenderWindow &window) const
+void PowerUp::render(RenderSnapshot &snapshot) const
 {
-    window.draw(m_sprite);
+    snapshot.draw(m_sprite);
 }
 
-void PowerUp::update(Context &context)
+bool PowerUp::render_batched(RenderBatch &batch) const
 {
-    //Here the sprite move downwards and disappears if outside screen or if the
-    //countdown exceeds 10 seconds.
-    m_sprite.move(0, powerup_speed * context.get_delta().asSeconds());
+    batch.add_sprite(m_sprite);
+    return true;
+}
 
-    if (m_sprite.getPosition().y > context.get_window_size().y)
+void PowerUp::update(Context &context)
+{
+    //If the player has collided whith a Nuke it sends out a shockwave that
+    //hits every enemy on its way.
+    if (activate_nuke)
     {
         remove();
+        context.spawn_object(new Shockwave{m_sprite.getPosition().x,
+                                           m_sprite.getPosition().y,
+                                           true, s_nuke_damage});
+        activate_nuke = 0;
     }
-    else if (PowerUp_clock.getElapsedTime().asSeconds() > 10)
+    //Here the sprite move downwards and disappears if outside screen. The
+    //lifetime is handled by m_lifetime.
+    m_sprite.move(0, powerup_speed * context.get_delta().asSeconds());
+
+    if (m_sprite.getPosition().y > context.get_window_size().y)
     {
         remove();
     }
 }
 
+void PowerUp::start_timers(TimerWheel &timers)
+{
+    m_lifetime.start(timers, s_lifetime, [this](Context &)
+                     { remove(); });
+}
+
 bool PowerUp::handle(const sf::Event &, Context &)
 {
     return false;
 }
 
+const sf::Transformable *PowerUp::get_transform() const
+{
+    return &m_sprite;
+}
+
 sf::FloatRect PowerUp::bounds() const
 {
     return m_sprite.getGlobalBounds();
 }
 
+CollisionLayer PowerUp::get_layer() const
+{
+    return CollisionLayer::PowerUp;
+}
+
 void PowerUp::collision(const GameObject *other)
 {
     //If the powerup collides whith the player it desappears and the
     //funktionality is handled whithin the player class. (Except for nuke)
-    if (dynamic_cast<const Player *>(other))
-	remove();
+    if (other->get_layer() == CollisionLayer::Player)
+    {
+        if (m_type == PowerUpType::Nuke)
+            activate_nuke = 1;
+        else
+            remove();
+    }
+}
+
+ObjectKind PowerUp::get_kind() const
+{
+    return ObjectKind::PowerUp;
+}
+
+PowerUpType PowerUp::get_type() const
+{
+    return m_type;
+}
+
+
+
+PowerUp *PowerUp::create_random(std::minstd_rand &rng, float x, float y, float v)
+{
+    // Every type is equally likely.
+    return create(rng() % 70u / 10u, x, y, v);
+}
+
+PowerUp *PowerUp::create(unsigned int type, float x, float y, float v)
+{
+    switch (type)
+    {
+    case 0:
+        return new Repair{x, y, v};
+    case 1:
+        return new Speed{x, y, v};
+    case 2:
+        return new Buckshot{x, y, v};
+    case 3:
+        return new Doubleshoot{x, y, v};
+    case 4:
+        return new Boost{x, y, v};
+    case 5:
+        return new Add_score{x, y, v};
+    default:
+        return new Nuke{x, y, v};
+    }
 }
 
 
@@ -69,7 +152,7 @@ void PowerUp::collision(const GameObject *other)
 //The separate powerups is defined initialized whith individual sprites.
 
 Repair::Repair(float x, float y, float v)
-: PowerUp{x, y, v},
+: PowerUp{PowerUpType::Repair, x, y, v},
 m_image{
     ResourceManager::load_texture("assets/images/powerup_images/Repair_transparent.png")
     }
@@ -79,7 +162,7 @@ m_image{
 
 
 Speed::Speed(float x, float y, float v)
-: PowerUp{x, y, v},
+: PowerUp{PowerUpType::Speed, x, y, v},
 m_image{
     ResourceManager::load_texture("assets/images/powerup_images/Speed_transparent.png")
     }
@@ -89,7 +172,7 @@ m_image{
 
 
 Buckshot::Buckshot(float x, float y, float v)
-: PowerUp{x, y, v},
+: PowerUp{PowerUpType::Buckshot, x, y, v},
 m_image{
     ResourceManager::load_texture("assets/images/powerup_images/Buckshot_transparent.png")
     }
@@ -99,7 +182,7 @@ m_image{
 
 
 Boost::Boost(float x, float y, float v)
-: PowerUp{x, y, v},
+: PowerUp{PowerUpType::Boost, x, y, v},
 m_image{
     ResourceManager::load_texture("assets/images/powerup_images/Boost_transparent.png")
     }
@@ -109,7 +192,7 @@ m_image{
 
 
 Doubleshoot::Doubleshoot(float x, float y, float v)
-: PowerUp{x, y, v},
+: PowerUp{PowerUpType::Doubleshoot, x, y, v},
 m_image{
     ResourceManager::load_texture("assets/images/powerup_images/Doubleshot_transparent.png")
     }
@@ -119,7 +202,7 @@ m_image{
 
 
 Add_score::Add_score(float x, float y, float v)
-: PowerUp{x, y, v},
+: PowerUp{PowerUpType::Score, x, y, v},
 m_image{
     ResourceManager::load_texture("assets/images/powerup_images/Add_score.png")
     }
@@ -129,38 +212,10 @@ m_image{
 
 
 Nuke::Nuke(float x, float y, float v)
-: PowerUp{x, y, v},
+: PowerUp{PowerUpType::Nuke, x, y, v},
 m_image{
     ResourceManager::load_texture("assets/images/powerup_images/Nuke_transparent.png")
     }
 {
     m_sprite.setTexture(m_image);
 }
-
-void Nuke::update(Context &context)
-{
-    //If the player has collided whith a Nuke it fires basic projectiles in
-    //every direction.
-    if (activate_nuke == 1)
-    {
-        remove();
-        float angle = 0;
-        while (angle < 4)        
-            {
-                context.spawn_object(
-                    new BasicProjectile(m_sprite.getPosition().x,
-                    m_sprite.getPosition().y,
-                    angle*M_PI_2, 500, true));
-                angle = angle + 0.05;
-                
-            }
-        activate_nuke = 0;
-    }    
-    PowerUp::update(context);
-}
-
-void Nuke::collision(const GameObject *other)
-{
-    if (dynamic_cast<const Player *>(other))
-        activate_nuke = 1;
-}
\ No newline at end of file
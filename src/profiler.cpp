@@ -0,0 +1,116 @@
+#include "profiler.hpp"
+
+#include <algorithm>
+
+namespace
+{
+    /**
+     * @brief Get the value of a name, added if it is missing. The name is only
+     * copied into a std::string when it is added.
+     */
+    template <typename Map>
+    typename Map::mapped_type &find_or_add(Map &map, const char *name)
+    {
+        auto it = map.find(name);
+        if (it == map.end())
+            it = map.emplace(name, typename Map::mapped_type{}).first;
+        return it->second;
+    }
+}
+
+std::mutex Profiler::Mutex{};
+std::map<std::string, ProfileEntry, std::less<>> Profiler::Entries{};
+std::map<std::string, CounterEntry, std::less<>> Profiler::Counters{};
+
+/*================================ProfileEntry================================*/
+
+ProfileEntry::ProfileEntry()
+    : last{},
+      max{},
+      total{},
+      samples{0}
+{
+}
+
+sf::Time ProfileEntry::get_average() const
+{
+    if (samples == 0)
+        return sf::Time::Zero;
+    return sf::microseconds(total.asMicroseconds() / static_cast<sf::Int64>(samples));
+}
+
+/*================================CounterEntry================================*/
+
+CounterEntry::CounterEntry()
+    : last{0},
+      max{0},
+      total{0},
+      samples{0}
+{
+}
+
+double CounterEntry::get_average() const
+{
+    if (samples == 0)
+        return 0.0;
+    return static_cast<double>(total) / samples;
+}
+
+/*==================================Profiler==================================*/
+
+void Profiler::record(const char *name, const sf::Time &time)
+{
+    std::lock_guard<std::mutex> lock{Mutex};
+    ProfileEntry &entry{find_or_add(Entries, name)};
+    entry.last = time;
+    entry.max = std::max(entry.max, time);
+    entry.total += time;
+    entry.samples++;
+}
+
+void Profiler::count(const char *name, std::size_t value)
+{
+    std::lock_guard<std::mutex> lock{Mutex};
+    CounterEntry &entry{find_or_add(Counters, name)};
+    entry.last = value;
+    entry.max = std::max(entry.max, value);
+    entry.total += value;
+    entry.samples++;
+}
+
+std::map<std::string, ProfileEntry> Profiler::get_entries()
+{
+    std::lock_guard<std::mutex> lock{Mutex};
+    return std::map<std::string, ProfileEntry>{Entries.begin(), Entries.end()};
+}
+
+ProfileEntry Profiler::get_entry(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock{Mutex};
+    auto it = Entries.find(name);
+    if (it == Entries.end())
+        return ProfileEntry{};
+    return it->second;
+}
+
+std::map<std::string, CounterEntry> Profiler::get_counters()
+{
+    std::lock_guard<std::mutex> lock{Mutex};
+    return std::map<std::string, CounterEntry>{Counters.begin(), Counters.end()};
+}
+
+CounterEntry Profiler::get_counter(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock{Mutex};
+    auto it = Counters.find(name);
+    if (it == Counters.end())
+        return CounterEntry{};
+    return it->second;
+}
+
+void Profiler::reset()
+{
+    std::lock_guard<std::mutex> lock{Mutex};
+    Entries.clear();
+    Counters.clear();
+}
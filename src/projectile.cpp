@@ -1,5 +1,5 @@
 #include "projectile.hpp"
-#include "enemy.hpp"
+#include "renderbatch.hpp"
 #include "player.hpp"
 #include <cmath>
 
@@ -16,9 +16,15 @@ Projectile::Projectile(float x, float y, float angle, float v, bool friendly, in
     m_circle.setFillColor(sf::Color{r, g, b});
 }
 
-void Projectile::render(sf::RenderWindow &window) const
+void Projectile::render(RenderSnapshot &snapshot) const
 {
-    window.draw(m_circle);
+    snapshot.draw(m_circle);
+}
+
+bool Projectile::render_batched(RenderBatch &batch) const
+{
+    batch.add_circle(m_circle);
+    return true;
 }
 
 void Projectile::update(Context &context)
@@ -44,6 +50,17 @@ sf::FloatRect Projectile::bounds() const
 {
     return m_circle.getGlobalBounds();
 }
+
+CollisionLayer Projectile::get_layer() const
+{
+    return CollisionLayer::Projectile;
+}
+
+const sf::Transformable *Projectile::get_transform() const
+{
+    return &m_circle;
+}
+
 bool Projectile::is_friendly() const
 {
     return friendly;
@@ -54,6 +71,11 @@ int Projectile::get_damage() const
     return damage;
 }
 
+ProjectileHit Projectile::get_hit() const
+{
+    return ProjectileHit{m_circle.getPosition(), damage, friendly};
+}
+
 BasicProjectile::BasicProjectile(float x, float y, float angle, float v, bool friendly, int damage)
     : Projectile::Projectile(x, y, angle, v, friendly, damage)
 {
@@ -61,11 +83,11 @@ BasicProjectile::BasicProjectile(float x, float y, float angle, float v, bool fr
 
 void BasicProjectile::collision(const GameObject *other)
 {
-    if (dynamic_cast<const Enemy *>(other) && friendly)
+    if (other->get_layer() == CollisionLayer::Enemy && friendly)
     {
         remove();
     }
-    if (dynamic_cast<const Player *>(other) && !friendly)
+    if (other->get_layer() == CollisionLayer::Player && !friendly)
     {
         remove();
     }
@@ -0,0 +1,425 @@
+#include "projectilesystem.hpp"
+#include "gameobject.hpp"
+#include "narrowphase.hpp"
+#include "profiler.hpp"
+#include "rendersnapshot.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+namespace
+{
+    // Same size as the circle of Projectile.
+    const float s_radius{3.f};
+    // Projectiles are killed this far outside the window.
+    const float s_margin{10.f};
+    const sf::Color s_color{0, 255, 0};
+    // Times are kept small by moving the clock back to 0 this often, so
+    // positions computed from them stay accurate in long games.
+    const float s_rebase_time{256.f};
+    const float s_infinity{std::numeric_limits<float>::infinity()};
+    // Size of the cells of the collision grid. Cells are made larger if the
+    // projectiles are spread over more than s_max_cells in any direction.
+    const float s_cell_size{64.f};
+    const float s_max_cells{256.f};
+
+    /**
+     * @brief Get the time after which a point moving along one axis is outside
+     * the interval [min, max] for good, relative to when it was at start.
+     * Infinite if it never leaves, minus infinity if it is outside and never
+     * comes back.
+     */
+    float get_exit_time(float start, float velocity, float min, float max)
+    {
+        if (velocity > 0.f)
+            return (max - start) / velocity;
+        if (velocity < 0.f)
+            return (min - start) / velocity;
+        return (start < min || start > max) ? -s_infinity : s_infinity;
+    }
+
+    /**
+     * @brief Clip the parameter range [t_min, t_max] of a moving point to the
+     * open interval (min, max) along one axis.
+     *
+     * @return false if the range became empty.
+     */
+    bool clip_axis(float start, float direction, float min, float max,
+                   float &t_min, float &t_max)
+    {
+        if (direction == 0.f)
+            return min < start && start < max;
+        float t_first{(min - start) / direction};
+        float t_second{(max - start) / direction};
+        if (t_first > t_second)
+            std::swap(t_first, t_second);
+        t_min = std::max(t_min, t_first);
+        t_max = std::min(t_max, t_second);
+        return t_min < t_max;
+    }
+
+    /**
+     * @brief Check if the segment from (x0, y0) to (x1, y1) passes through the
+     * inside of the box, using the slab method.
+     */
+    bool segment_intersects(float x0, float y0, float x1, float y1,
+                            float left, float top, float right, float bottom)
+    {
+        float t_min{0.f};
+        float t_max{1.f};
+        return clip_axis(x0, x1 - x0, left, right, t_min, t_max) &&
+               clip_axis(y0, y1 - y0, top, bottom, t_min, t_max);
+    }
+
+    /**
+     * @brief Check if a projectile is used up by hitting an object, the same
+     * way BasicProjectile::collision(...) removes itself.
+     */
+    bool stops_at(const GameObject &object, bool friendly)
+    {
+        return object.get_layer() == (friendly ? CollisionLayer::Enemy : CollisionLayer::Player);
+    }
+}
+
+ProjectileSystem::ProjectileSystem()
+    : m_origin_x{},
+      m_origin_y{},
+      m_vx{},
+      m_vy{},
+      m_spawn_time{},
+      m_damage{},
+      m_friendly{},
+      m_state{},
+      m_serial{},
+      m_time{0.f},
+      m_previous_time{0.f},
+      m_next_serial{0},
+      m_scheduled_serial{0},
+      m_window_size{},
+      m_expiry_queue{},
+      m_paths{},
+      m_grid{s_cell_size, s_max_cells},
+      m_candidates{}
+{
+}
+
+void ProjectileSystem::spawn(const ProjectileSpawn &projectile)
+{
+    m_origin_x.push_back(projectile.x);
+    m_origin_y.push_back(projectile.y);
+    m_vx.push_back(projectile.v * std::cos(projectile.angle));
+    m_vy.push_back(projectile.v * std::sin(projectile.angle));
+    m_spawn_time.push_back(m_time);
+    m_damage.push_back(projectile.damage);
+    m_friendly.push_back(projectile.friendly);
+    m_state.push_back(Alive);
+    m_serial.push_back(m_next_serial++);
+}
+
+void ProjectileSystem::update(float delta, const sf::Vector2u &window_size)
+{
+    if (m_time > s_rebase_time)
+        rebase_time();
+
+    // Expiry times depend on the window, so a new size means a new schedule.
+    std::size_t first{0};
+    if (window_size != m_window_size)
+    {
+        m_window_size = window_size;
+        m_expiry_queue.clear();
+    }
+    else
+    {
+        first = find_index(m_scheduled_serial);
+    }
+    schedule(first);
+    m_scheduled_serial = m_next_serial;
+
+    m_previous_time = m_time;
+    m_time += delta;
+
+    // Only projectiles whose time has come are touched.
+    std::size_t expired{0};
+    while (!m_expiry_queue.empty() && m_expiry_queue.front().time < m_time)
+    {
+        std::size_t serial{m_expiry_queue.front().serial};
+        std::pop_heap(m_expiry_queue.begin(), m_expiry_queue.end(), std::greater<Expiry>{});
+        m_expiry_queue.pop_back();
+        std::size_t i{find_index(serial)};
+        if (i < m_serial.size() && m_serial[i] == serial && m_state[i] == Alive)
+        {
+            m_state[i] = Leaving;
+            expired++;
+        }
+    }
+    Profiler::count("projectiles.expired", expired);
+}
+
+void ProjectileSystem::collide(const std::vector<GameObject *> &objects)
+{
+    std::size_t hits{0};
+    std::size_t swept_hits{0};
+    std::size_t candidates{0};
+    build_grid();
+    for (GameObject *object : objects)
+    {
+        // Like sf::FloatRect::intersects, flipped boxes are allowed and empty
+        // boxes never collide. Removed objects can not be hit, like in
+        // GameMode::resolve_collisions().
+        const sf::FloatRect &bounds{object->get_cached_bounds()};
+        if (object->is_removed() || bounds.width == 0.f || bounds.height == 0.f)
+            continue;
+        float left{std::min(bounds.left, bounds.left + bounds.width) - s_radius};
+        float right{std::max(bounds.left, bounds.left + bounds.width) + s_radius};
+        float top{std::min(bounds.top, bounds.top + bounds.height) - s_radius};
+        float bottom{std::max(bounds.top, bounds.top + bounds.height) + s_radius};
+        find_candidates(left, top, right, bottom);
+        candidates += m_candidates.size();
+        for (std::size_t i : m_candidates)
+        {
+            if (m_state[i] == Dead)
+                continue;
+            float age{m_time - m_spawn_time[i]};
+            float x{m_origin_x[i] + m_vx[i] * age};
+            float y{m_origin_y[i] + m_vy[i] * age};
+            // Same test as sf::FloatRect::intersects with the projectile's bounds.
+            if (x <= left || x >= right || y <= top || y >= bottom)
+            {
+                // Fast projectiles may have passed through the object since
+                // the last frame. The object is taken to be standing still.
+                float previous_age{std::max(m_previous_time - m_spawn_time[i], 0.f)};
+                if (!segment_intersects(m_origin_x[i] + m_vx[i] * previous_age,
+                                        m_origin_y[i] + m_vy[i] * previous_age,
+                                        x, y, left, top, right, bottom))
+                    continue;
+                swept_hits++;
+            }
+            else
+            {
+                // Only the bounding boxes are known to overlap.
+                sf::FloatRect box{x - s_radius, y - s_radius, 2 * s_radius, 2 * s_radius};
+                if (!Narrowphase::overlaps(*object, Narrowphase::make_box(box)))
+                    continue;
+            }
+            hits++;
+
+            object->projectile_hit(ProjectileHit{sf::Vector2f{x, y}, m_damage[i], m_friendly[i] != 0});
+            if (stops_at(*object, m_friendly[i] != 0))
+                m_state[i] = Dead;
+        }
+    }
+    Profiler::count("projectiles.hits", hits);
+    Profiler::count("projectiles.swept_hits", swept_hits);
+    Profiler::count("projectiles.candidates", candidates);
+}
+
+std::size_t ProjectileSystem::kill_in_ring(const sf::Vector2f &center, float inner_radius,
+                                           float outer_radius, bool friendly)
+{
+    if (outer_radius < 0.f || inner_radius >= outer_radius)
+        return 0;
+    float inner_radius2{inner_radius < 0.f ? -1.f : inner_radius * inner_radius};
+    float outer_radius2{outer_radius * outer_radius};
+    std::uint8_t side{friendly ? std::uint8_t{1} : std::uint8_t{0}};
+    std::size_t killed{0};
+    for (std::size_t i{0}; i < m_origin_x.size(); i++)
+    {
+        sf::Vector2f position{get_position(i)};
+        float dx{position.x - center.x};
+        float dy{position.y - center.y};
+        float distance2{dx * dx + dy * dy};
+        if (m_state[i] != Dead && m_friendly[i] == side &&
+            distance2 > inner_radius2 && distance2 <= outer_radius2)
+        {
+            m_state[i] = Dead;
+            killed++;
+        }
+    }
+    return killed;
+}
+
+void ProjectileSystem::remove_dead()
+{
+    std::size_t kept{0};
+    for (std::size_t i{0}; i < m_origin_x.size(); i++)
+    {
+        if (m_state[i] != Alive)
+            continue;
+        m_origin_x[kept] = m_origin_x[i];
+        m_origin_y[kept] = m_origin_y[i];
+        m_vx[kept] = m_vx[i];
+        m_vy[kept] = m_vy[i];
+        m_spawn_time[kept] = m_spawn_time[i];
+        m_damage[kept] = m_damage[i];
+        m_friendly[kept] = m_friendly[i];
+        m_state[kept] = Alive;
+        m_serial[kept] = m_serial[i];
+        kept++;
+    }
+    m_origin_x.resize(kept);
+    m_origin_y.resize(kept);
+    m_vx.resize(kept);
+    m_vy.resize(kept);
+    m_spawn_time.resize(kept);
+    m_damage.resize(kept);
+    m_friendly.resize(kept);
+    m_state.resize(kept);
+    m_serial.resize(kept);
+}
+
+void ProjectileSystem::clear()
+{
+    m_origin_x.clear();
+    m_origin_y.clear();
+    m_vx.clear();
+    m_vy.clear();
+    m_spawn_time.clear();
+    m_damage.clear();
+    m_friendly.clear();
+    m_state.clear();
+    m_serial.clear();
+    m_expiry_queue.clear();
+    m_scheduled_serial = m_next_serial;
+}
+
+void ProjectileSystem::render(RenderSnapshot &snapshot) const
+{
+    if (m_origin_x.empty())
+        return;
+
+    // SFML has no sized points, so every projectile is a quad of two triangles.
+    sf::Vertex *vertices{snapshot.get_batch_vertices(
+        snapshot.add_batch(nullptr, m_origin_x.size() * 6))};
+    for (std::size_t i{0}; i < m_origin_x.size(); i++)
+    {
+        sf::Vector2f position{get_position(i)};
+        sf::Vector2f top_left{position.x - s_radius, position.y - s_radius};
+        sf::Vector2f top_right{position.x + s_radius, position.y - s_radius};
+        sf::Vector2f bottom_right{position.x + s_radius, position.y + s_radius};
+        sf::Vector2f bottom_left{position.x - s_radius, position.y + s_radius};
+        sf::Vertex *quad{vertices + i * 6};
+        quad[0] = sf::Vertex{top_left, s_color};
+        quad[1] = sf::Vertex{top_right, s_color};
+        quad[2] = sf::Vertex{bottom_right, s_color};
+        quad[3] = sf::Vertex{top_left, s_color};
+        quad[4] = sf::Vertex{bottom_right, s_color};
+        quad[5] = sf::Vertex{bottom_left, s_color};
+    }
+}
+
+std::size_t ProjectileSystem::get_count() const
+{
+    return m_origin_x.size();
+}
+
+sf::Vector2f ProjectileSystem::get_position(std::size_t index) const
+{
+    float age{m_time - m_spawn_time[index]};
+    return sf::Vector2f{m_origin_x[index] + m_vx[index] * age,
+                        m_origin_y[index] + m_vy[index] * age};
+}
+
+bool ProjectileSystem::is_friendly(std::size_t index) const
+{
+    return m_friendly[index];
+}
+
+int ProjectileSystem::get_damage(std::size_t index) const
+{
+    return m_damage[index];
+}
+
+bool ProjectileSystem::is_alive(std::size_t index) const
+{
+    return m_state[index] == Alive;
+}
+
+void ProjectileSystem::schedule(std::size_t first)
+{
+    const float min_x{-s_margin};
+    const float min_y{-s_margin};
+    const float max_x{m_window_size.x + s_margin};
+    const float max_y{m_window_size.y + s_margin};
+    for (std::size_t i{first}; i < m_origin_x.size(); i++)
+    {
+        if (m_state[i] != Alive)
+            continue;
+        float exit_time{std::min(get_exit_time(m_origin_x[i], m_vx[i], min_x, max_x),
+                                 get_exit_time(m_origin_y[i], m_vy[i], min_y, max_y))};
+        // Projectiles standing still in the window never expire.
+        if (exit_time == s_infinity)
+            continue;
+        m_expiry_queue.push_back(Expiry{m_spawn_time[i] + exit_time, m_serial[i]});
+        std::push_heap(m_expiry_queue.begin(), m_expiry_queue.end(), std::greater<Expiry>{});
+    }
+}
+
+void ProjectileSystem::rebase_time()
+{
+    for (float &spawn_time : m_spawn_time)
+    {
+        spawn_time -= m_time;
+    }
+    // Moving every time by the same amount keeps the heap order.
+    for (Expiry &expiry : m_expiry_queue)
+    {
+        expiry.time -= m_time;
+    }
+    m_previous_time -= m_time;
+    m_time = 0.f;
+}
+
+void ProjectileSystem::build_grid()
+{
+    m_paths.resize(m_origin_x.size());
+    for (std::size_t i{0}; i < m_origin_x.size(); i++)
+    {
+        if (m_state[i] == Dead)
+        {
+            m_paths[i] = CellBox::empty();
+            continue;
+        }
+        float age{m_time - m_spawn_time[i]};
+        float previous_age{std::max(m_previous_time - m_spawn_time[i], 0.f)};
+        float x{m_origin_x[i] + m_vx[i] * age};
+        float y{m_origin_y[i] + m_vy[i] * age};
+        float previous_x{m_origin_x[i] + m_vx[i] * previous_age};
+        float previous_y{m_origin_y[i] + m_vy[i] * previous_age};
+        m_paths[i] = CellBox{std::min(x, previous_x), std::min(y, previous_y),
+                             std::max(x, previous_x), std::max(y, previous_y)};
+    }
+    m_grid.build(m_paths);
+}
+
+void ProjectileSystem::find_candidates(float left, float top, float right, float bottom)
+{
+    m_candidates.clear();
+    if (m_grid.get_columns() == 0)
+        return;
+
+    int first_column{std::max(m_grid.get_column(left), 0)};
+    int last_column{std::min(m_grid.get_column(right), m_grid.get_columns() - 1)};
+    int first_row{std::max(m_grid.get_row(top), 0)};
+    int last_row{std::min(m_grid.get_row(bottom), m_grid.get_rows() - 1)};
+    for (int row{first_row}; row <= last_row; row++)
+    {
+        for (int column{first_column}; column <= last_column; column++)
+        {
+            for (std::size_t projectile : m_grid.get_cell(column, row))
+            {
+                if (m_grid.is_first_cell(m_paths[projectile], column, row, first_column, first_row))
+                    m_candidates.push_back(projectile);
+            }
+        }
+    }
+    // Hits are reported in the order of the projectiles, as without the grid.
+    std::sort(m_candidates.begin(), m_candidates.end());
+}
+
+std::size_t ProjectileSystem::find_index(std::size_t serial) const
+{
+    return static_cast<std::size_t>(
+        std::lower_bound(m_serial.begin(), m_serial.end(), serial) - m_serial.begin());
+}
@@ -0,0 +1,182 @@
+#include "renderbatch.hpp"
+
+#include <cmath>
+#include <cstdlib>
+
+RenderBatch::RenderBatch()
+    : m_groups{},
+      m_group_count{0},
+      m_unbatched{},
+      m_last_group{0},
+      m_segment_begin{0}
+{
+}
+
+void RenderBatch::clear()
+{
+    for (std::size_t i{0}; i < m_group_count; i++)
+    {
+        m_groups[i].vertices.clear();
+    }
+    m_group_count = 0;
+    m_unbatched.clear();
+    m_last_group = 0;
+    m_segment_begin = 0;
+}
+
+void RenderBatch::add_sprite(const sf::Sprite &sprite, unsigned int layer)
+{
+    const sf::IntRect &rect{sprite.getTextureRect()};
+    float width{static_cast<float>(std::abs(rect.width))};
+    float height{static_cast<float>(std::abs(rect.height))};
+    float left{static_cast<float>(rect.left)};
+    float right{left + rect.width};
+    float top{static_cast<float>(rect.top)};
+    float bottom{top + rect.height};
+
+    const sf::Transform &transform{sprite.getTransform()};
+    const sf::Color &color{sprite.getColor()};
+    add_quad(get_vertices(layer, sprite.getTexture()),
+             {transform.transformPoint(0.f, 0.f), color, {left, top}},
+             {transform.transformPoint(width, 0.f), color, {right, top}},
+             {transform.transformPoint(width, height), color, {right, bottom}},
+             {transform.transformPoint(0.f, height), color, {left, bottom}});
+}
+
+void RenderBatch::add_rectangle(const sf::RectangleShape &rectangle, unsigned int layer)
+{
+    std::vector<sf::Vertex> &vertices{get_vertices(layer, nullptr)};
+    const sf::Transform &transform{rectangle.getTransform()};
+    const sf::Vector2f &size{rectangle.getSize()};
+
+    const sf::Color &fill{rectangle.getFillColor()};
+    add_quad(vertices,
+             {transform.transformPoint(0.f, 0.f), fill},
+             {transform.transformPoint(size.x, 0.f), fill},
+             {transform.transformPoint(size.x, size.y), fill},
+             {transform.transformPoint(0.f, size.y), fill});
+
+    // Outline is drawn outside the rectangle, as four strips.
+    float t{rectangle.getOutlineThickness()};
+    if (t == 0.f)
+        return;
+    const sf::Color &outline{rectangle.getOutlineColor()};
+    const sf::FloatRect strips[4]{
+        {-t, -t, size.x + 2 * t, t},
+        {-t, size.y, size.x + 2 * t, t},
+        {-t, 0.f, t, size.y},
+        {size.x, 0.f, t, size.y}};
+    for (const sf::FloatRect &strip : strips)
+    {
+        float right{strip.left + strip.width};
+        float bottom{strip.top + strip.height};
+        add_quad(vertices,
+                 {transform.transformPoint(strip.left, strip.top), outline},
+                 {transform.transformPoint(right, strip.top), outline},
+                 {transform.transformPoint(right, bottom), outline},
+                 {transform.transformPoint(strip.left, bottom), outline});
+    }
+}
+
+void RenderBatch::add_circle(const sf::CircleShape &circle, unsigned int layer)
+{
+    std::vector<sf::Vertex> &vertices{get_vertices(layer, nullptr)};
+    const sf::Transform &transform{circle.getTransform()};
+    const sf::Color &fill{circle.getFillColor()};
+    float radius{circle.getRadius()};
+    sf::Vertex center{transform.transformPoint(radius, radius), fill};
+
+    std::size_t count{circle.getPointCount()};
+    for (std::size_t i{0}; i < count; i++)
+    {
+        vertices.push_back(center);
+        vertices.emplace_back(transform.transformPoint(circle.getPoint(i)), fill);
+        vertices.emplace_back(transform.transformPoint(circle.getPoint((i + 1) % count)), fill);
+    }
+}
+
+void RenderBatch::add_ring(const sf::Vector2f &center, float inner_radius, float outer_radius,
+                           const sf::Color &color, std::size_t point_count, unsigned int layer)
+{
+    std::vector<sf::Vertex> &vertices{get_vertices(layer, nullptr)};
+    const float step{2.f * 3.141592654f / point_count};
+    sf::Vector2f previous{1.f, 0.f};
+    for (std::size_t i{1}; i <= point_count; i++)
+    {
+        // Last point is exactly the first, so the ring has no gap.
+        float angle{step * (i % point_count)};
+        sf::Vector2f next{std::cos(angle), std::sin(angle)};
+        add_quad(vertices,
+                 {center + previous * inner_radius, color},
+                 {center + previous * outer_radius, color},
+                 {center + next * outer_radius, color},
+                 {center + next * inner_radius, color});
+        previous = next;
+    }
+}
+
+void RenderBatch::add_unbatched(const GameObject *object)
+{
+    m_unbatched.push_back(object);
+    m_segment_begin = m_group_count;
+}
+
+std::size_t RenderBatch::get_group_count() const
+{
+    return m_group_count;
+}
+
+RenderBatch::Group &RenderBatch::get_group(std::size_t index)
+{
+    return m_groups[index];
+}
+
+const RenderBatch::Group &RenderBatch::get_group(std::size_t index) const
+{
+    return m_groups[index];
+}
+
+const std::vector<const GameObject *> &RenderBatch::get_unbatched() const
+{
+    return m_unbatched;
+}
+
+std::vector<sf::Vertex> &RenderBatch::get_vertices(unsigned int layer, const sf::Texture *texture)
+{
+    if (m_last_group >= m_segment_begin && m_last_group < m_group_count &&
+        m_groups[m_last_group].layer == layer && m_groups[m_last_group].texture == texture)
+    {
+        return m_groups[m_last_group].vertices;
+    }
+
+    // Few textures are used, a linear search is fast enough.
+    for (std::size_t i{m_segment_begin}; i < m_group_count; i++)
+    {
+        if (m_groups[i].layer == layer && m_groups[i].texture == texture)
+        {
+            m_last_group = i;
+            return m_groups[i].vertices;
+        }
+    }
+
+    if (m_group_count == m_groups.size())
+        m_groups.push_back(Group{});
+    Group &group{m_groups[m_group_count]};
+    group.segment = m_unbatched.size();
+    group.layer = layer;
+    group.texture = texture;
+    m_last_group = m_group_count++;
+    return group.vertices;
+}
+
+void RenderBatch::add_quad(
+    std::vector<sf::Vertex> &vertices,
+    const sf::Vertex &a, const sf::Vertex &b, const sf::Vertex &c, const sf::Vertex &d)
+{
+    vertices.push_back(a);
+    vertices.push_back(b);
+    vertices.push_back(c);
+    vertices.push_back(a);
+    vertices.push_back(c);
+    vertices.push_back(d);
+}
@@ -0,0 +1,130 @@
+#include "rendersnapshot.hpp"
+#include "resourcemanager.hpp"
+
+#include <type_traits>
+
+RenderSnapshot::RenderSnapshot()
+    : m_drawables{},
+      m_batches{},
+      m_batch_count{0},
+      m_texts{},
+      m_text_count{0},
+      m_size{},
+      m_view{}
+{
+}
+
+void RenderSnapshot::reset(const sf::Vector2u &size, const sf::View &view)
+{
+    m_drawables.clear();
+    m_batch_count = 0;
+    m_text_count = 0;
+    m_size = size;
+    m_view = view;
+}
+
+void RenderSnapshot::draw(const sf::Sprite &sprite)
+{
+    m_drawables.emplace_back(sprite);
+}
+
+void RenderSnapshot::draw(const sf::Text &text)
+{
+    const sf::Font *font{text.getFont()};
+    if (font == nullptr)
+        return;
+    if (m_text_count == m_texts.size())
+        m_texts.emplace_back();
+    sf::Text &slot{m_texts[m_text_count]};
+    // A new string is copied into the memory of the old one. The setters of
+    // sf::Text do nothing if the value is the same, and glyphs are only
+    // rebuilt when drawn.
+    if (slot.getString() != text.getString())
+        slot.setString(text.getString());
+    slot.setFont(ResourceManager::get_render_font(*font));
+    slot.setCharacterSize(text.getCharacterSize());
+    slot.setStyle(text.getStyle());
+    slot.setLetterSpacing(text.getLetterSpacing());
+    slot.setLineSpacing(text.getLineSpacing());
+    slot.setFillColor(text.getFillColor());
+    slot.setOutlineColor(text.getOutlineColor());
+    slot.setOutlineThickness(text.getOutlineThickness());
+    static_cast<sf::Transformable &>(slot) = text;
+    m_drawables.emplace_back(TextDraw{m_text_count++});
+}
+
+void RenderSnapshot::draw(const sf::RectangleShape &rectangle)
+{
+    m_drawables.emplace_back(rectangle);
+}
+
+void RenderSnapshot::draw(const sf::CircleShape &circle)
+{
+    m_drawables.emplace_back(circle);
+}
+
+std::size_t RenderSnapshot::add_batch(const sf::Texture *texture, std::size_t vertex_count)
+{
+    if (m_batch_count == m_batches.size())
+        m_batches.push_back(Batch{nullptr, {}});
+    Batch &batch{m_batches[m_batch_count]};
+    batch.texture = texture;
+    batch.vertices.resize(vertex_count);
+    m_drawables.emplace_back(BatchDraw{m_batch_count});
+    return m_batch_count++;
+}
+
+sf::Vertex *RenderSnapshot::get_batch_vertices(std::size_t index)
+{
+    return m_batches[index].vertices.data();
+}
+
+std::size_t RenderSnapshot::get_batch_count() const
+{
+    return m_batch_count;
+}
+
+std::size_t RenderSnapshot::get_batch_size(std::size_t index) const
+{
+    return m_batches[index].vertices.size();
+}
+
+sf::Vector2u RenderSnapshot::get_size() const
+{
+    return m_size;
+}
+
+std::size_t RenderSnapshot::get_draw_count() const
+{
+    return m_drawables.size();
+}
+
+void RenderSnapshot::render(sf::RenderTarget &target) const
+{
+    target.setView(m_view);
+    for (const Drawable &drawable : m_drawables)
+    {
+        std::visit([this, &target](const auto &value)
+                   {
+                       typedef std::decay_t<decltype(value)> Type;
+                       if constexpr (std::is_same_v<Type, BatchDraw>)
+                       {
+                           const Batch &batch{m_batches[value.index]};
+                           if (!batch.vertices.empty())
+                           {
+                               target.draw(batch.vertices.data(), batch.vertices.size(),
+                                           sf::Triangles, sf::RenderStates{batch.texture});
+                           }
+                       }
+                       else if constexpr (std::is_same_v<Type, TextDraw>)
+                       {
+                           target.draw(m_texts[value.index]);
+                       }
+                       else
+                       {
+                           target.draw(value);
+                       }
+                   },
+                   drawable);
+    }
+}
@@ -0,0 +1,87 @@
+#include "renderthread.hpp"
+#include "profiler.hpp"
+
+#include <utility>
+
+RenderThread::RenderThread(sf::RenderWindow &window)
+    : m_window{window},
+      m_snapshots{},
+      m_mutex{},
+      m_submitted{},
+      m_back{0},
+      m_ready{1},
+      m_front{2},
+      m_has_ready{false},
+      m_stop{false},
+      m_thread{}
+{
+}
+
+RenderThread::~RenderThread()
+{
+    stop();
+}
+
+RenderSnapshot &RenderThread::get_back_buffer()
+{
+    return m_snapshots[m_back];
+}
+
+void RenderThread::submit()
+{
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        std::swap(m_back, m_ready);
+        m_has_ready = true;
+    }
+    m_submitted.notify_one();
+}
+
+void RenderThread::start()
+{
+    if (m_thread.joinable())
+        return;
+
+    // A window can only be active on one thread at the time.
+    m_window.setActive(false);
+    m_stop = false;
+    m_thread = std::thread{&RenderThread::run, this};
+}
+
+void RenderThread::stop()
+{
+    if (!m_thread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_stop = true;
+    }
+    m_submitted.notify_one();
+    m_thread.join();
+    m_window.setActive(true);
+}
+
+void RenderThread::run()
+{
+    m_window.setActive(true);
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock{m_mutex};
+            m_submitted.wait(lock, [this]
+                             { return m_stop || m_has_ready; });
+            if (m_stop)
+                break;
+            std::swap(m_front, m_ready);
+            m_has_ready = false;
+        }
+
+        sf::Clock clock{};
+        m_window.clear();
+        m_snapshots[m_front].render(m_window);
+        m_window.display();
+        Profiler::record("render", clock.getElapsedTime());
+    }
+    m_window.setActive(false);
+}
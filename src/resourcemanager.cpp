@@ -3,31 +3,48 @@
 #include <sstream>
 
 std::map<std::string, sf::Font> ResourceManager::Fonts{};
+std::map<const sf::Font *, sf::Font> ResourceManager::Render_fonts{};
 std::map<std::string, sf::Texture> ResourceManager::Textures{};
 std::map<std::string, sf::SoundBuffer> ResourceManager::Sound_buffers{};
 std::map<std::string, sf::Sound> ResourceManager::Sounds{};
+std::map<const sf::Texture *, CollisionMask> ResourceManager::Masks{};
+std::recursive_mutex ResourceManager::Mutex{};
 
 sf::Texture &ResourceManager::load_texture(std::string const &path)
     // Inspired by lecture by Christoffer Holm. (https://www.ida.liu.se/~TDDC76/current/fo/index.sv.shtml)
 
 {
+    std::lock_guard<std::recursive_mutex> lock{Mutex};
     auto pair{Textures.find(path)};
     if (pair == end(Textures))
     {
+        // Load the image once for both the texture and its collision mask.
+        sf::Image image;
         sf::Texture texture;
-        if (!texture.loadFromFile(path))
+        if (!image.loadFromFile(path) || !texture.loadFromImage(image))
         {
             std::stringstream ss;
             ss << "the file " << path << " was not loaded correctly!"; 
             throw std::logic_error(ss.str());
         }
         pair = Textures.insert({path, texture}).first;
+        Masks.emplace(&pair->second, CollisionMask{image});
     }
     return pair->second;
 }
 
+const CollisionMask *ResourceManager::get_mask(const sf::Texture &texture)
+{
+    std::lock_guard<std::recursive_mutex> lock{Mutex};
+    auto pair{Masks.find(&texture)};
+    if (pair == end(Masks))
+        return nullptr;
+    return &pair->second;
+}
+
 sf::Sound &ResourceManager::load_sound(std::string const &path)
 {
+    std::lock_guard<std::recursive_mutex> lock{Mutex};
     auto pair{Sounds.find(path)};
     if (pair == end(Sounds))
     {
@@ -40,6 +57,7 @@ sf::Sound &ResourceManager::load_sound(std::string const &path)
 
 sf::SoundBuffer &ResourceManager::load_sound_buffer(const std::string &path)
 {
+    std::lock_guard<std::recursive_mutex> lock{Mutex};
     auto pair{Sound_buffers.find(path)};
     if (pair == end(Sound_buffers))
     {
@@ -57,17 +75,30 @@ sf::SoundBuffer &ResourceManager::load_sound_buffer(const std::string &path)
 
 sf::Font &ResourceManager::load_font(std::string const &path)
 {
+    std::lock_guard<std::recursive_mutex> lock{Mutex};
     auto pair{Fonts.find(path)};
     if (pair == end(Fonts))
     {
         sf::Font font;
-        if (!font.loadFromFile(path))
+        // Not a copy of font, copies share the same FreeType face.
+        sf::Font render_font;
+        if (!font.loadFromFile(path) || !render_font.loadFromFile(path))
         {
             std::stringstream ss;
             ss << "the file " << path << " was not loaded correctly!"; 
             throw std::logic_error(ss.str());
         }
         pair = Fonts.insert({path, font}).first;
+        Render_fonts.emplace(&pair->second, render_font);
     }
     return pair->second;
 }
+
+const sf::Font &ResourceManager::get_render_font(const sf::Font &font)
+{
+    std::lock_guard<std::recursive_mutex> lock{Mutex};
+    auto pair{Render_fonts.find(&font)};
+    if (pair == end(Render_fonts))
+        return font;
+    return pair->second;
+}
@@ -0,0 +1,420 @@
+#include "scorestore.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const char s_magic[4]{'S', 'I', 'L', 'B'};
+    const std::uint16_t s_version{1};
+    const std::size_t s_header_size{8};
+    const std::size_t s_entry_size{5 * 4 + 8};
+
+    void put_u16(std::vector<char> &buffer, std::uint16_t value)
+    {
+        buffer.push_back(static_cast<char>(value & 0xff));
+        buffer.push_back(static_cast<char>((value >> 8) & 0xff));
+    }
+
+    void put_u32(std::vector<char> &buffer, std::uint32_t value)
+    {
+        for (int i{0}; i < 4; i++)
+            buffer.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+    }
+
+    void put_u64(std::vector<char> &buffer, std::uint64_t value)
+    {
+        for (int i{0}; i < 8; i++)
+            buffer.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+    }
+
+    std::uint64_t get_bytes(const char *data, int count)
+    {
+        std::uint64_t value{0};
+        for (int i{0}; i < count; i++)
+            value |= static_cast<std::uint64_t>(static_cast<unsigned char>(data[i])) << (8 * i);
+        return value;
+    }
+
+    std::uint32_t checksum(const char *data, std::size_t size)
+    {
+        // FNV-1a, 32 bit.
+        std::uint32_t hash{2166136261u};
+        for (std::size_t i{0}; i < size; i++)
+        {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+#ifdef _WIN32
+    /**
+     * @brief Write all bytes to a new file and wait until they are on disk.
+     */
+    bool write_synced(const std::filesystem::path &path, const std::vector<char> &buffer)
+    {
+        int fd{::_wopen(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY,
+                        _S_IREAD | _S_IWRITE)};
+        if (fd < 0)
+            return false;
+        std::size_t written{0};
+        while (written < buffer.size())
+        {
+            int result{::_write(fd, buffer.data() + written,
+                                static_cast<unsigned int>(buffer.size() - written))};
+            if (result < 0)
+            {
+                ::_close(fd);
+                return false;
+            }
+            written += static_cast<std::size_t>(result);
+        }
+        bool synced{::_commit(fd) == 0};
+        return ::_close(fd) == 0 && synced;
+    }
+
+    /**
+     * @brief Rename from over to. MOVEFILE_WRITE_THROUGH only returns once the
+     * rename is on disk, Windows has no directory to sync.
+     */
+    bool replace_file(const std::filesystem::path &from, const std::filesystem::path &to)
+    {
+        return ::MoveFileExW(from.c_str(), to.c_str(),
+                             MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+    }
+#else
+    /**
+     * @brief Write all bytes to a new file and wait until they are on disk.
+     */
+    bool write_synced(const std::filesystem::path &path, const std::vector<char> &buffer)
+    {
+        int fd{::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644)};
+        if (fd < 0)
+            return false;
+        std::size_t written{0};
+        while (written < buffer.size())
+        {
+            ssize_t result{::write(fd, buffer.data() + written, buffer.size() - written)};
+            if (result < 0 && errno == EINTR)
+                continue;
+            if (result < 0)
+            {
+                ::close(fd);
+                return false;
+            }
+            written += static_cast<std::size_t>(result);
+        }
+        bool synced{::fsync(fd) == 0};
+        return ::close(fd) == 0 && synced;
+    }
+
+    /**
+     * @brief Sync the directory of a file, so a rename into it is on disk.
+     */
+    bool sync_directory(const std::filesystem::path &path)
+    {
+        std::filesystem::path directory{path.parent_path()};
+        if (directory.empty())
+            directory = ".";
+        int fd{::open(directory.c_str(), O_RDONLY | O_DIRECTORY)};
+        if (fd < 0)
+            return false;
+        bool synced{::fsync(fd) == 0};
+        return ::close(fd) == 0 && synced;
+    }
+
+    /**
+     * @brief Rename from over to and sync the directory.
+     */
+    bool replace_file(const std::filesystem::path &from, const std::filesystem::path &to)
+    {
+        return ::rename(from.c_str(), to.c_str()) == 0 && sync_directory(to);
+    }
+#endif
+
+    bool better(const ScoreEntry &lhs, const ScoreEntry &rhs)
+    {
+        // Higher score first. On equal score the older run keeps its place.
+        if (lhs.score != rhs.score)
+            return lhs.score > rhs.score;
+        return lhs.timestamp < rhs.timestamp;
+    }
+}
+
+/*=================================ScoreEntry=================================*/
+
+ScoreEntry::ScoreEntry()
+    : score{0},
+      kills{0},
+      boss_kills{0},
+      level{0},
+      seed{0},
+      timestamp{0}
+{
+}
+
+/*=================================ScoreStore=================================*/
+
+const int ScoreStore::s_pending_rank;
+
+ScoreStore::ScoreStore(const std::string &path, std::size_t capacity,
+                       const std::string &legacy_path)
+    : m_path{path},
+      m_capacity{capacity},
+      m_legacy_path{legacy_path},
+      m_mutex{},
+      m_changed{},
+      m_written{},
+      m_entries{},
+      m_pending{},
+      m_ranks{},
+      m_version{0},
+      m_written_version{0},
+      m_loaded{false},
+      m_stop{false},
+      m_writer{}
+{
+    // Started last, all other members must be initialized before run() is called.
+    m_writer = std::thread{&ScoreStore::run, this};
+}
+
+ScoreStore::~ScoreStore()
+{
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_stop = true;
+    }
+    m_changed.notify_one();
+    m_writer.join();
+}
+
+std::size_t ScoreStore::submit(const ScoreEntry &entry)
+{
+    std::size_t ticket{};
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        ticket = m_ranks.size();
+        m_ranks.push_back(s_pending_rank);
+        m_pending.emplace_back(ticket, entry);
+    }
+    m_changed.notify_one();
+    return ticket;
+}
+
+int ScoreStore::get_rank(std::size_t ticket) const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return ticket < m_ranks.size() ? m_ranks[ticket] : -1;
+}
+
+unsigned int ScoreStore::get_high_score() const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_entries.empty() ? 0 : m_entries.front().score;
+}
+
+std::vector<ScoreEntry> ScoreStore::get_leaderboard() const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_entries;
+}
+
+std::uint64_t ScoreStore::get_version() const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_version;
+}
+
+bool ScoreStore::is_loaded() const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_loaded;
+}
+
+void ScoreStore::flush()
+{
+    std::unique_lock<std::mutex> lock{m_mutex};
+    m_written.wait(lock, [this]
+                   { return m_loaded && m_pending.empty() && m_written_version == m_version; });
+}
+
+void ScoreStore::run()
+{
+    // Load without holding the lock. Entries submitted meanwhile are queued and
+    // ranked once the file is merged.
+    std::vector<ScoreEntry> loaded{};
+    bool from_legacy{false};
+    if (!read_file(m_path, loaded))
+    {
+        ScoreEntry legacy{};
+        if (read_legacy_file(m_legacy_path, legacy))
+        {
+            loaded.push_back(legacy);
+            from_legacy = true;
+        }
+    }
+
+    std::unique_lock<std::mutex> lock{m_mutex};
+    for (const ScoreEntry &entry : loaded)
+    {
+        insert(entry);
+    }
+    m_loaded = true;
+    m_version++;
+    // Nothing new to write unless the old text file has to be converted.
+    if (!from_legacy)
+        m_written_version = m_version;
+    m_written.notify_all();
+
+    while (true)
+    {
+        m_changed.wait(lock, [this]
+                       { return m_stop || !m_pending.empty() || m_version != m_written_version; });
+
+        insert_pending();
+
+        if (m_version != m_written_version)
+        {
+            // Copy under the lock, write without it so the getters never wait on disk.
+            std::vector<ScoreEntry> entries{m_entries};
+            std::uint64_t version{m_version};
+            lock.unlock();
+            if (!write_file(m_path, entries))
+            {
+                std::cerr << "ScoreStoreERROR: could not write " << m_path << std::endl;
+            }
+            lock.lock();
+            m_written_version = version;
+            m_written.notify_all();
+        }
+        else if (m_stop)
+        {
+            break;
+        }
+    }
+}
+
+void ScoreStore::insert_pending()
+{
+    if (m_pending.empty())
+        return;
+    for (const std::pair<std::size_t, ScoreEntry> &pending : m_pending)
+    {
+        int rank{insert(pending.second)};
+        m_ranks[pending.first] = rank;
+        if (rank >= 0)
+            m_version++;
+    }
+    m_pending.clear();
+    m_written.notify_all();
+}
+
+int ScoreStore::insert(const ScoreEntry &entry)
+{
+    auto it = std::upper_bound(m_entries.begin(), m_entries.end(), entry, better);
+    int rank{static_cast<int>(std::distance(m_entries.begin(), it))};
+    if (static_cast<std::size_t>(rank) >= m_capacity)
+        return -1;
+
+    m_entries.insert(it, entry);
+    if (m_entries.size() > m_capacity)
+        m_entries.pop_back();
+    return rank;
+}
+
+bool ScoreStore::read_file(const std::string &path, std::vector<ScoreEntry> &entries)
+{
+    std::ifstream fs{path, std::ios::binary};
+    if (!fs.is_open())
+        return false;
+
+    std::vector<char> buffer{std::istreambuf_iterator<char>{fs}, std::istreambuf_iterator<char>{}};
+    if (buffer.size() < s_header_size || !std::equal(s_magic, s_magic + 4, buffer.begin()))
+        return false;
+
+    std::uint16_t version{static_cast<std::uint16_t>(get_bytes(&buffer[4], 2))};
+    std::size_t count{static_cast<std::size_t>(get_bytes(&buffer[6], 2))};
+    if (version != s_version || buffer.size() != s_header_size + count * s_entry_size + 4)
+        return false;
+
+    const char *data{buffer.data() + s_header_size};
+    std::uint32_t stored{static_cast<std::uint32_t>(get_bytes(data + count * s_entry_size, 4))};
+    if (stored != checksum(data, count * s_entry_size))
+        return false;
+
+    entries.clear();
+    for (std::size_t i{0}; i < count; i++, data += s_entry_size)
+    {
+        ScoreEntry entry{};
+        entry.score = static_cast<std::uint32_t>(get_bytes(data, 4));
+        entry.kills = static_cast<std::uint32_t>(get_bytes(data + 4, 4));
+        entry.boss_kills = static_cast<std::uint32_t>(get_bytes(data + 8, 4));
+        entry.level = static_cast<std::uint32_t>(get_bytes(data + 12, 4));
+        entry.seed = static_cast<std::uint32_t>(get_bytes(data + 16, 4));
+        entry.timestamp = static_cast<std::int64_t>(get_bytes(data + 20, 8));
+        entries.push_back(entry);
+    }
+    return true;
+}
+
+bool ScoreStore::write_file(const std::string &path, const std::vector<ScoreEntry> &entries)
+{
+    std::vector<char> buffer{};
+    buffer.reserve(s_header_size + entries.size() * s_entry_size + 4);
+    buffer.insert(buffer.end(), s_magic, s_magic + 4);
+    put_u16(buffer, s_version);
+    put_u16(buffer, static_cast<std::uint16_t>(entries.size()));
+    for (const ScoreEntry &entry : entries)
+    {
+        put_u32(buffer, entry.score);
+        put_u32(buffer, entry.kills);
+        put_u32(buffer, entry.boss_kills);
+        put_u32(buffer, entry.level);
+        put_u32(buffer, entry.seed);
+        put_u64(buffer, static_cast<std::uint64_t>(entry.timestamp));
+    }
+    put_u32(buffer, checksum(buffer.data() + s_header_size, buffer.size() - s_header_size));
+
+    // Write to a temporary file first, the rename replaces the old file in one
+    // step. The data is synced before the rename, so the new file is never
+    // seen without its contents.
+    std::filesystem::path temp_path{path + ".tmp"};
+    if (!write_synced(temp_path, buffer))
+        return false;
+    return replace_file(temp_path, std::filesystem::path{path});
+}
+
+bool ScoreStore::read_legacy_file(const std::string &path, ScoreEntry &entry)
+{
+    std::ifstream fs{path};
+    if (!fs.is_open())
+        return false;
+
+    unsigned int score{};
+    if (!(fs >> score) || score == 0)
+        return false;
+    entry.score = score;
+    return true;
+}
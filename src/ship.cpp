@@ -1,4 +1,7 @@
 #include "ship.hpp"
+#include "narrowphase.hpp"
+#include "renderbatch.hpp"
+#include "resourcemanager.hpp"
 #include <cmath>
 
 Ship::Ship(int health, float speed, float projectile_speed)
@@ -11,7 +14,8 @@ Ship::Ship(int health, float speed, float projectile_speed)
       collide_clock{},
       s_health_bar_offset{},
       s_health_bar{s_max_health, s_health},
-      s_health_bar_visible{false}
+      s_health_bar_visible{false},
+      s_mask{nullptr}
 {
     s_health_bar_offset = sf::Vector2f{0, 34};
     s_health_bar.set_size(70, 6);
@@ -19,15 +23,34 @@ Ship::Ship(int health, float speed, float projectile_speed)
     s_health_bar.set_background_color(sf::Color{0x4b4b4bff});
 }
 
-void Ship::render(sf::RenderWindow &window) const
+void Ship::render(RenderSnapshot &snapshot) const
 {
-    window.draw(s_sprite);
+    snapshot.draw(s_sprite);
     if (s_health_bar_visible)
     {
-        s_health_bar.render(window);
+        s_health_bar.render(snapshot);
     }
 }
 
+bool Ship::render_batched(RenderBatch &batch) const
+{
+    batch.add_sprite(s_sprite);
+    if (s_health_bar_visible)
+    {
+        // Health bars on top of all ships.
+        s_health_bar.render_batched(batch, 1);
+    }
+    return true;
+}
+
+bool Ship::get_collision_shape(CollisionShape &shape) const
+{
+    const sf::IntRect &texture_rect{s_sprite.getTextureRect()};
+    shape = CollisionShape{Narrowphase::get_transform(s_sprite), s_sprite.getLocalBounds(),
+                           s_mask, sf::Vector2i{texture_rect.left, texture_rect.top}};
+    return true;
+}
+
 int Ship::get_health() const
 {
     return s_health;
@@ -49,4 +72,16 @@ void Ship::update_health_bar()
     ;
     s_health_bar.set_position(pos.x, pos.y);
     s_health_bar.update();
-}
\ No newline at end of file
+}
+
+void Ship::set_texture(const sf::Texture &texture)
+{
+    s_sprite.setTexture(texture);
+    s_mask = ResourceManager::get_mask(texture);
+    mark_bounds_dirty();
+}
+
+const sf::Transformable *Ship::get_transform() const
+{
+    return &s_sprite;
+}
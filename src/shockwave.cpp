@@ -0,0 +1,87 @@
+#include "shockwave.hpp"
+#include "renderbatch.hpp"
+#include "rendersnapshot.hpp"
+
+#include <cmath>
+
+namespace
+{
+    // Same speed as the projectiles of the old Nuke burst.
+    const float s_speed{500.f};
+    // Width of the drawn ring, behind its front.
+    const float s_thickness{12.f};
+    const sf::Color s_color{0, 255, 0, 160};
+}
+
+Shockwave::Shockwave(float x, float y, bool friendly, int damage)
+    : GameObject{},
+      m_center{x, y},
+      m_radius{0.f},
+      m_friendly{friendly},
+      m_damage{damage}
+{
+}
+
+void Shockwave::render(RenderSnapshot &snapshot) const
+{
+    // Same ring as render_batched(...): the outline is drawn outside the
+    // circle, from the inner radius out to the front.
+    float inner_radius{get_inner_radius()};
+    sf::CircleShape ring{inner_radius, 64};
+    ring.setOrigin(inner_radius, inner_radius);
+    ring.setPosition(m_center);
+    ring.setFillColor(sf::Color::Transparent);
+    ring.setOutlineColor(s_color);
+    ring.setOutlineThickness(m_radius - inner_radius);
+    snapshot.draw(ring);
+}
+
+bool Shockwave::render_batched(RenderBatch &batch) const
+{
+    batch.add_ring(m_center, get_inner_radius(), m_radius, s_color);
+    return true;
+}
+
+void Shockwave::update(Context &context)
+{
+    float previous_radius{m_radius};
+    m_radius += s_speed * context.get_delta().asSeconds();
+    context.spawn_area_effect(AreaEffect{m_center, previous_radius, m_radius, m_friendly, m_damage});
+
+    // Remove once the ring covers the whole window, wherever it started.
+    sf::Vector2f window_size{context.get_window_size()};
+    float far_x{std::fmax(m_center.x, window_size.x - m_center.x)};
+    float far_y{std::fmax(m_center.y, window_size.y - m_center.y)};
+    if (m_radius * m_radius > far_x * far_x + far_y * far_y)
+        remove();
+}
+
+bool Shockwave::handle(const sf::Event &, Context &)
+{
+    return false;
+}
+
+sf::FloatRect Shockwave::bounds() const
+{
+    return sf::FloatRect{m_center, sf::Vector2f{}};
+}
+
+ObjectKind Shockwave::get_kind() const
+{
+    return ObjectKind::Shockwave;
+}
+
+void Shockwave::collision(const GameObject *)
+{
+}
+
+float Shockwave::get_radius() const
+{
+    return m_radius;
+}
+
+float Shockwave::get_inner_radius() const
+{
+    // Thinner than s_thickness right after the shockwave starts.
+    return std::fmax(m_radius - s_thickness, 0.f);
+}
@@ -0,0 +1,262 @@
+#include "spatialgrid.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    // Cells are made larger if objects are spread over more than this many
+    // cells in any direction.
+    const float s_max_cells{256.f};
+    const float s_infinity{std::numeric_limits<float>::infinity()};
+
+    /**
+     * @brief Clip the parameter range [t_min, t_max] of a ray to the open
+     * interval (min, max) along one axis.
+     *
+     * @return false if the range became empty.
+     */
+    bool clip_axis(float origin, float direction, float min, float max,
+                   float &t_min, float &t_max)
+    {
+        if (direction == 0.f)
+            return min < origin && origin < max;
+        float t_first{(min - origin) / direction};
+        float t_second{(max - origin) / direction};
+        if (t_first > t_second)
+            std::swap(t_first, t_second);
+        t_min = std::max(t_min, t_first);
+        t_max = std::min(t_max, t_second);
+        return t_min < t_max;
+    }
+}
+
+SpatialGrid::SpatialGrid(float cell_size)
+    : m_entries{},
+      m_boxes{},
+      m_grid{cell_size, s_max_cells}
+{
+}
+
+void SpatialGrid::build(const std::vector<GameObject *> &objects)
+{
+    m_entries.clear();
+    m_boxes.clear();
+    for (const GameObject *object : objects)
+    {
+        CollisionLayer layer{object->get_layer()};
+        const sf::FloatRect &bounds{object->get_cached_bounds()};
+        if (object->is_removed() || layer == CollisionLayer::None ||
+            bounds.width == 0.f || bounds.height == 0.f)
+        {
+            continue;
+        }
+        m_entries.push_back(Entry{object, layer});
+        m_boxes.push_back(CellBox{std::min(bounds.left, bounds.left + bounds.width),
+                                  std::min(bounds.top, bounds.top + bounds.height),
+                                  std::max(bounds.left, bounds.left + bounds.width),
+                                  std::max(bounds.top, bounds.top + bounds.height)});
+    }
+    m_grid.build(m_boxes);
+}
+
+void SpatialGrid::clear()
+{
+    m_entries.clear();
+    m_boxes.clear();
+    m_grid.clear();
+}
+
+std::size_t SpatialGrid::get_size() const
+{
+    return m_entries.size();
+}
+
+const GameObject *SpatialGrid::find_nearest(const sf::Vector2f &point, CollisionLayer layers,
+                                            float max_distance) const
+{
+    if (m_entries.empty() || max_distance < 0.f)
+        return nullptr;
+
+    const GameObject *nearest{nullptr};
+    float nearest_distance2{max_distance * max_distance};
+    int columns{m_grid.get_columns()};
+    int rows{m_grid.get_rows()};
+    int point_column{m_grid.get_column(point.x)};
+    int point_row{m_grid.get_row(point.y)};
+    // Search rings of cells around the point, starting at the first ring that
+    // touches the grid.
+    int ring{std::max({0, -point_column, point_column - (columns - 1),
+                       -point_row, point_row - (rows - 1)})};
+    for (;; ring++)
+    {
+        // Cells in a ring are at least ring - 1 cells away from the point.
+        float ring_distance{std::max(0, ring - 1) * m_grid.get_cell_size()};
+        if (ring_distance * ring_distance > nearest_distance2)
+            break;
+
+        int first_column{point_column - ring};
+        int last_column{point_column + ring};
+        int first_row{point_row - ring};
+        int last_row{point_row + ring};
+        for (int row{std::max(first_row, 0)}; row <= std::min(last_row, rows - 1); row++)
+        {
+            // Rows in between only have the first and last column in the ring.
+            bool full_row{row == first_row || row == last_row};
+            int step{full_row ? 1 : last_column - first_column};
+            for (int column{first_column}; column <= last_column; column += step)
+            {
+                if (column < 0 || column >= columns)
+                    continue;
+                for (std::size_t i : m_grid.get_cell(column, row))
+                {
+                    const Entry &entry{m_entries[i]};
+                    if (!has_layer(layers, entry.layer))
+                        continue;
+                    float distance2{get_distance2(m_boxes[i], point)};
+                    if (distance2 < nearest_distance2 ||
+                        (nearest == nullptr && distance2 == nearest_distance2))
+                    {
+                        nearest = entry.object;
+                        nearest_distance2 = distance2;
+                    }
+                }
+            }
+        }
+
+        // The whole grid has been searched.
+        if (first_column <= 0 && first_row <= 0 && last_column >= columns - 1 && last_row >= rows - 1)
+            break;
+    }
+    return nearest;
+}
+
+void SpatialGrid::find_in_radius(const sf::Vector2f &point, float radius, CollisionLayer layers,
+                                 std::vector<const GameObject *> &found) const
+{
+    find_in_ring(point, -1.f, radius, layers, found);
+}
+
+void SpatialGrid::find_in_ring(const sf::Vector2f &point, float inner_radius, float outer_radius,
+                               CollisionLayer layers, std::vector<const GameObject *> &found) const
+{
+    float radius{outer_radius};
+    if (m_entries.empty() || radius < 0.f || inner_radius >= radius)
+        return;
+
+    int first_column{std::max(m_grid.get_column(point.x - radius), 0)};
+    int last_column{std::min(m_grid.get_column(point.x + radius), m_grid.get_columns() - 1)};
+    int first_row{std::max(m_grid.get_row(point.y - radius), 0)};
+    int last_row{std::min(m_grid.get_row(point.y + radius), m_grid.get_rows() - 1)};
+    float radius2{radius * radius};
+    // Distances are never negative, so a negative inner radius excludes nothing.
+    float inner_radius2{inner_radius < 0.f ? -1.f : inner_radius * inner_radius};
+    for (int row{first_row}; row <= last_row; row++)
+    {
+        for (int column{first_column}; column <= last_column; column++)
+        {
+            for (std::size_t i : m_grid.get_cell(column, row))
+            {
+                const Entry &entry{m_entries[i]};
+                if (!m_grid.is_first_cell(m_boxes[i], column, row, first_column, first_row))
+                    continue;
+                if (!has_layer(layers, entry.layer))
+                    continue;
+                float distance2{get_distance2(m_boxes[i], point)};
+                if (distance2 > inner_radius2 && distance2 <= radius2)
+                    found.push_back(entry.object);
+            }
+        }
+    }
+}
+
+bool SpatialGrid::raycast(const sf::Vector2f &origin, const sf::Vector2f &direction, float max_distance,
+                          CollisionLayer layers, RayHit &hit) const
+{
+    float length{std::sqrt(direction.x * direction.x + direction.y * direction.y)};
+    if (m_entries.empty() || length == 0.f || max_distance < 0.f)
+        return false;
+    sf::Vector2f unit{direction / length};
+
+    // Only the part of the ray inside the grid has to be walked. The grid is
+    // grown by a bit, so rays along its edges are not lost.
+    float t_min{0.f};
+    float t_max{max_distance};
+    int columns{m_grid.get_columns()};
+    int rows{m_grid.get_rows()};
+    float cell_size{m_grid.get_cell_size()};
+    const sf::Vector2f &grid_origin{m_grid.get_origin()};
+    float margin{cell_size * 1e-3f};
+    if (!clip_axis(origin.x, unit.x, grid_origin.x - margin, grid_origin.x + columns * cell_size + margin, t_min, t_max) ||
+        !clip_axis(origin.y, unit.y, grid_origin.y - margin, grid_origin.y + rows * cell_size + margin, t_min, t_max))
+    {
+        return false;
+    }
+
+    // Walk the cells along the ray, in order.
+    sf::Vector2f start{origin + unit * t_min};
+    int column{std::min(std::max(m_grid.get_column(start.x), 0), columns - 1)};
+    int row{std::min(std::max(m_grid.get_row(start.y), 0), rows - 1)};
+    int step_x{unit.x > 0.f ? 1 : (unit.x < 0.f ? -1 : 0)};
+    int step_y{unit.y > 0.f ? 1 : (unit.y < 0.f ? -1 : 0)};
+    float t_next_x{s_infinity};
+    float t_next_y{s_infinity};
+    if (step_x != 0)
+        t_next_x = (grid_origin.x + (column + (step_x > 0)) * cell_size - origin.x) / unit.x;
+    if (step_y != 0)
+        t_next_y = (grid_origin.y + (row + (step_y > 0)) * cell_size - origin.y) / unit.y;
+    float t_delta_x{step_x != 0 ? cell_size / std::fabs(unit.x) : s_infinity};
+    float t_delta_y{step_y != 0 ? cell_size / std::fabs(unit.y) : s_infinity};
+
+    const GameObject *first{nullptr};
+    float first_distance{s_infinity};
+    for (;;)
+    {
+        for (std::size_t i : m_grid.get_cell(column, row))
+        {
+            const Entry &entry{m_entries[i]};
+            if (!has_layer(layers, entry.layer))
+                continue;
+            const CellBox &box{m_boxes[i]};
+            float t_enter{0.f};
+            float t_exit{max_distance};
+            if (clip_axis(origin.x, unit.x, box.min_x, box.max_x, t_enter, t_exit) &&
+                clip_axis(origin.y, unit.y, box.min_y, box.max_y, t_enter, t_exit) &&
+                t_enter < first_distance)
+            {
+                first = entry.object;
+                first_distance = t_enter;
+            }
+        }
+
+        // Objects in later cells can not be hit before the end of this cell.
+        float t_cell_end{std::min(t_next_x, t_next_y)};
+        if ((first != nullptr && first_distance <= t_cell_end) || t_cell_end > t_max)
+            break;
+        if (t_next_x < t_next_y)
+        {
+            column += step_x;
+            t_next_x += t_delta_x;
+        }
+        else
+        {
+            row += step_y;
+            t_next_y += t_delta_y;
+        }
+        if (column < 0 || column >= columns || row < 0 || row >= rows)
+            break;
+    }
+
+    if (first == nullptr)
+        return false;
+    hit = RayHit{first, first_distance, origin + unit * first_distance};
+    return true;
+}
+
+float SpatialGrid::get_distance2(const CellBox &box, const sf::Vector2f &point)
+{
+    float dx{std::max({box.min_x - point.x, 0.f, point.x - box.max_x})};
+    float dy{std::max({box.min_y - point.y, 0.f, point.y - box.max_y})};
+    return dx * dx + dy * dy;
+}
@@ -0,0 +1,229 @@
+#include "spawntable.hpp"
+#include "archetypes.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+    const std::uint64_t s_threshold_scale{std::uint64_t{1} << 32};
+}
+
+/*================================AliasTable==================================*/
+
+AliasTable::AliasTable()
+    : m_thresholds{},
+      m_aliases{}
+{
+}
+
+AliasTable::AliasTable(const std::vector<double> &weights)
+    : m_thresholds(weights.size(), s_threshold_scale),
+      m_aliases(weights.size())
+{
+    if (weights.empty())
+        throw std::logic_error("AliasTableERROR: no weights.");
+    double sum{0.0};
+    for (double weight : weights)
+    {
+        if (weight < 0.0)
+            throw std::logic_error("AliasTableERROR: negative weight.");
+        sum += weight;
+    }
+    if (sum <= 0.0)
+        throw std::logic_error("AliasTableERROR: all weights are 0.");
+
+    // Scale so that the average column is exactly full, then let columns
+    // above 1 fill up the columns below 1.
+    std::size_t n{weights.size()};
+    std::vector<double> scaled(n);
+    std::vector<std::size_t> small{}, large{};
+    for (std::size_t i{0}; i < n; i++)
+    {
+        scaled[i] = weights[i] * n / sum;
+        m_aliases[i] = i;
+        if (scaled[i] < 1.0)
+            small.push_back(i);
+        else
+            large.push_back(i);
+    }
+    while (!small.empty() && !large.empty())
+    {
+        std::size_t less{small.back()};
+        small.pop_back();
+        std::size_t more{large.back()};
+        m_thresholds[less] = static_cast<std::uint64_t>(scaled[less] * s_threshold_scale);
+        m_aliases[less] = more;
+        scaled[more] -= 1.0 - scaled[less];
+        if (scaled[more] < 1.0)
+        {
+            large.pop_back();
+            small.push_back(more);
+        }
+    }
+    // Whatever is left is full up to rounding errors.
+    for (std::size_t i : small)
+        m_thresholds[i] = s_threshold_scale;
+    for (std::size_t i : large)
+        m_thresholds[i] = s_threshold_scale;
+}
+
+std::size_t AliasTable::sample(std::uint32_t random) const
+{
+    // High bits of the product pick the column, low bits are the position in it.
+    std::uint64_t product{static_cast<std::uint64_t>(random) * m_thresholds.size()};
+    std::size_t column{static_cast<std::size_t>(product >> 32)};
+    std::uint64_t position{product & (s_threshold_scale - 1)};
+    return position < m_thresholds[column] ? column : m_aliases[column];
+}
+
+double AliasTable::get_probability(std::size_t outcome) const
+{
+    double columns{0.0};
+    for (std::size_t column{0}; column < m_thresholds.size(); column++)
+    {
+        double keep{static_cast<double>(m_thresholds[column]) / s_threshold_scale};
+        if (column == outcome)
+            columns += keep;
+        if (m_aliases[column] == outcome && column != outcome)
+            columns += 1.0 - keep;
+    }
+    return columns / m_thresholds.size();
+}
+
+std::size_t AliasTable::get_size() const
+{
+    return m_thresholds.size();
+}
+
+/*================================SpawnTable==================================*/
+
+SpawnTable::SpawnTable()
+    : m_bands{},
+      m_aliases{},
+      m_choices{}
+{
+}
+
+SpawnTable SpawnTable::defaults()
+{
+    // Same odds as the old chains of rand() branches, one band per 3 levels.
+    SpawnTable table{};
+    table.add_band(SpawnBand{0, {{"minion", 1, 1.0}}});
+    table.add_band(SpawnBand{3, {{"minion", 1, 27.0}, {"minion", 2, 9.0}, {"mover", 1, 4.0}}});
+    table.add_band(SpawnBand{6, {{"minion", 1, 21.0}, {"minion", 2, 7.0}, {"mover", 1, 8.0}, {"tank", 1, 4.0}}});
+    table.add_band(SpawnBand{9, {{"minion", 2, 21.0}, {"minion", 3, 7.0}, {"mover", 1, 6.0}, {"mover", 2, 2.0},
+                                 {"tank", 1, 4.0}}});
+    table.add_band(SpawnBand{12, {{"minion", 2, 99.0}, {"minion", 3, 33.0}, {"mover", 2, 50.0},
+                                  {"mover", 3, 10.0}, {"tank", 1, 27.0}, {"tank", 2, 9.0},
+                                  {"multishot", 1, 12.0}}});
+    return table;
+}
+
+SpawnTable SpawnTable::from_file(const std::string &path)
+{
+    std::ifstream file{path};
+    if (!file.is_open())
+        throw std::logic_error("SpawnTableERROR: could not open " + path + ".");
+
+    SpawnTable table{};
+    SpawnBand band{};
+    bool in_band{false};
+    std::string line{}, key{}, value{};
+    while (std::getline(file, line))
+    {
+        if (line.rfind("//", 0) == 0 || line.empty())
+            continue;
+        std::stringstream ss{line};
+        std::getline(ss, key, '=');
+        std::getline(ss, value, ';');
+        std::stringstream vs{value};
+        if (key == "LEVEL")
+        {
+            if (in_band)
+                table.add_band(band);
+            band = SpawnBand{};
+            if (!(vs >> band.level))
+                throw std::logic_error("LEVEL value is not a valid uint.");
+            in_band = true;
+        }
+        else if (key == "SPAWN")
+        {
+            if (!in_band)
+                throw std::logic_error("SpawnTableERROR: SPAWN is not part of a level.");
+            SpawnEntry entry{};
+            char separator{};
+            if (!std::getline(vs, entry.archetype, ',') || !(vs >> entry.difficulty >> separator >> entry.weight) ||
+                separator != ',')
+            {
+                throw std::logic_error("SPAWN value is not archetype,difficulty,weight.");
+            }
+            band.entries.push_back(entry);
+        }
+    }
+    if (in_band)
+        table.add_band(band);
+    return table;
+}
+
+void SpawnTable::add_band(const SpawnBand &band)
+{
+    if (!m_bands.empty() && band.level <= m_bands.back().level)
+        throw std::logic_error("SpawnTableERROR: levels of bands must increase.");
+    m_bands.push_back(band);
+    m_aliases.clear();
+    m_choices.clear();
+}
+
+void SpawnTable::compile(const ArchetypeTable &archetypes)
+{
+    if (m_bands.empty())
+        throw std::logic_error("SpawnTableERROR: no bands.");
+    m_aliases.clear();
+    m_choices.clear();
+    for (const SpawnBand &band : m_bands)
+    {
+        std::vector<double> weights{};
+        std::vector<SpawnChoice> choices{};
+        for (const SpawnEntry &entry : band.entries)
+        {
+            weights.push_back(entry.weight);
+            choices.push_back(SpawnChoice{archetypes.find(entry.archetype), entry.difficulty});
+        }
+        m_aliases.emplace_back(weights);
+        m_choices.push_back(choices);
+    }
+}
+
+const SpawnChoice &SpawnTable::sample(unsigned int level, std::uint32_t random) const
+{
+    if (m_aliases.empty())
+        throw std::logic_error("SpawnTableERROR: table is not compiled.");
+    std::size_t band{find_band(level)};
+    return m_choices[band][m_aliases[band].sample(random)];
+}
+
+std::size_t SpawnTable::find_band(unsigned int level) const
+{
+    auto it = std::upper_bound(m_bands.begin(), m_bands.end(), level,
+                               [](unsigned int value, const SpawnBand &band)
+                               { return value < band.level; });
+    return it == m_bands.begin() ? 0 : static_cast<std::size_t>(it - m_bands.begin()) - 1;
+}
+
+std::size_t SpawnTable::get_band_count() const
+{
+    return m_bands.size();
+}
+
+const SpawnBand &SpawnTable::get_band(std::size_t band) const
+{
+    return m_bands.at(band);
+}
+
+double SpawnTable::get_probability(std::size_t band, std::size_t entry) const
+{
+    return m_aliases.at(band).get_probability(entry);
+}
@@ -0,0 +1,151 @@
+#include "taskgraph.hpp"
+#include "threadpool.hpp"
+#include "profiler.hpp"
+
+#include <exception>
+#include <stdexcept>
+
+TaskGraph::TaskGraph()
+    : m_tasks{},
+      m_remaining{},
+      m_remaining_size{0},
+      m_pool{nullptr},
+      m_counter{nullptr}
+{
+}
+
+TaskGraph::TaskId TaskGraph::add_task(
+    const std::string &name,
+    const std::function<void()> &function,
+    const std::vector<TaskId> &dependencies)
+{
+    TaskId id{m_tasks.size()};
+    for (TaskId dependency : dependencies)
+    {
+        if (dependency >= id)
+            throw std::logic_error("TaskGraphERROR: dependency is not in the graph.");
+        m_tasks[dependency].dependents.push_back(id);
+    }
+    m_tasks.push_back(Task{name, function, {}, static_cast<unsigned int>(dependencies.size()), {}});
+    return id;
+}
+
+void TaskGraph::run(ThreadPool *pool)
+{
+    if (m_remaining_size < m_tasks.size())
+    {
+        m_remaining = std::make_unique<std::atomic<unsigned int>[]>(m_tasks.size());
+        m_remaining_size = m_tasks.size();
+    }
+
+    if (pool == nullptr || pool->get_thread_count() == 1)
+    {
+        run_serial();
+        return;
+    }
+
+    for (TaskId id{0}; id < m_tasks.size(); id++)
+    {
+        m_remaining[id] = m_tasks[id].dependency_count;
+    }
+
+    TaskCounter counter{};
+    m_pool = pool;
+    m_counter = &counter;
+    for (TaskId id{0}; id < m_tasks.size(); id++)
+    {
+        if (m_tasks[id].dependency_count == 0)
+            submit(id);
+    }
+    try
+    {
+        pool->wait(counter);
+    }
+    catch (...)
+    {
+        m_pool = nullptr;
+        m_counter = nullptr;
+        throw;
+    }
+    m_pool = nullptr;
+    m_counter = nullptr;
+}
+
+void TaskGraph::clear()
+{
+    m_tasks.clear();
+}
+
+std::size_t TaskGraph::get_task_count() const
+{
+    return m_tasks.size();
+}
+
+sf::Time TaskGraph::get_task_time(TaskId id) const
+{
+    return m_tasks.at(id).time;
+}
+
+void TaskGraph::run_serial()
+{
+    // m_remaining is 1 for tasks that depend on a task that threw.
+    for (TaskId id{0}; id < m_tasks.size(); id++)
+    {
+        m_remaining[id] = 0;
+    }
+
+    std::exception_ptr error{};
+    for (TaskId id{0}; id < m_tasks.size(); id++)
+    {
+        if (m_remaining[id] != 0)
+        {
+            skip_dependents(id);
+            continue;
+        }
+        try
+        {
+            execute(id);
+        }
+        catch (...)
+        {
+            if (!error)
+                error = std::current_exception();
+            skip_dependents(id);
+        }
+    }
+    if (error)
+        std::rethrow_exception(error);
+}
+
+void TaskGraph::skip_dependents(TaskId id)
+{
+    for (TaskId dependent : m_tasks[id].dependents)
+    {
+        m_remaining[dependent] = 1;
+    }
+}
+
+void TaskGraph::submit(TaskId id)
+{
+    m_pool->submit(&TaskGraph::run_task, this, id, *m_counter);
+}
+
+void TaskGraph::run_task(void *graph, std::size_t id)
+{
+    TaskGraph &self{*static_cast<TaskGraph *>(graph)};
+    self.execute(id);
+    for (TaskId dependent : self.m_tasks[id].dependents)
+    {
+        if (self.m_remaining[dependent].fetch_sub(1) == 1)
+            self.submit(dependent);
+    }
+}
+
+void TaskGraph::execute(TaskId id)
+{
+    Task &task{m_tasks[id]};
+    sf::Clock clock{};
+    task.function();
+    task.time = clock.getElapsedTime();
+    Profiler::record(task.name.c_str(), task.time);
+}
@@ -0,0 +1,271 @@
+#include "threadpool.hpp"
+
+#include <algorithm>
+
+namespace
+{
+    // Set on worker threads, used to find the queue of the calling thread.
+    thread_local const ThreadPool *t_pool{nullptr};
+    thread_local std::size_t t_queue_index{0};
+    // Tasks every queue has room for before it grows.
+    const std::size_t s_queue_capacity{64};
+
+    // Chunks of a ThreadPool::parallel_for(...), the task index is the chunk.
+    struct ParallelFor
+    {
+        const std::function<void(std::size_t, std::size_t, std::size_t)> &function;
+        std::size_t count;
+        std::size_t chunk_size;
+    };
+
+    void run_chunk(void *data, std::size_t chunk)
+    {
+        const ParallelFor &loop{*static_cast<const ParallelFor *>(data)};
+        std::size_t begin{chunk * loop.chunk_size};
+        loop.function(chunk, begin, std::min(begin + loop.chunk_size, loop.count));
+    }
+}
+
+/*================================TaskCounter=================================*/
+
+TaskCounter::TaskCounter()
+    : m_pending{0},
+      m_error{}
+{
+}
+
+bool TaskCounter::is_done() const
+{
+    return m_pending == 0;
+}
+
+/*==============================ThreadPool::Queue=============================*/
+
+ThreadPool::Queue::Queue()
+    : mutex{},
+      tasks(s_queue_capacity),
+      first{0},
+      count{0}
+{
+}
+
+bool ThreadPool::Queue::empty() const
+{
+    return count == 0;
+}
+
+void ThreadPool::Queue::push_back(const Task &task)
+{
+    if (count == tasks.size())
+    {
+        // Unwrap the ring into a twice as large one.
+        std::vector<Task> grown(tasks.size() * 2);
+        for (std::size_t i{0}; i < count; i++)
+        {
+            grown[i] = tasks[(first + i) % tasks.size()];
+        }
+        tasks.swap(grown);
+        first = 0;
+    }
+    tasks[(first + count) % tasks.size()] = task;
+    count++;
+}
+
+ThreadPool::Task ThreadPool::Queue::pop_back()
+{
+    count--;
+    return tasks[(first + count) % tasks.size()];
+}
+
+ThreadPool::Task ThreadPool::Queue::pop_front()
+{
+    Task task{tasks[first]};
+    first = (first + 1) % tasks.size();
+    count--;
+    return task;
+}
+
+/*=================================ThreadPool=================================*/
+
+ThreadPool::ThreadPool(unsigned int workers)
+    : m_workers{},
+      m_queues{},
+      m_mutex{},
+      m_wake{},
+      m_queued{0},
+      m_stop{false}
+{
+    if (workers == 0)
+    {
+        unsigned int hardware{std::thread::hardware_concurrency()};
+        workers = hardware > 1 ? hardware - 1 : 0;
+    }
+
+    for (unsigned int i{0}; i < workers + 1; i++)
+    {
+        m_queues.push_back(std::make_unique<Queue>());
+    }
+
+    m_workers.reserve(workers);
+    for (unsigned int i{0}; i < workers; i++)
+    {
+        m_workers.emplace_back(&ThreadPool::run, this, i + 1);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (std::thread &worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+unsigned int ThreadPool::get_thread_count() const
+{
+    return static_cast<unsigned int>(m_workers.size()) + 1;
+}
+
+void ThreadPool::submit(TaskFunction function, void *data, std::size_t index, TaskCounter &counter)
+{
+    counter.m_pending++;
+    {
+        // Counted before it is queued, so m_queued never drops below zero.
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_queued++;
+    }
+
+    Queue &queue{*m_queues[get_queue_index()]};
+    {
+        std::lock_guard<std::mutex> lock{queue.mutex};
+        queue.push_back(Task{function, data, index, &counter});
+    }
+    m_wake.notify_one();
+}
+
+void ThreadPool::wait(TaskCounter &counter)
+{
+    std::size_t index{get_queue_index()};
+    while (!counter.is_done())
+    {
+        Task task{nullptr, nullptr, 0, nullptr};
+        if (take_task(index, task))
+        {
+            execute(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock{m_mutex};
+        m_wake.wait(lock, [this, &counter]
+                    { return counter.is_done() || m_queued > 0; });
+    }
+
+    std::exception_ptr error{};
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        std::swap(error, counter.m_error);
+    }
+    if (error)
+        std::rethrow_exception(error);
+}
+
+void ThreadPool::parallel_for(
+    std::size_t count,
+    std::size_t chunk_size,
+    const std::function<void(std::size_t, std::size_t, std::size_t)> &function)
+{
+    if (count == 0)
+        return;
+
+    ParallelFor loop{function, count, std::max<std::size_t>(chunk_size, 1)};
+    TaskCounter counter{};
+    for (std::size_t chunk{0}; chunk * loop.chunk_size < count; chunk++)
+    {
+        submit(&run_chunk, &loop, chunk, counter);
+    }
+    wait(counter);
+}
+
+void ThreadPool::run(std::size_t index)
+{
+    t_pool = this;
+    t_queue_index = index;
+    while (true)
+    {
+        Task task{nullptr, nullptr, 0, nullptr};
+        if (take_task(index, task))
+        {
+            execute(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock{m_mutex};
+        m_wake.wait(lock, [this]
+                    { return m_stop || m_queued > 0; });
+        if (m_stop)
+            return;
+    }
+}
+
+std::size_t ThreadPool::get_queue_index() const
+{
+    return t_pool == this ? t_queue_index : 0;
+}
+
+bool ThreadPool::take_task(std::size_t index, Task &task)
+{
+    // Newest task from the own queue first, it is most likely still in cache.
+    {
+        Queue &queue{*m_queues[index]};
+        std::lock_guard<std::mutex> lock{queue.mutex};
+        if (!queue.empty())
+        {
+            task = queue.pop_back();
+            m_queued--;
+            return true;
+        }
+    }
+
+    // Steal the oldest task from another queue.
+    for (std::size_t i{1}; i < m_queues.size(); i++)
+    {
+        Queue &queue{*m_queues[(index + i) % m_queues.size()]};
+        std::lock_guard<std::mutex> lock{queue.mutex};
+        if (!queue.empty())
+        {
+            task = queue.pop_front();
+            m_queued--;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::execute(Task &task)
+{
+    try
+    {
+        task.function(task.data, task.index);
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        if (!task.counter->m_error)
+            task.counter->m_error = std::current_exception();
+    }
+
+    // The counter may be destroyed as soon as it reaches zero.
+    if (task.counter->m_pending.fetch_sub(1) != 1)
+        return;
+
+    {
+        // Take the lock so a waiting thread cannot miss the notification.
+        std::lock_guard<std::mutex> lock{m_mutex};
+    }
+    m_wake.notify_all();
+}
@@ -0,0 +1,251 @@
+#include "timerwheel.hpp"
+
+#include <cmath>
+#include <utility>
+
+namespace
+{
+    const unsigned int s_slot_bits{6};
+    const std::size_t s_slots{std::size_t{1} << s_slot_bits};
+    const std::size_t s_levels{4};
+    // Slot field of a node in the free list.
+    const std::int32_t s_free_slot{-2};
+}
+
+/*================================TimerWheel==================================*/
+
+TimerWheel::TimerWheel(const sf::Time &resolution)
+    : m_resolution{resolution},
+      m_carry{},
+      m_now{0},
+      m_nodes{},
+      m_free{-1},
+      m_heads(s_slots * s_levels, -1),
+      m_tails(s_slots * s_levels, -1),
+      m_pending{0}
+{
+}
+
+TimerId TimerWheel::schedule(float delay, const Callback &callback, float period)
+{
+    std::int32_t index{allocate()};
+    Node &node{m_nodes[index]};
+    node.callback = callback;
+    node.expiry = m_now + to_ticks(delay);
+    node.period = period > 0.f ? to_ticks(period) : 0;
+    link(index);
+    m_pending++;
+    return static_cast<TimerId>(node.generation) << 32 | static_cast<std::uint32_t>(index);
+}
+
+bool TimerWheel::cancel(TimerId id)
+{
+    std::int32_t index{find(id)};
+    if (index < 0)
+        return false;
+    if (m_nodes[index].slot >= 0)
+        unlink(index);
+    release(index);
+    return true;
+}
+
+bool TimerWheel::is_pending(TimerId id) const
+{
+    return find(id) >= 0;
+}
+
+float TimerWheel::get_remaining(TimerId id) const
+{
+    std::int32_t index{find(id)};
+    if (index < 0 || m_nodes[index].slot < 0)
+        return 0.f;
+    float remaining{(m_nodes[index].expiry - m_now) * m_resolution.asSeconds() - m_carry.asSeconds()};
+    return remaining > 0.f ? remaining : 0.f;
+}
+
+void TimerWheel::advance(const sf::Time &delta, Context &context)
+{
+    m_carry += delta;
+    while (m_carry >= m_resolution)
+    {
+        m_carry -= m_resolution;
+        tick(context);
+    }
+}
+
+float TimerWheel::get_time() const
+{
+    return m_now * m_resolution.asSeconds();
+}
+
+std::size_t TimerWheel::get_pending_count() const
+{
+    return m_pending;
+}
+
+void TimerWheel::tick(Context &context)
+{
+    m_now++;
+    // Every time a level wraps around, the next slot of the level above is
+    // spread out over the levels below.
+    for (std::size_t level{1}; level < s_levels; level++)
+    {
+        if ((m_now >> (s_slot_bits * (level - 1))) % s_slots != 0)
+            break;
+        cascade(level * s_slots + (m_now >> (s_slot_bits * level)) % s_slots);
+    }
+
+    std::size_t slot{m_now % s_slots};
+    while (m_heads[slot] != -1)
+    {
+        std::int32_t index{m_heads[slot]};
+        unlink(index);
+        std::uint32_t generation{m_nodes[index].generation};
+        // The callback may schedule timers, which may move the nodes.
+        Callback callback{std::move(m_nodes[index].callback)};
+        callback(context);
+
+        Node &node{m_nodes[index]};
+        // Cancelled by the callback.
+        if (node.generation != generation)
+            continue;
+        if (node.period > 0)
+        {
+            node.callback = std::move(callback);
+            node.expiry += node.period;
+            link(index);
+        }
+        else
+        {
+            release(index);
+        }
+    }
+}
+
+void TimerWheel::cascade(std::size_t slot)
+{
+    std::int32_t index{m_heads[slot]};
+    m_heads[slot] = -1;
+    m_tails[slot] = -1;
+    while (index != -1)
+    {
+        std::int32_t next{m_nodes[index].next};
+        link(index);
+        index = next;
+    }
+}
+
+std::int32_t TimerWheel::allocate()
+{
+    if (m_free == -1)
+    {
+        m_nodes.push_back(Node{Callback{}, 0, 0, 1, -1, -1, s_free_slot});
+        return static_cast<std::int32_t>(m_nodes.size() - 1);
+    }
+    std::int32_t index{m_free};
+    m_free = m_nodes[index].next;
+    return index;
+}
+
+void TimerWheel::link(std::int32_t index)
+{
+    Node &node{m_nodes[index]};
+    std::uint64_t diff{node.expiry > m_now ? node.expiry - m_now : 0};
+    std::size_t level{0};
+    while (level + 1 < s_levels && diff >= std::uint64_t{1} << (s_slot_bits * (level + 1)))
+        level++;
+    std::size_t slot{level * s_slots + (node.expiry >> (s_slot_bits * level)) % s_slots};
+
+    node.slot = static_cast<std::int32_t>(slot);
+    node.prev = m_tails[slot];
+    node.next = -1;
+    if (m_tails[slot] == -1)
+        m_heads[slot] = index;
+    else
+        m_nodes[m_tails[slot]].next = index;
+    m_tails[slot] = index;
+}
+
+void TimerWheel::unlink(std::int32_t index)
+{
+    Node &node{m_nodes[index]};
+    std::size_t slot{static_cast<std::size_t>(node.slot)};
+    if (node.prev == -1)
+        m_heads[slot] = node.next;
+    else
+        m_nodes[node.prev].next = node.next;
+    if (node.next == -1)
+        m_tails[slot] = node.prev;
+    else
+        m_nodes[node.next].prev = node.prev;
+    node.slot = -1;
+    node.prev = -1;
+    node.next = -1;
+}
+
+void TimerWheel::release(std::int32_t index)
+{
+    Node &node{m_nodes[index]};
+    node.callback = nullptr;
+    node.generation++;
+    node.slot = s_free_slot;
+    node.next = m_free;
+    m_free = index;
+    m_pending--;
+}
+
+std::int32_t TimerWheel::find(TimerId id) const
+{
+    std::uint32_t index{static_cast<std::uint32_t>(id)};
+    std::uint32_t generation{static_cast<std::uint32_t>(id >> 32)};
+    if (index >= m_nodes.size())
+        return -1;
+    const Node &node{m_nodes[index]};
+    if (node.generation != generation || node.slot == s_free_slot)
+        return -1;
+    return static_cast<std::int32_t>(index);
+}
+
+std::uint64_t TimerWheel::to_ticks(float seconds) const
+{
+    long long ticks{std::llround(seconds / m_resolution.asSeconds())};
+    return ticks > 1 ? static_cast<std::uint64_t>(ticks) : 1;
+}
+
+/*===================================Timer====================================*/
+
+Timer::Timer()
+    : m_wheel{nullptr},
+      m_id{0}
+{
+}
+
+Timer::~Timer()
+{
+    stop();
+}
+
+void Timer::start(TimerWheel &wheel, float delay, const TimerWheel::Callback &callback, float period)
+{
+    stop();
+    m_wheel = &wheel;
+    m_id = wheel.schedule(delay, callback, period);
+}
+
+void Timer::stop()
+{
+    if (m_wheel != nullptr)
+        m_wheel->cancel(m_id);
+    m_wheel = nullptr;
+    m_id = 0;
+}
+
+bool Timer::is_running() const
+{
+    return m_wheel != nullptr && m_wheel->is_pending(m_id);
+}
+
+float Timer::get_remaining() const
+{
+    return m_wheel != nullptr ? m_wheel->get_remaining(m_id) : 0.f;
+}
@@ -68,9 +68,9 @@ Button::Button(
     m_hover_sound.setVolume(volume);
 }
 
-void Button::render(sf::RenderWindow &window) const
+void Button::render(RenderSnapshot &snapshot) const
 {
-    window.draw(m_button_sprite);
+    snapshot.draw(m_button_sprite);
 }
 
 void Button::update(Context &context)
@@ -206,10 +206,17 @@ RectangleBar<T>::RectangleBar(
 }
 
 template <typename T>
-void RectangleBar<T>::render(sf::RenderWindow &window) const
+void RectangleBar<T>::render(RenderSnapshot &snapshot) const
 {
-    window.draw(m_background);
-    window.draw(m_bar);
+    snapshot.draw(m_background);
+    snapshot.draw(m_bar);
+}
+
+template <typename T>
+void RectangleBar<T>::render_batched(RenderBatch &batch, unsigned int layer) const
+{
+    batch.add_rectangle(m_background, layer);
+    batch.add_rectangle(m_bar, layer);
 }
 
 template <typename T>
@@ -0,0 +1,285 @@
+#include "wavetimeline.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <initializer_list>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+    const char s_magic[4]{'W', 'A', 'V', 'E'};
+    const std::uint32_t s_version{1};
+    // time, type, difficulty, count, index, position and step.
+    const std::size_t s_record_size{4 + 1 + 1 + 2 + 4 + 4 * 4};
+    // Same order as the types of PowerUp::create(...).
+    const std::array<const char *, 7> s_powerup_names{"repair", "speed", "buckshot", "doubleshoot",
+                                                      "boost", "score", "nuke"};
+
+    void write_u32(std::ostream &out, std::uint32_t value)
+    {
+        unsigned char bytes[4]{static_cast<unsigned char>(value), static_cast<unsigned char>(value >> 8),
+                               static_cast<unsigned char>(value >> 16), static_cast<unsigned char>(value >> 24)};
+        out.write(reinterpret_cast<const char *>(bytes), 4);
+    }
+
+    std::uint32_t read_u32(const unsigned char *bytes)
+    {
+        return static_cast<std::uint32_t>(bytes[0]) | static_cast<std::uint32_t>(bytes[1]) << 8 |
+               static_cast<std::uint32_t>(bytes[2]) << 16 | static_cast<std::uint32_t>(bytes[3]) << 24;
+    }
+
+    std::uint32_t read_u32(std::istream &in)
+    {
+        unsigned char bytes[4]{};
+        if (!in.read(reinterpret_cast<char *>(bytes), 4))
+            throw std::logic_error("WaveCursorERROR: timeline ends early.");
+        return read_u32(bytes);
+    }
+
+    void put_u32(unsigned char *bytes, std::uint32_t value)
+    {
+        for (int i{0}; i < 4; i++)
+            bytes[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+
+    void put_float(unsigned char *bytes, float value)
+    {
+        std::uint32_t bits{};
+        std::memcpy(&bits, &value, sizeof(bits));
+        put_u32(bytes, bits);
+    }
+
+    float get_float(const unsigned char *bytes)
+    {
+        std::uint32_t bits{read_u32(bytes)};
+        float value{};
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    /**
+     * @brief Read comma separated floats, throwing if there are fewer.
+     */
+    void read_floats(std::stringstream &ss, const std::string &key, std::initializer_list<float *> values)
+    {
+        char separator{','};
+        for (float *value : values)
+        {
+            if (separator != ',' || !(ss >> *value))
+                throw std::logic_error(key + " value is missing a valid float.");
+            ss >> separator;
+        }
+    }
+}
+
+/*===============================WaveTimeline=================================*/
+
+std::size_t WaveTimeline::compile(std::istream &text, std::ostream &binary)
+{
+    std::vector<WaveEvent> events{};
+    std::vector<std::string> names{};
+    std::string line{}, key{}, value{};
+    while (std::getline(text, line))
+    {
+        if (line.rfind("//", 0) == 0 || line.empty())
+            continue;
+        std::stringstream ss{line};
+        std::getline(ss, key, '=');
+        std::getline(ss, value, ';');
+        std::stringstream vs{value};
+        WaveEvent event{};
+        char separator{};
+        if (key == "FORMATION")
+        {
+            std::string name{};
+            event.type = WaveEventType::Formation;
+            if (!(vs >> event.time >> separator) || separator != ',' || !std::getline(vs, name, ',') ||
+                !(vs >> event.difficulty >> separator >> event.count >> separator) || separator != ',')
+            {
+                throw std::logic_error("FORMATION value is not time,archetype,difficulty,count,x,y,step x,step y.");
+            }
+            if (event.count > 0xFFFF)
+                throw std::logic_error("FORMATION count is above 65535.");
+            read_floats(vs, key, {&event.position.x, &event.position.y, &event.step.x, &event.step.y});
+            auto it = std::find(names.begin(), names.end(), name);
+            event.index = static_cast<std::uint32_t>(it - names.begin());
+            if (it == names.end())
+                names.push_back(name);
+        }
+        else if (key == "POWERUP")
+        {
+            std::string name{};
+            event.type = WaveEventType::PowerUp;
+            event.count = 1;
+            if (!(vs >> event.time >> separator) || separator != ',' || !std::getline(vs, name, ','))
+                throw std::logic_error("POWERUP value is not time,type,x,y.");
+            event.index = find_powerup(name);
+            read_floats(vs, key, {&event.position.x, &event.position.y});
+        }
+        else if (key == "BOSS")
+        {
+            event.type = WaveEventType::Boss;
+            if (!(vs >> event.time))
+                throw std::logic_error("BOSS value is not a valid float.");
+        }
+        else
+        {
+            continue;
+        }
+        if (event.time < 0.f)
+            throw std::logic_error(key + " time is negative.");
+        events.push_back(event);
+    }
+    // Events at the same time keep the order they were written in.
+    std::stable_sort(events.begin(), events.end(), [](const WaveEvent &a, const WaveEvent &b)
+                     { return a.time < b.time; });
+
+    binary.write(s_magic, sizeof(s_magic));
+    write_u32(binary, s_version);
+    write_u32(binary, static_cast<std::uint32_t>(names.size()));
+    for (const std::string &name : names)
+    {
+        write_u32(binary, static_cast<std::uint32_t>(name.size()));
+        binary.write(name.data(), static_cast<std::streamsize>(name.size()));
+    }
+    write_u32(binary, static_cast<std::uint32_t>(events.size()));
+    for (const WaveEvent &event : events)
+    {
+        unsigned char record[s_record_size]{};
+        put_float(record, event.time);
+        record[4] = static_cast<unsigned char>(event.type);
+        record[5] = static_cast<unsigned char>(std::clamp(event.difficulty, 0, 255));
+        record[6] = static_cast<unsigned char>(event.count);
+        record[7] = static_cast<unsigned char>(event.count >> 8);
+        put_u32(record + 8, event.index);
+        put_float(record + 12, event.position.x);
+        put_float(record + 16, event.position.y);
+        put_float(record + 20, event.step.x);
+        put_float(record + 24, event.step.y);
+        binary.write(reinterpret_cast<const char *>(record), s_record_size);
+    }
+    if (!binary)
+        throw std::logic_error("WaveTimelineERROR: could not write timeline.");
+    return events.size();
+}
+
+std::size_t WaveTimeline::compile(const std::string &text_path, const std::string &binary_path)
+{
+    std::ifstream text{text_path};
+    if (!text.is_open())
+        throw std::logic_error("WaveTimelineERROR: could not open " + text_path + ".");
+    std::ofstream binary{binary_path, std::ios::binary};
+    if (!binary.is_open())
+        throw std::logic_error("WaveTimelineERROR: could not open " + binary_path + ".");
+    return compile(text, binary);
+}
+
+std::uint32_t WaveTimeline::find_powerup(const std::string &name)
+{
+    for (std::size_t i{0}; i < s_powerup_names.size(); i++)
+    {
+        if (name == s_powerup_names[i])
+            return static_cast<std::uint32_t>(i);
+    }
+    throw std::logic_error("WaveTimelineERROR: no power-up named " + name + ".");
+}
+
+/*================================WaveCursor==================================*/
+
+const std::size_t WaveCursor::s_chunk_size{64};
+
+WaveCursor::WaveCursor(const std::string &path)
+    : WaveCursor{std::unique_ptr<std::istream>{new std::ifstream{path, std::ios::binary}}}
+{
+}
+
+WaveCursor::WaveCursor(std::unique_ptr<std::istream> stream)
+    : m_stream{std::move(stream)},
+      m_names{},
+      m_event_count{0},
+      m_events_read{0},
+      m_chunk{},
+      m_next{0}
+{
+    if (!m_stream || !*m_stream)
+        throw std::logic_error("WaveCursorERROR: could not open timeline.");
+    m_chunk.reserve(s_chunk_size);
+    read_header();
+}
+
+bool WaveCursor::poll(float time, WaveEvent &event)
+{
+    if (m_next == m_chunk.size())
+    {
+        if (m_events_read == m_event_count)
+            return false;
+        read_chunk();
+    }
+    if (m_chunk[m_next].time > time)
+        return false;
+    event = m_chunk[m_next++];
+    return true;
+}
+
+bool WaveCursor::is_done() const
+{
+    return m_next == m_chunk.size() && m_events_read == m_event_count;
+}
+
+const std::vector<std::string> &WaveCursor::get_names() const
+{
+    return m_names;
+}
+
+std::size_t WaveCursor::get_event_count() const
+{
+    return m_event_count;
+}
+
+void WaveCursor::read_header()
+{
+    char magic[sizeof(s_magic)]{};
+    if (!m_stream->read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), s_magic))
+        throw std::logic_error("WaveCursorERROR: not a compiled timeline.");
+    if (read_u32(*m_stream) != s_version)
+        throw std::logic_error("WaveCursorERROR: unsupported timeline version.");
+    std::uint32_t name_count{read_u32(*m_stream)};
+    for (std::uint32_t i{0}; i < name_count; i++)
+    {
+        std::string name(read_u32(*m_stream), '\0');
+        if (!m_stream->read(&name[0], static_cast<std::streamsize>(name.size())))
+            throw std::logic_error("WaveCursorERROR: timeline ends early.");
+        m_names.push_back(name);
+    }
+    m_event_count = read_u32(*m_stream);
+}
+
+void WaveCursor::read_chunk()
+{
+    std::size_t count{std::min(s_chunk_size, m_event_count - m_events_read)};
+    m_chunk.clear();
+    for (std::size_t i{0}; i < count; i++)
+    {
+        unsigned char record[s_record_size]{};
+        if (!m_stream->read(reinterpret_cast<char *>(record), s_record_size))
+            throw std::logic_error("WaveCursorERROR: timeline ends early.");
+        WaveEvent event{};
+        event.time = get_float(record);
+        if (record[4] > static_cast<unsigned char>(WaveEventType::Boss))
+            throw std::logic_error("WaveCursorERROR: unknown event type.");
+        event.type = static_cast<WaveEventType>(record[4]);
+        event.difficulty = record[5];
+        event.count = static_cast<unsigned int>(record[6]) | static_cast<unsigned int>(record[7]) << 8;
+        event.index = read_u32(record + 8);
+        if (event.type == WaveEventType::Formation && event.index >= m_names.size())
+            throw std::logic_error("WaveCursorERROR: unknown archetype.");
+        event.position = sf::Vector2f{get_float(record + 12), get_float(record + 16)};
+        event.step = sf::Vector2f{get_float(record + 20), get_float(record + 24)};
+        m_chunk.push_back(event);
+    }
+    m_events_read += count;
+    m_next = 0;
+}
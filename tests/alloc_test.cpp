@@ -0,0 +1,182 @@
+#include "context.hpp"
+#include "framearena.hpp"
+#include "gameobject.hpp"
+#include "player.hpp"
+#include "renderbatch.hpp"
+#include "rendersnapshot.hpp"
+#include "resourcemanager.hpp"
+#include "threadpool.hpp"
+#include "gamemodetest.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include <catch.hpp>
+#include <SFML/Graphics.hpp>
+
+// These tests count every heap allocation by replacing the global operator
+// new, so they are built as their own executable with 'make alloctest' and do
+// not change how the other tests allocate.
+
+namespace
+{
+    // Heap allocations made through operator new by any test.
+    std::atomic<std::size_t> s_allocations{0};
+}
+
+void *operator new(std::size_t size)
+{
+    s_allocations++;
+    if (void *memory = std::malloc(size == 0 ? 1 : size))
+        return memory;
+    throw std::bad_alloc{};
+}
+
+// Not inlined, so the compiler does not see free(...) on memory from new.
+[[gnu::noinline]] void operator delete(void *memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept
+{
+    ::operator delete(memory);
+}
+
+/**
+ * @brief GameMode formatting its HUD in the frame arena and drawing it with
+ * render_texts(...), as the game modes do.
+ */
+class ArenaTestMode : public GameModeTest
+{
+public:
+    ArenaTestMode(const std::vector<GameObject *> &objects, Player *player)
+        : GameModeTest{objects, player},
+          m_health_text{}
+    {
+        m_health_text.setFont(ResourceManager::load_font("assets/font/Aquire.otf"));
+    }
+
+    virtual ~ArenaTestMode() = default;
+
+    void render(RenderSnapshot &snapshot) const override
+    {
+        GameMode::render(snapshot);
+        render_texts(snapshot);
+    }
+
+    const sf::Text &get_health_text() const
+    {
+        return m_health_text;
+    }
+
+private:
+    sf::Text m_health_text;
+
+    void render_texts(RenderSnapshot &snapshot) const
+    {
+        snapshot.draw(m_health_text);
+    }
+
+    void update_texts(const HudData &hud, FrameArena &arena) override
+    {
+        FrameString string{arena};
+        append_format(string, "Health - %d, score %d", hud.health, hud.score);
+        GameMode::set_text(m_health_text, string);
+    }
+};
+
+/**
+ * @brief GameObject that spawns a projectile every update, far away from
+ * everything else, and draws a rectangle.
+ */
+class ArenaTestObject : public GameObject
+{
+public:
+    /**
+     * @param batched draw the rectangle through a render batch, instead of
+     * on its own.
+     */
+    ArenaTestObject(bool batched)
+        : GameObject{},
+          m_rectangle{sf::Vector2f{10.f, 10.f}},
+          m_batched{batched}
+    {
+    }
+
+    virtual ~ArenaTestObject() = default;
+
+    virtual void update(Context &context) override
+    {
+        context.spawn_projectile(-1e6f, -1e6f, 0.f, 0.f, false);
+    }
+
+    virtual void render(RenderSnapshot &snapshot) const override
+    {
+        snapshot.draw(m_rectangle);
+    }
+
+    virtual bool render_batched(RenderBatch &batch) const override
+    {
+        if (m_batched)
+            batch.add_rectangle(m_rectangle, 1);
+        return m_batched;
+    }
+
+    virtual bool handle(const sf::Event &, Context &) override
+    {
+        return false;
+    }
+
+    virtual sf::FloatRect bounds() const override
+    {
+        return sf::FloatRect{-1e6f, -1e6f, 1.f, 1.f};
+    }
+
+    virtual void collision(const GameObject *) override
+    {
+        return;
+    }
+
+private:
+    sf::RectangleShape m_rectangle;
+    bool m_batched;
+};
+
+TEST_CASE("Steady state frames")
+{
+    sf::RenderWindow window{};
+    PlayerData data{};
+    data.health = 3;
+    Player *player{new Player{data, 0.f, 0.f}};
+    std::vector<GameObject *> objects{player};
+    // Enough objects for the parallel update and render list.
+    for (int i{0}; i < 300; i++)
+        objects.push_back(new ArenaTestObject{i % 2 == 0});
+    ArenaTestMode gm{objects, player};
+
+    // The first frames size the buffers, after that a frame allocates nothing,
+    // neither updating on the pool nor building the snapshot. The score
+    // changes every frame, so the HUD text is set and drawn anew each time.
+    ThreadPool pool{3};
+    Context context{sf::seconds(0.01f), window};
+    context.set_thread_pool(&pool);
+    RenderSnapshot snapshot{};
+    auto play_frame = [&]()
+    {
+        player->kills(1, false);
+        gm.update(context);
+        snapshot.reset(window.getSize(), window.getView());
+        gm.render(snapshot);
+        context.end_frame();
+    };
+    for (int frame{0}; frame < 10; frame++)
+        play_frame();
+    std::size_t allocations{s_allocations};
+    for (int frame{0}; frame < 20; frame++)
+        play_frame();
+    CHECK(s_allocations - allocations == 0);
+    CHECK(gm.get_health_text().getString().toAnsiString() == "Health - 3, score 30");
+    CHECK(snapshot.get_draw_count() > 2);
+}
@@ -0,0 +1,96 @@
+#include "framearena.hpp"
+#include "context.hpp"
+#include "eventbus.hpp"
+#include "gameconfiguration.hpp"
+#include "player.hpp"
+#include "shockwave.hpp"
+#include "spatialgrid.hpp"
+
+#include <cstdint>
+#include <vector>
+
+#include <catch.hpp>
+#include <SFML/Graphics.hpp>
+
+TEST_CASE("FrameArena")
+{
+    FrameArena arena{64};
+    CHECK(arena.get_block_count() == 0);
+
+    // Allocations are aligned and do not overlap.
+    char *a{static_cast<char *>(arena.allocate(3, 1))};
+    double *b{static_cast<double *>(arena.allocate(sizeof(double), alignof(double)))};
+    CHECK(reinterpret_cast<std::uintptr_t>(b) % alignof(double) == 0);
+    CHECK(reinterpret_cast<char *>(b) >= a + 3);
+    CHECK(arena.get_used() == 3 + sizeof(double));
+    CHECK(arena.get_block_count() == 1);
+
+    // A frame that does not fit adds blocks, the next reset merges them.
+    arena.allocate(60, 1);
+    arena.allocate(100, 1);
+    CHECK(arena.get_block_count() == 3);
+    std::size_t capacity{arena.get_capacity()};
+    arena.reset();
+    CHECK(arena.get_used() == 0);
+    CHECK(arena.get_block_count() == 1);
+    CHECK(arena.get_capacity() == capacity);
+    arena.allocate(3, 1);
+    arena.allocate(60, 1);
+    arena.allocate(100, 1);
+    CHECK(arena.get_block_count() == 1);
+    arena.reset();
+
+    // Containers live in the arena.
+    FrameVector<int> numbers{arena};
+    for (int i{0}; i < 20; i++)
+        numbers.push_back(i);
+    CHECK(numbers[19] == 19);
+    CHECK(arena.get_used() >= 20 * sizeof(int));
+    FrameString string{arena};
+    append_format(string, "Health - %d", 3);
+    append_format(string, "\n%s x%u", "Shield", 2u);
+    CHECK(string == "Health - 3\nShield x2");
+}
+
+TEST_CASE("Context reuse")
+{
+    sf::RenderWindow window{};
+    Context context{sf::seconds(0.1f), window};
+    std::vector<GameObject *> objects{};
+
+    // The queue and the caller's vector trade memory instead of allocating.
+    context.spawn_object(new Shockwave{0.f, 0.f, true, 1});
+    context.get_new_objects(objects);
+    REQUIRE(objects.size() == 1);
+    delete objects.front();
+    objects.clear();
+    context.spawn_object(new Shockwave{0.f, 0.f, true, 1});
+    context.get_new_objects(objects);
+    REQUIRE(objects.size() == 1);
+    delete objects.front();
+    objects.clear();
+
+    // A new frame starts without a next state and with an empty arena.
+    context.set_next_state(nullptr);
+    context.get_frame_arena().allocate(16, 8);
+    context.end_frame();
+    CHECK(context.get_next_state() == nullptr);
+    CHECK(context.get_frame_arena().get_used() == 0);
+
+    // The grid and the bus of the last state are let go, the state may be
+    // deleted before the next frame.
+    PlayerData data{};
+    data.health = 3;
+    Player player{data, 0.f, 0.f};
+    player.refresh_bounds();
+    SpatialGrid grid{};
+    grid.build({&player});
+    EventBus bus{};
+    context.set_spatial_grid(&grid);
+    context.set_event_bus(&bus);
+    CHECK(context.find_nearest(sf::Vector2f{}, CollisionLayer::All) == &player);
+    context.end_frame();
+    CHECK(context.find_nearest(sf::Vector2f{}, CollisionLayer::All) == nullptr);
+    context.publish(EnemyKilled{sf::Vector2f{}, 100});
+    CHECK(bus.get_size() == 0);
+}
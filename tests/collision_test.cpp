@@ -0,0 +1,643 @@
+#include "aabbarray.hpp"
+#include "cellgrid.hpp"
+#include "collisionmask.hpp"
+#include "contactcache.hpp"
+#include "gameobject.hpp"
+#include "narrowphase.hpp"
+#include "profiler.hpp"
+#include "spatialgrid.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <catch.hpp>
+#include <SFML/Graphics.hpp>
+
+/**
+ * @brief GameObject with fixed bounds, used to compare against the
+ * GameObject::collides(...) path.
+ */
+class BoxTestObject : public GameObject
+{
+public:
+    BoxTestObject(const sf::FloatRect &bounds) : m_bounds{bounds} {};
+    virtual ~BoxTestObject() = default;
+
+    virtual void update(Context &) override
+    {
+        return;
+    }
+
+    virtual void render(RenderSnapshot &) const override
+    {
+        return;
+    }
+
+    virtual bool handle(const sf::Event &, Context &) override
+    {
+        return false;
+    }
+
+    virtual sf::FloatRect bounds() const override
+    {
+        return m_bounds;
+    }
+
+    virtual void collision(const GameObject *) override
+    {
+        return;
+    }
+
+private:
+    sf::FloatRect m_bounds;
+};
+
+/**
+ * @brief GameObject whose bounds follow a rectangle. Counts calls to bounds().
+ */
+class MovingTestObject : public BoxTestObject
+{
+public:
+    MovingTestObject(bool has_transform)
+        : BoxTestObject{sf::FloatRect{}},
+          m_rectangle{sf::Vector2f{10.f, 10.f}},
+          m_has_transform{has_transform},
+          m_bounds_calls{0}
+    {
+    }
+
+    virtual sf::FloatRect bounds() const override
+    {
+        m_bounds_calls++;
+        return m_rectangle.getGlobalBounds();
+    }
+
+    void move(float x, float y)
+    {
+        m_rectangle.move(x, y);
+    }
+
+    void resize(float size)
+    {
+        m_rectangle.setSize(sf::Vector2f{size, size});
+        mark_bounds_dirty();
+    }
+
+    int get_bounds_calls() const { return m_bounds_calls; }
+
+protected:
+    virtual const sf::Transformable *get_transform() const override
+    {
+        return m_has_transform ? &m_rectangle : nullptr;
+    }
+
+private:
+    sf::RectangleShape m_rectangle;
+    bool m_has_transform;
+    mutable int m_bounds_calls;
+};
+
+/**
+ * @brief MovingTestObject made of two boxes with a gap between them.
+ */
+class CompoundTestObject : public MovingTestObject
+{
+public:
+    CompoundTestObject()
+        : MovingTestObject{true}
+    {
+        set_sub_colliders({{0.f, 0.f, 10.f, 10.f}, {20.f, 0.f, 10.f, 10.f}});
+    }
+};
+
+/**
+ * @brief BoxTestObject in a collision layer.
+ */
+class LayeredTestObject : public BoxTestObject
+{
+public:
+    LayeredTestObject(const sf::FloatRect &bounds, CollisionLayer layer)
+        : BoxTestObject{bounds},
+          m_layer{layer}
+    {
+    }
+
+    virtual CollisionLayer get_layer() const override
+    {
+        return m_layer;
+    }
+
+private:
+    CollisionLayer m_layer;
+};
+
+/**
+ * @brief Squared distance from a point to a box, 0 inside the box.
+ */
+float get_distance2(const sf::FloatRect &box, const sf::Vector2f &point)
+{
+    float min_x{std::min(box.left, box.left + box.width)};
+    float max_x{std::max(box.left, box.left + box.width)};
+    float min_y{std::min(box.top, box.top + box.height)};
+    float max_y{std::max(box.top, box.top + box.height)};
+    float dx{std::max({min_x - point.x, 0.f, point.x - max_x})};
+    float dy{std::max({min_y - point.y, 0.f, point.y - max_y})};
+    return dx * dx + dy * dy;
+}
+
+/**
+ * @brief Distance along a ray to a box, negative if the ray misses it.
+ */
+float get_ray_distance(const sf::FloatRect &box, const sf::Vector2f &origin,
+                       const sf::Vector2f &unit, float max_distance)
+{
+    float t_min{0.f};
+    float t_max{max_distance};
+    float origins[2]{origin.x, origin.y};
+    float directions[2]{unit.x, unit.y};
+    float mins[2]{std::min(box.left, box.left + box.width), std::min(box.top, box.top + box.height)};
+    float maxs[2]{std::max(box.left, box.left + box.width), std::max(box.top, box.top + box.height)};
+    for (int axis{0}; axis < 2; axis++)
+    {
+        if (directions[axis] == 0.f)
+        {
+            if (!(mins[axis] < origins[axis] && origins[axis] < maxs[axis]))
+                return -1.f;
+            continue;
+        }
+        float first{(mins[axis] - origins[axis]) / directions[axis]};
+        float second{(maxs[axis] - origins[axis]) / directions[axis]};
+        t_min = std::max(t_min, std::min(first, second));
+        t_max = std::min(t_max, std::max(first, second));
+    }
+    return t_min < t_max ? t_min : -1.f;
+}
+
+/**
+ * @brief Create boxes on a grid of whole numbers, so that many boxes touch,
+ * and some boxes that are flipped or empty.
+ */
+std::vector<sf::FloatRect> create_boxes(std::size_t count, float area)
+{
+    std::minstd_rand rng{1234};
+    std::uniform_int_distribution<int> position{0, static_cast<int>(area)};
+    std::uniform_int_distribution<int> size{-2, 12};
+    std::vector<sf::FloatRect> boxes{};
+    for (std::size_t i{0}; i < count; i++)
+    {
+        boxes.emplace_back(static_cast<float>(position(rng)), static_cast<float>(position(rng)),
+                           static_cast<float>(size(rng)), static_cast<float>(size(rng)));
+    }
+    return boxes;
+}
+
+TEST_CASE("AabbArray gives same result as sf::FloatRect::intersects")
+{
+    std::vector<sf::FloatRect> boxes{create_boxes(203, 60.f)};
+    AabbArray array{};
+    array.resize(boxes.size());
+    for (std::size_t i{0}; i < boxes.size(); i++)
+    {
+        array.set(i, boxes[i]);
+    }
+    REQUIRE(array.get_size() == boxes.size());
+
+    std::size_t total{0};
+    std::size_t mismatches{0};
+    for (std::size_t i{0}; i < boxes.size(); i++)
+    {
+        std::vector<std::size_t> expected{};
+        for (std::size_t j{i + 1}; j < boxes.size(); j++)
+        {
+            if (boxes[i].intersects(boxes[j]))
+                expected.push_back(j);
+            if (array.overlaps(i, j) != boxes[i].intersects(boxes[j]))
+                mismatches++;
+        }
+
+        std::vector<std::size_t> simd{};
+        std::vector<std::size_t> scalar{};
+        array.find_overlaps(i, i + 1, boxes.size(), simd);
+        array.find_overlaps_scalar(i, i + 1, boxes.size(), scalar);
+        CHECK(simd == expected);
+        CHECK(scalar == expected);
+        total += expected.size();
+    }
+    CHECK(mismatches == 0);
+    // Make sure the boxes actually overlap sometimes.
+    CHECK(total > 100);
+}
+
+TEST_CASE("Cached bounds")
+{
+    MovingTestObject object{true};
+    CHECK(object.refresh_bounds()); // New objects are dirty.
+    CHECK_FALSE(object.refresh_bounds());
+    CHECK(object.get_bounds_calls() == 1);
+    CHECK(object.get_cached_bounds() == sf::FloatRect{0.f, 0.f, 10.f, 10.f});
+
+    // Moving the transform makes the bounds dirty.
+    object.move(5.f, 0.f);
+    CHECK(object.refresh_bounds());
+    CHECK(object.get_cached_bounds() == sf::FloatRect{5.f, 0.f, 10.f, 10.f});
+
+    // Changes that keep the transform must mark the bounds dirty.
+    object.resize(20.f);
+    CHECK(object.refresh_bounds());
+    CHECK(object.get_cached_bounds() == sf::FloatRect{5.f, 0.f, 20.f, 20.f});
+    CHECK_FALSE(object.refresh_bounds());
+    CHECK(object.get_bounds_calls() == 3);
+
+    // Without a transform the bounds are recomputed every time.
+    MovingTestObject other{false};
+    CHECK(other.refresh_bounds());
+    CHECK(other.refresh_bounds());
+    CHECK(other.get_bounds_calls() == 2);
+}
+
+TEST_CASE("ContactCache")
+{
+    BoxTestObject a{sf::FloatRect{}}, b{sf::FloatRect{}}, c{sf::FloatRect{}};
+    ContactCache cache{};
+    std::vector<ContactEvent> events{};
+    auto types = [&events]()
+    {
+        std::vector<ContactEvent::Type> result{};
+        for (const ContactEvent &event : events)
+            result.push_back(event.type);
+        events.clear();
+        return result;
+    };
+    using Type = ContactEvent::Type;
+
+    cache.update({{&a, &b}, {&a, &c}}, events);
+    CHECK(types() == std::vector<Type>{Type::Enter, Type::Enter});
+    CHECK(cache.get_contact_count() == 2);
+
+    // Pair order may change between frames, the contact stays the same.
+    cache.update({{&c, &a}, {&b, &c}}, events);
+    REQUIRE(events.size() == 3);
+    CHECK(events[0].first == &c);
+    CHECK(events[2].first == &a);
+    CHECK(events[2].second == &b);
+    CHECK(types() == std::vector<Type>{Type::Stay, Type::Enter, Type::Exit});
+    CHECK(cache.has_contact(&a, &c));
+    CHECK_FALSE(cache.has_contact(&a, &b));
+
+    // Contacts with removed objects end before the objects are deleted.
+    c.remove();
+    cache.remove_removed_objects(events);
+    CHECK(types() == std::vector<Type>{Type::Exit, Type::Exit});
+    CHECK(cache.get_contact_count() == 0);
+
+    cache.update({{&a, &b}}, events);
+    cache.forget(&b);
+    CHECK(cache.get_contact_count() == 0);
+    cache.update({}, events);
+    CHECK(types() == std::vector<Type>{Type::Enter});
+}
+
+/**
+ * @brief Create an image with a transparent margin around an opaque square.
+ */
+sf::Image create_framed_image(unsigned size, unsigned margin)
+{
+    sf::Image image{};
+    image.create(size, size, sf::Color::Transparent);
+    for (unsigned y{margin}; y < size - margin; y++)
+    {
+        for (unsigned x{margin}; x < size - margin; x++)
+        {
+            image.setPixel(x, y, sf::Color::White);
+        }
+    }
+    return image;
+}
+
+/**
+ * @brief Create a shape like a sprite with its origin in the centre.
+ */
+CollisionShape create_shape(const CollisionMask *mask, float size, float x, float y, float rotation)
+{
+    sf::Transformable transformable{};
+    transformable.setOrigin(size / 2.f, size / 2.f);
+    transformable.setPosition(x, y);
+    transformable.setRotation(rotation);
+    return CollisionShape{Narrowphase::get_transform(transformable),
+                          sf::FloatRect{0.f, 0.f, size, size}, mask, sf::Vector2i{}};
+}
+
+TEST_CASE("CollisionMask")
+{
+    sf::Image image{};
+    image.create(70, 2, sf::Color::Transparent);
+    image.setPixel(0, 0, sf::Color::White);
+    image.setPixel(63, 0, sf::Color::White);
+    image.setPixel(64, 0, sf::Color::White);
+    image.setPixel(69, 1, sf::Color{255, 255, 255, 127});
+    CollisionMask mask{image};
+
+    CHECK(mask.get_width() == 70);
+    CHECK(mask.get_count() == 3);
+    CHECK(mask.get(63, 0));
+    CHECK_FALSE(mask.get(69, 1)); // Below the alpha threshold.
+    CHECK_FALSE(mask.get(-1, 0));
+    CHECK(mask.get_row_bits(0, 0) == (1u | (std::uint64_t{1} << 63)));
+    // Rows may start anywhere, also across words and outside the mask.
+    CHECK(mask.get_row_bits(63, 0) == 3u);
+    CHECK(mask.get_row_bits(-2, 0) == 4u);
+    CHECK(mask.get_row_bits(65, 0) == 0u);
+    CHECK(mask.get_row_bits(0, 2) == 0u);
+}
+
+TEST_CASE("Narrowphase")
+{
+    // 100 x 100 images, opaque 50 x 50 in the middle.
+    CollisionMask mask{create_framed_image(100, 25)};
+    REQUIRE(mask.get_count() == 50 * 50);
+
+    SECTION("Oriented boxes")
+    {
+        // Diagonal square, its bounding box overlaps the corner of the other.
+        CollisionShape box{Narrowphase::make_box(sf::FloatRect{0.f, 0.f, 10.f, 10.f})};
+        CollisionShape diamond{create_shape(nullptr, 10.f, 16.f, 16.f, 45.f)};
+        CHECK(box.transform.transformRect(box.rect).intersects(
+            diamond.transform.transformRect(diamond.rect)));
+        CHECK_FALSE(Narrowphase::overlaps(box, diamond));
+        diamond = create_shape(nullptr, 10.f, 15.f, 5.f, 45.f);
+        CHECK(Narrowphase::overlaps(box, diamond));
+        // Touching boxes do not overlap.
+        CHECK_FALSE(Narrowphase::overlaps(box, Narrowphase::make_box(sf::FloatRect{10.f, 0.f, 5.f, 5.f})));
+    }
+
+    SECTION("Moved masks")
+    {
+        // Only the transparent margins overlap.
+        CollisionShape first{create_shape(&mask, 100.f, 0.f, 0.f, 0.f)};
+        CollisionShape second{create_shape(&mask, 100.f, 60.f, 0.f, 0.f)};
+        CHECK(Narrowphase::boxes_overlap(first, second));
+        CHECK_FALSE(Narrowphase::overlaps(first, second));
+        // The opaque squares overlap by one pixel.
+        second = create_shape(&mask, 100.f, 49.f, 49.f, 0.f);
+        CHECK(Narrowphase::overlaps(first, second));
+        second = create_shape(&mask, 100.f, 50.f, 49.f, 0.f);
+        CHECK_FALSE(Narrowphase::overlaps(first, second));
+    }
+
+    SECTION("Rotated masks")
+    {
+        // Rotated by 45 degrees the corner of the square reaches about 35
+        // pixels from the centre.
+        CollisionShape first{create_shape(&mask, 100.f, 0.f, 0.f, 0.f)};
+        CollisionShape second{create_shape(&mask, 100.f, 58.f, 0.f, 45.f)};
+        CHECK(Narrowphase::overlaps(first, second));
+        CHECK(Narrowphase::overlaps(second, first));
+        second = create_shape(&mask, 100.f, 58.f, 30.f, 45.f);
+        CHECK_FALSE(Narrowphase::overlaps(first, second));
+        CHECK_FALSE(Narrowphase::overlaps(second, first));
+    }
+
+    SECTION("Masks and boxes")
+    {
+        CollisionShape shape{create_shape(&mask, 100.f, 0.f, 0.f, 30.f)};
+        CHECK(Narrowphase::overlaps(shape, Narrowphase::make_box(sf::FloatRect{-2.f, -2.f, 4.f, 4.f})));
+        CHECK_FALSE(Narrowphase::overlaps(shape, Narrowphase::make_box(sf::FloatRect{-48.f, -48.f, 4.f, 4.f})));
+        // Flipped boxes are allowed.
+        CHECK(Narrowphase::overlaps(Narrowphase::make_box(sf::FloatRect{2.f, 2.f, -4.f, -4.f}), shape));
+    }
+}
+
+TEST_CASE("Compound colliders")
+{
+    CompoundTestObject compound{};
+    CHECK(compound.refresh_bounds());
+    // The bounds of the sub-colliders are used instead of bounds().
+    CHECK(compound.get_bounds_calls() == 0);
+    CHECK(compound.get_cached_bounds() == sf::FloatRect{0.f, 0.f, 30.f, 10.f});
+    REQUIRE(compound.get_sub_colliders().size() == 2);
+
+    BoxTestObject gap{sf::FloatRect{12.f, 2.f, 6.f, 6.f}};
+    BoxTestObject right{sf::FloatRect{25.f, 2.f, 6.f, 6.f}};
+    gap.refresh_bounds();
+    right.refresh_bounds();
+    CHECK_FALSE(Narrowphase::overlaps(compound, gap));
+    CHECK_FALSE(Narrowphase::overlaps(gap, compound));
+    CHECK(Narrowphase::overlaps(compound, right));
+    CHECK(Narrowphase::overlaps(right, compound));
+
+    // Sub-colliders follow the transform.
+    compound.move(-20.f, 0.f);
+    CHECK(compound.refresh_bounds());
+    CHECK(compound.get_cached_bounds() == sf::FloatRect{-20.f, 0.f, 30.f, 10.f});
+    CHECK_FALSE(Narrowphase::overlaps(compound, right));
+    CHECK(Narrowphase::overlaps(compound, Narrowphase::make_box(sf::FloatRect{5.f, 2.f, 1.f, 1.f})));
+}
+
+TEST_CASE("CellGrid")
+{
+    CellGrid grid{10.f, 4.f};
+    std::vector<CellBox> boxes{CellBox{0.f, 0.f, 5.f, 5.f},
+                               CellBox::empty(),
+                               CellBox{5.f, 5.f, 25.f, 15.f},
+                               CellBox{35.f, 15.f, 39.f, 19.f}};
+    grid.build(boxes);
+    REQUIRE(grid.get_columns() == 4);
+    REQUIRE(grid.get_rows() == 2);
+
+    // Every box is in all cells it touches, empty boxes are left out.
+    auto cell = [&grid](int column, int row)
+    {
+        CellGrid::Cell items{grid.get_cell(column, row)};
+        return std::vector<std::size_t>{items.begin(), items.end()};
+    };
+    CHECK(cell(0, 0) == std::vector<std::size_t>{0, 2});
+    CHECK(cell(2, 1) == std::vector<std::size_t>{2});
+    CHECK(cell(3, 0).empty());
+    CHECK(cell(3, 1) == std::vector<std::size_t>{3});
+    CHECK(grid.is_first_cell(boxes[2], 0, 0, 0, 0));
+    CHECK_FALSE(grid.is_first_cell(boxes[2], 1, 0, 0, 0));
+    CHECK(grid.is_first_cell(boxes[2], 1, 1, 1, 1));
+
+    // Boxes spread over too many cells make the cells larger.
+    boxes.push_back(CellBox{100.f, 0.f, 101.f, 1.f});
+    grid.build(boxes);
+    CHECK(grid.get_cell_size() == Approx(40.f));
+    CHECK(grid.get_columns() == 3);
+
+    grid.clear();
+    CHECK(grid.get_columns() == 0);
+}
+
+TEST_CASE("SpatialGrid gives same result as checking every object")
+{
+    std::vector<sf::FloatRect> boxes{create_boxes(300, 400.f)};
+    const CollisionLayer layers[3]{CollisionLayer::Enemy, CollisionLayer::Player, CollisionLayer::None};
+    std::vector<LayeredTestObject> objects{};
+    objects.reserve(boxes.size());
+    for (std::size_t i{0}; i < boxes.size(); i++)
+    {
+        objects.emplace_back(boxes[i], layers[i % 3]);
+    }
+    std::vector<GameObject *> pointers{};
+    for (LayeredTestObject &object : objects)
+    {
+        object.refresh_bounds();
+        pointers.push_back(&object);
+    }
+    // Skipped by the grid: no layer, no size or removed.
+    auto is_found = [](const LayeredTestObject &object, CollisionLayer layer)
+    {
+        const sf::FloatRect &bounds{object.get_cached_bounds()};
+        return object.get_layer() == layer && bounds.width != 0.f && bounds.height != 0.f &&
+               !object.is_removed();
+    };
+    objects[0].remove();
+
+    SpatialGrid grid{16.f};
+    grid.build(pointers);
+    std::size_t expected_size{0};
+    for (const LayeredTestObject &object : objects)
+    {
+        if (is_found(object, object.get_layer()) && object.get_layer() != CollisionLayer::None)
+            expected_size++;
+    }
+    CHECK(grid.get_size() == expected_size);
+
+    std::minstd_rand rng{42};
+    std::uniform_real_distribution<float> position{-50.f, 450.f};
+    std::uniform_real_distribution<float> angle{0.f, 6.2831853f};
+    for (int query{0}; query < 100; query++)
+    {
+        sf::Vector2f point{position(rng), position(rng)};
+
+        // Radius.
+        std::vector<const GameObject *> found{};
+        grid.find_in_radius(point, 40.f, CollisionLayer::Enemy, found);
+        std::vector<const GameObject *> expected{};
+        for (const LayeredTestObject &object : objects)
+        {
+            if (is_found(object, CollisionLayer::Enemy) &&
+                get_distance2(object.get_cached_bounds(), point) <= 40.f * 40.f)
+            {
+                expected.push_back(&object);
+            }
+        }
+        std::sort(found.begin(), found.end());
+        CHECK(found == expected);
+
+        // Ring.
+        found.clear();
+        grid.find_in_ring(point, 20.f, 40.f, CollisionLayer::Enemy, found);
+        expected.erase(std::remove_if(expected.begin(), expected.end(),
+                                      [&point](const GameObject *object)
+                                      { return get_distance2(object->get_cached_bounds(), point) <= 20.f * 20.f; }),
+                       expected.end());
+        std::sort(found.begin(), found.end());
+        CHECK(found == expected);
+
+        // Nearest, compared by distance since several objects may be as close.
+        const GameObject *nearest{grid.find_nearest(point, CollisionLayer::Enemy | CollisionLayer::Player)};
+        float expected_distance2{std::numeric_limits<float>::infinity()};
+        for (const LayeredTestObject &object : objects)
+        {
+            if (is_found(object, CollisionLayer::Enemy) || is_found(object, CollisionLayer::Player))
+                expected_distance2 = std::min(expected_distance2, get_distance2(object.get_cached_bounds(), point));
+        }
+        REQUIRE(nearest != nullptr);
+        CHECK(get_distance2(nearest->get_cached_bounds(), point) == expected_distance2);
+        CHECK(grid.find_nearest(point, CollisionLayer::Enemy, std::sqrt(expected_distance2) * 0.5f - 1.f) == nullptr);
+
+        // Raycast.
+        float a{angle(rng)};
+        sf::Vector2f direction{std::cos(a), std::sin(a)};
+        RayHit hit{};
+        bool is_hit{grid.raycast(point, direction * 3.f, 200.f, CollisionLayer::Player, hit)};
+        float expected_ray{-1.f};
+        for (const LayeredTestObject &object : objects)
+        {
+            if (!is_found(object, CollisionLayer::Player))
+                continue;
+            float distance{get_ray_distance(object.get_cached_bounds(), point, direction, 200.f)};
+            if (distance >= 0.f && (expected_ray < 0.f || distance < expected_ray))
+                expected_ray = distance;
+        }
+        CHECK(is_hit == (expected_ray >= 0.f));
+        if (is_hit)
+        {
+            CHECK(hit.distance == Approx(expected_ray).margin(1e-3));
+            CHECK(get_ray_distance(hit.object->get_cached_bounds(), point, direction, 200.f) ==
+                  Approx(expected_ray).margin(1e-3));
+            CHECK(hit.object->get_layer() == CollisionLayer::Player);
+        }
+    }
+
+    grid.clear();
+    CHECK(grid.get_size() == 0);
+    CHECK(grid.find_nearest(sf::Vector2f{}, CollisionLayer::All) == nullptr);
+}
+
+TEST_CASE("AabbArray benchmark", "[.][benchmark]")
+{
+    using Clock = std::chrono::steady_clock;
+    for (std::size_t count : {1000u, 4000u})
+    {
+        std::vector<sf::FloatRect> boxes{create_boxes(count, 2000.f)};
+        std::vector<GameObject *> objects{};
+        AabbArray array{};
+        array.resize(count);
+        for (std::size_t i{0}; i < count; i++)
+        {
+            objects.push_back(new BoxTestObject{boxes[i]});
+            array.set(i, boxes[i]);
+        }
+        double pairs{count * (count - 1) / 2.0};
+
+        // Current path, virtual bounds() and sf::FloatRect::intersects.
+        std::size_t found_objects{0};
+        auto start = Clock::now();
+        for (std::size_t i{0}; i < count; i++)
+        {
+            for (std::size_t j{i + 1}; j < count; j++)
+            {
+                if (objects[i]->collides(objects[j]))
+                    found_objects++;
+            }
+        }
+        std::chrono::duration<double> objects_time{Clock::now() - start};
+
+        std::vector<std::size_t> found{};
+        start = Clock::now();
+        for (std::size_t i{0}; i < count; i++)
+        {
+            array.find_overlaps_scalar(i, i + 1, count, found);
+        }
+        std::chrono::duration<double> scalar_time{Clock::now() - start};
+        std::size_t found_scalar{found.size()};
+
+        found.clear();
+        start = Clock::now();
+        for (std::size_t i{0}; i < count; i++)
+        {
+            array.find_overlaps(i, i + 1, count, found);
+        }
+        std::chrono::duration<double> simd_time{Clock::now() - start};
+        CHECK(found.size() == found_objects);
+        CHECK(found_scalar == found_objects);
+
+        std::cout << count << " boxes, " << found_objects << " overlaps, million pairs/s: "
+                  << "GameObject::collides " << pairs / objects_time.count() / 1e6
+                  << ", scalar " << pairs / scalar_time.count() / 1e6
+                  << ", " << AabbArray::get_kernel_name() << " "
+                  << pairs / simd_time.count() / 1e6 << std::endl;
+
+        for (GameObject *object : objects)
+        {
+            delete object;
+        }
+    }
+}
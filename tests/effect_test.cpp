@@ -0,0 +1,117 @@
+#include "effectstack.hpp"
+#include "context.hpp"
+#include "gameconfiguration.hpp"
+#include "player.hpp"
+#include "powerup.hpp"
+#include "projectile.hpp"
+
+#include <catch.hpp>
+#include <SFML/Graphics.hpp>
+
+TEST_CASE("EffectStack")
+{
+    sf::RenderWindow window{};
+    Context context{sf::Time{}, window};
+    EffectStack effects{};
+    CHECK_FALSE(effects.has(EffectType::FireRate));
+    CHECK(effects.get_multiplier(EffectType::FireRate) == 1.f);
+
+    // Stacks of a type multiply, up to the allowed number of stacks.
+    effects.add(EffectType::FireRate, 0.5f, 10.f, 2);
+    effects.update(sf::seconds(2.f), context);
+    effects.add(EffectType::FireRate, 0.5f, 10.f, 2);
+    CHECK(effects.get_stacks(EffectType::FireRate) == 2);
+    CHECK(effects.get_multiplier(EffectType::FireRate) == Approx(0.25f));
+    // One more refreshes the stack that runs out first.
+    effects.add(EffectType::FireRate, 0.5f, 10.f, 2);
+    CHECK(effects.get_stacks(EffectType::FireRate) == 2);
+    effects.add(EffectType::Spread, 1.f, 5.f);
+    CHECK(effects.get_size() == 3);
+
+    EffectStack::StatusArray status{};
+    REQUIRE(effects.get_status(status) == 2);
+    CHECK(status[0].type == EffectType::FireRate);
+    CHECK(status[0].stacks == 2);
+    CHECK(status[0].remaining == Approx(10.f));
+    CHECK(status[1].type == EffectType::Spread);
+    CHECK(status[1].remaining == Approx(5.f));
+
+    // Stacks run out when their time is up, not before.
+    effects.update(sf::seconds(4.9f), context);
+    CHECK(effects.has(EffectType::Spread));
+    effects.update(sf::seconds(0.1f), context);
+    CHECK_FALSE(effects.has(EffectType::Spread));
+    effects.update(sf::seconds(5.f), context);
+    CHECK_FALSE(effects.has(EffectType::FireRate));
+    CHECK(effects.get_size() == 0);
+
+    // Shields are consumed one at a time.
+    effects.add(EffectType::Shield, 1.f, 10.f, 3);
+    effects.add(EffectType::Shield, 1.f, 10.f, 3);
+    CHECK(effects.consume(EffectType::Shield));
+    CHECK(effects.get_stacks(EffectType::Shield) == 1);
+    CHECK(effects.consume(EffectType::Shield));
+    CHECK_FALSE(effects.consume(EffectType::Shield));
+
+    // A full stack replaces the stack closest to running out.
+    effects.add(EffectType::DoubleShot, 1.f, 1.f);
+    for (std::size_t i{1}; i < EffectStack::s_capacity; i++)
+        effects.add(EffectType::Speed, 1.1f, 20.f, 100);
+    CHECK(effects.get_size() == EffectStack::s_capacity);
+    effects.add(EffectType::Shield, 1.f, 20.f);
+    CHECK(effects.get_size() == EffectStack::s_capacity);
+    CHECK_FALSE(effects.has(EffectType::DoubleShot));
+    CHECK(effects.has(EffectType::Shield));
+
+    // Replaced and removed stacks never fire.
+    effects.remove(EffectType::Speed);
+    CHECK(effects.get_size() == 1);
+    effects.update(sf::seconds(20.f), context);
+    CHECK(effects.get_size() == 0);
+    effects.add(EffectType::Speed, 2.f, 1.f);
+    effects.clear();
+    effects.update(sf::seconds(2.f), context);
+    CHECK(effects.get_size() == 0);
+}
+
+TEST_CASE("Player effects")
+{
+    sf::RenderWindow window{};
+    PlayerData data{};
+    data.health = 3;
+    Player player{data, 0.f, 0.f};
+
+    // Only one weapon at a time.
+    player.collect(PowerUpType::Buckshot);
+    CHECK(player.get_effects().has(EffectType::Spread));
+    player.collect(PowerUpType::Doubleshoot);
+    CHECK_FALSE(player.get_effects().has(EffectType::Spread));
+    CHECK(player.get_effects().has(EffectType::DoubleShot));
+
+    // Repair at full health gives a shield, which absorbs one hit.
+    player.collect(PowerUpType::Repair);
+    CHECK(player.get_health() == 3);
+    CHECK(player.get_effects().get_stacks(EffectType::Shield) == 1);
+    BasicProjectile hostile{0.f, 0.f, 0.f, 0.f, false, 1};
+    player.collision(&hostile);
+    CHECK(player.get_health() == 3);
+    CHECK_FALSE(player.get_effects().has(EffectType::Shield));
+    player.collision(&hostile);
+    CHECK(player.get_health() == 2);
+    player.collect(PowerUpType::Repair);
+    CHECK(player.get_health() == 3);
+
+    // Effects run out as the player is updated.
+    for (int i{0}; i < 19; i++)
+    {
+        Context context{sf::seconds(1.f), window};
+        player.update(context);
+    }
+    CHECK(player.get_effects().has(EffectType::DoubleShot));
+    {
+        Context context{sf::seconds(1.f), window};
+        player.update(context);
+    }
+    CHECK_FALSE(player.get_effects().has(EffectType::DoubleShot));
+    CHECK(player.get_score() == 400);
+}
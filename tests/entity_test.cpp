@@ -0,0 +1,846 @@
+#include "entityworld.hpp"
+#include "entityobject.hpp"
+#include "archetypes.hpp"
+#include "bossmode.hpp"
+#include "context.hpp"
+#include "enemy.hpp"
+#include "gameconfiguration.hpp"
+#include "gamestate.hpp"
+#include "normalmode.hpp"
+#include "player.hpp"
+#include "projectile.hpp"
+#include "renderbatch.hpp"
+#include "resourcemanager.hpp"
+#include "spawntable.hpp"
+#include "threadpool.hpp"
+#include "gamemodetest.hpp"
+
+#define _USE_MATH_DEFINES
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <catch.hpp>
+#include <SFML/Graphics.hpp>
+
+/**
+ * @brief Enemy stored the way all enemies were before EntityWorld: its own
+ * sprite, clock and health bar, updated and batched through virtual calls.
+ */
+class VirtualEnemyTestObject : public GameObject
+{
+public:
+    VirtualEnemyTestObject(const sf::Texture &texture, const EnemyMinionData &data, float x, float y)
+        : m_sprite{texture},
+          m_clock{},
+          m_bar_background{sf::Vector2f{70.f, 6.f}},
+          m_bar{sf::Vector2f{70.f, 6.f}},
+          m_data{data},
+          m_health{data.base_health}
+    {
+        m_sprite.setOrigin(texture.getSize().x / 2.f, texture.getSize().y / 2.f);
+        m_sprite.setPosition(x, y);
+    }
+
+    virtual ~VirtualEnemyTestObject() = default;
+
+    virtual void update(Context &context) override
+    {
+        if (m_clock.getElapsedTime().asSeconds() >= m_data.base_attack_cooldown)
+        {
+            context.spawn_projectile(m_sprite.getPosition().x, m_sprite.getPosition().y, M_PI_2,
+                                     m_data.base_projectile_speed, false);
+            m_clock.restart();
+        }
+        m_sprite.move(0.f, m_data.base_speed * context.get_delta().asSeconds());
+        m_bar_background.setPosition(m_sprite.getPosition() + sf::Vector2f{-35.f, 30.f});
+        m_bar.setPosition(m_bar_background.getPosition());
+        m_bar.setSize(sf::Vector2f{70.f * m_health / m_data.base_health, 6.f});
+    }
+
+    virtual void render(RenderSnapshot &) const override
+    {
+        return;
+    }
+
+    virtual bool render_batched(RenderBatch &batch) const override
+    {
+        batch.add_sprite(m_sprite);
+        batch.add_rectangle(m_bar_background, 1);
+        batch.add_rectangle(m_bar, 1);
+        return true;
+    }
+
+    virtual bool handle(const sf::Event &, Context &) override
+    {
+        return false;
+    }
+
+    virtual sf::FloatRect bounds() const override
+    {
+        return m_sprite.getGlobalBounds();
+    }
+
+    virtual CollisionLayer get_layer() const override
+    {
+        return CollisionLayer::Enemy;
+    }
+
+    virtual void collision(const GameObject *) override
+    {
+        m_health--;
+    }
+
+protected:
+    virtual const sf::Transformable *get_transform() const override
+    {
+        return &m_sprite;
+    }
+
+private:
+    sf::Sprite m_sprite;
+    sf::Clock m_clock;
+    sf::RectangleShape m_bar_background;
+    sf::RectangleShape m_bar;
+    EnemyMinionData m_data;
+    int m_health;
+};
+
+/**
+ * @brief Get components of a plain enemy entity, without texture or mask.
+ *
+ * @param position position of the entity.
+ * @param speed speed straight down.
+ * @param health health and max health.
+ */
+EntityDesc get_test_desc(const sf::Vector2f &position, float speed, int health)
+{
+    return EntityDesc{Transform{position},
+                      Velocity{sf::Vector2f{0.f, 1.f}, speed, false},
+                      Collider{sf::FloatRect{-5.f, -5.f, 10.f, 10.f}, nullptr},
+                      Health{health, health},
+                      WeaponCooldown{1.f, 0, 0.f, 100.f, AttackPattern::None},
+                      SpriteRef{nullptr, sf::IntRect{}, sf::Vector2f{}, 0.f},
+                      Loot{0.f, 0.f, 100},
+                      Faction::Enemy};
+}
+
+/**
+ * @brief Delete all objects spawned into a context, so it can be destroyed.
+ */
+void delete_new_objects(Context &context)
+{
+    std::vector<GameObject *> objects{};
+    context.get_new_objects(objects);
+    for (GameObject *object : objects)
+    {
+        delete object;
+    }
+}
+
+TEST_CASE("EntityWorld create and destroy")
+{
+    EntityWorld world{};
+    std::vector<EntityObject *> objects{};
+    for (int i{0}; i < 4; i++)
+    {
+        objects.push_back(new EntityObject{world, get_test_desc(sf::Vector2f{10.f * i, 0.f}, 0.f, i + 1)});
+    }
+    REQUIRE(world.get_size() == 4);
+
+    // Destroying an entity moves the last one into its place, ids stay the same.
+    Entity removed{objects[1]->get_entity()};
+    delete objects[1];
+    objects.erase(objects.begin() + 1);
+    CHECK(world.get_size() == 3);
+    CHECK_FALSE(world.contains(removed));
+    CHECK_THROWS(world.get_health(removed));
+    for (EntityObject *object : objects)
+    {
+        Entity entity{object->get_entity()};
+        REQUIRE(world.contains(entity));
+        float x{world.get_transform(entity).position.x};
+        CHECK(world.get_health(entity).current == static_cast<int>(x / 10.f) + 1);
+        CHECK(object->bounds() == sf::FloatRect{x - 5.f, -5.f, 10.f, 10.f});
+    }
+
+    // Slots of destroyed entities are reused, but their old ids stay out of
+    // the world.
+    objects.push_back(new EntityObject{world, get_test_desc(sf::Vector2f{}, 0.f, 1)});
+    Entity reused{objects.back()->get_entity()};
+    CHECK(reused.index == removed.index);
+    CHECK(reused != removed);
+    CHECK(world.contains(reused));
+    CHECK_FALSE(world.contains(removed));
+    CHECK_THROWS(world.get_transform(removed));
+    CHECK(objects.back()->get_layer() == CollisionLayer::Enemy);
+
+    for (EntityObject *object : objects)
+    {
+        delete object;
+    }
+    CHECK(world.get_size() == 0);
+}
+
+TEST_CASE("EntityWorld systems")
+{
+    EntityWorld world{};
+    Player player{{}, 0.f, 0.f};
+    sf::RenderWindow window{};
+    Context context{sf::seconds(0.1f), window};
+    // Score and health reach the player through events, as in a GameMode.
+    EventBus events{};
+    events.subscribe<EnemyKilled>([&player](const EnemyKilled &event)
+                                  { player.kills(event.score, false); });
+    events.subscribe<PlayerHit>([&player](const PlayerHit &event)
+                                { player.lose_health(event.damage); });
+    context.set_event_bus(&events);
+
+    // The window has no size, so everything below y = 0 is past the player.
+    EntityObject *mover{new EntityObject{world, get_test_desc(sf::Vector2f{0.f, -100.f}, 100.f, 2)}};
+    EntityObject *target{new EntityObject{world, get_test_desc(sf::Vector2f{0.f, -100.f}, 0.f, 2)}};
+    EntityObject *escaping{new EntityObject{world, get_test_desc(sf::Vector2f{0.f, -5.f}, 100.f, 2)}};
+
+    int health{player.get_health()};
+    world.update(context);
+    CHECK(world.get_transform(mover->get_entity()).position.y == Approx(-90.f));
+    CHECK(world.get_transform(target->get_entity()).position.y == Approx(-100.f));
+    CHECK_FALSE(mover->is_removed());
+    CHECK(escaping->is_removed());
+    REQUIRE(events.get_events<PlayerHit>().get_size() == 1);
+    CHECK(player.get_health() == health);
+    events.dispatch();
+    CHECK(player.get_health() == health - 1);
+
+    // Friendly projectiles and the player damage the entity, enemy projectiles
+    // do not. Entities without health are removed on the next update.
+    BasicProjectile friendly{0.f, 0.f, 0.f, 0.f, true, 1};
+    BasicProjectile hostile{0.f, 0.f, 0.f, 0.f, false, 1};
+    target->collision(&hostile);
+    CHECK(target->get_health() == 2);
+    target->collision(&friendly);
+    target->collision(&player);
+    CHECK(target->get_health() == 0);
+    world.update(context);
+    CHECK(target->is_removed());
+    events.dispatch();
+    CHECK(player.get_kills() == 1);
+    CHECK(player.get_score() == 100);
+
+    // Removed entities are skipped by the systems.
+    sf::Vector2f position{world.get_transform(target->get_entity()).position};
+    world.update(context);
+    CHECK(world.get_transform(target->get_entity()).position == position);
+    CHECK(events.get_size() == 0);
+    CHECK(player.get_kills() == 1);
+
+    delete_new_objects(context);
+    delete mover;
+    delete target;
+    delete escaping;
+}
+
+TEST_CASE("EntityWorld weapons")
+{
+    EntityWorld world{};
+    TimerWheel timers{};
+    sf::RenderWindow window{};
+    Context context{sf::seconds(0.1f), window};
+    EventBus events{};
+    context.set_event_bus(&events);
+
+    EntityDesc desc{get_test_desc(sf::Vector2f{0.f, -100.f}, 0.f, 1)};
+    desc.weapon = WeaponCooldown{0.5f, 0, 1.f, 100.f, AttackPattern::Cross};
+    EntityObject *shooter{new EntityObject{world, desc}};
+    EntityObject *idle{new EntityObject{world, desc}};
+    EntityObject *removed{new EntityObject{world, desc}};
+
+    // Weapons are not polled by the systems, only started weapons attack.
+    world.update(context);
+    shooter->start_timers(timers);
+    removed->start_timers(timers);
+    REQUIRE(timers.get_pending_count() == 2);
+    timers.advance(sf::seconds(0.4f), context);
+    std::vector<ProjectileSpawn> projectiles{};
+    context.get_new_projectiles(projectiles);
+    CHECK(projectiles.empty());
+
+    // Removed entities stop attacking and leave the wheel.
+    world.get_health(removed->get_entity()).current = 0;
+    world.update(context);
+    REQUIRE(removed->is_removed());
+    timers.advance(sf::seconds(0.1f), context);
+    context.get_new_projectiles(projectiles);
+    CHECK(projectiles.size() == 4);
+    CHECK(timers.get_pending_count() == 1);
+
+    // Destroying an entity cancels its weapon.
+    delete shooter;
+    CHECK(timers.get_pending_count() == 0);
+    timers.advance(sf::seconds(1.f), context);
+    projectiles.clear();
+    context.get_new_projectiles(projectiles);
+    CHECK(projectiles.empty());
+
+    delete idle;
+    delete removed;
+}
+
+/**
+ * @brief State of an EntityWorld after some updates, see simulate_entity_world(...).
+ */
+struct EntityWorldResult
+{
+    std::vector<sf::Vector2f> positions;
+    std::vector<bool> removed;
+    std::vector<sf::Vector2f> kills;
+    std::size_t hits;
+    std::vector<sf::FloatRect> powerups;
+};
+
+/**
+ * @brief Update a world of many entities for some frames, with an optional
+ * thread pool, and return what happened.
+ */
+EntityWorldResult simulate_entity_world(ThreadPool *pool)
+{
+    EntityWorld world{};
+    sf::RenderWindow window{};
+    Context context{sf::seconds(0.1f), window};
+    context.set_thread_pool(pool);
+    EventBus events{};
+    context.set_event_bus(&events);
+
+    // Every entity seeds its generator from rand().
+    std::srand(7);
+    std::vector<EntityObject *> objects{};
+    for (int i{0}; i < 2000; i++)
+    {
+        EntityDesc desc{get_test_desc(sf::Vector2f{static_cast<float>(i % 50), -10.f * (i % 97)},
+                                      static_cast<float>(i % 13) * 10.f, i % 5)};
+        desc.velocity.bounce = i % 2 == 0;
+        desc.loot.powerup_probability = 0.5f;
+        objects.push_back(new EntityObject{world, desc});
+    }
+
+    EntityWorldResult result{{}, {}, {}, 0, {}};
+    std::vector<GameObject *> spawned{};
+    for (int frame{0}; frame < 10; frame++)
+    {
+        // Damage some entities every frame, so some die in every frame.
+        for (std::size_t i{static_cast<std::size_t>(frame)}; i < objects.size(); i += 10)
+        {
+            world.get_health(objects[i]->get_entity()).current -= 1;
+        }
+        world.update(context);
+        context.get_new_objects(spawned);
+        for (GameObject *object : spawned)
+        {
+            result.powerups.push_back(object->bounds());
+            delete object;
+        }
+        spawned.clear();
+    }
+    const EventQueue<EnemyKilled> &kills{events.get_events<EnemyKilled>()};
+    for (std::size_t i{0}; i < kills.get_size(); i++)
+    {
+        result.kills.push_back(kills[i].position);
+    }
+    result.hits = events.get_events<PlayerHit>().get_size();
+    for (EntityObject *object : objects)
+    {
+        result.positions.push_back(world.get_transform(object->get_entity()).position);
+        result.removed.push_back(object->is_removed());
+        delete object;
+    }
+    return result;
+}
+
+TEST_CASE("Parallel EntityWorld update gives same result as serial update")
+{
+    ThreadPool pool{3};
+    EntityWorldResult serial{simulate_entity_world(nullptr)};
+    EntityWorldResult parallel{simulate_entity_world(&pool)};
+    CHECK(serial.positions == parallel.positions);
+    CHECK(serial.removed == parallel.removed);
+    CHECK(serial.kills == parallel.kills);
+    CHECK(serial.hits == parallel.hits);
+    CHECK(serial.powerups == parallel.powerups);
+    // All systems did something.
+    CHECK(serial.kills.size() > 100);
+    CHECK(serial.hits > 20);
+    CHECK_FALSE(serial.powerups.empty());
+    CHECK(std::count(serial.removed.begin(), serial.removed.end(), false) > 100);
+}
+
+TEST_CASE("Parallel EntityWorld benchmark", "[.][benchmark]")
+{
+    ThreadPool pool{};
+    sf::RenderWindow window{};
+    for (unsigned int count : {1000u, 10000u, 50000u})
+    {
+        std::chrono::duration<double, std::milli> times[2]{};
+        for (int parallel{0}; parallel < 2; parallel++)
+        {
+            EntityWorld world{};
+            Context context{sf::seconds(0.001f), window};
+            context.set_thread_pool(parallel == 1 ? &pool : nullptr);
+            std::vector<EntityObject *> objects{};
+            for (unsigned int i{0}; i < count; i++)
+            {
+                EntityDesc desc{get_test_desc(sf::Vector2f{static_cast<float>(i % 800), -1e6f}, 10.f, 1)};
+                desc.velocity.bounce = true;
+                objects.push_back(new EntityObject{world, desc});
+            }
+            auto start = std::chrono::steady_clock::now();
+            for (int frame{0}; frame < 100; frame++)
+            {
+                world.update(context);
+            }
+            times[parallel] = std::chrono::steady_clock::now() - start;
+            for (EntityObject *object : objects)
+            {
+                delete object;
+            }
+        }
+        std::cout << count << " entities, 100 frames: serial " << times[0].count()
+                  << " ms, parallel (" << pool.get_thread_count() << " threads) "
+                  << times[1].count() << " ms" << std::endl;
+    }
+}
+
+TEST_CASE("ArchetypeTable")
+{
+    // The shipped file describes the built in table.
+    ArchetypeTable defaults{ArchetypeTable::defaults()};
+    ArchetypeTable table{ArchetypeTable::from_file("assets/archetypes.txt")};
+    REQUIRE(table.get_size() == defaults.get_size());
+    for (std::size_t id{0}; id < table.get_size(); id++)
+    {
+        const EnemyArchetype &loaded{table.get(id)};
+        const EnemyArchetype &built_in{defaults.get(id)};
+        CHECK(loaded.name == built_in.name);
+        CHECK(loaded.texture == built_in.texture);
+        CHECK(loaded.health == Approx(built_in.health));
+        CHECK(loaded.speed == Approx(built_in.speed));
+        CHECK(loaded.attack_cooldown == Approx(built_in.attack_cooldown));
+        CHECK(loaded.projectile_prob == Approx(built_in.projectile_prob));
+        CHECK(loaded.powerup_prob == Approx(built_in.powerup_prob));
+        CHECK(loaded.pattern == built_in.pattern);
+        CHECK(loaded.direction.x == Approx(built_in.direction.x));
+        CHECK(loaded.direction.y == Approx(built_in.direction.y));
+        CHECK(loaded.bounce == built_in.bounce);
+        for (std::size_t d{0}; d < 3; d++)
+        {
+            CHECK(loaded.difficulties[d].health == Approx(built_in.difficulties[d].health));
+            CHECK(loaded.difficulties[d].speed == Approx(built_in.difficulties[d].speed));
+        }
+    }
+    CHECK_THROWS(table.find("XXXX"));
+    CHECK_THROWS(ArchetypeTable::from_file("XXXX"));
+
+    EnemyArchetype archetype{};
+    CHECK(archetype.set_value("SPEED_2", "0.5"));
+    CHECK(archetype.difficulties[1].speed == Approx(0.5f));
+    CHECK_FALSE(archetype.set_value("XXXX", "1"));
+    CHECK_THROWS(archetype.set_value("PATTERN", "XXXX"));
+    CHECK_THROWS(archetype.set_value("HEALTH", "XXXX"));
+
+    // Multipliers of the archetype and the difficulty are applied to the base
+    // values, difficulties outside 1 to 3 are clamped.
+    EnemyMinionData data{};
+    data.base_health = 2;
+    data.base_speed = 10.f;
+    EntityWorld world{};
+    std::size_t tank{table.find("tank")};
+    EntityObject *first{dynamic_cast<EntityObject *>(table.create(world, data, tank, 0.f, 0.f, 1))};
+    EntityObject *third{dynamic_cast<EntityObject *>(table.create(world, data, tank, 0.f, 0.f, 5))};
+    REQUIRE(first != nullptr);
+    REQUIRE(third != nullptr);
+    CHECK(first->get_health() == 15);
+    CHECK(world.get_velocity(first->get_entity()).speed == Approx(4.f));
+    CHECK(third->get_health() == 10);
+    CHECK(world.get_velocity(third->get_entity()).speed == Approx(6.f));
+
+    // Deleted objects go back to the pool and are reused.
+    std::size_t pool_free{EntityObject::get_pool_free()};
+    const void *address{third};
+    delete third;
+    CHECK(EntityObject::get_pool_free() == pool_free + 1);
+    GameObject *reused{table.create(world, data, tank, 0.f, 0.f, 1)};
+    CHECK(static_cast<const void *>(reused) == address);
+    CHECK(EntityObject::get_pool_free() == pool_free);
+    delete reused;
+    delete first;
+
+    // The pool may be used from several threads at once.
+    pool_free = EntityObject::get_pool_free();
+    ThreadPool pool{4};
+    pool.parallel_for(4000, 1, [](std::size_t, std::size_t, std::size_t)
+                      {
+                          void *memory{EntityObject::operator new(sizeof(EntityObject))};
+                          EntityObject::operator delete(memory, sizeof(EntityObject));
+                      });
+    CHECK(EntityObject::get_pool_free() >= pool_free);
+}
+
+TEST_CASE("AliasTable")
+{
+    std::vector<double> weights{27.0, 9.0, 4.0, 0.0, 60.0};
+    AliasTable table{weights};
+    REQUIRE(table.get_size() == weights.size());
+    for (std::size_t i{0}; i < weights.size(); i++)
+    {
+        CHECK(table.get_probability(i) == Approx(weights[i] / 100.0).margin(1e-6));
+    }
+
+    // Drawn about as often as the weights say, never an outcome without weight.
+    std::mt19937 rng{1};
+    std::vector<unsigned int> counts(weights.size(), 0);
+    for (int i{0}; i < 100000; i++)
+    {
+        counts[table.sample(rng())]++;
+    }
+    for (std::size_t i{0}; i < weights.size(); i++)
+    {
+        CHECK(counts[i] / 100000.0 == Approx(weights[i] / 100.0).margin(0.01));
+    }
+    CHECK(counts[3] == 0);
+    CHECK(table.sample(0) < weights.size());
+    CHECK(table.sample(0xffffffff) < weights.size());
+
+    CHECK_THROWS(AliasTable{{}});
+    CHECK_THROWS(AliasTable{{0.0, 0.0}});
+    CHECK_THROWS(AliasTable{{1.0, -1.0}});
+}
+
+TEST_CASE("SpawnTable")
+{
+    // The shipped file describes the built in table.
+    ArchetypeTable archetypes{ArchetypeTable::defaults()};
+    SpawnTable defaults{SpawnTable::defaults()};
+    SpawnTable table{SpawnTable::from_file("assets/spawns.txt")};
+    REQUIRE(table.get_band_count() == defaults.get_band_count());
+    for (std::size_t b{0}; b < table.get_band_count(); b++)
+    {
+        const SpawnBand &loaded{table.get_band(b)};
+        const SpawnBand &built_in{defaults.get_band(b)};
+        CHECK(loaded.level == built_in.level);
+        REQUIRE(loaded.entries.size() == built_in.entries.size());
+        for (std::size_t e{0}; e < loaded.entries.size(); e++)
+        {
+            CHECK(loaded.entries[e].archetype == built_in.entries[e].archetype);
+            CHECK(loaded.entries[e].difficulty == built_in.entries[e].difficulty);
+            CHECK(loaded.entries[e].weight == Approx(built_in.entries[e].weight));
+        }
+    }
+    CHECK_THROWS(SpawnTable::from_file("XXXX"));
+
+    // Bands cover the levels from their level to the next band.
+    CHECK(table.find_band(0) == 0);
+    CHECK(table.find_band(2) == 0);
+    CHECK(table.find_band(3) == 1);
+    CHECK(table.find_band(11) == 3);
+    CHECK(table.find_band(100) == 4);
+
+    CHECK_THROWS(table.sample(0, 0));
+    table.compile(archetypes);
+    const SpawnChoice &first{table.sample(0, 12345)};
+    CHECK(first.archetype == archetypes.find("minion"));
+    CHECK(first.difficulty == 1);
+    // Old odds of the mover at levels 3 to 5 were 1 in 10.
+    CHECK(table.get_probability(1, 2) == Approx(0.1));
+
+    // Bands must increase, archetypes must exist.
+    CHECK_THROWS(table.add_band(SpawnBand{12, {{"minion", 1, 1.0}}}));
+    table.add_band(SpawnBand{20, {{"XXXX", 1, 1.0}}});
+    CHECK_THROWS(table.compile(archetypes));
+}
+
+/**
+ * @brief Time update and render of a frame with many enemies and a player.
+ *
+ * @details Not a NormalMode frame: there are no spawner, bosses or power-ups,
+ * and the enemies are far above the window, so they never fight. The times
+ * only compare the two ways of storing enemies with each other. They say
+ * little about the game, most of all when built against an SFML stand-in
+ * that does not draw. See simulate_normal_mode(...) for a full game.
+ *
+ * @param count number of enemies.
+ * @param entities true to spawn enemies with Archetypes, false to spawn
+ * VirtualEnemyTestObjects.
+ * @return milliseconds spent in update and render.
+ */
+std::pair<double, double> simulate_enemies(unsigned int count, bool entities)
+{
+    EnemyMinionData data{};
+    data.base_health = 3;
+    data.base_speed = 100.f;
+    data.base_attack_cooldown = 1.5f;
+    data.base_projectile_speed = 300.f;
+    data.base_projectile_prob = 1.f;
+    const sf::Texture &texture{ResourceManager::load_texture("assets/images/enemy/enemy.png")};
+
+    ArchetypeTable table{ArchetypeTable::defaults()};
+    std::size_t minion{table.find("minion")};
+    GameModeTest gm{};
+    gm.set_player(new Player{{}, 0.f, 0.f});
+    for (unsigned int i{0}; i < count; i++)
+    {
+        // Spread out far above the window, so no enemy gets past the player.
+        float x{(i % 100) * 80.f + 1000.f};
+        float y{(i / 100) * 80.f - 100000.f};
+        if (entities)
+            gm.spawn_object(table.create(gm.get_entities(), data, minion, x, y, 1));
+        else
+            gm.spawn_object(new VirtualEnemyTestObject{texture, data, x, y});
+    }
+
+    sf::RenderWindow window{};
+    Context c{sf::seconds(1.f / 60.f), window};
+    RenderSnapshot snapshot{};
+    std::chrono::duration<double, std::milli> update{};
+    std::chrono::duration<double, std::milli> render{};
+    for (int frame{0}; frame < 60; frame++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        gm.update(c);
+        auto middle = std::chrono::steady_clock::now();
+        snapshot.reset(window.getSize(), window.getView());
+        gm.render(snapshot);
+        auto end = std::chrono::steady_clock::now();
+        update += middle - start;
+        render += end - middle;
+    }
+    return {update.count(), render.count()};
+}
+
+// Prints times only, nothing is checked. Measure with the real SFML.
+TEST_CASE("Entity storage benchmark", "[.][benchmark]")
+{
+    for (unsigned int count : {1000u, 2500u, 5000u})
+    {
+        std::pair<double, double> objects{simulate_enemies(count, false)};
+        std::pair<double, double> entities{simulate_enemies(count, true)};
+        std::cout << count << " enemies, 60 frames: GameObjects update " << objects.first
+                  << " ms, render " << objects.second << " ms; entities update " << entities.first
+                  << " ms, render " << entities.second << " ms" << std::endl;
+    }
+}
+
+/**
+ * @brief Enemy of an archetype stored the way all enemies were before
+ * EntityWorld: an Enemy with its own sprite, health bar and timer, updated
+ * and batched through virtual calls.
+ */
+class ArchetypeEnemyTestObject : public Enemy
+{
+public:
+    ArchetypeEnemyTestObject(const EnemyArchetype &archetype, const EnemyMinionData &data,
+                             const sf::Vector2f &position, int difficulty)
+        : Enemy{static_cast<int>(data.base_health * archetype.health *
+                                 archetype.difficulties[std::clamp(difficulty, 1, 3) - 1].health),
+                data.base_speed * archetype.speed * archetype.difficulties[std::clamp(difficulty, 1, 3) - 1].speed,
+                data.base_projectile_speed,
+                data.base_attack_cooldown * archetype.attack_cooldown,
+                data.base_projectile_prob * archetype.projectile_prob,
+                data.base_powerup_prob * archetype.powerup_prob,
+                data.base_speed * 0.5f,
+                archetype.direction},
+          m_pattern{archetype.pattern},
+          m_bounce{archetype.bounce}
+    {
+        const sf::Texture &texture{ResourceManager::load_texture(archetype.texture)};
+        set_texture(texture);
+        s_sprite.setOrigin(texture.getSize().x / 2.f, texture.getSize().y / 2.f);
+        s_sprite.setPosition(position);
+        s_health_bar_offset = sf::Vector2f{0.f, texture.getSize().y / 2.f + 10.f};
+        toggle_health_bar();
+    }
+
+    virtual void update(Context &context) override
+    {
+        sf::Vector2f old_position{s_sprite.getPosition()};
+        Enemy::update(context);
+        if (m_bounce && (s_sprite.getPosition().x < 0 || s_sprite.getPosition().x > context.get_window_size().x))
+        {
+            e_move_direction.x *= -1;
+            s_sprite.setPosition(old_position);
+        }
+        update_health_bar();
+        mark_bounds_dirty();
+    }
+
+protected:
+    virtual void attack(Context &context) override
+    {
+        sf::Vector2f position{s_sprite.getPosition()};
+        switch (m_pattern)
+        {
+        case AttackPattern::Down:
+            context.spawn_projectile(position.x, position.y, M_PI_2, s_projectile_speed, false);
+            break;
+        case AttackPattern::Cross:
+            for (int direction{0}; direction < 4; direction++)
+                context.spawn_projectile(position.x, position.y, direction * M_PI_2, s_projectile_speed, false);
+            break;
+        case AttackPattern::Turn:
+            e_move_direction.x *= -1;
+            break;
+        case AttackPattern::None:
+            break;
+        }
+    }
+
+private:
+    AttackPattern m_pattern;
+    bool m_bounce;
+};
+
+/**
+ * @brief NormalMode that spawns its simple enemies either as entities, as in
+ * the game, or as ArchetypeEnemyTestObjects.
+ */
+class BenchmarkNormalMode : public NormalMode
+{
+public:
+    explicit BenchmarkNormalMode(bool entities)
+        : NormalMode{},
+          m_entities{entities}
+    {
+    }
+
+    Player *get_benchmark_player() const { return get_player(); }
+    std::size_t get_object_count() const { return get_objects().size(); }
+
+protected:
+    virtual GameObject *create_enemy(std::size_t archetype, const sf::Vector2f &position, int difficulty) override
+    {
+        if (m_entities)
+            return NormalMode::create_enemy(archetype, position, difficulty);
+        return new ArchetypeEnemyTestObject{get_archetypes().get(archetype), get_minion_data(), position, difficulty};
+    }
+
+private:
+    bool m_entities;
+};
+
+/**
+ * @brief Times of one NormalMode benchmark run.
+ */
+struct NormalModeTimes
+{
+    double update;
+    double render;
+    unsigned int boss_fights;
+    std::size_t peak_objects;
+};
+
+/**
+ * @brief Play a heavy NormalMode for a number of frames, the way Game runs it.
+ *
+ * @details Enemies spawn every 20 ms from the spawn table of level 5 and up,
+ * drop power-ups and shoot at the player. The player fires three projectiles
+ * up every 100 ms and cannot die. The boss comes every 20 seconds and is weak
+ * enough to be beaten, after which the game goes back to the NormalMode.
+ * Frames are run on a thread pool. Render is the time to build the snapshot,
+ * nothing is drawn.
+ *
+ * @param entities true to spawn enemies as entities, false to spawn
+ * ArchetypeEnemyTestObjects.
+ * @param frames number of frames of 1/60 second.
+ */
+NormalModeTimes simulate_normal_mode(bool entities, unsigned int frames)
+{
+    std::string path{(std::filesystem::temp_directory_path() / "normal_mode_benchmark.txt").string()};
+    {
+        std::ofstream file{path};
+        file << "WINDOW_WIDTH=900;\n"
+             << "WINDOW_HEIGHT=900;\n"
+             << "START_LEVEL=5;\n"
+             << "BOSS_SPAWN_TIME=20.0;\n"
+             << "BASE_SPAWN_TIME=0.02;\n"
+             << "SPAWN_TIME_MIN=0.02;\n"
+             << "BASE_POWERUP_PROB=0.3;\n"
+             << "PLAYER_HEALTH=1000000;\n"
+             << "BOSS_BASE_HEALTH=10;\n"
+             << "GRACE_PERIOD=1.0;\n"
+             << "MUSIC_VOLUME=0;\n"
+             << "EFFECTS_VOLUME=0;\n";
+    }
+    GameConfiguration gc{GameConfiguration::from_file(path)};
+    std::filesystem::remove(path);
+
+    BenchmarkNormalMode *normal_mode{new BenchmarkNormalMode{entities}};
+    GameState *state{normal_mode};
+    state->init(gc);
+    Player *player{normal_mode->get_benchmark_player()};
+
+    sf::RenderWindow window{sf::VideoMode{gc.get_window_size().x, gc.get_window_size().y}, "benchmark"};
+    ThreadPool pool{gc.get_data().worker_threads};
+    Context c{sf::seconds(1.f / 60.f), window};
+    c.set_thread_pool(&pool);
+    RenderSnapshot snapshot{};
+    NormalModeTimes times{0.0, 0.0, 0, 0};
+    std::chrono::duration<double, std::milli> update{};
+    std::chrono::duration<double, std::milli> render{};
+    for (unsigned int frame{0}; frame < frames; frame++)
+    {
+        if (frame % 6 == 0)
+        {
+            sf::Vector2f position{player->bounds().left + player->bounds().width / 2.f, player->bounds().top};
+            for (float angle : {-0.3f, 0.f, 0.3f})
+                c.spawn_projectile(position.x, position.y, -M_PI_2 + angle, 500.f, true);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        state->update(c);
+        auto middle = std::chrono::steady_clock::now();
+        snapshot.reset(window.getSize(), window.getView());
+        state->render(snapshot);
+        auto end = std::chrono::steady_clock::now();
+        update += middle - start;
+        render += end - middle;
+
+        if (state == normal_mode)
+            times.peak_objects = std::max(times.peak_objects, normal_mode->get_object_count());
+
+        // Switch state the way Game does. BossMode owns the NormalMode and
+        // hands it back once the boss is beaten.
+        if (GameState *next{c.get_next_state()})
+        {
+            if (dynamic_cast<BossMode *>(next))
+                times.boss_fights++;
+            else
+                delete state;
+            state = next;
+            state->init(gc);
+        }
+        c.end_frame();
+    }
+    delete state;
+    times.update = update.count();
+    times.render = render.count();
+    return times;
+}
+
+// Prints times only, nothing is checked. Opens a window, measure with the real
+// SFML.
+TEST_CASE("NormalMode storage benchmark", "[.][benchmark]")
+{
+    const unsigned int frames{3600};
+    for (bool entities : {false, true})
+    {
+        NormalModeTimes times{simulate_normal_mode(entities, frames)};
+        std::cout << (entities ? "entities" : "GameObjects") << ", " << frames << " frames: update "
+                  << times.update << " ms, render " << times.render << " ms, "
+                  << times.boss_fights << " boss fights, at most " << times.peak_objects
+                  << " objects" << std::endl;
+    }
+}
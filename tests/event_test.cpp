@@ -0,0 +1,218 @@
+#include "eventbus.hpp"
+#include "context.hpp"
+#include "gameconfiguration.hpp"
+#include "gameobject.hpp"
+#include "gamestate.hpp"
+#include "player.hpp"
+#include "powerup.hpp"
+#include "threadpool.hpp"
+#include "gamemodetest.hpp"
+
+#include <string>
+#include <vector>
+
+#include <catch.hpp>
+#include <SFML/Graphics.hpp>
+
+/**
+ * @brief GameObject publishing an EnemyKilled with its index every update.
+ * Objects are far apart, so they never collide.
+ */
+class PublishTestObject : public GameObject
+{
+public:
+    PublishTestObject(int index)
+        : m_index{index}
+    {
+    }
+
+    virtual ~PublishTestObject() = default;
+
+    virtual void update(Context &context) override
+    {
+        context.publish(EnemyKilled{sf::Vector2f{}, m_index});
+    }
+
+    virtual void render(RenderSnapshot &) const override
+    {
+        return;
+    }
+
+    virtual bool handle(const sf::Event &, Context &) override
+    {
+        return false;
+    }
+
+    virtual sf::FloatRect bounds() const override
+    {
+        return sf::FloatRect{m_index * 100.f, -1e6f, 1.f, 1.f};
+    }
+
+    virtual void collision(const GameObject *) override
+    {
+        return;
+    }
+
+private:
+    int m_index;
+};
+
+TEST_CASE("EventQueue")
+{
+    EventQueue<int> queue{3};
+    CHECK(queue.get_capacity() == 4);
+    CHECK(queue.is_empty());
+
+    // Events come out in the order they went in, also across the end of the
+    // ring.
+    std::vector<int> popped{};
+    for (int i{0}; i < 3; i++)
+        queue.push(i);
+    popped.push_back(queue.pop());
+    popped.push_back(queue.pop());
+    for (int i{3}; i < 6; i++)
+        queue.push(i);
+    CHECK(queue.get_capacity() == 4);
+    REQUIRE(queue.get_size() == 4);
+    CHECK(queue[0] == 2);
+    CHECK(queue[3] == 5);
+
+    // A full queue grows, keeping the order.
+    queue.push(6);
+    CHECK(queue.get_capacity() == 8);
+    while (!queue.is_empty())
+        popped.push_back(queue.pop());
+    CHECK(popped == std::vector<int>{0, 1, 2, 3, 4, 5, 6});
+
+    // Once grown, the memory is kept.
+    queue.push(7);
+    queue.clear();
+    CHECK(queue.is_empty());
+    CHECK(queue.get_capacity() == 8);
+}
+
+TEST_CASE("EventBus")
+{
+    EventBus bus{};
+    std::vector<std::string> delivered{};
+    bus.subscribe<LevelUp>([&delivered](const LevelUp &event)
+                           { delivered.push_back("level " + std::to_string(event.level)); });
+    bus.subscribe<EnemyKilled>([&delivered](const EnemyKilled &event)
+                               { delivered.push_back("killed " + std::to_string(event.score)); });
+    bus.subscribe<PlayerHit>([&delivered](const PlayerHit &event)
+                             { delivered.push_back("hit " + std::to_string(event.damage)); });
+    // Subscribers are called in the order they were added.
+    bus.subscribe<PlayerHit>([&delivered](const PlayerHit &)
+                             { delivered.push_back("hit again"); });
+    // Events published by a subscriber are delivered by the same dispatch.
+    bus.subscribe<BossDefeated>([&bus](const BossDefeated &event)
+                                { bus.publish(EnemyKilled{event.position, event.score}); });
+
+    bus.publish(LevelUp{2});
+    bus.publish(EnemyKilled{sf::Vector2f{}, 100});
+    bus.publish(PlayerHit{1});
+    bus.publish(EnemyKilled{sf::Vector2f{}, 200});
+    bus.publish(BossDefeated{sf::Vector2f{}, 2500});
+    CHECK(bus.get_size() == 5);
+    CHECK(bus.get_events<EnemyKilled>().get_size() == 2);
+
+    // Types are dispatched in a fixed order, events of a type in the order
+    // they were published.
+    bus.dispatch();
+    CHECK(delivered == std::vector<std::string>{"hit 1", "hit again", "killed 100", "killed 200",
+                                                "level 2", "killed 2500"});
+    CHECK(bus.get_size() == 0);
+
+    // Appending moves the events of another bus after the events already
+    // queued, without calling the subscribers of the other bus.
+    EventBus other{};
+    bool other_called{false};
+    other.subscribe<EnemyKilled>([&other_called](const EnemyKilled &)
+                                 { other_called = true; });
+    bus.publish(EnemyKilled{sf::Vector2f{}, 1});
+    other.publish(EnemyKilled{sf::Vector2f{}, 2});
+    other.publish(EnemyKilled{sf::Vector2f{}, 3});
+    bus.append(other);
+    CHECK(other.get_size() == 0);
+    delivered.clear();
+    bus.dispatch();
+    CHECK(delivered == std::vector<std::string>{"killed 1", "killed 2", "killed 3"});
+    CHECK_FALSE(other_called);
+
+    // Dropped events are not delivered.
+    bus.publish(PlayerHit{1});
+    bus.clear();
+    delivered.clear();
+    bus.dispatch();
+    CHECK(delivered.empty());
+}
+
+TEST_CASE("GameMode events")
+{
+    sf::RenderWindow window{};
+
+    SECTION("Events are dispatched in object order, also when updated in parallel")
+    {
+        ThreadPool pool{4};
+        std::vector<int> serial{}, parallel{};
+        for (ThreadPool *used : {static_cast<ThreadPool *>(nullptr), &pool})
+        {
+            std::vector<GameObject *> objects{};
+            for (int i{0}; i < 600; i++)
+                objects.push_back(new PublishTestObject{i});
+            GameModeTest mode{objects};
+            std::vector<int> &scores{used == nullptr ? serial : parallel};
+            mode.get_events().subscribe<EnemyKilled>([&scores](const EnemyKilled &event)
+                                                     { scores.push_back(event.score); });
+            Context context{sf::seconds(0.01f), window};
+            context.set_thread_pool(used);
+            mode.update(context);
+            CHECK(mode.get_events().get_size() == 0);
+        }
+        REQUIRE(serial.size() == 600);
+        CHECK(parallel == serial);
+        CHECK(serial.front() == 0);
+        CHECK(serial.back() == 599);
+    }
+
+    SECTION("The player keeps score and health through events")
+    {
+        PlayerData data{};
+        data.health = 3;
+        Player *player{new Player{data, 0.f, 0.f}};
+        GameModeTest mode{{player}, player};
+        int health{player->get_health()};
+
+        mode.get_events().publish(EnemyKilled{sf::Vector2f{}, 100});
+        mode.get_events().publish(BossDefeated{sf::Vector2f{}, 2500});
+        mode.get_events().publish(PlayerHit{1});
+        // Nothing happens until the events are dispatched by the update.
+        CHECK(player->get_score() == 0);
+        {
+            Context context{sf::seconds(0.01f), window};
+            mode.update(context);
+        }
+        CHECK(player->get_score() == 2600);
+        CHECK(player->get_kills() == 1);
+        CHECK(player->get_boss_kills() == 1);
+        CHECK(player->get_health() == health - 1);
+
+        // Picking up a power-up is published, and applied by the player.
+        mode.get_events().subscribe<PowerupCollected>([](const PowerupCollected &event)
+                                                      { CHECK(event.type == PowerUpType::Score); });
+        PowerUp *powerup{PowerUp::create(5, 0.f, 0.f, 0.f)};
+        REQUIRE(powerup->get_type() == PowerUpType::Score);
+        REQUIRE(powerup->bounds().intersects(player->bounds()));
+        {
+            Context context{sf::seconds(0.01f), window};
+            context.spawn_object(powerup);
+            mode.update(context);
+        }
+        {
+            Context context{sf::seconds(0.01f), window};
+            mode.update(context);
+        }
+        CHECK(player->get_score() == 4600);
+        CHECK(mode.get_objects().size() == 1);
+    }
+}
@@ -2,6 +2,10 @@
 #include "gameobject.hpp"
 
 #include "player.hpp"
+#include "powerup.hpp"
+#include "shockwave.hpp"
+#include "resourcemanager.hpp"
+#include "gamemodetest.hpp"
 
 #include <iostream>
 
@@ -9,105 +13,6 @@
 #include <SFML/Graphics.hpp>
 #include <SFML/Audio.hpp>
 
-/**
- * @brief Basic GamMode derived class for testing GameMode functions.
- *
- * @note All functions are public for testing purposes. They wrap the protected
- * functions of GameMode.
- */
-class GameModeTest : public GameMode
-{
-public:
-    GameModeTest(const std::vector<GameObject *> &objects) : GameMode{objects} {};
-    virtual ~GameModeTest() = default;
-
-    virtual void init(const GameConfiguration &) override
-    {
-        return;
-    }
-
-    void spawn_object(GameObject *object)
-    {
-        GameMode::spawn_object(object);
-        return;
-    }
-
-    void set_player(Player *player)
-    {
-        GameMode::set_player(player);
-        return;
-    }
-
-    void remove_player(bool delete_player)
-    {
-        GameMode::remove_player(delete_player);
-        return;
-    }
-
-    Player *get_player() const
-    {
-        return GameMode::get_player();
-    }
-
-    void clear_objects(bool delete_player)
-    {
-        GameMode::clear_objects(delete_player);
-        return;
-    }
-
-    void set_music(const std::string &path, float volume = 100.0f)
-    {
-        GameMode::set_music(path, volume);
-        return;
-    }
-
-    void play_music()
-    {
-        GameMode::play_music();
-        return;
-    }
-
-    void pause_music()
-    {
-        GameMode::pause_music();
-        return;
-    }
-
-    void loop_music(bool loop)
-    {
-        GameMode::loop_music(loop);
-        return;
-    }
-
-    void fade_out_music(float duration)
-    {
-        GameMode::fade_out_music(duration);
-        return;
-    }
-
-    void fade_in_music(float duration, float target_volume = 100.0f)
-    {
-        GameMode::fade_in_music(duration, target_volume);
-        return;
-    }
-
-    void set_music_volume(float volume)
-    {
-        GameMode::set_music_volume(volume);
-        return;
-    }
-
-    const std::vector<GameObject *> &get_objects() const
-    {
-        return GameMode::get_objects();
-    }
-
-    sf::Music &get_music()
-    {
-        return GameMode::get_music();
-    }
-};
-
 /**
  * @brief Basic GameObject derived class for testing GameMode functions.
  */
@@ -144,7 +49,7 @@ public:
         return;
     }
 
-    virtual void render(sf::RenderWindow &) const override
+    virtual void render(RenderSnapshot &) const override
     {
         if (m_info)
         {
@@ -235,7 +140,7 @@ public:
         return;
     }
 
-    virtual void render(sf::RenderWindow &) const override
+    virtual void render(RenderSnapshot &) const override
     {
         if (m_info)
             std::cout << "\tSpawnerTestObject '" << m_id << "' rendered" << std::endl;
@@ -311,7 +216,7 @@ public:
         return;
     }
 
-    virtual void render(sf::RenderWindow &) const override
+    virtual void render(RenderSnapshot &) const override
     {
         if (m_info)
             std::cout << "\tCollisionTestObject '" << m_id << "' rendered" << std::endl;
@@ -362,6 +267,61 @@ private:
 
 unsigned int CollisionTestObject::object_count = 0;
 
+/**
+ * @brief Enemy with fixed bounds that adds up damage from friendly projectiles.
+ */
+class EnemyTestObject : public GameObject
+{
+public:
+    EnemyTestObject(const sf::FloatRect &bounds) : m_bounds{bounds}, m_damage{0} {};
+    virtual ~EnemyTestObject() = default;
+
+    virtual void update(Context &) override
+    {
+        return;
+    }
+
+    virtual void render(RenderSnapshot &) const override
+    {
+        return;
+    }
+
+    virtual bool handle(const sf::Event &, Context &) override
+    {
+        return false;
+    }
+
+    virtual sf::FloatRect bounds() const override
+    {
+        return m_bounds;
+    }
+
+    virtual CollisionLayer get_layer() const override
+    {
+        return CollisionLayer::Enemy;
+    }
+
+    virtual void collision(const GameObject *) override
+    {
+        return;
+    }
+
+    virtual void projectile_hit(const ProjectileHit &hit) override
+    {
+        if (hit.friendly)
+            m_damage += hit.damage;
+    }
+
+    int get_damage() const
+    {
+        return m_damage;
+    }
+
+private:
+    sf::FloatRect m_bounds;
+    int m_damage;
+};
+
 /**
  * @brief Simulate a number of frames. Helper function for testing.
  *
@@ -373,10 +333,12 @@ void simulate_frames(GameMode &gm, unsigned int frames)
     // Create window and context. Needed to use GameMode functions.
     sf::RenderWindow window{};
     Context c{sf::Time::Zero, window};
+    RenderSnapshot snapshot{};
     for (unsigned int i = 0; i < frames; i++)
     {
         gm.update(c);
-        gm.render(window);
+        snapshot.reset(window.getSize(), window.getView());
+        gm.render(snapshot);
         gm.handle(sf::Event{}, c);
     }
 }
@@ -556,6 +518,98 @@ TEST_CASE("Combination of player and objects")
     }
 }
 
+TEST_CASE("Shockwave")
+{
+    // The ring grows 50 pixels per frame from (400, 300).
+    EnemyTestObject *near{new EnemyTestObject{sf::FloatRect{420.f, 295.f, 10.f, 10.f}}};
+    EnemyTestObject *far{new EnemyTestObject{sf::FloatRect{1000.f, 295.f, 10.f, 10.f}}};
+    Shockwave *shockwave{new Shockwave{400.f, 300.f, true, 2}};
+    GameModeTest gm{{near, far, shockwave}};
+    sf::RenderWindow window{};
+    Context c{sf::seconds(0.1f), window};
+
+    // Objects are hit the frame they are first updated.
+    gm.update(c);
+    CHECK(shockwave->get_radius() == Approx(50.f));
+    CHECK(near->get_damage() == 2);
+
+    // Objects spawned between two frames are hit in the next one.
+    EnemyTestObject *spawned{new EnemyTestObject{sf::FloatRect{475.f, 295.f, 10.f, 10.f}}};
+    gm.spawn_object(spawned);
+    gm.update(c);
+    CHECK(spawned->get_damage() == 2);
+
+    // Every target is hit once, the ring is removed once it has passed the
+    // farthest corner of the window.
+    for (int i{0}; i < 10; i++)
+    {
+        gm.update(c);
+    }
+    CHECK(near->get_damage() == 2);
+    CHECK(spawned->get_damage() == 2);
+    CHECK(far->get_damage() == 0);
+    CHECK(gm.get_objects().size() == 3);
+}
+
+TEST_CASE("Objects by kind")
+{
+    Player player{{}, 0.f, 0.f};
+    PowerUp *nuke{PowerUp::create(6, 400.f, -100.f, 10.f)};
+    Shockwave shockwave{0.f, 0.f, true, 1};
+    TestObject other{};
+    CHECK(player.get_kind() == ObjectKind::Player);
+    CHECK(nuke->get_kind() == ObjectKind::PowerUp);
+    CHECK(shockwave.get_kind() == ObjectKind::Shockwave);
+    CHECK(other.get_kind() == ObjectKind::Other);
+
+    GameModeTest gm{{nuke}};
+    sf::RenderWindow window{};
+    Context c{sf::seconds(0.1f), window};
+
+    // Power-ups are updated in a loop of their own.
+    gm.update(c);
+    CHECK(nuke->m_sprite.getPosition().y == Approx(-99.f));
+
+    // A Nuke the player touched fires a shockwave on its next update.
+    nuke->collision(&player);
+    CHECK_FALSE(nuke->is_removed());
+    gm.update(c);
+    CHECK(nuke->is_removed());
+    gm.update(c);
+    REQUIRE(gm.get_objects().size() == 1);
+    GameObject *spawned{gm.get_objects()[0]};
+    REQUIRE(spawned->get_kind() == ObjectKind::Shockwave);
+    CHECK(static_cast<Shockwave *>(spawned)->get_radius() == Approx(50.f));
+    gm.update(c);
+    CHECK(static_cast<Shockwave *>(spawned)->get_radius() == Approx(100.f));
+}
+
+TEST_CASE("Render snapshot")
+{
+    GameModeTest gm{{new TestObject{1, false}}};
+    RenderSnapshot snapshot{};
+    snapshot.reset({800, 600}, sf::View{});
+    gm.render(snapshot);
+    CHECK(snapshot.get_size() == sf::Vector2u{800, 600});
+    CHECK(snapshot.get_draw_count() == 1); // Only background, TestObject draws nothing.
+    snapshot.reset({800, 600}, sf::View{});
+    CHECK(snapshot.get_draw_count() == 0); // Reset removes everything drawn.
+
+    // Texts are drawn with a font of their own, never the simulation's.
+    sf::Font &font{ResourceManager::load_font("assets/font/Aquire.otf")};
+    CHECK(&ResourceManager::get_render_font(font) != &font);
+    CHECK(&ResourceManager::get_render_font(font) == &ResourceManager::get_render_font(font));
+    sf::Font unknown{};
+    CHECK(&ResourceManager::get_render_font(unknown) == &unknown);
+    sf::Text text{"score", font};
+    snapshot.draw(text);
+    CHECK(text.getFont() == &font);
+    CHECK(snapshot.get_draw_count() == 1);
+    // Texts without a font draw nothing and are left out.
+    snapshot.draw(sf::Text{});
+    CHECK(snapshot.get_draw_count() == 1);
+}
+
 // This test will play music in different ways and check if the status is correct.
 TEST_CASE("MUSIC")
 {
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "gamestate.hpp"
+#include "player.hpp"
+
+#include <string>
+#include <vector>
+
+#include <SFML/Audio.hpp>
+
+/**
+ * @brief Basic GamMode derived class for testing GameMode functions. Shared by
+ * all tests that need a game mode.
+ *
+ * @note All functions are public for testing purposes. They wrap the protected
+ * functions of GameMode.
+ */
+class GameModeTest : public GameMode
+{
+public:
+    GameModeTest() : GameMode{} {};
+    GameModeTest(const std::vector<GameObject *> &objects, Player *player = nullptr)
+        : GameMode{objects, player} {};
+    virtual ~GameModeTest() = default;
+
+    virtual void init(const GameConfiguration &) override
+    {
+        return;
+    }
+
+    ObjectHandle spawn_object(GameObject *object)
+    {
+        return GameMode::spawn_object(object);
+    }
+
+    void set_player(Player *player)
+    {
+        GameMode::set_player(player);
+        return;
+    }
+
+    void remove_player(bool delete_player)
+    {
+        GameMode::remove_player(delete_player);
+        return;
+    }
+
+    Player *get_player() const
+    {
+        return GameMode::get_player();
+    }
+
+    void delete_removed_objects()
+    {
+        GameMode::delete_removed_objects();
+        return;
+    }
+
+    void clear_objects(bool delete_player)
+    {
+        GameMode::clear_objects(delete_player);
+        return;
+    }
+
+    // Same as update(...) but without the collision check, which would
+    // otherwise dominate the parallel benchmark.
+    void update_without_collision(Context &context)
+    {
+        update_objects(context);
+        GameMode::delete_removed_objects();
+        spawn_new_objects(context);
+    }
+
+    void set_music(const std::string &path, float volume = 100.0f)
+    {
+        GameMode::set_music(path, volume);
+        return;
+    }
+
+    void play_music()
+    {
+        GameMode::play_music();
+        return;
+    }
+
+    void pause_music()
+    {
+        GameMode::pause_music();
+        return;
+    }
+
+    void loop_music(bool loop)
+    {
+        GameMode::loop_music(loop);
+        return;
+    }
+
+    void fade_out_music(float duration)
+    {
+        GameMode::fade_out_music(duration);
+        return;
+    }
+
+    void fade_in_music(float duration, float target_volume = 100.0f)
+    {
+        GameMode::fade_in_music(duration, target_volume);
+        return;
+    }
+
+    void set_music_volume(float volume)
+    {
+        GameMode::set_music_volume(volume);
+        return;
+    }
+
+    const std::vector<GameObject *> &get_objects() const
+    {
+        return GameMode::get_objects();
+    }
+
+    sf::Music &get_music()
+    {
+        return GameMode::get_music();
+    }
+
+    TimerWheel &get_timers()
+    {
+        return GameMode::get_timers();
+    }
+
+    EventBus &get_events()
+    {
+        return GameMode::get_events();
+    }
+
+    EntityWorld &get_entities()
+    {
+        return GameMode::get_entities();
+    }
+};
@@ -0,0 +1,127 @@
+#include "handletable.hpp"
+#include "gamestate.hpp"
+#include "gameobject.hpp"
+#include "player.hpp"
+#include "gamemodetest.hpp"
+
+#include <catch.hpp>
+#include <SFML/Graphics.hpp>
+
+/**
+ * @brief GameObject that does nothing, far away from everything else.
+ */
+class HandleTestObject : public GameObject
+{
+public:
+    HandleTestObject() = default;
+    virtual ~HandleTestObject() = default;
+
+    virtual void update(Context &) override
+    {
+        return;
+    }
+
+    virtual void render(RenderSnapshot &) const override
+    {
+        return;
+    }
+
+    virtual bool handle(const sf::Event &, Context &) override
+    {
+        return false;
+    }
+
+    virtual sf::FloatRect bounds() const override
+    {
+        return sf::FloatRect{-1e6f, -1e6f, 1.f, 1.f};
+    }
+
+    virtual void collision(const GameObject *) override
+    {
+        return;
+    }
+};
+
+TEST_CASE("HandleTable")
+{
+    HandleTable table{};
+    CHECK(Handle{}.is_null());
+    CHECK_FALSE(table.contains(Handle{}));
+    CHECK(table.get_index(Handle{}) == HandleTable::s_no_index);
+
+    Handle a{table.insert(0)};
+    Handle b{table.insert(1)};
+    Handle c{table.insert(2)};
+    CHECK_FALSE(a.is_null());
+    CHECK(a != b);
+    CHECK(table.get_size() == 3);
+    CHECK(table.get_index(b) == 1);
+
+    // Removing the first element moves the last one into its place.
+    CHECK(table.erase(a));
+    table.move(c, 0);
+    CHECK(table.get_index(c) == 0);
+    CHECK(table.get_index(b) == 1);
+    CHECK_FALSE(table.contains(a));
+    CHECK_FALSE(table.erase(a));
+    CHECK_THROWS_AS(table.move(a, 1), std::logic_error);
+
+    // A reused slot does not bring old handles back.
+    Handle d{table.insert(2)};
+    CHECK(d.index == a.index);
+    CHECK(d != a);
+    CHECK_FALSE(table.contains(a));
+    CHECK(table.get_index(d) == 2);
+
+    table.clear();
+    CHECK(table.get_size() == 0);
+    CHECK_FALSE(table.contains(b));
+    CHECK_FALSE(table.contains(d));
+    Handle e{table.insert(0)};
+    CHECK(e != b);
+    CHECK(e != c);
+    CHECK(e != d);
+}
+
+TEST_CASE("GameMode handles")
+{
+    PlayerData data{};
+    data.health = 3;
+    Player *player{new Player{data, 0.f, 0.f}};
+    GameModeTest gm{{player}, player};
+    CHECK(gm.get_object(ObjectHandle{}) == nullptr);
+
+    std::vector<GameObject *> objects{};
+    std::vector<ObjectHandle> handles{};
+    for (int i{0}; i < 6; i++)
+    {
+        objects.push_back(new HandleTestObject{});
+        handles.push_back(gm.spawn_object(objects.back()));
+    }
+    for (std::size_t i{0}; i < objects.size(); i++)
+        CHECK(gm.get_object(handles[i]) == objects[i]);
+
+    // Deleted objects are compacted away, the rest are still found by handle.
+    objects[0]->remove();
+    objects[3]->remove();
+    gm.delete_removed_objects();
+    CHECK(gm.get_objects().size() == 5);
+    CHECK(gm.get_object(handles[0]) == nullptr);
+    CHECK(gm.get_object(handles[3]) == nullptr);
+    for (std::size_t i : {1, 2, 4, 5})
+        CHECK(gm.get_object(handles[i]) == objects[i]);
+    CHECK(gm.get_player() == player);
+
+    // New objects reuse the slots, but not the handles.
+    ObjectHandle reused{gm.spawn_object(new HandleTestObject{})};
+    CHECK(reused.index == handles[3].index);
+    CHECK(gm.get_object(handles[3]) == nullptr);
+    CHECK(gm.get_object(reused) != nullptr);
+
+    // Clearing keeps the player but drops every old handle.
+    gm.clear_objects(false);
+    CHECK(gm.get_objects().size() == 1);
+    CHECK(gm.get_player() == player);
+    CHECK(gm.get_object(reused) == nullptr);
+    CHECK(gm.get_object(handles[5]) == nullptr);
+}
@@ -0,0 +1,342 @@
+#include "gamestate.hpp"
+#include "gameobject.hpp"
+#include "threadpool.hpp"
+#include "taskgraph.hpp"
+#include "profiler.hpp"
+#include "renderbatch.hpp"
+#include "rendersnapshot.hpp"
+#include "gamemodetest.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include <catch.hpp>
+#include <SFML/Graphics.hpp>
+
+/**
+ * @brief GameObject doing some work every update. Spawns a child every few
+ * frames, the child value only depends on the parent. Position and collisions
+ * depend on the value.
+ */
+class WorkTestObject : public GameObject
+{
+public:
+    WorkTestObject(unsigned int value, unsigned int lifetime)
+        : m_value{value},
+          m_lifetime{lifetime},
+          m_update_count{0}
+    {
+    }
+
+    virtual ~WorkTestObject() = default;
+
+    virtual void update(Context &context) override
+    {
+        // Some busy work to make the update cost something.
+        float sum{0.f};
+        for (unsigned int i{0}; i < 200; i++)
+        {
+            sum += std::sin(static_cast<float>(m_value + i));
+        }
+        m_value = m_value * 1664525u + 1013904223u + (sum > 0.f ? 1u : 0u);
+
+        if (m_update_count % 4 == 0)
+            context.spawn_object(new WorkTestObject{m_value, 6});
+
+        if (m_update_count >= m_lifetime)
+            remove();
+        m_update_count++;
+    }
+
+    virtual void render(RenderSnapshot &) const override
+    {
+        return;
+    }
+
+    virtual bool render_batched(RenderBatch &batch) const override
+    {
+        // Every third object is not batched, the rest use two layers.
+        if (m_value % 3 == 0)
+            return false;
+        sf::RectangleShape rectangle{sf::Vector2f{8.f, 8.f}};
+        rectangle.setPosition(bounds().left, bounds().top);
+        batch.add_rectangle(rectangle, m_value % 2);
+        return true;
+    }
+
+    virtual bool handle(const sf::Event &, Context &) override
+    {
+        return false;
+    }
+
+    virtual sf::FloatRect bounds() const override
+    {
+        float x{static_cast<float>(m_value % 400)};
+        float y{static_cast<float>((m_value / 400) % 400)};
+        return sf::FloatRect{x, y, 8.f, 8.f};
+    }
+
+    virtual void collision(const GameObject *other) override
+    {
+        // Depends on the order collisions are resolved in.
+        const WorkTestObject *object{dynamic_cast<const WorkTestObject *>(other)};
+        m_value = m_value * 31u + object->get_value();
+    }
+
+    unsigned int get_value() const { return m_value; }
+
+private:
+    unsigned int m_value;
+    unsigned int m_lifetime;
+    unsigned int m_update_count;
+};
+
+/**
+ * @brief Create a game mode with the given number of WorkTestObjects.
+ */
+std::vector<GameObject *> create_work_objects(unsigned int count)
+{
+    std::vector<GameObject *> objects{};
+    for (unsigned int i{0}; i < count; i++)
+    {
+        objects.push_back(new WorkTestObject{i, 20 + i % 7});
+    }
+    return objects;
+}
+
+/**
+ * @brief Simulate frames with an optional thread pool and return the values of
+ * all objects in order.
+ */
+std::vector<unsigned int> simulate_work(
+    unsigned int count, unsigned int frames, ThreadPool *pool, bool collision = true)
+{
+    GameModeTest gm{create_work_objects(count)};
+    sf::RenderWindow window{};
+    Context c{sf::Time::Zero, window};
+    c.set_thread_pool(pool);
+    for (unsigned int i{0}; i < frames; i++)
+    {
+        if (collision)
+            gm.update(c);
+        else
+            gm.update_without_collision(c);
+    }
+
+    std::vector<unsigned int> values{};
+    for (const GameObject *object : gm.get_objects())
+    {
+        values.push_back(dynamic_cast<const WorkTestObject *>(object)->get_value());
+    }
+    return values;
+}
+
+TEST_CASE("ThreadPool parallel_for")
+{
+    ThreadPool pool{3};
+    CHECK(pool.get_thread_count() == 4);
+
+    // Every item is visited exactly once.
+    std::vector<int> visits(1000, 0);
+    pool.parallel_for(visits.size(), 64, [&visits](std::size_t, std::size_t begin, std::size_t end)
+                      {
+                          for (std::size_t i{begin}; i < end; i++)
+                              visits[i]++;
+                      });
+    CHECK(std::count(visits.begin(), visits.end(), 1) == 1000);
+
+    // Queues grow when more tasks are queued than they have room for, also
+    // from inside a task.
+    std::vector<std::size_t> chunks(1000, 0);
+    std::vector<int> nested(200, 0);
+    pool.parallel_for(chunks.size(), 1, [&chunks, &nested, &pool](std::size_t chunk, std::size_t begin, std::size_t)
+                      {
+                          chunks[begin] = chunk;
+                          if (chunk == 0)
+                          {
+                              pool.parallel_for(nested.size(), 1, [&nested](std::size_t, std::size_t begin, std::size_t)
+                                                { nested[begin]++; });
+                          }
+                      });
+    for (std::size_t i{0}; i < chunks.size(); i++)
+        REQUIRE(chunks[i] == i);
+    CHECK(std::count(nested.begin(), nested.end(), 1) == 200);
+
+    // Exceptions are passed on to the caller.
+    CHECK_THROWS_AS(pool.parallel_for(10, 1, [](std::size_t chunk, std::size_t, std::size_t)
+                                      {
+                                          if (chunk == 5)
+                                              throw std::logic_error("error");
+                                      }),
+                    std::logic_error);
+}
+
+TEST_CASE("TaskGraph")
+{
+    ThreadPool pool{3};
+    for (ThreadPool *p : {static_cast<ThreadPool *>(nullptr), &pool})
+    {
+        // Diamond: a -> (b, c) -> d, e has no dependencies.
+        std::atomic<int> a{0}, b{0}, c{0}, d{0}, e{0};
+        TaskGraph graph{};
+        TaskGraph::TaskId ta{graph.add_task("test.a", [&a]
+                                            { a = 1; })};
+        TaskGraph::TaskId tb{graph.add_task("test.b", [&a, &b]
+                                            { b = a + 1; }, {ta})};
+        TaskGraph::TaskId tc{graph.add_task("test.c", [&a, &c]
+                                            { c = a + 2; }, {ta})};
+        graph.add_task("test.d", [&b, &c, &d]
+                       { d = b + c; }, {tb, tc});
+        graph.add_task("test.e", [&e]
+                       { e = 5; });
+        CHECK(graph.get_task_count() == 5);
+
+        graph.run(p);
+        CHECK(d == 5);
+        CHECK(e == 5);
+
+        // Graph can be run again.
+        a = 0;
+        graph.run(p);
+        CHECK(d == 5);
+    }
+
+    // Every run is recorded in the profiler.
+    CHECK(Profiler::get_entry("test.d").samples == 4);
+    CHECK(Profiler::get_entry("not.recorded").samples == 0);
+
+    // Only earlier tasks can be dependencies.
+    TaskGraph graph{};
+    CHECK_THROWS_AS(graph.add_task("test.f", [] {}, {0}), std::logic_error);
+
+    // Exceptions are passed on, dependents are skipped and independent tasks
+    // still run.
+    bool skipped{true};
+    std::atomic<int> independent{0};
+    TaskGraph::TaskId tg{graph.add_task("test.g", []
+                                        { throw std::logic_error("error"); })};
+    TaskGraph::TaskId th{graph.add_task("test.h", [&skipped]
+                                        { skipped = false; }, {tg})};
+    graph.add_task("test.i", [&skipped]
+                   { skipped = false; }, {th});
+    graph.add_task("test.j", [&independent]
+                   { independent++; });
+    for (ThreadPool *p : {static_cast<ThreadPool *>(nullptr), &pool})
+    {
+        CHECK_THROWS_AS(graph.run(p), std::logic_error);
+    }
+    CHECK(skipped);
+    CHECK(independent == 2);
+}
+
+TEST_CASE("Parallel update gives same result as serial update")
+{
+    ThreadPool pool{3};
+    std::vector<unsigned int> serial{simulate_work(1000, 10, nullptr)};
+    std::vector<unsigned int> parallel{simulate_work(1000, 10, &pool)};
+    CHECK(serial.size() > 1000);
+    CHECK(serial == parallel);
+
+    // WorkTestObject has no transform, so every object is recomputed.
+    CHECK(Profiler::get_counter("bounds.recomputed").max >= 1000);
+}
+
+/**
+ * @brief Render the game mode after some frames and return the vertices of all
+ * batches, in draw order.
+ */
+std::vector<std::vector<sf::Vertex>> render_work(unsigned int count, ThreadPool *pool)
+{
+    GameModeTest gm{create_work_objects(count)};
+    sf::RenderWindow window{};
+    Context c{sf::Time::Zero, window};
+    c.set_thread_pool(pool);
+    gm.update(c);
+
+    RenderSnapshot snapshot{};
+    snapshot.reset(window.getSize(), window.getView());
+    gm.render(snapshot);
+
+    std::vector<std::vector<sf::Vertex>> batches{};
+    for (std::size_t i{0}; i < snapshot.get_batch_count(); i++)
+    {
+        const sf::Vertex *vertices{snapshot.get_batch_vertices(i)};
+        batches.emplace_back(vertices, vertices + snapshot.get_batch_size(i));
+    }
+    return batches;
+}
+
+TEST_CASE("RenderBatch")
+{
+    sf::Texture texture{};
+    sf::Sprite sprite{texture};
+    sf::RectangleShape rectangle{sf::Vector2f{4.f, 4.f}};
+
+    RenderBatch batch{};
+    batch.add_sprite(sprite);
+    batch.add_rectangle(rectangle, 1);
+    batch.add_sprite(sprite);
+    batch.add_unbatched(nullptr);
+
+    // Sprites share one group, two triangles each.
+    REQUIRE(batch.get_group_count() == 2);
+    CHECK(batch.get_group(0).texture == &texture);
+    CHECK(batch.get_group(0).vertices.size() == 12);
+    CHECK(batch.get_group(0).segment == 0);
+    CHECK(batch.get_group(1).layer == 1);
+    CHECK(batch.get_group(1).texture == nullptr);
+    CHECK(batch.get_unbatched().size() == 1);
+
+    // Sprites after the unbatched object are drawn after it, in a new group.
+    batch.add_sprite(sprite);
+    REQUIRE(batch.get_group_count() == 3);
+    CHECK(batch.get_group(2).texture == &texture);
+    CHECK(batch.get_group(2).segment == 1);
+
+    batch.clear();
+    CHECK(batch.get_group_count() == 0);
+    CHECK(batch.get_unbatched().empty());
+}
+
+TEST_CASE("Parallel render list gives same result as serial render list")
+{
+    ThreadPool pool{3};
+    std::vector<std::vector<sf::Vertex>> serial{render_work(1000, nullptr)};
+    std::vector<std::vector<sf::Vertex>> parallel{render_work(1000, &pool)};
+
+    // Rectangles have no texture, so one batch per layer between every two
+    // unbatched objects. Chunk boundaries do not split batches.
+    REQUIRE(serial.size() > 2);
+    REQUIRE(parallel.size() == serial.size());
+    for (std::size_t i{0}; i < serial.size(); i++)
+    {
+        REQUIRE(serial[i].size() == parallel[i].size());
+        CHECK(std::equal(serial[i].begin(), serial[i].end(), parallel[i].begin(),
+                         [](const sf::Vertex &lhs, const sf::Vertex &rhs)
+                         { return lhs.position == rhs.position && lhs.color == rhs.color; }));
+    }
+    CHECK(Profiler::get_entry("render.build").samples >= 2);
+}
+
+TEST_CASE("Parallel update benchmark", "[.][benchmark]")
+{
+    ThreadPool pool{};
+    for (unsigned int count : {1000u, 10000u, 50000u})
+    {
+        auto start = std::chrono::steady_clock::now();
+        simulate_work(count, 5, nullptr, false);
+        auto middle = std::chrono::steady_clock::now();
+        simulate_work(count, 5, &pool, false);
+        auto end = std::chrono::steady_clock::now();
+
+        std::chrono::duration<double, std::milli> serial{middle - start};
+        std::chrono::duration<double, std::milli> parallel{end - middle};
+        std::cout << count << " objects, 5 frames: serial " << serial.count()
+                  << " ms, parallel (" << pool.get_thread_count() << " threads) "
+                  << parallel.count() << " ms" << std::endl;
+    }
+}
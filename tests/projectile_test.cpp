@@ -0,0 +1,239 @@
+#include "projectilesystem.hpp"
+#include "gameobject.hpp"
+#include "profiler.hpp"
+#include "rendersnapshot.hpp"
+
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <vector>
+
+#include <catch.hpp>
+#include <SFML/Graphics.hpp>
+
+/**
+ * @brief GameObject with fixed bounds that counts projectile hits.
+ */
+class TargetTestObject : public GameObject
+{
+public:
+    TargetTestObject(const sf::FloatRect &bounds)
+        : m_bounds{bounds},
+          m_hits{0},
+          m_enemy_damage{0}
+    {
+    }
+
+    virtual ~TargetTestObject() = default;
+
+    virtual void update(Context &) override
+    {
+        return;
+    }
+
+    virtual void render(RenderSnapshot &) const override
+    {
+        return;
+    }
+
+    virtual bool handle(const sf::Event &, Context &) override
+    {
+        return false;
+    }
+
+    virtual sf::FloatRect bounds() const override
+    {
+        return m_bounds;
+    }
+
+    virtual void collision(const GameObject *) override
+    {
+        return;
+    }
+
+    virtual void projectile_hit(const ProjectileHit &hit) override
+    {
+        m_hits++;
+        if (!hit.friendly)
+            m_enemy_damage += hit.damage;
+    }
+
+    int get_hits() const { return m_hits; }
+    int get_enemy_damage() const { return m_enemy_damage; }
+
+private:
+    sf::FloatRect m_bounds;
+    int m_hits;
+    int m_enemy_damage;
+};
+
+TEST_CASE("ProjectileSystem update")
+{
+    // 13 projectiles in a column, moving right.
+    ProjectileSystem projectiles{};
+    for (int i{0}; i < 13; i++)
+    {
+        projectiles.spawn(ProjectileSpawn{100.f, 10.f * i, 0.f, 100.f, true, 1});
+    }
+    // Leaves the window to the left.
+    projectiles.spawn(ProjectileSpawn{0.f, 50.f, static_cast<float>(M_PI), 100.f, false, 2});
+    REQUIRE(projectiles.get_count() == 14);
+
+    projectiles.update(0.5f, sf::Vector2u{400, 400});
+    for (std::size_t i{0}; i < 13; i++)
+    {
+        CHECK(projectiles.get_position(i).x == Approx(150.f));
+        CHECK(projectiles.get_position(i).y == Approx(10.f * i));
+        CHECK(projectiles.is_alive(i));
+    }
+    CHECK(projectiles.get_position(13).x == Approx(-50.f));
+    CHECK_FALSE(projectiles.is_alive(13));
+
+    // Dead projectiles are removed, the others keep their order.
+    projectiles.remove_dead();
+    REQUIRE(projectiles.get_count() == 13);
+    CHECK(projectiles.get_position(12).y == Approx(120.f));
+    CHECK(projectiles.is_friendly(12));
+    CHECK(projectiles.get_damage(12) == 1);
+
+    // All projectiles are drawn as one batch, six vertices each.
+    RenderSnapshot snapshot{};
+    projectiles.render(snapshot);
+    CHECK(snapshot.get_draw_count() == 1);
+    CHECK(snapshot.get_batch_size(0) == 13 * 6);
+
+    projectiles.clear();
+    CHECK(projectiles.get_count() == 0);
+}
+
+TEST_CASE("ProjectileSystem collision")
+{
+    TargetTestObject target{sf::FloatRect{-10.f, -10.f, 20.f, 20.f}};
+    TargetTestObject empty{sf::FloatRect{0.f, 0.f, 0.f, 0.f}};
+    std::vector<GameObject *> objects{&target, &empty};
+    target.refresh_bounds();
+    empty.refresh_bounds();
+    Profiler::reset();
+
+    ProjectileSystem projectiles{};
+    // Enemy projectile and friendly projectile inside the target.
+    projectiles.spawn(ProjectileSpawn{0.f, 0.f, 0.f, 0.f, false, 2});
+    projectiles.spawn(ProjectileSpawn{5.f, 5.f, 0.f, 0.f, true, 1});
+    // Bounds only touch the target.
+    projectiles.spawn(ProjectileSpawn{13.f, 0.f, 0.f, 0.f, false, 1});
+    // Far away from the target.
+    projectiles.spawn(ProjectileSpawn{1000.f, 1000.f, 0.f, 0.f, false, 1});
+
+    projectiles.collide(objects);
+    CHECK(target.get_hits() == 2);
+    CHECK(target.get_enemy_damage() == 2);
+    // Objects without size are never hit.
+    CHECK(empty.get_hits() == 0);
+    // Only ships remove projectiles.
+    CHECK(projectiles.is_alive(0));
+    // The projectile far away is not in a cell the target covers.
+    CHECK(Profiler::get_counter("projectiles.candidates").last == 3);
+    Profiler::reset();
+}
+
+TEST_CASE("ProjectileSystem swept collision")
+{
+    // Thin wall, narrower than the distance a projectile moves in one frame.
+    TargetTestObject wall{sf::FloatRect{100.f, 0.f, 2.f, 400.f}};
+    std::vector<GameObject *> objects{&wall};
+    wall.refresh_bounds();
+    Profiler::reset();
+
+    ProjectileSystem projectiles{};
+    // Jumps from x = 50 to x = 150 through the wall.
+    projectiles.spawn(ProjectileSpawn{50.f, 200.f, 0.f, 1000.f, false, 1});
+    // Passes above the wall.
+    projectiles.spawn(ProjectileSpawn{50.f, -8.f, 0.f, 1000.f, false, 1});
+    // Leaves the window through the wall, still hits on the way out.
+    projectiles.spawn(ProjectileSpawn{90.f, 390.f, 0.f, 1000.f, false, 1});
+    // Ends inside the wall, a normal hit.
+    projectiles.spawn(ProjectileSpawn{0.f, 300.f, 0.f, 1000.f, false, 1});
+    projectiles.update(0.1f, sf::Vector2u{160, 400});
+    CHECK(projectiles.get_position(0).x == Approx(150.f));
+    CHECK_FALSE(projectiles.is_alive(2));
+
+    projectiles.collide(objects);
+    CHECK(wall.get_hits() == 3);
+    CHECK(Profiler::get_counter("projectiles.hits").last == 3);
+    CHECK(Profiler::get_counter("projectiles.swept_hits").last == 2);
+
+    // Without moving only the projectile inside the wall hits again.
+    projectiles.remove_dead();
+    REQUIRE(projectiles.get_count() == 3);
+    projectiles.update(0.f, sf::Vector2u{400, 400});
+    projectiles.collide(objects);
+    CHECK(wall.get_hits() == 4);
+    CHECK(Profiler::get_counter("projectiles.swept_hits").last == 0);
+    Profiler::reset();
+}
+
+TEST_CASE("ProjectileSystem kill in ring")
+{
+    ProjectileSystem projectiles{};
+    // Enemy projectiles at distance 0, 10, 20 and 30 from the centre.
+    for (int i{0}; i < 4; i++)
+    {
+        projectiles.spawn(ProjectileSpawn{10.f * i, 0.f, 0.f, 0.f, false, 1});
+    }
+    // Friendly projectile inside the ring.
+    projectiles.spawn(ProjectileSpawn{0.f, 15.f, 0.f, 0.f, true, 1});
+
+    CHECK(projectiles.kill_in_ring(sf::Vector2f{}, 10.f, 20.f, false) == 1);
+    CHECK(projectiles.is_alive(0));
+    CHECK(projectiles.is_alive(1));
+    CHECK_FALSE(projectiles.is_alive(2));
+    CHECK(projectiles.is_alive(3));
+    CHECK(projectiles.is_alive(4));
+
+    // A negative inner radius includes the centre. Dead projectiles are not
+    // killed twice.
+    CHECK(projectiles.kill_in_ring(sf::Vector2f{}, -1.f, 20.f, false) == 2);
+    CHECK(projectiles.kill_in_ring(sf::Vector2f{}, 0.f, 100.f, true) == 1);
+    CHECK(projectiles.kill_in_ring(sf::Vector2f{}, 20.f, 10.f, false) == 0);
+    projectiles.remove_dead();
+    CHECK(projectiles.get_count() == 1);
+}
+
+TEST_CASE("ProjectileSystem expiry")
+{
+    Profiler::reset();
+    ProjectileSystem projectiles{};
+    // Spawned left of the window and flies in, leaves at x = 410 after 4.6 s.
+    projectiles.spawn(ProjectileSpawn{-50.f, 100.f, 0.f, 100.f, true, 1});
+    // Standing still in the window, never expires.
+    projectiles.spawn(ProjectileSpawn{10.f, 10.f, 0.f, 0.f, true, 1});
+    // Spawned left of the window and flies away from it.
+    projectiles.spawn(ProjectileSpawn{-50.f, 100.f, static_cast<float>(M_PI), 100.f, true, 1});
+
+    projectiles.update(0.1f, sf::Vector2u{400, 400});
+    CHECK(projectiles.is_alive(0));
+    CHECK_FALSE(projectiles.is_alive(2));
+    CHECK(Profiler::get_counter("projectiles.expired").last == 1);
+    projectiles.update(4.4f, sf::Vector2u{400, 400});
+    CHECK(projectiles.get_position(0).x == Approx(400.f));
+    CHECK(projectiles.is_alive(0));
+    projectiles.update(0.2f, sf::Vector2u{400, 400});
+    CHECK_FALSE(projectiles.is_alive(0));
+    projectiles.remove_dead();
+    REQUIRE(projectiles.get_count() == 1);
+
+    // Positions stay exact in long games, and expiry times follow a resized
+    // window.
+    for (int i{0}; i < 600; i++)
+    {
+        projectiles.update(1.f, sf::Vector2u{400, 400});
+    }
+    projectiles.spawn(ProjectileSpawn{0.f, 200.f, 0.f, 100.f, true, 1});
+    projectiles.update(0.25f, sf::Vector2u{400, 400});
+    CHECK(projectiles.get_position(0) == sf::Vector2f{10.f, 10.f});
+    CHECK(projectiles.get_position(1).x == Approx(25.f).margin(1e-3));
+    projectiles.update(1.f, sf::Vector2u{100, 400});
+    CHECK(projectiles.get_position(1).x == Approx(125.f).margin(1e-3));
+    CHECK_FALSE(projectiles.is_alive(1));
+    CHECK(projectiles.is_alive(0));
+    Profiler::reset();
+}
@@ -0,0 +1,221 @@
+#include "scorestore.hpp"
+#include "gameconfiguration.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include <catch.hpp>
+
+namespace
+{
+    /**
+     * @brief Paths of a leaderboard and a legacy file in the temp directory,
+     * removed before and after the test.
+     */
+    struct ScoreTestFiles
+    {
+        std::string path;
+        std::string legacy_path;
+
+        ScoreTestFiles(const std::string &name)
+            : path{(std::filesystem::temp_directory_path() / (name + ".dat")).string()},
+              legacy_path{(std::filesystem::temp_directory_path() / (name + ".txt")).string()}
+        {
+            remove();
+        }
+
+        ~ScoreTestFiles()
+        {
+            remove();
+        }
+
+        void remove() const
+        {
+            std::filesystem::remove(path);
+            std::filesystem::remove(path + ".tmp");
+            std::filesystem::remove(legacy_path);
+        }
+    };
+
+    ScoreEntry make_entry(std::uint32_t score, std::int64_t timestamp)
+    {
+        ScoreEntry entry{};
+        entry.score = score;
+        entry.kills = score / 10;
+        entry.boss_kills = 1;
+        entry.level = 2;
+        entry.seed = 1234;
+        entry.timestamp = timestamp;
+        return entry;
+    }
+
+    std::vector<char> read_bytes(const std::string &path)
+    {
+        std::ifstream fs{path, std::ios::binary};
+        return std::vector<char>{std::istreambuf_iterator<char>{fs}, std::istreambuf_iterator<char>{}};
+    }
+
+    void write_bytes(const std::string &path, const std::vector<char> &bytes)
+    {
+        std::ofstream fs{path, std::ios::binary | std::ios::trunc};
+        fs.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+}
+
+TEST_CASE("ScoreStore round trip")
+{
+    ScoreTestFiles files{"score_test_round_trip"};
+    {
+        ScoreStore store{files.path, 10, files.legacy_path};
+        std::size_t first{store.submit(make_entry(500, 1))};
+        std::size_t second{store.submit(make_entry(900, 2))};
+        store.flush();
+        CHECK(store.get_rank(first) == 0);
+        CHECK(store.get_rank(second) == 0);
+    }
+
+    ScoreStore store{files.path, 10, files.legacy_path};
+    store.flush();
+    std::vector<ScoreEntry> entries{store.get_leaderboard()};
+    REQUIRE(entries.size() == 2);
+    CHECK(entries[0].score == 900);
+    CHECK(entries[0].kills == 90);
+    CHECK(entries[0].boss_kills == 1);
+    CHECK(entries[0].level == 2);
+    CHECK(entries[0].seed == 1234);
+    CHECK(entries[0].timestamp == 2);
+    CHECK(entries[1].score == 500);
+    CHECK(store.get_high_score() == 900);
+}
+
+TEST_CASE("ScoreStore corrupt file")
+{
+    ScoreTestFiles files{"score_test_corrupt"};
+    {
+        ScoreStore store{files.path, 10, files.legacy_path};
+        store.submit(make_entry(700, 1));
+        store.flush();
+    }
+    std::vector<char> bytes{read_bytes(files.path)};
+    REQUIRE(bytes.size() > 4);
+
+    SECTION("Bad checksum")
+    {
+        bytes.back() ^= 0x01;
+        write_bytes(files.path, bytes);
+    }
+    SECTION("Bad size")
+    {
+        bytes.pop_back();
+        write_bytes(files.path, bytes);
+    }
+
+    // A corrupt file is ignored, the leaderboard starts empty.
+    ScoreStore store{files.path, 10, files.legacy_path};
+    store.flush();
+    CHECK(store.is_loaded());
+    CHECK(store.get_leaderboard().empty());
+    CHECK(store.get_high_score() == 0);
+}
+
+TEST_CASE("ScoreStore capacity")
+{
+    ScoreTestFiles files{"score_test_capacity"};
+    ScoreStore store{files.path, 3, files.legacy_path};
+
+    // Ranked against the leaderboard at the time the entry is inserted.
+    auto rank = [&store](const ScoreEntry &entry)
+    {
+        std::size_t ticket{store.submit(entry)};
+        store.flush();
+        return store.get_rank(ticket);
+    };
+
+    CHECK(rank(make_entry(300, 1)) == 0);
+    CHECK(rank(make_entry(100, 2)) == 1);
+    CHECK(rank(make_entry(200, 3)) == 1);
+
+    // Full, a better entry evicts the worst one and a worse one is rejected.
+    CHECK(rank(make_entry(400, 4)) == 0);
+    std::uint64_t version{store.get_version()};
+    CHECK(rank(make_entry(50, 5)) == -1);
+    CHECK(store.get_version() == version);
+
+    // Equal scores keep the older run first.
+    CHECK(rank(make_entry(300, 6)) == 2);
+
+    std::vector<ScoreEntry> entries{store.get_leaderboard()};
+    REQUIRE(entries.size() == 3);
+    CHECK(entries[0].score == 400);
+    CHECK(entries[1].score == 300);
+    CHECK(entries[1].timestamp == 1);
+    CHECK(entries[2].score == 300);
+    CHECK(entries[2].timestamp == 6);
+}
+
+TEST_CASE("ScoreStore submit before load")
+{
+    ScoreTestFiles files{"score_test_submit_before_load"};
+    {
+        ScoreStore store{files.path, 10, files.legacy_path};
+        store.submit(make_entry(800, 1));
+        store.flush();
+    }
+
+    // Submitted right away, the entry is queued and ranked once the file is in.
+    ScoreStore store{files.path, 10, files.legacy_path};
+    std::size_t ticket{store.submit(make_entry(600, 2))};
+    int rank{store.get_rank(ticket)};
+    CHECK((rank == ScoreStore::s_pending_rank || rank == 1));
+    store.flush();
+    CHECK(store.get_rank(ticket) == 1);
+    CHECK(store.get_high_score() == 800);
+}
+
+TEST_CASE("ScoreStore legacy import")
+{
+    ScoreTestFiles files{"score_test_legacy"};
+    {
+        std::ofstream fs{files.legacy_path};
+        fs << 1234;
+    }
+
+    {
+        ScoreStore store{files.path, 10, files.legacy_path};
+        store.flush();
+        CHECK(store.get_high_score() == 1234);
+        CHECK(std::filesystem::exists(files.path));
+    }
+
+    // The converted file is used from now on.
+    std::filesystem::remove(files.legacy_path);
+    ScoreStore store{files.path, 10, files.legacy_path};
+    store.flush();
+    CHECK(store.get_high_score() == 1234);
+}
+
+TEST_CASE("ScoreStore lent to a configuration")
+{
+    ScoreTestFiles files{"score_test_config"};
+    std::string config_path{(std::filesystem::temp_directory_path() / "score_test_config.cfg").string()};
+    {
+        std::ofstream fs{config_path};
+        fs << "// No keys, all defaults.\n";
+    }
+
+    // Loading a configuration does not create a leaderboard.
+    GameConfiguration gc{GameConfiguration::from_file(config_path)};
+    std::filesystem::remove(config_path);
+    CHECK(gc.get_score_store() == nullptr);
+    CHECK(gc.get_high_score() == 0);
+
+    ScoreStore store{files.path, 10, files.legacy_path};
+    store.submit(make_entry(700, 1));
+    store.flush();
+    gc.set_score_store(&store);
+    GameConfiguration copy{gc};
+    CHECK(copy.get_score_store() == &store);
+    CHECK(copy.get_high_score() == 700);
+}
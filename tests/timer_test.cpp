@@ -0,0 +1,140 @@
+#include "timerwheel.hpp"
+#include "context.hpp"
+#include "gamestate.hpp"
+#include "powerup.hpp"
+#include "gamemodetest.hpp"
+
+#include <vector>
+
+#include <catch.hpp>
+#include <SFML/Graphics.hpp>
+
+TEST_CASE("TimerWheel")
+{
+    sf::RenderWindow window{};
+    Context context{sf::Time{}, window};
+    TimerWheel wheel{sf::milliseconds(10)};
+    std::vector<int> fired{};
+
+    // Timers fire in the order they are due, also when far apart.
+    wheel.schedule(0.5f, [&fired](Context &)
+                   { fired.push_back(2); });
+    wheel.schedule(0.05f, [&fired](Context &)
+                   { fired.push_back(1); });
+    TimerId late{wheel.schedule(100.f, [&fired](Context &)
+                                { fired.push_back(3); })};
+    CHECK(wheel.get_pending_count() == 3);
+    CHECK(wheel.get_remaining(late) == Approx(100.f));
+
+    wheel.advance(sf::milliseconds(40), context);
+    CHECK(fired.empty());
+    wheel.advance(sf::milliseconds(10), context);
+    CHECK(fired == std::vector<int>{1});
+    // Less than a tick is carried over.
+    for (int i{0}; i < 90; i++)
+        wheel.advance(sf::microseconds(5000), context);
+    CHECK(fired == std::vector<int>{1, 2});
+    CHECK(wheel.get_time() == Approx(0.5f));
+    wheel.advance(sf::seconds(99.f), context);
+    CHECK(fired == std::vector<int>{1, 2});
+    CHECK(wheel.is_pending(late));
+    wheel.advance(sf::milliseconds(500), context);
+    CHECK(fired == std::vector<int>{1, 2, 3});
+    CHECK_FALSE(wheel.is_pending(late));
+    CHECK(wheel.get_pending_count() == 0);
+    // Ids are not reused.
+    CHECK_FALSE(wheel.cancel(late));
+    CHECK_FALSE(wheel.is_pending(0));
+
+    // Repeating timers keep their period, and may cancel themselves.
+    int repeats{0};
+    TimerId repeating{};
+    repeating = wheel.schedule(0.1f, [&](Context &)
+                               {
+                                   if (++repeats == 5)
+                                       wheel.cancel(repeating);
+                               },
+                               0.1f);
+    wheel.advance(sf::seconds(0.35f), context);
+    CHECK(repeats == 3);
+    wheel.advance(sf::seconds(10.f), context);
+    CHECK(repeats == 5);
+    CHECK(wheel.get_pending_count() == 0);
+
+    // Cancelled timers do not fire, timers scheduled by a callback fire later.
+    int chained{0};
+    TimerId cancelled{wheel.schedule(0.2f, [&chained](Context &)
+                                     { chained += 100; })};
+    wheel.schedule(0.1f, [&](Context &)
+                   {
+                       wheel.cancel(cancelled);
+                       wheel.schedule(0.f, [&chained](Context &)
+                                      { chained++; });
+                   });
+    wheel.advance(sf::seconds(0.1f), context);
+    CHECK(chained == 0);
+    wheel.advance(sf::seconds(1.f), context);
+    CHECK(chained == 1);
+
+    // Timers cancel themselves when they are destroyed.
+    {
+        Timer timer{};
+        timer.start(wheel, 1.f, [&chained](Context &)
+                    { chained += 100; });
+        CHECK(timer.is_running());
+        CHECK(timer.get_remaining() == Approx(1.f));
+        timer.start(wheel, 2.f, [&chained](Context &)
+                    { chained += 100; });
+        CHECK(wheel.get_pending_count() == 1);
+    }
+    CHECK(wheel.get_pending_count() == 0);
+    wheel.advance(sf::seconds(5.f), context);
+    CHECK(chained == 1);
+}
+
+TEST_CASE("TimerWheel many timers")
+{
+    sf::RenderWindow window{};
+    Context context{sf::Time{}, window};
+    TimerWheel wheel{sf::milliseconds(10)};
+
+    // Every timer fires exactly once, in its own tick.
+    const int count{20000};
+    std::vector<int> fired_at(count, -1);
+    for (int i{0}; i < count; i++)
+    {
+        wheel.schedule((i + 1) * 0.01f, [&fired_at, &wheel, i](Context &)
+                       { fired_at[i] = static_cast<int>(wheel.get_time() * 100.f + 0.5f); });
+    }
+    for (int frame{0}; frame < count / 2 + 10; frame++)
+        wheel.advance(sf::milliseconds(20), context);
+    bool all_on_time{true};
+    for (int i{0}; i < count; i++)
+        all_on_time = all_on_time && fired_at[i] == i + 1;
+    CHECK(all_on_time);
+    CHECK(wheel.get_pending_count() == 0);
+}
+
+TEST_CASE("GameMode timers")
+{
+    sf::RenderWindow window{};
+    GameModeTest mode{};
+    PowerUp *powerup{new Repair{100.f, -1e6f, 0.f}};
+    mode.spawn_object(powerup);
+    CHECK(mode.get_timers().get_pending_count() == 1);
+
+    // The power-up disappears after 10 seconds of updates, no matter how
+    // much time passes between them.
+    for (int i{0}; i < 9; i++)
+    {
+        Context context{sf::seconds(1.f), window};
+        mode.update(context);
+    }
+    CHECK(mode.get_objects().size() == 1);
+    {
+        Context context{sf::seconds(1.f), window};
+        mode.update(context);
+    }
+    CHECK(mode.get_objects().empty());
+    CHECK(mode.get_timers().get_pending_count() == 0);
+}
@@ -0,0 +1,122 @@
+#include "wavetimeline.hpp"
+#include "archetypes.hpp"
+
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include <catch.hpp>
+
+namespace
+{
+    /**
+     * @brief Compile a timeline and open a cursor on the result.
+     */
+    WaveCursor compile_cursor(const std::string &text)
+    {
+        std::stringstream in{text};
+        std::unique_ptr<std::stringstream> out{new std::stringstream{}};
+        WaveTimeline::compile(in, *out);
+        return WaveCursor{std::move(out)};
+    }
+}
+
+TEST_CASE("WaveTimeline compile")
+{
+    WaveCursor cursor{compile_cursor("// Written out of order\n"
+                                     "BOSS=45.0;\n"
+                                     "FORMATION=2.5,minion,2,5,0.1,-20,0.2,-10;\n"
+                                     "UNKNOWN=1.0;\n"
+                                     "POWERUP=10.0,nuke,0.5,-30;\n"
+                                     "FORMATION=2.5,tank,1,1,0.5,-40,0,0;\n")};
+    REQUIRE(cursor.get_event_count() == 4);
+    REQUIRE(cursor.get_names().size() == 2);
+    CHECK(cursor.get_names()[0] == "minion");
+    CHECK(cursor.get_names()[1] == "tank");
+
+    // Nothing is due before the first mark.
+    WaveEvent event{};
+    CHECK_FALSE(cursor.poll(2.f, event));
+
+    // Events at the same time keep the order they were written in.
+    REQUIRE(cursor.poll(3.f, event));
+    CHECK(event.type == WaveEventType::Formation);
+    CHECK(event.time == Approx(2.5f));
+    CHECK(event.difficulty == 2);
+    CHECK(event.count == 5);
+    CHECK(event.index == 0);
+    CHECK(event.position == sf::Vector2f{0.1f, -20.f});
+    CHECK(event.step == sf::Vector2f{0.2f, -10.f});
+    REQUIRE(cursor.poll(3.f, event));
+    CHECK(event.index == 1);
+    CHECK_FALSE(cursor.poll(3.f, event));
+
+    // Several events may be due in one tick.
+    REQUIRE(cursor.poll(100.f, event));
+    CHECK(event.type == WaveEventType::PowerUp);
+    CHECK(event.index == WaveTimeline::find_powerup("nuke"));
+    CHECK(event.position == sf::Vector2f{0.5f, -30.f});
+    REQUIRE(cursor.poll(100.f, event));
+    CHECK(event.type == WaveEventType::Boss);
+    CHECK_FALSE(cursor.poll(100.f, event));
+    CHECK(cursor.is_done());
+
+    // Invalid values throw.
+    std::stringstream out{};
+    std::stringstream missing{"FORMATION=1.0,minion,1,5,0.1;\n"};
+    CHECK_THROWS(WaveTimeline::compile(missing, out));
+    std::stringstream powerup{"POWERUP=1.0,XXXX,0.1,0.1;\n"};
+    CHECK_THROWS(WaveTimeline::compile(powerup, out));
+    std::stringstream negative{"BOSS=-1.0;\n"};
+    CHECK_THROWS(WaveTimeline::compile(negative, out));
+    CHECK_THROWS(WaveCursor{std::unique_ptr<std::istream>{new std::stringstream{"XXXX"}}});
+    CHECK_THROWS(WaveCursor{"XXXX"});
+}
+
+TEST_CASE("WaveCursor streaming")
+{
+    // Many more events than are read at a time.
+    std::stringstream text{};
+    for (int i{999}; i >= 0; i--)
+        text << "FORMATION=" << i << ",minion,1," << i % 7 << ",0.5,-20,0,0;\n";
+    WaveCursor cursor{compile_cursor(text.str())};
+    REQUIRE(cursor.get_event_count() == 1000);
+
+    WaveEvent event{};
+    int polled{0};
+    for (int tick{0}; tick < 1000; tick++)
+    {
+        int due{0};
+        while (cursor.poll(tick + 0.5f, event))
+        {
+            CHECK(event.time == Approx(static_cast<float>(tick)));
+            CHECK(event.count == static_cast<unsigned int>(tick % 7));
+            due++;
+        }
+        CHECK(due == 1);
+        polled += due;
+    }
+    CHECK(polled == 1000);
+    CHECK(cursor.is_done());
+
+    // A timeline that ends early throws while streaming.
+    std::stringstream in{"BOSS=1.0;\nBOSS=2.0;\n"};
+    std::string binary{};
+    {
+        std::stringstream out{};
+        WaveTimeline::compile(in, out);
+        binary = out.str();
+    }
+    WaveCursor truncated{std::unique_ptr<std::istream>{
+        new std::stringstream{binary.substr(0, binary.size() - 4)}}};
+    CHECK_THROWS(truncated.poll(10.f, event));
+
+    // The shipped timeline uses existing archetypes.
+    WaveTimeline::compile("assets/waves.txt", "build_waves_test.wave");
+    WaveCursor shipped{"build_waves_test.wave"};
+    ArchetypeTable archetypes{ArchetypeTable::from_file("assets/archetypes.txt")};
+    for (const std::string &name : shipped.get_names())
+        CHECK_NOTHROW(archetypes.find(name));
+    std::remove("build_waves_test.wave");
+}
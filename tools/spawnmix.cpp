@@ -0,0 +1,74 @@
+#include "archetypes.hpp"
+#include "gameconfiguration.hpp"
+#include "spawntable.hpp"
+
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+// Prints the chance of every enemy to be spawned, per level band of the spawn
+// table named in the configuration. Usage: spawnmix [config file]
+
+namespace
+{
+    // Draws per band used to check the compiled tables.
+    const unsigned int s_samples{1000000};
+}
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        GameConfiguration gc{GameConfiguration::from_file(argc > 1 ? argv[1] : "config.txt")};
+        const NormalModeData &data{gc.get_normal_mode_data()};
+        ArchetypeTable archetypes{data.archetype_file.empty() ? ArchetypeTable::defaults()
+                                                               : ArchetypeTable::from_file(data.archetype_file)};
+        SpawnTable spawns{data.spawn_file.empty() ? SpawnTable::defaults()
+                                                  : SpawnTable::from_file(data.spawn_file)};
+        spawns.compile(archetypes);
+
+        std::mt19937 rng{data.spawn_seed};
+        std::cout << std::fixed << std::setprecision(2);
+        for (std::size_t b{0}; b < spawns.get_band_count(); b++)
+        {
+            const SpawnBand &band{spawns.get_band(b)};
+            std::cout << "Levels " << band.level;
+            if (b + 1 < spawns.get_band_count())
+                std::cout << "-" << spawns.get_band(b + 1).level - 1 << "\n";
+            else
+                std::cout << "+\n";
+
+            // Count how often every spawn is drawn from the compiled table.
+            std::vector<unsigned int> counts(band.entries.size(), 0);
+            for (unsigned int i{0}; i < s_samples; i++)
+            {
+                const SpawnChoice &choice{spawns.sample(band.level, rng())};
+                for (std::size_t e{0}; e < band.entries.size(); e++)
+                {
+                    if (archetypes.find(band.entries[e].archetype) == choice.archetype &&
+                        band.entries[e].difficulty == choice.difficulty)
+                    {
+                        counts[e]++;
+                        break;
+                    }
+                }
+            }
+
+            for (std::size_t e{0}; e < band.entries.size(); e++)
+            {
+                const SpawnEntry &entry{band.entries[e]};
+                std::cout << "    " << std::left << std::setw(12) << entry.archetype
+                          << "difficulty " << entry.difficulty << std::right
+                          << std::setw(8) << spawns.get_probability(b, e) * 100.0 << " %"
+                          << "  (sampled " << std::setw(6) << counts[e] * 100.0 / s_samples << " %)\n";
+            }
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
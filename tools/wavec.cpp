@@ -0,0 +1,26 @@
+#include "wavetimeline.hpp"
+
+#include <iostream>
+#include <stdexcept>
+
+// Compiles an authored wave timeline into the binary format read by the game,
+// see WaveTimeline. Usage: wavec <timeline file> <output file>
+
+int main(int argc, char *argv[])
+{
+    if (argc != 3)
+    {
+        std::cerr << "Usage: wavec <timeline file> <output file>" << std::endl;
+        return 1;
+    }
+    try
+    {
+        std::size_t events{WaveTimeline::compile(argv[1], argv[2])};
+        std::cout << argv[2] << ": " << events << " events" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}